@@ -52,16 +52,75 @@ class Distortion
     inline std::size_t getDistortionParametersCount() const { return _distortionParams.size(); }
 
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    virtual Vec2 addDistortion(const Vec2& p) const { return p; }
+    Vec2 addDistortion(const Vec2& p) const { return addDistortion(_distortionParams.data(), p); }
+
+    /**
+     * @brief Add distortion to the point p using the given parameters instead of the stored ones.
+     * @note Stateless: does not modify the object and does not allocate, so it can be called concurrently.
+     *       The models overriding it redeclare the stateful overloads with a using-declaration.
+     * @param[in] params distortion parameters (getDistortionParametersCount() values)
+     * @param[in] p point in the camera frame [normalized coordinates]
+     * @return the distorted point
+     */
+    virtual Vec2 addDistortion(const double* params, const Vec2& p) const { return p; }
 
     /// Remove distortion (return p' such that disto(p') = p)
     virtual Vec2 removeDistortion(const Vec2& p) const { return p; }
 
+    /**
+     * @brief Add distortion to a set of points (assume the points are in the camera frame [normalized coordinates]).
+     * @note The default implementation distorts the points one by one,
+     *       the distortion models with a closed form override it with a vectorized implementation.
+     * @param[in] pts the points, one per column
+     * @param[out] out_pts the distorted points, may be the same matrix as pts
+     */
+    virtual void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
+    {
+        out_pts.resize(2, pts.cols());
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            out_pts.col(i) = addDistortion(_distortionParams.data(), pts.col(i));
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a set of points (return the points p' such that disto(p') = p).
+     * @param[in] pts the points, one per column
+     * @param[out] out_pts the undistorted points, may be the same matrix as pts
+     */
+    virtual void removeDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
+    {
+        out_pts.resize(2, pts.cols());
+        for (Eigen::Index i = 0; i < pts.cols(); ++i)
+        {
+            out_pts.col(i) = removeDistortion(pts.col(i));
+        }
+    }
+
     virtual double getUndistortedRadius(double r) const { return r; }
 
-    virtual Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const { return Eigen::Matrix2d::Identity(); }
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const { return getDerivativeAddDistoWrtPt(_distortionParams.data(), p); }
+
+    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const
+    {
+        Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor> ret(2, _distortionParams.size());
+        getDerivativeAddDistoWrtDisto(_distortionParams.data(), p, ret);
+        return ret;
+    }
 
-    virtual Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const { return Eigen::MatrixXd(0, 0); }
+    /// Stateless version of getDerivativeAddDistoWrtPt using the given distortion parameters
+    virtual Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const { return Eigen::Matrix2d::Identity(); }
+
+    /**
+     * @brief Stateless version of getDerivativeAddDistoWrtDisto using the given distortion parameters.
+     * @param[in] params distortion parameters (getDistortionParametersCount() values)
+     * @param[in] p point in the camera frame [normalized coordinates]
+     * @param[out] jacobian 2 x getDistortionParametersCount() output block (may be a view into a larger jacobian)
+     */
+    virtual void getDerivativeAddDistoWrtDisto(const double* params,
+                                               const Vec2& p,
+                                               Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
+    {}
 
     virtual Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const { return Eigen::Matrix2d::Identity(); }
 
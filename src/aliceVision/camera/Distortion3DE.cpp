@@ -9,14 +9,14 @@
 namespace aliceVision {
 namespace camera {
 
-Vec2 Distortion3DERadial4::addDistortion(const Vec2& p) const
+Vec2 Distortion3DERadial4::addDistortion(const double* params, const Vec2& p) const
 {
-    const double& c2 = _distortionParams[0];
-    const double& c4 = _distortionParams[1];
-    const double& u1 = _distortionParams[2];
-    const double& v1 = _distortionParams[3];
-    const double& u3 = _distortionParams[4];
-    const double& v3 = _distortionParams[5];
+    const double& c2 = params[0];
+    const double& c4 = params[1];
+    const double& u1 = params[2];
+    const double& v1 = params[3];
+    const double& u3 = params[4];
+    const double& v3 = params[5];
 
     const double& x = p.x();
     const double& y = p.y();
@@ -42,14 +42,14 @@ Vec2 Distortion3DERadial4::addDistortion(const Vec2& p) const
     return np;
 }
 
-Eigen::Matrix2d Distortion3DERadial4::getDerivativeAddDistoWrtPt(const Vec2& p) const
+Eigen::Matrix2d Distortion3DERadial4::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
 {
-    const double& c2 = _distortionParams[0];
-    const double& c4 = _distortionParams[1];
-    const double& u1 = _distortionParams[2];
-    const double& v1 = _distortionParams[3];
-    const double& u3 = _distortionParams[4];
-    const double& v3 = _distortionParams[5];
+    const double& c2 = params[0];
+    const double& c4 = params[1];
+    const double& u1 = params[2];
+    const double& v1 = params[3];
+    const double& u3 = params[4];
+    const double& v3 = params[5];
 
     const double& x = p.x();
     const double& y = p.y();
@@ -114,14 +114,16 @@ Eigen::Matrix2d Distortion3DERadial4::getDerivativeAddDistoWrtPt(const Vec2& p)
     return ret;
 }
 
-Eigen::MatrixXd Distortion3DERadial4::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void Distortion3DERadial4::getDerivativeAddDistoWrtDisto(const double* params,
+                                                         const Vec2& p,
+                                                         Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double& c2 = _distortionParams[0];
-    const double& c4 = _distortionParams[1];
-    const double& u1 = _distortionParams[2];
-    const double& v1 = _distortionParams[3];
-    const double& u3 = _distortionParams[4];
-    const double& v3 = _distortionParams[5];
+    const double& c2 = params[0];
+    const double& c4 = params[1];
+    const double& u1 = params[2];
+    const double& v1 = params[3];
+    const double& u3 = params[4];
+    const double& v3 = params[5];
 
     const double& x = p.x();
     const double& y = p.y();
@@ -135,7 +137,8 @@ Eigen::MatrixXd Distortion3DERadial4::getDerivativeAddDistoWrtDisto(const Vec2&
     const double eps = 1e-8;
     if (r2 < eps)
     {
-        return Eigen::Matrix<double, 2, 6>::Zero();
+        jacobian.setZero();
+        return;
     }
 
     const double p1 = 1.0 + c2 * r2 + c4 * r4;
@@ -175,7 +178,7 @@ Eigen::MatrixXd Distortion3DERadial4::getDerivativeAddDistoWrtDisto(const Vec2&
     ret.block<1, 6>(0, 0) = x * d_p1_d_disto + p2 * d_p4_d_disto + p6 * d_p5_d_disto;
     ret.block<1, 6>(1, 0) = y * d_p1_d_disto + p3 * d_p5_d_disto + p6 * d_p4_d_disto;
 
-    return ret;
+    jacobian = ret;
 }
 
 Vec2 Distortion3DERadial4::removeDistortion(const Vec2& p) const
@@ -183,13 +186,13 @@ Vec2 Distortion3DERadial4::removeDistortion(const Vec2& p) const
     const double epsilon = 1e-8;
     Vec2 undistorted_value = p;
 
-    Vec2 diff = addDistortion(undistorted_value) - p;
+    Vec2 diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
 
     int iter = 0;
     while (diff.norm() > epsilon)
     {
-        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(undistorted_value).inverse() * diff;
-        diff = addDistortion(undistorted_value) - p;
+        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(_distortionParams.data(), undistorted_value).inverse() * diff;
+        diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
         iter++;
         if (iter > 100)
             break;
@@ -198,21 +201,21 @@ Vec2 Distortion3DERadial4::removeDistortion(const Vec2& p) const
     return undistorted_value;
 }
 
-Vec2 Distortion3DEAnamorphic4::addDistortion(const Vec2& p) const
+Vec2 Distortion3DEAnamorphic4::addDistortion(const double* params, const Vec2& p) const
 {
-    const double& cx02 = _distortionParams[0];
-    const double& cy02 = _distortionParams[1];
-    const double& cx22 = _distortionParams[2];
-    const double& cy22 = _distortionParams[3];
-    const double& cx04 = _distortionParams[4];
-    const double& cy04 = _distortionParams[5];
-    const double& cx24 = _distortionParams[6];
-    const double& cy24 = _distortionParams[7];
-    const double& cx44 = _distortionParams[8];
-    const double& cy44 = _distortionParams[9];
-    const double& phi = _distortionParams[10];
-    const double& sqx = _distortionParams[11];
-    const double& sqy = _distortionParams[12];
+    const double& cx02 = params[0];
+    const double& cy02 = params[1];
+    const double& cx22 = params[2];
+    const double& cy22 = params[3];
+    const double& cx04 = params[4];
+    const double& cy04 = params[5];
+    const double& cx24 = params[6];
+    const double& cy24 = params[7];
+    const double& cx44 = params[8];
+    const double& cy44 = params[9];
+    const double& phi = params[10];
+    const double& sqx = params[11];
+    const double& sqy = params[12];
 
     const double cphi = std::cos(phi);
     const double sphi = std::sin(phi);
@@ -256,21 +259,21 @@ Vec2 Distortion3DEAnamorphic4::addDistortion(const Vec2& p) const
     return np;
 }
 
-Eigen::Matrix2d Distortion3DEAnamorphic4::getDerivativeAddDistoWrtPt(const Vec2& p) const
+Eigen::Matrix2d Distortion3DEAnamorphic4::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
 {
-    const double& cx02 = _distortionParams[0];
-    const double& cy02 = _distortionParams[1];
-    const double& cx22 = _distortionParams[2];
-    const double& cy22 = _distortionParams[3];
-    const double& cx04 = _distortionParams[4];
-    const double& cy04 = _distortionParams[5];
-    const double& cx24 = _distortionParams[6];
-    const double& cy24 = _distortionParams[7];
-    const double& cx44 = _distortionParams[8];
-    const double& cy44 = _distortionParams[9];
-    const double& phi = _distortionParams[10];
-    const double& sqx = _distortionParams[11];
-    const double& sqy = _distortionParams[12];
+    const double& cx02 = params[0];
+    const double& cy02 = params[1];
+    const double& cx22 = params[2];
+    const double& cy22 = params[3];
+    const double& cx04 = params[4];
+    const double& cy04 = params[5];
+    const double& cx24 = params[6];
+    const double& cy24 = params[7];
+    const double& cx44 = params[8];
+    const double& cy44 = params[9];
+    const double& phi = params[10];
+    const double& sqx = params[11];
+    const double& sqy = params[12];
 
     const double cphi = std::cos(phi);
     const double sphi = std::sin(phi);
@@ -328,21 +331,23 @@ Eigen::Matrix2d Distortion3DEAnamorphic4::getDerivativeAddDistoWrtPt(const Vec2&
     return d_np_d_squizzed * d_squizzed_d_d * d_d_d_r * d_r_d_p;
 }
 
-Eigen::MatrixXd Distortion3DEAnamorphic4::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void Distortion3DEAnamorphic4::getDerivativeAddDistoWrtDisto(const double* params,
+                                                             const Vec2& p,
+                                                             Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double& cx02 = _distortionParams[0];
-    const double& cy02 = _distortionParams[1];
-    const double& cx22 = _distortionParams[2];
-    const double& cy22 = _distortionParams[3];
-    const double& cx04 = _distortionParams[4];
-    const double& cy04 = _distortionParams[5];
-    const double& cx24 = _distortionParams[6];
-    const double& cy24 = _distortionParams[7];
-    const double& cx44 = _distortionParams[8];
-    const double& cy44 = _distortionParams[9];
-    const double& phi = _distortionParams[10];
-    const double& sqx = _distortionParams[11];
-    const double& sqy = _distortionParams[12];
+    const double& cx02 = params[0];
+    const double& cy02 = params[1];
+    const double& cx22 = params[2];
+    const double& cy22 = params[3];
+    const double& cx04 = params[4];
+    const double& cy04 = params[5];
+    const double& cx24 = params[6];
+    const double& cy24 = params[7];
+    const double& cx44 = params[8];
+    const double& cy44 = params[9];
+    const double& phi = params[10];
+    const double& sqx = params[11];
+    const double& sqy = params[12];
 
     const double cphi = std::cos(phi);
     const double sphi = std::sin(phi);
@@ -453,7 +458,7 @@ Eigen::MatrixXd Distortion3DEAnamorphic4::getDerivativeAddDistoWrtDisto(const Ve
 
     J.block(0, 10, 2, 4) = Eigen::Matrix<double, 2, 4>::Zero();
 
-    return J;
+    jacobian = J;
 }
 
 Vec2 Distortion3DEAnamorphic4::removeDistortion(const Vec2& p) const
@@ -461,13 +466,13 @@ Vec2 Distortion3DEAnamorphic4::removeDistortion(const Vec2& p) const
     double epsilon = 1e-8;
     Vec2 undistorted_value = p;
 
-    Vec2 diff = addDistortion(undistorted_value) - p;
+    Vec2 diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
 
     int iter = 0;
     while (diff.norm() > epsilon)
     {
-        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(undistorted_value).inverse() * diff;
-        diff = addDistortion(undistorted_value) - p;
+        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(_distortionParams.data(), undistorted_value).inverse() * diff;
+        diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
         iter++;
         if (iter > 10)
             break;
@@ -476,13 +481,13 @@ Vec2 Distortion3DEAnamorphic4::removeDistortion(const Vec2& p) const
     return undistorted_value;
 }
 
-Vec2 Distortion3DEClassicLD::addDistortion(const Vec2& p) const
+Vec2 Distortion3DEClassicLD::addDistortion(const double* params, const Vec2& p) const
 {
-    const double& delta = _distortionParams[0];
-    const double& invepsilon = _distortionParams[1];
-    const double& mux = _distortionParams[2];
-    const double& muy = _distortionParams[3];
-    const double& q = _distortionParams[4];
+    const double& delta = params[0];
+    const double& invepsilon = params[1];
+    const double& mux = params[2];
+    const double& muy = params[3];
+    const double& q = params[4];
 
     const double eps = 1.0 + std::cos(invepsilon);
 
@@ -513,13 +518,13 @@ Vec2 Distortion3DEClassicLD::addDistortion(const Vec2& p) const
     return np;
 }
 
-Eigen::Matrix2d Distortion3DEClassicLD::getDerivativeAddDistoWrtPt(const Vec2& p) const
+Eigen::Matrix2d Distortion3DEClassicLD::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
 {
-    const double& delta = _distortionParams[0];
-    const double& invepsilon = _distortionParams[1];
-    const double& mux = _distortionParams[2];
-    const double& muy = _distortionParams[3];
-    const double& q = _distortionParams[4];
+    const double& delta = params[0];
+    const double& invepsilon = params[1];
+    const double& mux = params[2];
+    const double& muy = params[3];
+    const double& q = params[4];
 
     const double eps = 1.0 + std::cos(invepsilon);
 
@@ -563,13 +568,15 @@ Eigen::Matrix2d Distortion3DEClassicLD::getDerivativeAddDistoWrtPt(const Vec2& p
     return ret;
 }
 
-Eigen::MatrixXd Distortion3DEClassicLD::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void Distortion3DEClassicLD::getDerivativeAddDistoWrtDisto(const double* params,
+                                                           const Vec2& p,
+                                                           Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double& delta = _distortionParams[0];
-    const double& invepsilon = _distortionParams[1];
-    const double& mux = _distortionParams[2];
-    const double& muy = _distortionParams[3];
-    const double& q = _distortionParams[4];
+    const double& delta = params[0];
+    const double& invepsilon = params[1];
+    const double& mux = params[2];
+    const double& muy = params[3];
+    const double& q = params[4];
 
     const double eps = 1.0 + std::cos(invepsilon);
 
@@ -649,7 +656,7 @@ Eigen::MatrixXd Distortion3DEClassicLD::getDerivativeAddDistoWrtDisto(const Vec2
     localParams(8, 4) = 2;
     localParams(9, 4) = 1;
 
-    return ret * localParams;
+    jacobian = ret * localParams;
 }
 
 Vec2 Distortion3DEClassicLD::removeDistortion(const Vec2& p) const
@@ -657,13 +664,13 @@ Vec2 Distortion3DEClassicLD::removeDistortion(const Vec2& p) const
     const double epsilon = 1e-8;
     Vec2 undistorted_value = p;
 
-    Vec2 diff = addDistortion(undistorted_value) - p;
+    Vec2 diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
 
     int iter = 0;
     while (diff.norm() > epsilon)
     {
-        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(undistorted_value).inverse() * diff;
-        diff = addDistortion(undistorted_value) - p;
+        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(_distortionParams.data(), undistorted_value).inverse() * diff;
+        diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
         iter++;
         if (iter > 1000)
             break;
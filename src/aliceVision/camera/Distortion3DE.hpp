@@ -36,12 +36,18 @@ class Distortion3DERadial4 : public Distortion
 
     Distortion3DERadial4* clone() const override { return new Distortion3DERadial4(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
@@ -98,12 +104,18 @@ class Distortion3DEAnamorphic4 : public Distortion
 
     Distortion3DEAnamorphic4* clone() const override { return new Distortion3DEAnamorphic4(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
@@ -147,12 +159,18 @@ class Distortion3DEClassicLD : public Distortion
 
     Distortion3DEClassicLD* clone() const override { return new Distortion3DEClassicLD(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
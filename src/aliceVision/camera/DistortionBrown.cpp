@@ -11,13 +11,13 @@
 namespace aliceVision {
 namespace camera {
 
-Vec2 DistortionBrown::addDistortion(const Vec2& p) const 
+Vec2 DistortionBrown::addDistortion(const double* params, const Vec2& p) const 
 { 
-    const double k1 = _distortionParams[0];
-    const double k2 = _distortionParams[1];
-    const double k3 = _distortionParams[2];
-    const double t1 = _distortionParams[3]; 
-    const double t2 = _distortionParams[4];
+    const double k1 = params[0];
+    const double k2 = params[1];
+    const double k3 = params[2];
+    const double t1 = params[3]; 
+    const double t2 = params[4];
 
     double px = p(0);
     double py = p(1);
@@ -38,14 +38,34 @@ Vec2 DistortionBrown::addDistortion(const Vec2& p) const
     return result; 
 }
 
-Eigen::Matrix2d DistortionBrown::getDerivativeAddDistoWrtPt(const Vec2& p) const 
+void DistortionBrown::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
 {
     const double k1 = _distortionParams[0];
     const double k2 = _distortionParams[1];
     const double k3 = _distortionParams[2];
-    const double t1 = _distortionParams[3]; 
+    const double t1 = _distortionParams[3];
     const double t2 = _distortionParams[4];
 
+    // copies, out_pts may be the same matrix as pts
+    const Eigen::Array<double, 1, Eigen::Dynamic> px = pts.row(0).array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> py = pts.row(1).array();
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = px.square() + py.square();
+    const Eigen::Array<double, 1, Eigen::Dynamic> k_diff = r2 * (k1 + r2 * (k2 + r2 * k3));
+
+    out_pts.resize(2, pts.cols());
+    out_pts.row(0) = (px + px * k_diff + t2 * (r2 + 2 * px.square()) + 2 * t1 * px * py).matrix();
+    out_pts.row(1) = (py + py * k_diff + t1 * (r2 + 2 * py.square()) + 2 * t2 * px * py).matrix();
+}
+
+Eigen::Matrix2d DistortionBrown::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const 
+{
+    const double k1 = params[0];
+    const double k2 = params[1];
+    const double k3 = params[2];
+    const double t1 = params[3]; 
+    const double t2 = params[4];
+
     double px = p(0);
     double py = p(1);
 
@@ -63,13 +83,15 @@ Eigen::Matrix2d DistortionBrown::getDerivativeAddDistoWrtPt(const Vec2& p) const
     return ret;
 }
 
-Eigen::MatrixXd DistortionBrown::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionBrown::getDerivativeAddDistoWrtDisto(const double* params,
+                                                    const Vec2& p,
+                                                    Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double k1 = _distortionParams[0];
-    const double k2 = _distortionParams[1];
-    const double k3 = _distortionParams[2];
-    const double t1 = _distortionParams[3]; 
-    const double t2 = _distortionParams[4];
+    const double k1 = params[0];
+    const double k2 = params[1];
+    const double k3 = params[2];
+    const double t1 = params[3]; 
+    const double t2 = params[4];
 
     double px = p(0);
     double py = p(1);
@@ -78,22 +100,17 @@ Eigen::MatrixXd DistortionBrown::getDerivativeAddDistoWrtDisto(const Vec2& p) co
     const double r4 = r2 * r2;
     const double r6 = r4 * r2;
 
-    Eigen::Matrix<double, 2, 5> ret = Eigen::Matrix<double, 2, 5>::Zero();
-
-    ret(0, 0) = px*r2;
-    ret(0, 1) = px*r4;
-    ret(0, 2) = px*r6;
-    ret(0, 3) = 2*px*py;
-    ret(0, 4) = 3*px*px + py*py;
-
-
-    ret(1, 0) = py*r2;
-    ret(1, 1) = py*r4;
-    ret(1, 2) = py*r6;
-    ret(1, 3) = px*px + 3*py*py;
-    ret(1, 4) = 2*px*py;
-
-    return ret;
+    jacobian(0, 0) = px*r2;
+    jacobian(0, 1) = px*r4;
+    jacobian(0, 2) = px*r6;
+    jacobian(0, 3) = 2*px*py;
+    jacobian(0, 4) = 3*px*px + py*py;
+
+    jacobian(1, 0) = py*r2;
+    jacobian(1, 1) = py*r4;
+    jacobian(1, 2) = py*r6;
+    jacobian(1, 3) = px*px + 3*py*py;
+    jacobian(1, 4) = 2*px*py;
 }
 
 Vec2 DistortionBrown::removeDistortion(const Vec2& p) const
@@ -102,14 +119,14 @@ Vec2 DistortionBrown::removeDistortion(const Vec2& p) const
     Vec2 undistorted_value = p;
 
     
-    Vec2 diff = addDistortion(undistorted_value) - p;
+    Vec2 diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
 
     int iter = 0;
     while (diff.norm() > epsilon)
     {
-        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(undistorted_value).inverse() * diff;
+        undistorted_value = undistorted_value - getDerivativeAddDistoWrtPt(_distortionParams.data(), undistorted_value).inverse() * diff;
         
-        diff = addDistortion(undistorted_value) - p;
+        diff = addDistortion(_distortionParams.data(), undistorted_value) - p;
         iter++;
         if (iter > 10)
         {
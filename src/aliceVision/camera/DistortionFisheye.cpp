@@ -9,7 +9,7 @@
 namespace aliceVision {
 namespace camera {
 
-Vec2 DistortionFisheye::addDistortion(const Vec2& p) const
+Vec2 DistortionFisheye::addDistortion(const double* params, const Vec2& p) const
 {
     const double eps = 1e-8;
     const double r = std::hypot(p(0), p(1));
@@ -18,10 +18,10 @@ Vec2 DistortionFisheye::addDistortion(const Vec2& p) const
         return p;
     }
 
-    const double& k1 = _distortionParams.at(0);
-    const double& k2 = _distortionParams.at(1);
-    const double& k3 = _distortionParams.at(2);
-    const double& k4 = _distortionParams.at(3);
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
+    const double& k4 = params[3];
 
     const double theta = std::atan(r);
     const double theta2 = theta * theta;
@@ -38,7 +38,25 @@ Vec2 DistortionFisheye::addDistortion(const Vec2& p) const
     return p * cdist;
 }
 
-Eigen::Matrix2d DistortionFisheye::getDerivativeAddDistoWrtPt(const Vec2& p) const
+void DistortionFisheye::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
+{
+    const double eps = 1e-8;
+    const double& k1 = _distortionParams[0];
+    const double& k2 = _distortionParams[1];
+    const double& k3 = _distortionParams[2];
+    const double& k4 = _distortionParams[3];
+
+    const Eigen::Array<double, 1, Eigen::Dynamic> r = pts.colwise().norm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> theta = r.atan();
+    const Eigen::Array<double, 1, Eigen::Dynamic> theta2 = theta.square();
+    const Eigen::Array<double, 1, Eigen::Dynamic> theta_dist = theta * (1. + theta2 * (k1 + theta2 * (k2 + theta2 * (k3 + theta2 * k4))));
+
+    // the points close to the center are not distorted
+    const Eigen::Array<double, 1, Eigen::Dynamic> cdist = (r < eps).select(1.0, theta_dist / r);
+    out_pts = (pts.array().rowwise() * cdist).matrix();
+}
+
+Eigen::Matrix2d DistortionFisheye::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
 {
     const double eps = 1e-8;
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
@@ -47,10 +65,10 @@ Eigen::Matrix2d DistortionFisheye::getDerivativeAddDistoWrtPt(const Vec2& p) con
         return Eigen::Matrix2d::Identity();
     }
 
-    const double& k1 = _distortionParams.at(0);
-    const double& k2 = _distortionParams.at(1);
-    const double& k3 = _distortionParams.at(2);
-    const double& k4 = _distortionParams.at(3);
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
+    const double& k4 = params[3];
 
     const double theta = std::atan(r);
     const double theta2 = theta * theta;
@@ -78,14 +96,17 @@ Eigen::Matrix2d DistortionFisheye::getDerivativeAddDistoWrtPt(const Vec2& p) con
     return Eigen::Matrix2d::Identity() * cdist + p * d_cdist_d_p;
 }
 
-Eigen::MatrixXd DistortionFisheye::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionFisheye::getDerivativeAddDistoWrtDisto(const double* params,
+                                                      const Vec2& p,
+                                                      Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
     const double eps = 1e-8;
 
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     if (r < eps)
     {
-        return Eigen::Matrix<double, 2, 4>::Zero();
+        jacobian.setZero();
+        return;
     }
 
     const double theta = std::atan(r);
@@ -106,9 +127,7 @@ Eigen::MatrixXd DistortionFisheye::getDerivativeAddDistoWrtDisto(const Vec2& p)
     d_r_theta_dist_d_params(0, 2) = theta7;
     d_r_theta_dist_d_params(0, 3) = theta9;
 
-    const Eigen::MatrixXd ret = p * d_cdist_d_theta_dist * d_r_theta_dist_d_params;
-
-    return ret;
+    jacobian = p * d_cdist_d_theta_dist * d_r_theta_dist_d_params;
 }
 
 Vec2 DistortionFisheye::removeDistortion(const Vec2& p) const
@@ -144,7 +163,7 @@ Eigen::Matrix2d DistortionFisheye::getDerivativeRemoveDistoWrtPt(const Vec2& p)
 
     const Vec2 undist = removeDistortion(p);
 
-    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(undist);
+    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(_distortionParams.data(), undist);
 
     return Jinv.inverse();
 }
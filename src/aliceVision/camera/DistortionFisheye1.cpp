@@ -9,10 +9,10 @@
 namespace aliceVision {
 namespace camera {
 
-Vec2 DistortionFisheye1::addDistortion(const Vec2& p) const
+Vec2 DistortionFisheye1::addDistortion(const double* params, const Vec2& p) const
 {
     const double eps = 1e-8;
-    const double& k1 = _distortionParams.at(0);
+    const double& k1 = params[0];
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     if (k1 * r < eps)
     {
@@ -24,9 +24,9 @@ Vec2 DistortionFisheye1::addDistortion(const Vec2& p) const
     return p * coef;
 }
 
-Eigen::Matrix2d DistortionFisheye1::getDerivativeAddDistoWrtPt(const Vec2& p) const
+Eigen::Matrix2d DistortionFisheye1::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
 {
-    const double& k1 = _distortionParams.at(0);
+    const double& k1 = params[0];
     const double eps = 1e-8;
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     if (k1 * r < eps)
@@ -55,14 +55,17 @@ Eigen::Matrix2d DistortionFisheye1::getDerivativeAddDistoWrtPt(const Vec2& p) co
     return Eigen::Matrix2d::Identity() * coef + p * d_coef_d_p;
 }
 
-Eigen::MatrixXd DistortionFisheye1::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionFisheye1::getDerivativeAddDistoWrtDisto(const double* params,
+                                                       const Vec2& p,
+                                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double& k1 = _distortionParams.at(0);
+    const double& k1 = params[0];
     const double eps = 1e-21;
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     if (k1 * r < eps)
     {
-        return Eigen::Matrix<double, 2, 1>::Zero();
+        jacobian.setZero();
+        return;
     }
 
     /* const double eps = 1e-8;
@@ -92,7 +95,7 @@ Eigen::MatrixXd DistortionFisheye1::getDerivativeAddDistoWrtDisto(const Vec2& p)
 
     double d_coef_d_params = d_coef_d_part3 * d_part3_d_params + d_coef_d_part2 * d_part2_d_part1 * d_part1_d_params;
 
-    return p * d_coef_d_params;
+    jacobian = p * d_coef_d_params;
 }
 
 Vec2 DistortionFisheye1::removeDistortion(const Vec2& p) const
@@ -121,7 +124,7 @@ Eigen::Matrix2d DistortionFisheye1::getDerivativeRemoveDistoWrtPt(const Vec2& p)
 
     const Vec2 undist = removeDistortion(p);
 
-    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(undist);
+    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(_distortionParams.data(), undist);
 
     return Jinv.inverse();
 }
@@ -23,15 +23,21 @@ class DistortionFisheye1 : public Distortion
 
     DistortionFisheye1* clone() const override { return new DistortionFisheye1(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override;
 
@@ -15,17 +15,25 @@ double DistortionRadialK1::distoFunctor(const std::vector<double>& params, doubl
     return r2 * Square(1. + r2 * k1);
 }
 
-Vec2 DistortionRadialK1::addDistortion(const Vec2& p) const
+Vec2 DistortionRadialK1::addDistortion(const double* params, const Vec2& p) const
 {
-    const double k1 = _distortionParams.at(0);
+    const double k1 = params[0];
     const double r2 = p(0) * p(0) + p(1) * p(1);
     const double r_coeff = (1. + k1 * r2);
     return (p * r_coeff);
 }
 
-Eigen::Matrix2d DistortionRadialK1::getDerivativeAddDistoWrtPt(const Vec2& p) const
+void DistortionRadialK1::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
 {
     const double k1 = _distortionParams[0];
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> r_coeff = 1. + k1 * r2;
+    out_pts = (pts.array().rowwise() * r_coeff).matrix();
+}
+
+Eigen::Matrix2d DistortionRadialK1::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
+{
+    const double k1 = params[0];
     const double r2 = p(0) * p(0) + p(1) * p(1);
     const double r_coeff = 1.0 + k1 * r2;
     Eigen::Matrix<double, 1, 2> d_r_coeff_d_p;
@@ -34,12 +42,13 @@ Eigen::Matrix2d DistortionRadialK1::getDerivativeAddDistoWrtPt(const Vec2& p) co
     return Eigen::Matrix2d::Identity() * r_coeff + p * d_r_coeff_d_p;
 }
 
-Eigen::MatrixXd DistortionRadialK1::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionRadialK1::getDerivativeAddDistoWrtDisto(const double* params,
+                                                       const Vec2& p,
+                                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double k1 = _distortionParams[0];
+    const double k1 = params[0];
     const double r2 = p(0) * p(0) + p(1) * p(1);
-    const Eigen::MatrixXd ret = p * r2;
-    return ret;
+    jacobian = p * r2;
 }
 
 Vec2 DistortionRadialK1::removeDistortion(const Vec2& p) const
@@ -63,7 +72,7 @@ Eigen::Matrix2d DistortionRadialK1::getDerivativeRemoveDistoWrtPt(const Vec2& p)
 
     const Vec2 undist = removeDistortion(p);
 
-    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(undist);
+    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(_distortionParams.data(), undist);
 
     return Jinv.inverse();
 }
@@ -107,11 +116,11 @@ double DistortionRadialK3::distoFunctor(const std::vector<double>& params, doubl
     return r2 * Square(1. + r2 * (k1 + r2 * (k2 + r2 * k3)));
 }
 
-Vec2 DistortionRadialK3::addDistortion(const Vec2& p) const
+Vec2 DistortionRadialK3::addDistortion(const double* params, const Vec2& p) const
 {
-    const double& k1 = _distortionParams[0];
-    const double& k2 = _distortionParams[1];
-    const double& k3 = _distortionParams[2];
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
 
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
 
@@ -123,12 +132,23 @@ Vec2 DistortionRadialK3::addDistortion(const Vec2& p) const
     return (p * r_coeff);
 }
 
-Eigen::Matrix2d DistortionRadialK3::getDerivativeAddDistoWrtPt(const Vec2& p) const
+void DistortionRadialK3::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
 {
     const double& k1 = _distortionParams[0];
     const double& k2 = _distortionParams[1];
     const double& k3 = _distortionParams[2];
 
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> r_coeff = 1. + r2 * (k1 + r2 * (k2 + r2 * k3));
+    out_pts = (pts.array().rowwise() * r_coeff).matrix();
+}
+
+Eigen::Matrix2d DistortionRadialK3::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
+{
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
+
     const double r2 = p(0) * p(0) + p(1) * p(1);
     const double eps = 1e-21;
     if (r2 < eps)
@@ -151,27 +171,27 @@ Eigen::Matrix2d DistortionRadialK3::getDerivativeAddDistoWrtPt(const Vec2& p) co
     return ret;
 }
 
-Eigen::MatrixXd DistortionRadialK3::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionRadialK3::getDerivativeAddDistoWrtDisto(const double* params,
+                                                       const Vec2& p,
+                                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
     const double r2 = p(0) * p(0) + p(1) * p(1);
     const double eps = 1e-21;
     if (r2 < eps)
     {
-        return Eigen::Matrix<double, 2, 3>::Zero();
+        jacobian.setZero();
+        return;
     }
 
     const double r4 = r2 * r2;
     const double r6 = r4 * r2;
 
-    Eigen::Matrix<double, 2, 3> ret;
-    ret(0, 0) = p(0) * r2;
-    ret(0, 1) = p(0) * r4;
-    ret(0, 2) = p(0) * r6;
-    ret(1, 0) = p(1) * r2;
-    ret(1, 1) = p(1) * r4;
-    ret(1, 2) = p(1) * r6;
-
-    return ret;
+    jacobian(0, 0) = p(0) * r2;
+    jacobian(0, 1) = p(0) * r4;
+    jacobian(0, 2) = p(0) * r6;
+    jacobian(1, 0) = p(1) * r2;
+    jacobian(1, 1) = p(1) * r4;
+    jacobian(1, 2) = p(1) * r6;
 }
 
 Vec2 DistortionRadialK3::removeDistortion(const Vec2& p) const
@@ -197,7 +217,7 @@ Eigen::Matrix2d DistortionRadialK3::getDerivativeRemoveDistoWrtPt(const Vec2& p)
 
     const Vec2 undist = removeDistortion(p);
 
-    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(undist);
+    const Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(_distortionParams.data(), undist);
 
     return Jinv.inverse();
 }
@@ -259,11 +279,11 @@ double DistortionRadialK3PT::distoFunctor(const std::vector<double>& params, dou
     return r2 * Square(r_coeff);
 }
 
-Vec2 DistortionRadialK3PT::addDistortion(const Vec2& p) const
+Vec2 DistortionRadialK3PT::addDistortion(const double* params, const Vec2& p) const
 {
-    const double& k1 = _distortionParams[0];
-    const double& k2 = _distortionParams[1];
-    const double& k3 = _distortionParams[2];
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
 
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
 
@@ -276,12 +296,23 @@ Vec2 DistortionRadialK3PT::addDistortion(const Vec2& p) const
     return (p * r_coeff);
 }
 
-Eigen::Matrix2d DistortionRadialK3PT::getDerivativeAddDistoWrtPt(const Vec2& p) const
+void DistortionRadialK3PT::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
 {
     const double& k1 = _distortionParams[0];
     const double& k2 = _distortionParams[1];
     const double& k3 = _distortionParams[2];
 
+    const Eigen::Array<double, 1, Eigen::Dynamic> r2 = pts.colwise().squaredNorm().array();
+    const Eigen::Array<double, 1, Eigen::Dynamic> r_coeff = (1.0 + r2 * (k1 + r2 * (k2 + r2 * k3))) / (1.0 + k1 + k2 + k3);
+    out_pts = (pts.array().rowwise() * r_coeff).matrix();
+}
+
+Eigen::Matrix2d DistortionRadialK3PT::getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const
+{
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
+
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     if (r < 1e-12)
     {
@@ -306,17 +337,20 @@ Eigen::Matrix2d DistortionRadialK3PT::getDerivativeAddDistoWrtPt(const Vec2& p)
     return Eigen::Matrix2d::Identity() * r_coeff + p * d_r_coeff_d_p;
 }
 
-Eigen::MatrixXd DistortionRadialK3PT::getDerivativeAddDistoWrtDisto(const Vec2& p) const
+void DistortionRadialK3PT::getDerivativeAddDistoWrtDisto(const double* params,
+                                                         const Vec2& p,
+                                                         Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const
 {
-    const double& k1 = _distortionParams[0];
-    const double& k2 = _distortionParams[1];
-    const double& k3 = _distortionParams[2];
+    const double& k1 = params[0];
+    const double& k2 = params[1];
+    const double& k3 = params[2];
 
     const double r = sqrt(p(0) * p(0) + p(1) * p(1));
     const double eps = 1e-8;
     if (r < eps)
     {
-        return Eigen::Matrix<double, 2, 3>::Zero();
+        jacobian.setZero();
+        return;
     }
 
     const double r2 = r * r;
@@ -338,10 +372,9 @@ Eigen::MatrixXd DistortionRadialK3PT::getDerivativeAddDistoWrtDisto(const Vec2&
     d_denum_d_params(0, 1) = 1;
     d_denum_d_params(0, 2) = 1;
 
-    Eigen::Matrix<double, 1, 3> d_rcoeff_d_params = (denum * d_num_d_params - num * d_denum_d_params) / denum2;
-    Eigen::MatrixXd ret = p * d_rcoeff_d_params;
+    const Eigen::Matrix<double, 1, 3> d_rcoeff_d_params = (denum * d_num_d_params - num * d_denum_d_params) / denum2;
 
-    return ret;
+    jacobian.noalias() = p * d_rcoeff_d_params;
 }
 
 Eigen::Matrix2d DistortionRadialK3PT::getDerivativeRemoveDistoWrtPt(const Vec2& p) const
@@ -355,7 +388,7 @@ Eigen::Matrix2d DistortionRadialK3PT::getDerivativeRemoveDistoWrtPt(const Vec2&
 
     Vec2 undist = removeDistortion(p);
 
-    Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(undist);
+    Eigen::Matrix2d Jinv = getDerivativeAddDistoWrtPt(_distortionParams.data(), undist);
 
     return Jinv.inverse();
 }
@@ -70,12 +70,21 @@ class DistortionRadialK1 : public Distortion
 
     DistortionRadialK1* clone() const override { return new DistortionRadialK1(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
+
+    /// Add distortion to a set of points (vectorized)
+    void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
@@ -117,12 +126,21 @@ class DistortionRadialK3 : public Distortion
 
     DistortionRadialK3* clone() const override { return new DistortionRadialK3(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    /// Add distortion to a set of points (vectorized)
+    void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
+
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     /// Remove distortion (return p' such that disto(p') = p)
     Vec2 removeDistortion(const Vec2& p) const override;
@@ -150,12 +168,21 @@ class DistortionRadialK3PT : public Distortion
 
     DistortionRadialK3PT* clone() const override { return new DistortionRadialK3PT(*this); }
 
+    using Distortion::addDistortion;
+    using Distortion::getDerivativeAddDistoWrtPt;
+    using Distortion::getDerivativeAddDistoWrtDisto;
+
     /// Add distortion to the point p (assume p is in the camera frame [normalized coordinates])
-    Vec2 addDistortion(const Vec2& p) const override;
+    Vec2 addDistortion(const double* params, const Vec2& p) const override;
+
+    /// Add distortion to a set of points (vectorized)
+    void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const override;
 
-    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2& p) const override;
+    Eigen::Matrix2d getDerivativeAddDistoWrtPt(const double* params, const Vec2& p) const override;
 
-    Eigen::MatrixXd getDerivativeAddDistoWrtDisto(const Vec2& p) const override;
+    void getDerivativeAddDistoWrtDisto(const double* params,
+                                       const Vec2& p,
+                                       Eigen::Ref<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> jacobian) const override;
 
     Eigen::Matrix2d getDerivativeRemoveDistoWrtPt(const Vec2& p) const override;
 
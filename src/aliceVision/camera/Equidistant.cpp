@@ -38,6 +38,38 @@ Vec2 Equidistant::project(const Eigen::Matrix4d& pose, const Vec4& pt, bool appl
     return pt_ima;
 }
 
+void Equidistant::projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion) const
+{
+    const double rsensor = std::min(sensorWidth(), sensorHeight());
+    const double rscale = sensorWidth() / std::max(w(), h());
+    const double fmm = _scale(0) * rscale;
+    const double fov = rsensor / fmm;
+
+    const Mat3X X = pose.topRows<3>() * pts3D;
+
+    Mat2X P(2, X.cols());
+    for (Eigen::Index i = 0; i < X.cols(); ++i)
+    {
+        // Compute angle with optical center
+        const double angle_Z = std::atan2(sqrt(X(0, i) * X(0, i) + X(1, i) * X(1, i)), X(2, i));
+
+        // Ignore depth component and compute radial angle
+        const double angle_radial = std::atan2(X(1, i), X(0, i));
+
+        const double radius = angle_Z / (0.5 * fov);
+
+        // radius = focal * angle_Z
+        P(0, i) = cos(angle_radial) * radius;
+        P(1, i) = sin(angle_radial) * radius;
+    }
+
+    if (applyDistortion)
+    {
+        this->addDistortionPoints(P, P);
+    }
+    this->cam2imaPoints(P, out_pts2D);
+}
+
 Eigen::Matrix<double, 2, 9> Equidistant::getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt) const
 {
     Eigen::Matrix4d T = pose;
@@ -365,6 +397,98 @@ Eigen::Matrix<double, 2, Eigen::Dynamic> Equidistant::getDerivativeProjectWrtPar
     return ret;
 }
 
+void Equidistant::projectWithParams(const double* params,
+                                    const Eigen::Matrix4d& pose,
+                                    const Vec4& pt3D,
+                                    Vec2& pt2D,
+                                    Eigen::Matrix<double, 2, 3>* dPtCamera,
+                                    double* dParams) const
+{
+    const double scale = params[0];
+    const Vec2 pp(params[2] + static_cast<double>(_w) * 0.5, params[3] + static_cast<double>(_h) * 0.5);
+    const double* distortionParams = params + 4;
+
+    const double rsensor = std::min(sensorWidth(), sensorHeight());
+    const double rscale = sensorWidth() / std::max(w(), h());
+    const double fmm = scale * rscale;
+    const double fov = rsensor / fmm;
+
+    const Vec4 X = pose * pt3D;  // apply pose
+
+    /* Compute angle with optical center */
+    const double len2d = sqrt(X(0) * X(0) + X(1) * X(1));
+    const double angle_Z = std::atan2(len2d, X(2));
+
+    /* Ignore depth component and compute radial angle */
+    const double angle_radial = std::atan2(X(1), X(0));
+
+    const double radius = angle_Z / (0.5 * fov);
+
+    /* radius = focal * angle_Z */
+    const Vec2 P{cos(angle_radial) * radius, sin(angle_radial) * radius};
+
+    const Vec2 distorted = (_pDistortion) ? _pDistortion->addDistortion(distortionParams, P) : P;
+
+    pt2D = _circleRadius * distorted + pp;
+
+    if (dPtCamera == nullptr && dParams == nullptr)
+    {
+        return;
+    }
+
+    const Eigen::Matrix2d d_ima_d_P =
+      (_pDistortion) ? Eigen::Matrix2d(_circleRadius * _pDistortion->getDerivativeAddDistoWrtPt(distortionParams, P))
+                     : Eigen::Matrix2d(_circleRadius * Eigen::Matrix2d::Identity());
+
+    if (dPtCamera != nullptr)
+    {
+        const double sqlen2d = X(0) * X(0) + X(1) * X(1);
+        const double sqlen3d = sqlen2d + X(2) * X(2);
+        const double d_angle_Z_d_len2d = X(2) / sqlen3d;
+
+        Eigen::Matrix<double, 2, 3> d_angles_d_X;
+        d_angles_d_X(0, 0) = -X(1) / sqlen2d;
+        d_angles_d_X(0, 1) = X(0) / sqlen2d;
+        d_angles_d_X(0, 2) = 0.0;
+        d_angles_d_X(1, 0) = d_angle_Z_d_len2d * X(0) / len2d;
+        d_angles_d_X(1, 1) = d_angle_Z_d_len2d * X(1) / len2d;
+        d_angles_d_X(1, 2) = -len2d / sqlen3d;
+
+        const double d_radius_d_angle_Z = 1.0 / (0.5 * fov);
+
+        Eigen::Matrix<double, 2, 2> d_P_d_angles;
+        d_P_d_angles(0, 0) = -sin(angle_radial) * radius;
+        d_P_d_angles(0, 1) = cos(angle_radial) * d_radius_d_angle_Z;
+        d_P_d_angles(1, 0) = cos(angle_radial) * radius;
+        d_P_d_angles(1, 1) = sin(angle_radial) * d_radius_d_angle_Z;
+
+        *dPtCamera = d_ima_d_P * d_P_d_angles * d_angles_d_X;
+    }
+
+    if (dParams != nullptr)
+    {
+        const std::size_t distortionSize = (_pDistortion) ? _pDistortion->getDistortionParametersCount() : 0;
+        Eigen::Map<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> J(dParams, 2, 4 + distortionSize);
+
+        J.setZero();
+
+        // Only the first scale parameter drives the field of view
+        const Vec2 d_P_d_radius(cos(angle_radial), sin(angle_radial));
+        const double d_radius_d_fov = -2.0 * angle_Z / (fov * fov);
+        const double d_fov_d_scale = -rsensor / (scale * scale * rscale);
+        J.col(0) = d_ima_d_P * d_P_d_radius * (d_radius_d_fov * d_fov_d_scale);
+
+        J(0, 2) = 1.0;
+        J(1, 3) = 1.0;
+
+        if (distortionSize > 0)
+        {
+            _pDistortion->getDerivativeAddDistoWrtDisto(distortionParams, P, J.rightCols(distortionSize));
+            J.rightCols(distortionSize) *= _circleRadius;
+        }
+    }
+}
+
 Vec3 Equidistant::toUnitSphere(const Vec2& pt) const
 {
     const double rsensor = std::min(sensorWidth(), sensorHeight());
@@ -441,10 +565,14 @@ double Equidistant::imagePlaneToCameraPlaneError(double value) const { return va
 
 Vec2 Equidistant::cam2ima(const Vec2& p) const { return _circleRadius * p + getPrincipalPoint(); }
 
+void Equidistant::cam2imaPoints(const Mat2X& pts, Mat2X& out_pts) const { out_pts = (_circleRadius * pts).colwise() + getPrincipalPoint(); }
+
 Eigen::Matrix2d Equidistant::getDerivativeCam2ImaWrtPoint() const { return Eigen::Matrix2d::Identity() * _circleRadius; }
 
 Vec2 Equidistant::ima2cam(const Vec2& p) const { return (p - getPrincipalPoint()) / _circleRadius; }
 
+void Equidistant::ima2camPoints(const Mat2X& pts, Mat2X& out_pts) const { out_pts = (pts.colwise() - getPrincipalPoint()) / _circleRadius; }
+
 Eigen::Matrix2d Equidistant::getDerivativeIma2CamWrtPoint() const { return Eigen::Matrix2d::Identity() * (1.0 / _circleRadius); }
 
 Eigen::Matrix2d Equidistant::getDerivativeIma2CamWrtPrincipalPoint() const { return Eigen::Matrix2d::Identity() * (-1.0 / _circleRadius); }
@@ -67,6 +67,8 @@ class Equidistant : public IntrinsicScaleOffsetDisto
 
     Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDistortion = true) const override;
 
+    void projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion = true) const override;
+
     Vec2 project(const geometry::Pose3& pose, const Vec4& pt3D, bool applyDistortion = true) const
     {
         return project(pose.getHomogeneous(), pt3D, applyDistortion);
@@ -90,6 +92,13 @@ class Equidistant : public IntrinsicScaleOffsetDisto
 
     Eigen::Matrix<double, 2, Eigen::Dynamic> getDerivativeProjectWrtParams(const Eigen::Matrix4d& pose, const Vec4& pt3D) const override;
 
+    void projectWithParams(const double* params,
+                           const Eigen::Matrix4d& pose,
+                           const Vec4& pt3D,
+                           Vec2& pt2D,
+                           Eigen::Matrix<double, 2, 3>* dPtCamera = nullptr,
+                           double* dParams = nullptr) const override;
+
     Vec3 toUnitSphere(const Vec2& pt) const override;
 
     Eigen::Matrix<double, 3, 2> getDerivativetoUnitSphereWrtPoint(const Vec2& pt) const;
@@ -101,11 +110,15 @@ class Equidistant : public IntrinsicScaleOffsetDisto
     // Transform a point from the camera plane to the image plane
     Vec2 cam2ima(const Vec2& p) const override;
 
+    void cam2imaPoints(const Mat2X& pts, Mat2X& out_pts) const override;
+
     Eigen::Matrix2d getDerivativeCam2ImaWrtPoint() const override;
 
     // Transform a point from the image plane to the camera plane
     Vec2 ima2cam(const Vec2& p) const override;
 
+    void ima2camPoints(const Mat2X& pts, Mat2X& out_pts) const override;
+
     Eigen::Matrix2d getDerivativeIma2CamWrtPoint() const override;
 
     Eigen::Matrix2d getDerivativeIma2CamWrtPrincipalPoint() const override;
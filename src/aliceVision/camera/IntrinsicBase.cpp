@@ -27,6 +27,71 @@ Vec3 IntrinsicBase::backproject(const Vec2& pt2D, bool applyUndistortion, const
     return output;
 }
 
+void IntrinsicBase::projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion) const
+{
+    out_pts2D.resize(2, pts3D.cols());
+    for (Eigen::Index i = 0; i < pts3D.cols(); ++i)
+    {
+        out_pts2D.col(i) = project(pose, pts3D.col(i), applyDistortion);
+    }
+}
+
+void IntrinsicBase::backprojectPoints(const Mat2X& pts2D, Mat3X& out_rays, bool applyUndistortion) const
+{
+    Mat2X pts2D_cam;
+    ima2camPoints(pts2D, pts2D_cam);
+    if (applyUndistortion)
+    {
+        removeDistortionPoints(pts2D_cam, pts2D_cam);
+    }
+    toUnitSpherePoints(pts2D_cam, out_rays);
+}
+
+void IntrinsicBase::cam2imaPoints(const Mat2X& pts, Mat2X& out_pts) const
+{
+    out_pts.resize(2, pts.cols());
+    for (Eigen::Index i = 0; i < pts.cols(); ++i)
+    {
+        out_pts.col(i) = cam2ima(pts.col(i));
+    }
+}
+
+void IntrinsicBase::ima2camPoints(const Mat2X& pts, Mat2X& out_pts) const
+{
+    out_pts.resize(2, pts.cols());
+    for (Eigen::Index i = 0; i < pts.cols(); ++i)
+    {
+        out_pts.col(i) = ima2cam(pts.col(i));
+    }
+}
+
+void IntrinsicBase::addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
+{
+    out_pts.resize(2, pts.cols());
+    for (Eigen::Index i = 0; i < pts.cols(); ++i)
+    {
+        out_pts.col(i) = addDistortion(pts.col(i));
+    }
+}
+
+void IntrinsicBase::removeDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const
+{
+    out_pts.resize(2, pts.cols());
+    for (Eigen::Index i = 0; i < pts.cols(); ++i)
+    {
+        out_pts.col(i) = removeDistortion(pts.col(i));
+    }
+}
+
+void IntrinsicBase::toUnitSpherePoints(const Mat2X& pts, Mat3X& out_pts) const
+{
+    out_pts.resize(3, pts.cols());
+    for (Eigen::Index i = 0; i < pts.cols(); ++i)
+    {
+        out_pts.col(i) = toUnitSphere(pts.col(i));
+    }
+}
+
 Vec4 IntrinsicBase::getCartesianfromSphericalCoordinates(const Vec3& pt)
 {
     Vec4 rpt;
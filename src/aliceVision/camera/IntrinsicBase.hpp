@@ -107,6 +107,17 @@ class IntrinsicBase
      */
     virtual Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt3D, bool applyDistortion = true) const = 0;
 
+    /**
+     * @brief Projection of a set of 3D points into the camera plane (Apply pose, disto (if any) and Intrinsics)
+     * @note The default implementation projects the points one by one,
+     *       the camera models override it to process the whole set with matrix operations.
+     * @param[in] pose The pose
+     * @param[in] pts3D The 3d points, one per column
+     * @param[out] out_pts2D The 2d projections in the camera plane, one per column
+     * @param[in] applyDistortion If true apply distortion if any
+     */
+    virtual void projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion = true) const;
+
     /**
      * @brief Back-projection of a 2D point at a specific depth into a 3D point
      * @param[in] pt2D The 2d point
@@ -117,6 +128,14 @@ class IntrinsicBase
      */
     Vec3 backproject(const Vec2& pt2D, bool applyUndistortion = true, const geometry::Pose3& pose = geometry::Pose3(), double depth = 1.0) const;
 
+    /**
+     * @brief Back-projection of a set of 2D points (e.g. a pixel grid) on the unit sphere of the camera frame
+     * @param[in] pts2D The 2d points, one per column
+     * @param[out] out_rays The unit rays in the camera frame, one per column
+     * @param[in] applyUndistortion If true remove the distortion if any
+     */
+    void backprojectPoints(const Mat2X& pts2D, Mat3X& out_rays, bool applyUndistortion = true) const;
+
     Vec4 getCartesianfromSphericalCoordinates(const Vec3& pt);
 
     Eigen::Matrix<double, 4, 3> getDerivativeCartesianfromSphericalCoordinates(const Vec3& pt);
@@ -166,6 +185,25 @@ class IntrinsicBase
      */
     virtual Eigen::Matrix<double, 2, Eigen::Dynamic> getDerivativeProjectWrtParams(const Eigen::Matrix4d& pos, const Vec4& pt3D) const = 0;
 
+    /**
+     * @brief Stateless projection of a 3D point into the camera plane (and its jacobians),
+     *        using the given raw intrinsic parameters instead of the stored ones.
+     * @note It neither modifies the intrinsic nor allocates memory, so it is safe to call concurrently
+     *       (e.g. from the residual evaluation of a parallel solver).
+     * @param[in] params The raw intrinsic parameters, with the same layout as getParams()
+     * @param[in] pose The pose
+     * @param[in] pt3D The 3d point
+     * @param[out] pt2D The 2d projection in the camera plane
+     * @param[out] dPtCamera If not null, jacobian of the projection wrt the 3d point expressed in the camera frame (pose * pt3D)
+     * @param[out] dParams If not null, row-major 2 x getParamsSize() jacobian of the projection wrt params
+     */
+    virtual void projectWithParams(const double* params,
+                                   const Eigen::Matrix4d& pose,
+                                   const Vec4& pt3D,
+                                   Vec2& pt2D,
+                                   Eigen::Matrix<double, 2, 3>* dPtCamera = nullptr,
+                                   double* dParams = nullptr) const = 0;
+
     /**
      * @brief Compute the residual between the 3D projected point X and an image observation x
      * @param[in] pose The pose
@@ -310,6 +348,20 @@ class IntrinsicBase
      */
     virtual Vec2 ima2cam(const Vec2& p) const = 0;
 
+    /**
+     * @brief Transform a set of points from the camera plane to the image plane
+     * @param[in] pts Points from the camera plane, one per column
+     * @param[out] out_pts Image plane points, may be the same matrix as pts
+     */
+    virtual void cam2imaPoints(const Mat2X& pts, Mat2X& out_pts) const;
+
+    /**
+     * @brief Transform a set of points from the image plane to the camera plane
+     * @param[in] pts Points from the image plane, one per column
+     * @param[out] out_pts Camera plane points, may be the same matrix as pts
+     */
+    virtual void ima2camPoints(const Mat2X& pts, Mat2X& out_pts) const;
+
     /**
      * @brief Camera model handle a distortion field
      * @return True if the camera model handle a distortion field
@@ -330,6 +382,20 @@ class IntrinsicBase
      */
     virtual Vec2 removeDistortion(const Vec2& p) const = 0;
 
+    /**
+     * @brief Add the distortion field to a set of points (that are in normalized camera frame)
+     * @param[in] pts The points, one per column
+     * @param[out] out_pts The points with added distortion field, may be the same matrix as pts
+     */
+    virtual void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const;
+
+    /**
+     * @brief Remove the distortion to a set of camera points (that are in normalized camera frame)
+     * @param[in] pts The points, one per column
+     * @param[out] out_pts The points with removed distortion field, may be the same matrix as pts
+     */
+    virtual void removeDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const;
+
     /**
      * @brief Return the undistorted pixel (with removed distortion)
      * @param[in] p The point
@@ -419,6 +485,13 @@ class IntrinsicBase
      */
     virtual Vec3 toUnitSphere(const Vec2& pt) const = 0;
 
+    /**
+     * @brief transform a set of points to unit sphere in meters
+     * @param[in] pts the input points, one per column
+     * @param[out] out_pts the points on the unit sphere
+     */
+    virtual void toUnitSpherePoints(const Mat2X& pts, Mat3X& out_pts) const;
+
     /**
      * @Brief get horizontal fov in radians
      * @return  horizontal fov in radians
@@ -103,6 +103,40 @@ class IntrinsicScaleOffsetDisto : public IntrinsicScaleOffset
         return p;
     }
 
+    /**
+     * @brief Add distortion to a set of points in the camera plane.
+     * @param[in] pts Points in the camera plane, one per column.
+     * @param[out] out_pts Distorted points in the camera plane.
+     */
+    void addDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const override
+    {
+        if (_pDistortion)
+        {
+            _pDistortion->addDistortionPoints(pts, out_pts);
+        }
+        else
+        {
+            IntrinsicScaleOffset::addDistortionPoints(pts, out_pts);
+        }
+    }
+
+    /**
+     * @brief Remove distortion from a set of points in the camera plane.
+     * @param[in] pts Points in the camera plane, one per column.
+     * @param[out] out_pts Undistorted points in the camera plane.
+     */
+    void removeDistortionPoints(const Mat2X& pts, Mat2X& out_pts) const override
+    {
+        if (_pDistortion && !_pUndistortion)
+        {
+            _pDistortion->removeDistortionPoints(pts, out_pts);
+        }
+        else
+        {
+            IntrinsicScaleOffset::removeDistortionPoints(pts, out_pts);
+        }
+    }
+
     /// Return the un-distorted pixel (with removed distortion)
     Vec2 get_ud_pixel(const Vec2& p) const override;
 
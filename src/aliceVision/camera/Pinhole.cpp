@@ -46,6 +46,16 @@ Vec2 Pinhole::project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDis
     return impt;
 }
 
+void Pinhole::projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion) const
+{
+    const Mat3X X = pose.topRows<3>() * pts3D;  // apply pose
+    const Mat2X P = (X.topRows<2>().array().rowwise() / X.row(2).array()).matrix();
+
+    // as in project, the distortion is always applied
+    this->addDistortionPoints(P, out_pts2D);
+    this->cam2imaPoints(out_pts2D, out_pts2D);
+}
+
 Eigen::Matrix<double, 2, 9> Pinhole::getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt)
 {
     const Vec4 X = pose * pt;  // apply pose
@@ -248,8 +258,78 @@ Eigen::Matrix<double, 2, Eigen::Dynamic> Pinhole::getDerivativeProjectWrtParams(
     return ret;
 }
 
+void Pinhole::projectWithParams(const double* params,
+                                const Eigen::Matrix4d& pose,
+                                const Vec4& pt3D,
+                                Vec2& pt2D,
+                                Eigen::Matrix<double, 2, 3>* dPtCamera,
+                                double* dParams) const
+{
+    const Vec2 scale(params[0], params[1]);
+    const Vec2 pp(params[2] + static_cast<double>(_w) * 0.5, params[3] + static_cast<double>(_h) * 0.5);
+    const double* distortionParams = params + 4;
+
+    const Vec4 X = pose * pt3D;  // apply pose
+    const Vec2 P = X.head<2>() / X(2);
+
+    Vec2 distorted = P;
+    if (_pDistortion)
+    {
+        distorted = _pDistortion->addDistortion(distortionParams, P);
+    }
+    else if (_pUndistortion)
+    {
+        distorted = (_pUndistortion->inverse(P.cwiseProduct(scale) + pp) - pp).cwiseQuotient(scale);
+    }
+
+    pt2D = distorted.cwiseProduct(scale) + pp;
+
+    if (dPtCamera != nullptr)
+    {
+        const double invz = 1.0 / X(2);
+
+        Eigen::Matrix<double, 2, 3> d_P_d_X;
+        d_P_d_X(0, 0) = invz;
+        d_P_d_X(0, 1) = 0.0;
+        d_P_d_X(0, 2) = -P(0) * invz;
+        d_P_d_X(1, 0) = 0.0;
+        d_P_d_X(1, 1) = invz;
+        d_P_d_X(1, 2) = -P(1) * invz;
+
+        if (_pDistortion)
+        {
+            *dPtCamera = scale.asDiagonal() * _pDistortion->getDerivativeAddDistoWrtPt(distortionParams, P) * d_P_d_X;
+        }
+        else
+        {
+            *dPtCamera = scale.asDiagonal() * d_P_d_X;
+        }
+    }
+
+    if (dParams != nullptr)
+    {
+        const std::size_t distortionSize = (_pDistortion) ? _pDistortion->getDistortionParametersCount() : 0;
+        Eigen::Map<Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor>> J(dParams, 2, 4 + distortionSize);
+
+        J.setZero();
+        J(0, 0) = distorted(0);
+        J(1, 1) = distorted(1);
+        J(0, 2) = 1.0;
+        J(1, 3) = 1.0;
+
+        if (distortionSize > 0)
+        {
+            _pDistortion->getDerivativeAddDistoWrtDisto(distortionParams, P, J.rightCols(distortionSize));
+            J.row(0).tail(distortionSize) *= scale(0);
+            J.row(1).tail(distortionSize) *= scale(1);
+        }
+    }
+}
+
 Vec3 Pinhole::toUnitSphere(const Vec2& pt) const { return pt.homogeneous().normalized(); }
 
+void Pinhole::toUnitSpherePoints(const Mat2X& pts, Mat3X& out_pts) const { out_pts = pts.colwise().homogeneous().colwise().normalized(); }
+
 Eigen::Matrix<double, 3, 2> Pinhole::getDerivativetoUnitSphereWrtPoint(const Vec2& pt) const
 {
     const double norm2 = pt(0) * pt(0) + pt(1) * pt(1) + 1.0;
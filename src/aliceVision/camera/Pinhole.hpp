@@ -70,6 +70,8 @@ class Pinhole : public IntrinsicScaleOffsetDisto
 
     Vec2 project(const Eigen::Matrix4d& pose, const Vec4& pt, bool applyDistortion = true) const override;
 
+    void projectPoints(const Eigen::Matrix4d& pose, const Mat4X& pts3D, Mat2X& out_pts2D, bool applyDistortion = true) const override;
+
     Eigen::Matrix<double, 2, 9> getDerivativeProjectWrtRotation(const Eigen::Matrix4d& pose, const Vec4& pt);
 
     Eigen::Matrix<double, 2, 16> getDerivativeProjectWrtPose(const Eigen::Matrix4d& pose, const Vec4& pt) const override;
@@ -88,8 +90,17 @@ class Pinhole : public IntrinsicScaleOffsetDisto
 
     Eigen::Matrix<double, 2, Eigen::Dynamic> getDerivativeProjectWrtParams(const Eigen::Matrix4d& pose, const Vec4& pt3D) const override;
 
+    void projectWithParams(const double* params,
+                           const Eigen::Matrix4d& pose,
+                           const Vec4& pt3D,
+                           Vec2& pt2D,
+                           Eigen::Matrix<double, 2, 3>* dPtCamera = nullptr,
+                           double* dParams = nullptr) const override;
+
     Vec3 toUnitSphere(const Vec2& pt) const override;
 
+    void toUnitSpherePoints(const Mat2X& pts, Mat3X& out_pts) const override;
+
     Eigen::Matrix<double, 3, 2> getDerivativetoUnitSphereWrtPoint(const Vec2& pt) const;
 
     double imagePlaneToCameraPlaneError(double value) const override;
@@ -0,0 +1,297 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "UndistortionMap.hpp"
+
+#include <aliceVision/camera/IntrinsicScaleOffsetDisto.hpp>
+#include <aliceVision/camera/Pinhole.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/utils/filesIO.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace aliceVision {
+namespace camera {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// metadata of the undistortion map files describing the map, checked on load
+const std::string undistortionMapDescriptionMetadata = "AliceVision:undistortionMapDescription";
+
+/**
+ * @brief Description of an undistortion map: the intrinsic parameters, the undistortion model,
+ *        the resolution and the principal point correction, with the full precision of the values.
+ */
+std::string getUndistortionMapDescription(const IntrinsicBase& intrinsic, int width, int height, const Vec2& ppCorrection)
+{
+    std::ostringstream description;
+    description << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    description << "intrinsic:" << intrinsic.getTypeStr() << "," << intrinsic.w() << "," << intrinsic.h();
+    for (double param : intrinsic.getParams())
+    {
+        description << "," << param;
+    }
+
+    const IntrinsicScaleOffsetDisto* intrinsicDisto = dynamic_cast<const IntrinsicScaleOffsetDisto*>(&intrinsic);
+    if (intrinsicDisto && intrinsicDisto->getDistortion())
+    {
+        description << ";distortion:" << static_cast<int>(intrinsicDisto->getDistortion()->getType());
+    }
+    if (intrinsicDisto && intrinsicDisto->getUndistortion())
+    {
+        const Undistortion& undistortion = *intrinsicDisto->getUndistortion();
+        description << ";undistortion:" << static_cast<int>(undistortion.getType());
+        for (double param : undistortion.getParameters())
+        {
+            description << "," << param;
+        }
+        description << "," << undistortion.getOffset()(0) << "," << undistortion.getOffset()(1);
+        description << "," << undistortion.getSize()(0) << "," << undistortion.getSize()(1);
+    }
+
+    description << ";map:" << width << "," << height << "," << ppCorrection(0) << "," << ppCorrection(1);
+    return description.str();
+}
+
+/**
+ * @brief 64-bit FNV-1a hash, stable across runs and platforms unlike std::hash, to name the map files.
+ */
+std::uint64_t getStableHash(const std::string& str)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : str)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}  // namespace
+
+void UndistortionMap::compute(const IntrinsicBase& intrinsic, int width, int height, const Vec2& ppCorrection)
+{
+    _mapX.resize(width, height);
+    _mapY.resize(width, height);
+
+#pragma omp parallel for
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            const Vec2 undisto_pix(x, y);
+
+            // compute coordinates with distortion
+            const Vec2 disto_pix = intrinsic.get_d_pixel(undisto_pix + ppCorrection);
+
+            _mapX(y, x) = static_cast<float>(disto_pix(0));
+            _mapY(y, x) = static_cast<float>(disto_pix(1));
+        }
+    }
+}
+
+void UndistortionMap::save(const std::string& path, image::EStorageDataType storageDataType, const oiio::ParamValueList& metadata) const
+{
+    image::Image<image::RGBfColor> displacements(width(), height());
+
+    for (int y = 0; y < height(); ++y)
+    {
+        for (int x = 0; x < width(); ++x)
+        {
+            displacements(y, x) = image::RGBfColor(_mapX(y, x) - x, _mapY(y, x) - y, 0.0f);
+        }
+    }
+
+    image::ImageWriteOptions writeOptions;
+    writeOptions.toColorSpace(image::EImageColorSpace::NO_CONVERSION);
+    writeOptions.storageDataType(storageDataType);
+
+    image::writeImage(path, displacements, writeOptions, metadata);
+}
+
+void UndistortionMap::load(const std::string& path)
+{
+    image::Image<image::RGBfColor> displacements;
+    image::readImage(path, displacements, image::EImageColorSpace::NO_CONVERSION);
+
+    _mapX.resize(displacements.width(), displacements.height());
+    _mapY.resize(displacements.width(), displacements.height());
+
+    for (int y = 0; y < height(); ++y)
+    {
+        for (int x = 0; x < width(); ++x)
+        {
+            _mapX(y, x) = displacements(y, x).r() + x;
+            _mapY(y, x) = displacements(y, x).g() + y;
+        }
+    }
+}
+
+UndistortionMapCache::UndistortionMapCache(const std::string& cacheFolder, std::size_t maxMemorySize, image::EStorageDataType storageDataType)
+  : _cacheFolder(cacheFolder),
+    _maxMemorySize(maxMemorySize),
+    _storageDataType(storageDataType)
+{}
+
+UndistortionMapCache::MapSharedPtr UndistortionMapCache::get(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint)
+{
+    Vec2 ppCorrection(0.0, 0.0);
+
+    if (correctPrincipalPoint && isPinhole(intrinsic.getType()))
+    {
+        const Vec2 center(width * 0.5, height * 0.5);
+        ppCorrection = dynamic_cast<const Pinhole&>(intrinsic).getPrincipalPoint() - center;
+    }
+
+    const std::string description = getUndistortionMapDescription(intrinsic, width, height, ppCorrection);
+    const std::uint64_t hash = getStableHash(description);
+    const auto isRequestedEntry = [&](const Entry& entry) {
+        return entry.hash == hash && entry.width == width && entry.height == height && entry.ppCorrection == ppCorrection &&
+               entry.description == description && *entry.intrinsic == intrinsic;
+    };
+
+    std::promise<MapSharedPtr> promise;
+    std::shared_future<MapSharedPtr> map;
+    bool compute = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = std::find_if(_entries.begin(), _entries.end(), isRequestedEntry);
+
+        if (it != _entries.end())
+        {
+            // most recently used
+            _entries.splice(_entries.begin(), _entries, it);
+            map = it->map;
+        }
+        else
+        {
+            compute = true;
+            map = promise.get_future().share();
+            _entries.push_front({hash, description, std::shared_ptr<const IntrinsicBase>(intrinsic.clone()), width, height, ppCorrection, map});
+            _memorySize += UndistortionMap::getMemorySize(width, height);
+
+            // release the least recently used maps, their current users keep them alive
+            while (_memorySize > _maxMemorySize && _entries.size() > 1)
+            {
+                _memorySize -= UndistortionMap::getMemorySize(_entries.back().width, _entries.back().height);
+                _entries.pop_back();
+            }
+        }
+    }
+
+    // the map is computed outside of the lock, the other threads requesting it wait for the shared future
+    if (compute)
+    {
+        try
+        {
+            std::string mapPath;
+            if (!_cacheFolder.empty())
+            {
+                std::ostringstream filename;
+                filename << "undistortionMap_" << std::hex << std::setfill('0') << std::setw(16) << hash << std::dec << "_" << width << "x"
+                         << height << ".exr";
+                mapPath = (fs::path(_cacheFolder) / filename.str()).string();
+            }
+
+            auto newMap = std::make_shared<UndistortionMap>();
+
+            if (!mapPath.empty() && fs::exists(mapPath))
+            {
+                // a file of another map with the same hash or an unreadable file is replaced
+                try
+                {
+                    if (image::readImageMetadata(mapPath).get_string(undistortionMapDescriptionMetadata) == description)
+                    {
+                        ALICEVISION_LOG_DEBUG("Load undistortion map: " << mapPath);
+                        newMap->load(mapPath);
+                    }
+                    else
+                    {
+                        ALICEVISION_LOG_WARNING("The undistortion map '" << mapPath << "' does not match the intrinsic, it is computed again.");
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    ALICEVISION_LOG_WARNING("Cannot read the undistortion map '" << mapPath << "', it is computed again: " << e.what());
+                    newMap = std::make_shared<UndistortionMap>();
+                }
+            }
+
+            if (newMap->width() != width || newMap->height() != height)
+            {
+                newMap->compute(intrinsic, width, height, ppCorrection);
+
+                if (!mapPath.empty())
+                {
+                    ALICEVISION_LOG_DEBUG("Write undistortion map: " << mapPath);
+
+                    // write in a temporary file then rename it, so concurrent runs never read a partial map
+                    const fs::path path(mapPath);
+                    const std::string tmpPath = (path.parent_path() / path.stem()).string() + "." + utils::generateUniqueFilename() + ".exr";
+
+                    oiio::ParamValueList metadata;
+                    metadata.push_back(oiio::ParamValue(undistortionMapDescriptionMetadata, description));
+
+                    // the map is still usable if it cannot be stored
+                    try
+                    {
+                        newMap->save(tmpPath, _storageDataType, metadata);
+                        fs::rename(tmpPath, mapPath);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        ALICEVISION_LOG_WARNING("Cannot write the undistortion map '" << mapPath << "': " << e.what());
+                        std::error_code ec;
+                        fs::remove(tmpPath, ec);
+                    }
+                }
+            }
+
+            promise.set_value(std::move(newMap));
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+
+            // do not keep the failure in the cache
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = std::find_if(_entries.begin(), _entries.end(), isRequestedEntry);
+            if (it != _entries.end())
+            {
+                _memorySize -= UndistortionMap::getMemorySize(width, height);
+                _entries.erase(it);
+            }
+        }
+    }
+
+    return map.get();
+}
+
+std::size_t UndistortionMapCache::getMemorySize()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memorySize;
+}
+
+void UndistortionMapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _memorySize = 0;
+}
+
+}  // namespace camera
+}  // namespace aliceVision
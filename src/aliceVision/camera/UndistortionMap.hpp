@@ -0,0 +1,166 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/image/io.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace aliceVision {
+namespace camera {
+
+/**
+ * @brief Lookup map (ST-map) from the undistorted pixels to the distorted pixels of an intrinsic.
+ * @details The distorted position of each undistorted pixel is computed once,
+ *          the images sharing the intrinsic are then undistorted with a bilinear lookup only.
+ */
+class UndistortionMap
+{
+  public:
+    UndistortionMap() = default;
+
+    /**
+     * @brief Compute the map of an intrinsic.
+     * @param[in] intrinsic the intrinsic with distortion
+     * @param[in] width the undistorted image width
+     * @param[in] height the undistorted image height
+     * @param[in] ppCorrection offset added to the undistorted pixels (principal point correction)
+     */
+    void compute(const IntrinsicBase& intrinsic, int width, int height, const Vec2& ppCorrection = Vec2(0.0, 0.0));
+
+    /**
+     * @brief Write the map in an EXR file.
+     * @note The displacements from the undistorted to the distorted pixels are stored
+     *       (not the absolute positions), half float keeps a sub-pixel precision only for moderate distortions.
+     * @param[in] path the map file path
+     * @param[in] storageDataType the storage data type (float or half)
+     * @param[in] metadata the metadata of the map file
+     */
+    void save(const std::string& path,
+              image::EStorageDataType storageDataType = image::EStorageDataType::Float,
+              const oiio::ParamValueList& metadata = oiio::ParamValueList()) const;
+
+    /**
+     * @brief Read a map written by save.
+     * @param[in] path the map file path
+     */
+    void load(const std::string& path);
+
+    inline int width() const { return _mapX.width(); }
+    inline int height() const { return _mapX.height(); }
+    inline bool empty() const { return _mapX.size() == 0; }
+
+    /**
+     * @brief Get the memory used by a map.
+     * @param[in] width the undistorted image width
+     * @param[in] height the undistorted image height
+     * @return size in bytes
+     */
+    static inline std::size_t getMemorySize(int width, int height) { return 2 * sizeof(float) * std::size_t(width) * std::size_t(height); }
+
+    /**
+     * @brief Get the horizontal distorted position of the undistorted pixels.
+     * @return NaN if the distortion cannot be computed
+     */
+    inline const image::Image<float>& getMapX() const { return _mapX; }
+
+    /**
+     * @brief Get the vertical distorted position of the undistorted pixels.
+     * @return NaN if the distortion cannot be computed
+     */
+    inline const image::Image<float>& getMapY() const { return _mapY; }
+
+  private:
+    image::Image<float> _mapX;
+    image::Image<float> _mapY;
+};
+
+/**
+ * @brief Thread-safe cache of undistortion maps.
+ * @details The maps are identified by the intrinsic (parameters and undistortion model), the image resolution
+ *          and the principal point correction, so the views sharing an intrinsic share a single map.
+ *          Concurrent requests of the same map wait for a single computation.
+ *          The least recently used maps are released above the memory budget.
+ *          If a cache folder is given, the maps are also stored on disk and reused across runs:
+ *          the files are named after a stable hash of the map description and store the description in their metadata,
+ *          a file which does not match the requested map is computed again.
+ */
+class UndistortionMapCache
+{
+  public:
+    using MapSharedPtr = std::shared_ptr<const UndistortionMap>;
+
+    /**
+     * @brief UndistortionMapCache constructor
+     * @param[in] cacheFolder folder to store the maps on disk, empty to keep them in memory only
+     * @param[in] maxMemorySize the memory budget of the maps kept in memory, in bytes
+     * @param[in] storageDataType the storage data type of the maps on disk
+     */
+    explicit UndistortionMapCache(const std::string& cacheFolder = "",
+                                  std::size_t maxMemorySize = std::size_t(1) << 30,
+                                  image::EStorageDataType storageDataType = image::EStorageDataType::Float);
+
+    UndistortionMapCache(const UndistortionMapCache&) = delete;
+    UndistortionMapCache& operator=(const UndistortionMapCache&) = delete;
+
+    /**
+     * @brief Get the undistortion map of an intrinsic, compute it if it is not in the cache.
+     * @param[in] intrinsic the intrinsic with distortion
+     * @param[in] width the undistorted image width
+     * @param[in] height the undistorted image height
+     * @param[in] correctPrincipalPoint move the principal point of pinhole intrinsics to the image center
+     * @return the map shared with the other users of the cache
+     */
+    MapSharedPtr get(const IntrinsicBase& intrinsic, int width, int height, bool correctPrincipalPoint = false);
+
+    /**
+     * @brief Get the memory used by the maps kept in memory.
+     * @return size in bytes
+     */
+    std::size_t getMemorySize();
+
+    /**
+     * @brief Release all the maps of the cache.
+     */
+    void clear();
+
+  private:
+    struct Entry
+    {
+        /// stable hash of the description, used in the map file name
+        std::uint64_t hash;
+        /// description of the intrinsic, the resolution and the principal point correction, stored in the map file
+        std::string description;
+        /// copy of the intrinsic, compared to the requested one on hash match
+        std::shared_ptr<const IntrinsicBase> intrinsic;
+        int width;
+        int height;
+        Vec2 ppCorrection;
+        std::shared_future<MapSharedPtr> map;
+    };
+
+    const std::string _cacheFolder;
+    const std::size_t _maxMemorySize;
+    const image::EStorageDataType _storageDataType;
+
+    std::mutex _mutex;
+    /// maps from the most recently used to the least recently used
+    std::list<Entry> _entries;
+    std::size_t _memorySize = 0;
+};
+
+}  // namespace camera
+}  // namespace aliceVision
@@ -16,6 +16,7 @@
 #include <aliceVision/camera/IntrinsicScaleOffsetDisto.hpp>
 #include <aliceVision/camera/Pinhole.hpp>
 #include <aliceVision/camera/Undistortion.hpp>
+#include <aliceVision/camera/UndistortionMap.hpp>
 #include <aliceVision/image/io.hpp>
 
 #include <memory>
@@ -138,5 +139,50 @@ void UndistortImage(const image::Image<T>& imageIn,
     }
 }
 
+/// Undistort an image with a precomputed undistortion map
+template<typename T>
+void UndistortImage(const image::Image<T>& imageIn,
+                    const UndistortionMap& undistortionMap,
+                    image::Image<T>& image_ud,
+                    T fillcolor,
+                    const oiio::ROI& roi = oiio::ROI())
+{
+    int widthRoi = undistortionMap.width();
+    int heightRoi = undistortionMap.height();
+    int xOffset = 0;
+    int yOffset = 0;
+    if (roi.defined())
+    {
+        widthRoi = roi.width();
+        heightRoi = roi.height();
+        xOffset = roi.xbegin;
+        yOffset = roi.ybegin;
+    }
+
+    image_ud.resize(widthRoi, heightRoi, true, fillcolor);
+    const image::Sampler2d<image::SamplerLinear> sampler;
+
+#pragma omp parallel for
+    for (int y = 0; y < heightRoi; ++y)
+    {
+        // the map rows are contiguous, only a lookup and a bilinear interpolation are left per pixel
+        const float* mapX = &undistortionMap.getMapX()(y + yOffset, xOffset);
+        const float* mapY = &undistortionMap.getMapY()(y + yOffset, xOffset);
+        T* outRow = &image_ud(y, 0);
+
+        for (int x = 0; x < widthRoi; ++x)
+        {
+            const double disto_x = mapX[x];
+            const double disto_y = mapY[x];
+
+            // pick pixel if it is in the image domain
+            if (imageIn.contains(disto_y, disto_x))
+            {
+                outRow[x] = sampler(imageIn, disto_y, disto_x);
+            }
+        }
+    }
+}
+
 }  // namespace camera
 }  // namespace aliceVision
@@ -0,0 +1,135 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+
+#define BOOST_TEST_MODULE projectPoints
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+const std::vector<EINTRINSIC> intrinsicTypes = {EINTRINSIC::PINHOLE_CAMERA,
+                                                EINTRINSIC::PINHOLE_CAMERA_RADIAL1,
+                                                EINTRINSIC::PINHOLE_CAMERA_RADIAL3,
+                                                EINTRINSIC::PINHOLE_CAMERA_BROWN,
+                                                EINTRINSIC::PINHOLE_CAMERA_FISHEYE,
+                                                EINTRINSIC::PINHOLE_CAMERA_FISHEYE1,
+                                                EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4,
+                                                EINTRINSIC::EQUIDISTANT_CAMERA,
+                                                EINTRINSIC::EQUIDISTANT_CAMERA_RADIAL3};
+
+std::shared_ptr<IntrinsicBase> createPerturbedIntrinsic(EINTRINSIC type)
+{
+    std::shared_ptr<IntrinsicBase> intrinsic = createIntrinsic(type, 1000, 800, 900.0, 910.0, 12.0, -7.0);
+
+    std::shared_ptr<IntrinsicScaleOffsetDisto> intrinsicDisto = std::dynamic_pointer_cast<IntrinsicScaleOffsetDisto>(intrinsic);
+    if (intrinsicDisto)
+    {
+        std::vector<double> distortionParams = intrinsicDisto->getDistortionParams();
+        for (double& param : distortionParams)
+        {
+            param += 0.01 * Vec2::Random()(0);
+        }
+        intrinsicDisto->setDistortionParams(distortionParams);
+    }
+
+    return intrinsic;
+}
+
+}  // namespace
+
+//-----------------
+// Test summary:
+//-----------------
+// - For every intrinsic type, project a set of random points with the batched API
+// - Assert the projections match the projection of the points one by one
+//-----------------
+BOOST_AUTO_TEST_CASE(cameraProjectPoints_matchesProject)
+{
+    makeRandomOperationsReproducible();
+
+    const int nbPoints = 100;
+
+    for (const EINTRINSIC type : intrinsicTypes)
+    {
+        BOOST_TEST_CONTEXT("Intrinsic type: " << EINTRINSIC_enumToString(type))
+        {
+            const std::shared_ptr<IntrinsicBase> intrinsic = createPerturbedIntrinsic(type);
+            const geometry::Pose3 pose(geometry::randomPose());
+            const Eigen::Matrix4d T = pose.getHomogeneous();
+
+            // random points in front of the camera
+            Mat4X pts3D(4, nbPoints);
+            for (int i = 0; i < nbPoints; ++i)
+            {
+                const Vec3 ptCamera = Vec3(0.3 * Vec2::Random()(0), 0.3 * Vec2::Random()(1), 2.0 + std::abs(Vec2::Random()(0)));
+                const Vec3 ptWorld = pose.inverse()(ptCamera);
+                pts3D.col(i) = ptWorld.homogeneous();
+            }
+
+            for (const bool applyDistortion : {true, false})
+            {
+                Mat2X pts2D;
+                intrinsic->projectPoints(T, pts3D, pts2D, applyDistortion);
+
+                BOOST_CHECK_EQUAL(pts2D.cols(), nbPoints);
+                for (int i = 0; i < nbPoints; ++i)
+                {
+                    const Vec2 pt2D = intrinsic->project(T, pts3D.col(i), applyDistortion);
+                    BOOST_CHECK_SMALL((pts2D.col(i) - pt2D).norm(), 1e-8);
+                }
+            }
+        }
+    }
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - For every intrinsic type, back-project a pixel grid with the batched API
+// - Assert the rays match the back-projection of the pixels one by one
+//-----------------
+BOOST_AUTO_TEST_CASE(cameraBackprojectPoints_matchesBackproject)
+{
+    makeRandomOperationsReproducible();
+
+    for (const EINTRINSIC type : intrinsicTypes)
+    {
+        BOOST_TEST_CONTEXT("Intrinsic type: " << EINTRINSIC_enumToString(type))
+        {
+            const std::shared_ptr<IntrinsicBase> intrinsic = createPerturbedIntrinsic(type);
+
+            Mat2X pixels(2, 0);
+            for (int y = 100; y < 700; y += 50)
+            {
+                for (int x = 100; x < 900; x += 50)
+                {
+                    pixels.conservativeResize(2, pixels.cols() + 1);
+                    pixels.col(pixels.cols() - 1) = Vec2(x, y);
+                }
+            }
+
+            for (const bool applyUndistortion : {true, false})
+            {
+                Mat3X rays;
+                intrinsic->backprojectPoints(pixels, rays, applyUndistortion);
+
+                BOOST_CHECK_EQUAL(rays.cols(), pixels.cols());
+                for (int i = 0; i < pixels.cols(); ++i)
+                {
+                    const Vec3 ray = intrinsic->backproject(pixels.col(i), applyUndistortion);
+                    BOOST_CHECK_SMALL((rays.col(i) - ray).norm(), 1e-8);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+
+#define BOOST_TEST_MODULE projectWithParams
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+std::shared_ptr<IntrinsicBase> createPerturbedIntrinsic(EINTRINSIC type)
+{
+    std::shared_ptr<IntrinsicBase> intrinsic = createIntrinsic(type, 1000, 800, 900.0, 910.0, 12.0, -7.0);
+
+    std::shared_ptr<IntrinsicScaleOffsetDisto> intrinsicDisto = std::dynamic_pointer_cast<IntrinsicScaleOffsetDisto>(intrinsic);
+    if (intrinsicDisto)
+    {
+        std::vector<double> distortionParams = intrinsicDisto->getDistortionParams();
+        for (double& param : distortionParams)
+        {
+            param += 0.01 * Vec2::Random()(0);
+        }
+        intrinsicDisto->setDistortionParams(distortionParams);
+    }
+
+    return intrinsic;
+}
+
+}  // namespace
+
+//-----------------
+// Test summary:
+//-----------------
+// - For every intrinsic type, project random points with the stateless API
+// - Assert projection and jacobians match the stateful API when using the stored parameters
+// - Assert that using other parameters does not modify the intrinsic and matches an updated copy
+//-----------------
+BOOST_AUTO_TEST_CASE(cameraProjectWithParams_matchesStatefulApi)
+{
+    makeRandomOperationsReproducible();
+
+    const std::vector<EINTRINSIC> types = {EINTRINSIC::PINHOLE_CAMERA,
+                                           EINTRINSIC::PINHOLE_CAMERA_RADIAL1,
+                                           EINTRINSIC::PINHOLE_CAMERA_RADIAL3,
+                                           EINTRINSIC::PINHOLE_CAMERA_BROWN,
+                                           EINTRINSIC::PINHOLE_CAMERA_FISHEYE,
+                                           EINTRINSIC::PINHOLE_CAMERA_FISHEYE1,
+                                           EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4,
+                                           EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD,
+                                           EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4,
+                                           EINTRINSIC::EQUIDISTANT_CAMERA,
+                                           EINTRINSIC::EQUIDISTANT_CAMERA_RADIAL3};
+
+    for (const EINTRINSIC type : types)
+    {
+        BOOST_TEST_CONTEXT("Intrinsic type: " << EINTRINSIC_enumToString(type))
+        {
+            const std::shared_ptr<IntrinsicBase> intrinsic = createPerturbedIntrinsic(type);
+            const std::vector<double> params = intrinsic->getParams();
+            BOOST_CHECK_EQUAL(params.size(), intrinsic->getParamsSize());
+
+            for (int i = 0; i < 10; ++i)
+            {
+                const geometry::Pose3 pose(geometry::randomPose());
+                const Eigen::Matrix4d T = pose.getHomogeneous();
+
+                // random point in front of the camera
+                const Vec3 ptCamera = Vec3(0.3 * Vec2::Random()(0), 0.3 * Vec2::Random()(1), 2.0 + std::abs(Vec2::Random()(0)));
+                const Vec3 ptWorld = pose.inverse()(ptCamera);
+                const Vec4 pt = ptWorld.homogeneous();
+
+                Vec2 proj;
+                Eigen::Matrix<double, 2, 3> dPtCamera;
+                Eigen::Matrix<double, 2, Eigen::Dynamic, Eigen::RowMajor> dParams(2, params.size());
+                intrinsic->projectWithParams(params.data(), T, pt, proj, &dPtCamera, dParams.data());
+
+                EXPECT_MATRIX_NEAR(intrinsic->project(T, pt, true), proj, 1e-8);
+
+                const Eigen::Matrix<double, 2, 3> dPoint = intrinsic->getDerivativeProjectWrtPoint3(T, pt);
+                const Eigen::Matrix<double, 2, 3> dPointStateless = dPtCamera * T.block<3, 3>(0, 0);
+                EXPECT_MATRIX_NEAR(dPoint, dPointStateless, 1e-6);
+
+                const Eigen::Matrix<double, 2, Eigen::Dynamic> dParamsStateful = intrinsic->getDerivativeProjectWrtParams(T, pt);
+                EXPECT_MATRIX_NEAR(dParamsStateful, dParams, 1e-6);
+
+                // use other parameters: the stored ones must stay untouched
+                std::vector<double> otherParams = params;
+                otherParams[0] *= 1.05;
+                otherParams[2] += 3.0;
+                for (std::size_t k = 4; k < otherParams.size(); ++k)
+                {
+                    otherParams[k] += 0.001;
+                }
+
+                intrinsic->projectWithParams(otherParams.data(), T, pt, proj);
+
+                std::shared_ptr<IntrinsicBase> updated(intrinsic->clone());
+                updated->updateFromParams(otherParams);
+
+                EXPECT_MATRIX_NEAR(updated->project(T, pt, true), proj, 1e-8);
+                BOOST_CHECK(intrinsic->getParams() == params);
+            }
+        }
+    }
+}
+
+//-----------------
+// Test summary:
+// - The stateful distortion overloads must stay callable on the concrete distortion models
+//   and match the stateless overloads evaluated with the stored parameters
+//-----------------
+BOOST_AUTO_TEST_CASE(distortionStatefulOverloads_concreteModels)
+{
+    const Vec2 pt(0.12, -0.07);
+
+    const DistortionRadialK3 radial(0.01, -0.002, 0.0003);
+    EXPECT_MATRIX_NEAR(radial.addDistortion(pt), radial.addDistortion(radial.getParameters().data(), pt), 1e-12);
+    EXPECT_MATRIX_NEAR(radial.getDerivativeAddDistoWrtPt(pt), radial.getDerivativeAddDistoWrtPt(radial.getParameters().data(), pt), 1e-12);
+    BOOST_CHECK_EQUAL(radial.getDerivativeAddDistoWrtDisto(pt).cols(), 3);
+
+    const DistortionBrown brown(0.01, -0.002, 0.0003, 0.0001, -0.0002);
+    EXPECT_MATRIX_NEAR(brown.addDistortion(pt), brown.addDistortion(brown.getParameters().data(), pt), 1e-12);
+    EXPECT_MATRIX_NEAR(brown.getDerivativeAddDistoWrtPt(pt), brown.getDerivativeAddDistoWrtPt(brown.getParameters().data(), pt), 1e-12);
+    BOOST_CHECK_EQUAL(brown.getDerivativeAddDistoWrtDisto(pt).cols(), 5);
+}
@@ -0,0 +1,278 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+
+#include <filesystem>
+
+#define BOOST_TEST_MODULE undistortionMap
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace fs = std::filesystem;
+
+//-----------------
+// Test summary:
+//-----------------
+// - Create a PinholeFisheye camera (iterative inverse distortion)
+// - Compute its undistortion map
+// - Assert that the map stores the distorted pixels of the camera
+// - Assert that undistorting an image with the map or with the camera gives the same result
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_compute_apply)
+{
+    std::shared_ptr<Distortion> distortion = std::make_shared<DistortionFisheye>(0.1, -0.05, 0.01, 0.002);
+    const Pinhole cam(200, 150, 180, 180, 2.0, -3.0, distortion);
+
+    UndistortionMap undistortionMap;
+    undistortionMap.compute(cam, cam.w(), cam.h());
+
+    BOOST_CHECK_EQUAL(undistortionMap.width(), cam.w());
+    BOOST_CHECK_EQUAL(undistortionMap.height(), cam.h());
+
+    for (int y = 0; y < cam.h(); y += 7)
+    {
+        for (int x = 0; x < cam.w(); x += 7)
+        {
+            const Vec2 disto_pix = cam.get_d_pixel(Vec2(x, y));
+            BOOST_CHECK_SMALL(undistortionMap.getMapX()(y, x) - disto_pix(0), 1e-3);
+            BOOST_CHECK_SMALL(undistortionMap.getMapY()(y, x) - disto_pix(1), 1e-3);
+        }
+    }
+
+    // smooth image, the float map and the direct computation give the same interpolation
+    image::Image<float> image(cam.w(), cam.h());
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 0; x < image.width(); ++x)
+            image(y, x) = std::sin(x * 0.05f) + std::cos(y * 0.07f);
+
+    image::Image<float> image_ud;
+    image::Image<float> image_udMap;
+    UndistortImage(image, &cam, image_ud, -10.0f);
+    UndistortImage(image, undistortionMap, image_udMap, -10.0f);
+
+    BOOST_CHECK_EQUAL(image_ud.width(), image_udMap.width());
+    BOOST_CHECK_EQUAL(image_ud.height(), image_udMap.height());
+
+    for (int y = 0; y < image_ud.height(); ++y)
+        for (int x = 0; x < image_ud.width(); ++x)
+            BOOST_CHECK_SMALL(image_ud(y, x) - image_udMap(y, x), 1e-3f);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Request the undistortion maps of identical and different cameras
+// - Assert that identical cameras share the same map
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_cache)
+{
+    const Pinhole cam1(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.1, 0.01, 0.001));
+    const Pinhole cam2(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.1, 0.01, 0.001));
+    const Pinhole cam3(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.2, 0.01, 0.001));
+
+    UndistortionMapCache cache;
+
+    const UndistortionMapCache::MapSharedPtr map1 = cache.get(cam1, cam1.w(), cam1.h());
+    const UndistortionMapCache::MapSharedPtr map2 = cache.get(cam2, cam2.w(), cam2.h());
+    const UndistortionMapCache::MapSharedPtr map3 = cache.get(cam3, cam3.w(), cam3.h());
+    const UndistortionMapCache::MapSharedPtr map4 = cache.get(cam1, cam1.w() / 2, cam1.h() / 2);
+
+    BOOST_CHECK(map1 == map2);
+    BOOST_CHECK(map1 != map3);
+    BOOST_CHECK(map1 != map4);
+    BOOST_CHECK_EQUAL(map4->width(), cam1.w() / 2);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Request the undistortion maps of cameras only differing by their undistortion model
+// - Assert that the undistortion model is part of the map identity
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_cache_undistortion)
+{
+    const auto createCamera = [](double undistortionParam) {
+        auto undistortion = std::make_shared<Undistortion3DEAnamorphic4>(100, 80);
+        std::vector<double> params = undistortion->getParameters();
+        params[0] = undistortionParam;
+        undistortion->setParameters(params);
+        return Pinhole(100, 80, 90, 90, 0, 0, nullptr, undistortion);
+    };
+
+    const Pinhole cam1 = createCamera(0.05);
+    const Pinhole cam2 = createCamera(0.05);
+    const Pinhole cam3 = createCamera(0.1);
+
+    UndistortionMapCache cache;
+
+    const UndistortionMapCache::MapSharedPtr map1 = cache.get(cam1, cam1.w(), cam1.h());
+    const UndistortionMapCache::MapSharedPtr map2 = cache.get(cam2, cam2.w(), cam2.h());
+    const UndistortionMapCache::MapSharedPtr map3 = cache.get(cam3, cam3.w(), cam3.h());
+
+    BOOST_CHECK(map1 == map2);
+    BOOST_CHECK(map1 != map3);
+    BOOST_CHECK_GT(std::abs(map1->getMapX()(0, 0) - map3->getMapX()(0, 0)), 1e-3);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Request more undistortion maps than the memory budget of the cache
+// - Assert that the least recently used maps are released
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_cache_memoryBudget)
+{
+    const Pinhole cam1(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.1, 0.01, 0.001));
+    const Pinhole cam2(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.2, 0.01, 0.001));
+    const Pinhole cam3(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.3, 0.01, 0.001));
+
+    // room for two maps
+    const std::size_t mapMemorySize = UndistortionMap::getMemorySize(100, 80);
+    UndistortionMapCache cache("", 2 * mapMemorySize);
+
+    const UndistortionMapCache::MapSharedPtr map1 = cache.get(cam1, cam1.w(), cam1.h());
+    const UndistortionMapCache::MapSharedPtr map2 = cache.get(cam2, cam2.w(), cam2.h());
+    BOOST_CHECK_EQUAL(cache.getMemorySize(), 2 * mapMemorySize);
+
+    // cam1 becomes the most recently used, cam2 is released by cam3
+    BOOST_CHECK(cache.get(cam1, cam1.w(), cam1.h()) == map1);
+    const UndistortionMapCache::MapSharedPtr map3 = cache.get(cam3, cam3.w(), cam3.h());
+    BOOST_CHECK_EQUAL(cache.getMemorySize(), 2 * mapMemorySize);
+
+    BOOST_CHECK(cache.get(cam1, cam1.w(), cam1.h()) == map1);
+    BOOST_CHECK(cache.get(cam2, cam2.w(), cam2.h()) != map2);
+    BOOST_CHECK_EQUAL(cache.getMemorySize(), 2 * mapMemorySize);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.getMemorySize(), 0);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Save an undistortion map and load it back
+// - Assert that the loaded map matches the computed map
+// - Assert that a cache with a folder reuses the map written by another cache
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_save_load)
+{
+    const fs::path folder = fs::temp_directory_path() / "undistortionMap_test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+
+    std::shared_ptr<Distortion> distortion = std::make_shared<DistortionFisheye>(0.1, -0.05, 0.01, 0.002);
+    const Pinhole cam(200, 150, 180, 180, 2.0, -3.0, distortion);
+
+    UndistortionMap undistortionMap;
+    undistortionMap.compute(cam, cam.w(), cam.h());
+
+    const std::string mapPath = (folder / "undistortionMap.exr").string();
+    undistortionMap.save(mapPath);
+
+    UndistortionMap loadedMap;
+    loadedMap.load(mapPath);
+
+    BOOST_REQUIRE_EQUAL(loadedMap.width(), undistortionMap.width());
+    BOOST_REQUIRE_EQUAL(loadedMap.height(), undistortionMap.height());
+
+    for (int y = 0; y < cam.h(); ++y)
+    {
+        for (int x = 0; x < cam.w(); ++x)
+        {
+            BOOST_CHECK_SMALL(loadedMap.getMapX()(y, x) - undistortionMap.getMapX()(y, x), 1e-4f);
+            BOOST_CHECK_SMALL(loadedMap.getMapY()(y, x) - undistortionMap.getMapY()(y, x), 1e-4f);
+        }
+    }
+
+    fs::remove(mapPath);
+
+    // the first cache writes the map, the second one reads it
+    UndistortionMapCache::MapSharedPtr cachedMap;
+    {
+        UndistortionMapCache cache(folder.string());
+        cachedMap = cache.get(cam, cam.w(), cam.h());
+    }
+    BOOST_REQUIRE_EQUAL(std::distance(fs::directory_iterator(folder), fs::directory_iterator()), 1);
+
+    UndistortionMapCache cache(folder.string());
+    const UndistortionMapCache::MapSharedPtr reloadedMap = cache.get(cam, cam.w(), cam.h());
+
+    BOOST_CHECK(reloadedMap != cachedMap);
+    BOOST_REQUIRE_EQUAL(reloadedMap->width(), cachedMap->width());
+    for (int y = 0; y < cam.h(); y += 7)
+    {
+        for (int x = 0; x < cam.w(); x += 7)
+        {
+            BOOST_CHECK_SMALL(reloadedMap->getMapX()(y, x) - cachedMap->getMapX()(y, x), 1e-4f);
+            BOOST_CHECK_SMALL(reloadedMap->getMapY()(y, x) - cachedMap->getMapY()(y, x), 1e-4f);
+        }
+    }
+
+    fs::remove_all(folder);
+}
+
+//-----------------
+// Test summary:
+//-----------------
+// - Replace the map file written by a cache with the map of another camera
+// - Assert that the file name does not depend on the run and that the file stores the map description
+// - Assert that a map file which does not match the requested camera is computed again
+//-----------------
+BOOST_AUTO_TEST_CASE(undistortionMap_cache_fileCheck)
+{
+    const fs::path folder = fs::temp_directory_path() / "undistortionMap_fileCheck_test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+
+    const Pinhole cam1(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.1, 0.01, 0.001));
+    const Pinhole cam2(100, 80, 90, 90, 0, 0, std::make_shared<DistortionRadialK3>(0.3, 0.01, 0.001));
+
+    UndistortionMapCache::MapSharedPtr map1;
+    {
+        UndistortionMapCache cache(folder.string());
+        map1 = cache.get(cam1, cam1.w(), cam1.h());
+    }
+    BOOST_REQUIRE_EQUAL(std::distance(fs::directory_iterator(folder), fs::directory_iterator()), 1);
+    const std::string mapPath = fs::directory_iterator(folder)->path().string();
+    BOOST_CHECK(!image::readImageMetadata(mapPath).get_string("AliceVision:undistortionMapDescription").empty());
+
+    // the same cache folder gives the same file name
+    {
+        UndistortionMapCache cache(folder.string());
+        cache.get(cam1, cam1.w(), cam1.h());
+    }
+    BOOST_CHECK_EQUAL(std::distance(fs::directory_iterator(folder), fs::directory_iterator()), 1);
+    BOOST_CHECK(fs::exists(mapPath));
+
+    // replace the file with the map of cam2, without description
+    UndistortionMap map2;
+    map2.compute(cam2, cam2.w(), cam2.h());
+    map2.save(mapPath);
+
+    UndistortionMapCache cache(folder.string());
+    const UndistortionMapCache::MapSharedPtr reloadedMap = cache.get(cam1, cam1.w(), cam1.h());
+
+    BOOST_REQUIRE_EQUAL(reloadedMap->width(), map1->width());
+    for (int y = 0; y < cam1.h(); y += 7)
+    {
+        for (int x = 0; x < cam1.w(); x += 7)
+        {
+            BOOST_CHECK_SMALL(reloadedMap->getMapX()(y, x) - map1->getMapX()(y, x), 1e-4f);
+            BOOST_CHECK_SMALL(reloadedMap->getMapY()(y, x) - map1->getMapY()(y, x), 1e-4f);
+        }
+    }
+
+    // the file is written again with the description of cam1
+    BOOST_CHECK(!image::readImageMetadata(mapPath).get_string("AliceVision:undistortionMapDescription").empty());
+
+    fs::remove_all(folder);
+}
@@ -114,6 +114,8 @@ bool FeedProvider::goToFrame(const unsigned int frame) { return _feeder->goToFra
 
 bool FeedProvider::goToNextFrame() { return _feeder->goToNextFrame(); }
 
+void FeedProvider::setDecodingWidth(std::size_t width) { _feeder->setDecodingWidth(width); }
+
 bool FeedProvider::isInit() const { return (_feeder->isInit()); }
 
 FeedProvider::~FeedProvider() {}
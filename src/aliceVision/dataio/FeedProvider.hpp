@@ -78,6 +78,13 @@ class FeedProvider
      */
     bool goToNextFrame();
 
+    /**
+     * @brief Set the width at which the RGB images are used. The feeds able to decode an image at a reduced
+     * resolution (e.g. JPEG images) provide the smallest reduced image that is not narrower than this width.
+     * @param[in] width The width at which the images are used (0 for the full resolution).
+     */
+    void setDecodingWidth(std::size_t width);
+
     /**
      * @brief Return true if the feed is correctly initialized.
      *
@@ -63,6 +63,14 @@ class IFeed
 
     virtual bool goToNextFrame() = 0;
 
+    /**
+     * @brief Set the width at which the RGB images are used. The feeds able to decode an image at a reduced
+     * resolution provide the smallest reduced image that is not narrower than this width, the others
+     * always provide the full resolution.
+     * @param[in] width The width at which the images are used (0 for the full resolution).
+     */
+    virtual void setDecodingWidth(std::size_t width) {}
+
     virtual ~IFeed() {}
 };
 
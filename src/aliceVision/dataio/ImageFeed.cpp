@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ImageFeed.hpp"
+#include <aliceVision/config.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/utils/regexFilter.hpp>
 
@@ -19,10 +20,63 @@
 #include <regex>
 #include <iterator>
 #include <string>
+#include <type_traits>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV)
+    #include <opencv2/imgcodecs.hpp>
+    #include <opencv2/imgproc.hpp>
+#endif
 
 namespace aliceVision {
 namespace dataio {
 
+namespace {
+
+/**
+ * @brief Read a JPEG image at a reduced resolution, the downscaling is done by the JPEG decoder
+ * @param[in] imagePath The path to the image
+ * @param[in] width The width at which the image is used
+ * @param[out] imageRGB The image, at the smallest reduced resolution that is not narrower than \p width
+ * @return false if the image is not a JPEG image or if it cannot be decoded at a reduced resolution
+ */
+bool readReducedJpegImage(const std::string& imagePath, std::size_t width, image::Image<image::RGBColor>& imageRGB)
+{
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_OPENCV)
+    const std::string extension = boost::to_lower_copy(std::filesystem::path(imagePath).extension().string());
+    if (width == 0 || (extension != ".jpg" && extension != ".jpeg"))
+        return false;
+
+    int fullWidth = 0;
+    int fullHeight = 0;
+    image::readImageSize(imagePath, fullWidth, fullHeight);
+
+    // largest downscale factor supported by the decoder
+    int flags = 0;
+    if (fullWidth / 8 >= static_cast<int>(width))
+        flags = cv::IMREAD_REDUCED_COLOR_8;
+    else if (fullWidth / 4 >= static_cast<int>(width))
+        flags = cv::IMREAD_REDUCED_COLOR_4;
+    else if (fullWidth / 2 >= static_cast<int>(width))
+        flags = cv::IMREAD_REDUCED_COLOR_2;
+    else
+        return false;
+
+    // the orientation is not applied, as for the full resolution images
+    const cv::Mat bgr = cv::imread(imagePath, flags | cv::IMREAD_IGNORE_ORIENTATION);
+    if (bgr.empty())
+        return false;
+
+    imageRGB.resize(bgr.cols, bgr.rows);
+    cv::Mat rgb(bgr.rows, bgr.cols, CV_8UC3, imageRGB.data(), bgr.cols * 3);
+    cv::cvtColor(bgr, rgb, cv::COLOR_BGR2RGB);
+    return true;
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
 class ImageFeed::FeederImpl
 {
   public:
@@ -59,11 +113,18 @@ class ImageFeed::FeederImpl
 
         imageName = _images[_currentImageIndex];
         ALICEVISION_LOG_DEBUG(imageName);
+        if constexpr (std::is_same_v<T, image::RGBColor>)
+        {
+            if (readReducedJpegImage(imageName, _decodingWidth, image))
+                return true;
+        }
         image::readImage(imageName, image, image::EImageColorSpace::NO_CONVERSION);
 
         return true;
     }
 
+    void setDecodingWidth(std::size_t width) { _decodingWidth = width; }
+
     std::size_t nbFrames() const;
 
     bool goToFrame(const unsigned int frame);
@@ -80,6 +141,8 @@ class ImageFeed::FeederImpl
     camera::Pinhole _camIntrinsics;
 
     unsigned int _currentImageIndex = 0;
+    /// width at which the RGB images are used, 0 for the full resolution
+    std::size_t _decodingWidth = 0;
 };
 
 ImageFeed::FeederImpl::FeederImpl(const std::string& imagePath, const std::string& calibPath)
@@ -264,6 +327,8 @@ bool ImageFeed::goToNextFrame() { return _imageFeed->goToNextFrame(); }
 
 bool ImageFeed::isInit() const { return (_imageFeed->isInit()); }
 
+void ImageFeed::setDecodingWidth(std::size_t width) { _imageFeed->setDecodingWidth(width); }
+
 bool ImageFeed::isSupported(const std::string& extension)
 {
     std::string ext = boost::to_lower_copy(extension);
@@ -86,6 +86,13 @@ class ImageFeed : public IFeed
 
     bool goToNextFrame();
 
+    /**
+     * @brief Set the width at which the RGB images are used. The JPEG images are decoded at the
+     * smallest reduced resolution (1/2, 1/4 or 1/8) that is not narrower than this width.
+     * @param[in] width The width at which the images are used (0 for the full resolution).
+     */
+    void setDecodingWidth(std::size_t width);
+
     /**
      * @brief Return true if the feed is correctly initialized.
      *
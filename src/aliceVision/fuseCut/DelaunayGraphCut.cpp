@@ -16,6 +16,7 @@
 #include <aliceVision/mvsData/Pixel.hpp>
 #include <aliceVision/mvsData/Point2d.hpp>
 #include <aliceVision/mvsData/Universe.hpp>
+#include <aliceVision/mvsUtils/ChunkedMap.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/mvsUtils/mapIO.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
@@ -1160,20 +1161,36 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
             const int width = _mp.getWidth(c);
             const int height = _mp.getHeight(c);
 
+            // depth and similarity maps are read by bands of rows, aligned on the step,
+            // with a margin covering the similarity smoothing kernel and the modals neighborhood.
+            // Only the chunked map files can be partially read: without them, the maps are read once in a single band.
+            const std::string depthMapPath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::depthMapFiltered);
+            const std::string simMapPath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::simMapFiltered);
+            const bool readByBands = mvsUtils::isChunkedMapUpToDate(mvsUtils::getChunkedMapPath(depthMapPath), depthMapPath) &&
+                                     mvsUtils::isChunkedMapUpToDate(mvsUtils::getChunkedMapPath(simMapPath), simMapPath);
+            const int bandHeight = readByBands ? step * divideRoundUp(512, step) : height;
+            const int bandMargin = static_cast<int>(std::ceil(params.simGaussianSizeInit)) + 1;
+            const int sxMax = divideRoundUp(width, step);
+
+            for (int bandBegin = 0; bandBegin < height; bandBegin += bandHeight)
             {
+                const int bandEnd = std::min(bandBegin + bandHeight, height);
+                const ROI readRoi(0, width, std::max(bandBegin - bandMargin, 0), std::min(bandEnd + bandMargin, height));
+                const int readY = readRoi.y.begin;
+
                 // read depth map
-                mvsUtils::readMap(c, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+                mvsUtils::readMap(c, _mp, mvsUtils::EFileType::depthMapFiltered, readRoi, depthMap);
 
                 if (depthMap.size() <= 0)
                 {
                     ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
-                    continue;
+                    break;
                 }
 
                 // read similarity map
                 try
                 {
-                    mvsUtils::readMap(c, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
+                    mvsUtils::readMap(c, _mp, mvsUtils::EFileType::simMapFiltered, readRoi, simMap);
                     image::Image<float> simMapTmp;
                     imageAlgo::convolveImage(simMap, simMapTmp, "gaussian", params.simGaussianSizeInit, params.simGaussianSizeInit);
                     simMap.swap(simMapTmp);
@@ -1181,99 +1198,99 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
                 catch (const std::exception& e)
                 {
                     ALICEVISION_LOG_WARNING("simMap file can't be found.");
-                    simMap.resize(width, height, true, -1);
+                    simMap.resize(width, readRoi.height(), true, -1);
                 }
 
                 // read nmod map
-                int wTmp, hTmp;
-                const std::string nmodMapFilepath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::nmodMap);
-                // If we have an nModMap in input (from depthmapfilter) use it,
-                // else init with a constant value.
-                if (fs::exists(nmodMapFilepath))
-                {
-                    image::readImage(nmodMapFilepath, numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
-                    if (numOfModalsMap.width() != width || numOfModalsMap.height() != height)
-                        throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
-                }
-                else
+                if (bandBegin == 0)
                 {
-                    ALICEVISION_LOG_WARNING("nModMap file can't be found: " << nmodMapFilepath);
-                    numOfModalsMap.resize(width, height, true, 1);
+                    const std::string nmodMapFilepath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::nmodMap);
+                    // If we have an nModMap in input (from depthmapfilter) use it,
+                    // else init with a constant value.
+                    if (fs::exists(nmodMapFilepath))
+                    {
+                        image::readImage(nmodMapFilepath, numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
+                        if (numOfModalsMap.width() != width || numOfModalsMap.height() != height)
+                            throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
+                    }
+                    else
+                    {
+                        ALICEVISION_LOG_WARNING("nModMap file can't be found: " << nmodMapFilepath);
+                        numOfModalsMap.resize(width, height, true, 1);
+                    }
                 }
-            }
 
-            const int syMax = divideRoundUp(height, step);
-            const int sxMax = divideRoundUp(width, step);
 #pragma omp parallel for
-            for (int sy = 0; sy < syMax; ++sy)
-            {
-                for (int sx = 0; sx < sxMax; ++sx)
+                for (int sy = bandBegin / step; sy < divideRoundUp(bandEnd, step); ++sy)
                 {
-                    const int index = startIndex[c] + sy * sxMax + sx;
-                    float bestDepth = std::numeric_limits<float>::max();
-                    float bestScore = 0;
-                    float bestSimScore = 0;
-                    int bestX = 0;
-                    int bestY = 0;
-                    for (int y = sy * step, ymax = std::min((sy + 1) * step, height); y < ymax; ++y)
+                    for (int sx = 0; sx < sxMax; ++sx)
                     {
-                        for (int x = sx * step, xmax = std::min((sx + 1) * step, width); x < xmax; ++x)
+                        const int index = startIndex[c] + sy * sxMax + sx;
+                        float bestDepth = std::numeric_limits<float>::max();
+                        float bestScore = 0;
+                        float bestSimScore = 0;
+                        int bestX = 0;
+                        int bestY = 0;
+                        for (int y = sy * step, ymax = std::min((sy + 1) * step, height); y < ymax; ++y)
                         {
-                            const std::size_t index = y * width + x;
-                            const float depth = depthMap(index);
-                            if (depth <= 0.0f)
-                                continue;
-
-                            int numOfModals = 0;
-                            const int scoreKernelSize = 1;
-                            for (int ly = std::max(y - scoreKernelSize, 0), lyMax = std::min(y + scoreKernelSize, height - 1); ly < lyMax; ++ly)
+                            for (int x = sx * step, xmax = std::min((sx + 1) * step, width); x < xmax; ++x)
                             {
-                                for (int lx = std::max(x - scoreKernelSize, 0), lxMax = std::min(x + scoreKernelSize, width - 1); lx < lxMax; ++lx)
+                                const std::size_t index = (y - readY) * width + x;
+                                const float depth = depthMap(index);
+                                if (depth <= 0.0f)
+                                    continue;
+
+                                int numOfModals = 0;
+                                const int scoreKernelSize = 1;
+                                for (int ly = std::max(y - scoreKernelSize, 0), lyMax = std::min(y + scoreKernelSize, height - 1); ly < lyMax; ++ly)
                                 {
-                                    if (depthMap(ly * width + lx) > 0.0f)
+                                    for (int lx = std::max(x - scoreKernelSize, 0), lxMax = std::min(x + scoreKernelSize, width - 1); lx < lxMax; ++lx)
                                     {
-                                        numOfModals += 10 + int(numOfModalsMap(ly * width + lx));
+                                        if (depthMap((ly - readY) * width + lx) > 0.0f)
+                                        {
+                                            numOfModals += 10 + int(numOfModalsMap(ly * width + lx));
+                                        }
                                     }
                                 }
-                            }
-                            float sim = simMap(index);
-                            sim = sim < 0.0f ? 0.0f : sim;  // clamp values < 0
-                            // remap similarity values from [-1;+1] to [+1;+simScale]
-                            // interpretation is [goodSimilarity;badSimilarity]
-                            const float simScore = 1.0f + sim * params.simFactor;
-
-                            const float score = numOfModals + (1.0f / simScore);
-                            if (score > bestScore)
-                            {
-                                bestDepth = depth;
-                                bestScore = score;
-                                bestSimScore = simScore;
-                                bestX = x;
-                                bestY = y;
+                                float sim = simMap(index);
+                                sim = sim < 0.0f ? 0.0f : sim;  // clamp values < 0
+                                // remap similarity values from [-1;+1] to [+1;+simScale]
+                                // interpretation is [goodSimilarity;badSimilarity]
+                                const float simScore = 1.0f + sim * params.simFactor;
+
+                                const float score = numOfModals + (1.0f / simScore);
+                                if (score > bestScore)
+                                {
+                                    bestDepth = depth;
+                                    bestScore = score;
+                                    bestSimScore = simScore;
+                                    bestX = x;
+                                    bestY = y;
+                                }
                             }
                         }
-                    }
-                    if (bestScore < 3 * 13)
-                    {
-                        // discard the point
-                        pixSizePrepare[index] = -1.0;
-                    }
-                    else
-                    {
-                        const Point3d p = _mp.CArr[c] + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
-
-                        // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
-                        if (voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel))
+                        if (bestScore < 3 * 13)
                         {
-                            verticesCoordsPrepare[index] = p;
-                            simScorePrepare[index] = bestSimScore;
-                            pixSizePrepare[index] = _mp.getCamPixelSize(p, c);
+                            // discard the point
+                            pixSizePrepare[index] = -1.0;
                         }
                         else
                         {
-                            // discard the point
-                            // verticesCoordsPrepare[index] = p;
-                            pixSizePrepare[index] = -1.0;
+                            const Point3d p = _mp.CArr[c] + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
+
+                            // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
+                            if (voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel))
+                            {
+                                verticesCoordsPrepare[index] = p;
+                                simScorePrepare[index] = bestSimScore;
+                                pixSizePrepare[index] = _mp.getCamPixelSize(p, c);
+                            }
+                            else
+                            {
+                                // discard the point
+                                // verticesCoordsPrepare[index] = p;
+                                pixSizePrepare[index] = -1.0;
+                            }
                         }
                     }
                 }
@@ -7,6 +7,7 @@
 #include "Fuser.hpp"
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
@@ -17,19 +18,100 @@
 #include <aliceVision/mvsUtils/mapIO.hpp>
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 
+#include <algorithm>
 #include <filesystem>
-
 #include <iostream>
+#include <map>
 
 namespace aliceVision {
 namespace fuseCut {
 
 namespace fs = std::filesystem;
 
+namespace {
+
+/**
+ * @brief Order the cameras so that consecutive cameras are neighbors.
+ * @details Consecutive cameras are processed at the same time by the threads
+ *          and read mostly the same neighbor depth maps from the map cache.
+ * @param[in] cams the cameras to process
+ * @param[in] tcamsPerCam the nearest cameras of each camera to process
+ * @return the cameras in processing order
+ */
+std::vector<int> getCamsProcessingOrder(const std::vector<int>& cams, const std::vector<StaticVector<int>>& tcamsPerCam)
+{
+    std::map<int, std::size_t> indexPerCam;
+    for (std::size_t i = 0; i < cams.size(); ++i)
+        indexPerCam.emplace(cams[i], i);
+
+    std::vector<bool> visited(cams.size(), false);
+    std::vector<int> order;
+    order.reserve(cams.size());
+
+    for (std::size_t start = 0; start < cams.size(); ++start)
+    {
+        // greedy chain: go to the nearest unvisited neighbor of the last camera
+        std::size_t current = start;
+        while (!visited[current])
+        {
+            visited[current] = true;
+            order.push_back(cams[current]);
+
+            for (int i = 0; i < tcamsPerCam[current].size(); ++i)
+            {
+                const auto it = indexPerCam.find(tcamsPerCam[current][i]);
+                if (it != indexPerCam.end() && !visited[it->second])
+                {
+                    current = it->second;
+                    break;
+                }
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Get the image region containing the projection of an hexahedron.
+ * @param[in] mp the multi-view parameters
+ * @param[in] hexah the 8 hexahedron corners
+ * @param[in] rc the camera index
+ * @return the bounding box of the projected corners, the full image if a corner is behind the camera
+ */
+ROI getHexahedronImageRoi(const mvsUtils::MultiViewParams& mp, const Point3d* hexah, int rc)
+{
+    const int width = mp.getWidth(rc);
+    const int height = mp.getHeight(rc);
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    for (int i = 0; i < 8; ++i)
+    {
+        if (!mp.is3DPointInFrontOfCam(&hexah[i], rc))
+            return ROI(0, width, 0, height);
+
+        Point2d pix;
+        mp.getPixelFor3DPoint(&pix, hexah[i], rc);
+        minX = std::min(minX, pix.x);
+        minY = std::min(minY, pix.y);
+        maxX = std::max(maxX, pix.x);
+        maxY = std::max(maxY, pix.y);
+    }
+
+    const auto clampCoord = [](double value, int size) { return static_cast<unsigned int>(std::clamp(value, 0.0, double(size))); };
+    return ROI(clampCoord(std::floor(minX), width), clampCoord(std::floor(maxX) + 1.0, width), clampCoord(std::floor(minY), height), clampCoord(std::floor(maxY) + 1.0, height));
+}
+
+}  // namespace
+
 unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int scale)
 {
     unsigned long npts = 0;
@@ -44,7 +126,8 @@ unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int
 }
 
 Fuser::Fuser(const mvsUtils::MultiViewParams& mp)
-  : _mp(mp)
+  : _mp(mp),
+    _mapCache(mp, 1)
 {}
 
 Fuser::~Fuser() {}
@@ -120,23 +203,73 @@ bool Fuser::updateInSurr(float pixToleranceFactor,
     return true;
 }
 
+std::vector<int> Fuser::prepareFiltering(const std::vector<int>& cams, int nNearestCams, std::map<int, StaticVector<int>>& tcamsPerRc)
+{
+    std::vector<StaticVector<int>> tcamsPerCam(cams.size());
+#pragma omp parallel for
+    for (int c = 0; c < cams.size(); c++)
+    {
+        tcamsPerCam[c] = _mp.findNearestCamsFromLandmarks(cams[c], nNearestCams);
+    }
+
+    // process the neighbor cameras together: each thread needs the maps of a camera and of its nearest cameras
+    const std::vector<int> order = getCamsProcessingOrder(cams, tcamsPerCam);
+
+    tcamsPerRc.clear();
+    for (std::size_t c = 0; c < cams.size(); ++c)
+        tcamsPerRc[cams[c]] = std::move(tcamsPerCam[c]);
+
+    std::size_t mapCacheSize = _mapCacheSize;
+    if (mapCacheSize == 0)
+    {
+        // the maps of the cameras filtered in parallel and of their nearest cameras, within half of the available memory
+        const std::size_t mapMemSize = std::size_t(_mp.getMaxImageWidth()) * std::size_t(_mp.getMaxImageHeight()) * sizeof(float);
+        const system::MemoryInfo memoryInfo = system::getMemoryInfo();
+        const std::size_t nbMapsInMemory = (memoryInfo.availableRam / 2) / std::max<std::size_t>(mapMemSize, 1);
+        const std::size_t nbMapsNeeded = (omp_get_max_threads() + 1) * (nNearestCams + 2);
+
+        mapCacheSize = std::max<std::size_t>(std::min(nbMapsNeeded, nbMapsInMemory), 1);
+
+        ALICEVISION_LOG_INFO("Depth/sim maps cache: " << nbMapsNeeded << " maps needed, " << nbMapsInMemory << " maps of "
+                                                      << mapMemSize / (1024 * 1024) << " MB fit in half of the available memory ("
+                                                      << memoryInfo.availableRam / (1024 * 1024) << " MB).");
+    }
+    _mapCache.setMaxNbMaps(mapCacheSize);
+    _mapCache.resetStatistics();
+
+    return order;
+}
+
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 void Fuser::filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
 {
     ALICEVISION_LOG_INFO("Precomputing groups.");
     long t1 = clock();
-#pragma omp parallel for
-    for (int c = 0; c < cams.size(); c++)
+
+    std::map<int, StaticVector<int>> tcamsPerRc;
+    const std::vector<int> order = prepareFiltering(cams, nNearestCams, tcamsPerRc);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < order.size(); c++)
     {
-        int rc = cams[c];
-        filterGroupsRC(rc, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams);
+        const int rc = order[c];
+        filterGroupsRC(rc, tcamsPerRc.at(rc), pixToleranceFactor, pixSizeBall, pixSizeBallWSP);
     }
+    _camsOrder = order;
 
+    ALICEVISION_LOG_INFO("Depth/sim maps cache (" << _mapCache.getMaxNbMaps() << " maps): " << _mapCache.getNbHits() << " hits, "
+                                                  << _mapCache.getNbMisses() << " reads, hit rate: " << 100.0 * _mapCache.getHitRate() << "%.");
     mvsUtils::printfElapsedTime(t1);
 }
 
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
+{
+    const StaticVector<int> tcams = _mp.findNearestCamsFromLandmarks(rc, nNearestCams);
+    return filterGroupsRC(rc, tcams, pixToleranceFactor, pixSizeBall, pixSizeBallWSP);
+}
+
+bool Fuser::filterGroupsRC(int rc, const StaticVector<int>& tcams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP)
 {
     if (fs::exists(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap)))
     {
@@ -144,17 +277,159 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
     }
 
     long t1 = clock();
-    int w = _mp.getWidth(rc);
-    int h = _mp.getHeight(rc);
 
-    image::Image<float> depthMap;
-    image::Image<float> simMap;
+    // read depth/sim maps from depthMapEstimation folder (shared with the other cameras through the cache)
+    const mvsUtils::MapCache::MapSharedPtr depthMapPtr = _mapCache.get(rc, mvsUtils::EFileType::depthMap);
+    const mvsUtils::MapCache::MapSharedPtr simMapPtr = _mapCache.get(rc, mvsUtils::EFileType::simMap);
+
+    image::Image<unsigned char> numOfModalsMap;
+    computeNumOfModalsMap(rc, tcams, *depthMapPtr, *simMapPtr, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, numOfModalsMap);
+    writeNumOfModalsMap(rc, numOfModalsMap);
+
+    ALICEVISION_LOG_DEBUG(rc << " solved.");
+    mvsUtils::printfElapsedTime(t1);
+
+    return true;
+}
+
+// minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
+void Fuser::filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, int minNumOfModalsWSP2SSP)
+{
+    ALICEVISION_LOG_INFO("Filtering depth maps.");
+    long t1 = clock();
+
+    // the maps of the last cameras of filterGroups are the most likely to be still in the cache
+    std::vector<int> order = cams;
+    if (!_camsOrder.empty() && std::is_permutation(_camsOrder.begin(), _camsOrder.end(), cams.begin(), cams.end()))
+        order.assign(_camsOrder.rbegin(), _camsOrder.rend());
+
+    _mapCache.resetStatistics();
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < order.size(); c++)
+    {
+        int rc = order[c];
+        filterDepthMapsRC(rc, minNumOfModals, minNumOfModalsWSP2SSP);
+    }
+
+    ALICEVISION_LOG_INFO("Depth/sim maps cache: " << _mapCache.getNbHits() << " hits, " << _mapCache.getNbMisses()
+                                                  << " reads, hit rate: " << 100.0 * _mapCache.getHitRate() << "%.");
+
+    // the filtered cameras do not need their input maps anymore
+    _mapCache.clear();
+    _camsOrder.clear();
+
+    mvsUtils::printfElapsedTime(t1);
+}
+
+// minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
+bool Fuser::filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2SSP)
+{
+    long t1 = clock();
+
+    // read depth/sim maps from depthMapEstimation folder (copies: the maps are modified)
+    image::Image<float> depthMap = *_mapCache.get(rc, mvsUtils::EFileType::depthMap);
+    image::Image<float> simMap = *_mapCache.get(rc, mvsUtils::EFileType::simMap);
+    image::Image<unsigned char> numOfModalsMap;
+
+    image::readImage(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap), numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
+
+    applyNumOfModalsMap(numOfModalsMap, minNumOfModals, minNumOfModalsWSP2SSP, depthMap, simMap);
+
+    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
+
+    ALICEVISION_LOG_DEBUG(rc << " solved.");
+    mvsUtils::printfElapsedTime(t1);
+
+    return true;
+}
+
+void Fuser::filterGroupsAndDepthMaps(const std::vector<int>& cams,
+                                     float pixToleranceFactor,
+                                     int pixSizeBall,
+                                     int pixSizeBallWSP,
+                                     int nNearestCams,
+                                     int minNumOfModals,
+                                     int minNumOfModalsWSP2SSP)
+{
+    ALICEVISION_LOG_INFO("Filtering depth maps (single pass).");
+    long t1 = clock();
+
+    std::map<int, StaticVector<int>> tcamsPerRc;
+    const std::vector<int> order = prepareFiltering(cams, nNearestCams, tcamsPerRc);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < order.size(); c++)
+    {
+        const int rc = order[c];
+        filterGroupsAndDepthMapsRC(rc, tcamsPerRc.at(rc), pixToleranceFactor, pixSizeBall, pixSizeBallWSP, minNumOfModals, minNumOfModalsWSP2SSP);
+    }
 
-    // read depth/sim maps from depthMapEstimation folder
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
+    ALICEVISION_LOG_INFO("Depth/sim maps cache (" << _mapCache.getMaxNbMaps() << " maps): " << _mapCache.getNbHits() << " hits, "
+                                                  << _mapCache.getNbMisses() << " reads, hit rate: " << 100.0 * _mapCache.getHitRate() << "%.");
 
-    image::Image<unsigned char> numOfModalsMap(w, h, true, 0);
+    _mapCache.clear();
+
+    mvsUtils::printfElapsedTime(t1);
+}
+
+bool Fuser::filterGroupsAndDepthMapsRC(int rc,
+                                       const StaticVector<int>& tcams,
+                                       float pixToleranceFactor,
+                                       int pixSizeBall,
+                                       int pixSizeBallWSP,
+                                       int minNumOfModals,
+                                       int minNumOfModalsWSP2SSP)
+{
+    long t1 = clock();
+
+    // read depth/sim maps from depthMapEstimation folder (shared with the other cameras through the cache)
+    const mvsUtils::MapCache::MapSharedPtr depthMapPtr = _mapCache.get(rc, mvsUtils::EFileType::depthMap);
+    const mvsUtils::MapCache::MapSharedPtr simMapPtr = _mapCache.get(rc, mvsUtils::EFileType::simMap);
+
+    // the number of consistent cameras stays in memory, it is only exported for the meshing
+    // (as in filterGroupsRC, an existing nmodMap file is reused)
+    image::Image<unsigned char> numOfModalsMap;
+    const std::string numOfModalsMapPath = getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap);
+    if (fs::exists(numOfModalsMapPath))
+    {
+        image::readImage(numOfModalsMapPath, numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
+    }
+    else
+    {
+        computeNumOfModalsMap(rc, tcams, *depthMapPtr, *simMapPtr, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, numOfModalsMap);
+        writeNumOfModalsMap(rc, numOfModalsMap);
+    }
+
+    // copies: the maps are modified while the neighbor cameras may still use the input maps
+    image::Image<float> depthMap = *depthMapPtr;
+    image::Image<float> simMap = *simMapPtr;
+
+    applyNumOfModalsMap(numOfModalsMap, minNumOfModals, minNumOfModalsWSP2SSP, depthMap, simMap);
+
+    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
+    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
+
+    ALICEVISION_LOG_DEBUG(rc << " solved.");
+    mvsUtils::printfElapsedTime(t1);
+
+    return true;
+}
+
+void Fuser::computeNumOfModalsMap(int rc,
+                                  const StaticVector<int>& tcams,
+                                  const image::Image<float>& depthMap,
+                                  const image::Image<float>& simMap,
+                                  float pixToleranceFactor,
+                                  int pixSizeBall,
+                                  int pixSizeBallWSP,
+                                  image::Image<unsigned char>& numOfModalsMap)
+{
+    int w = _mp.getWidth(rc);
+    int h = _mp.getHeight(rc);
+
+    numOfModalsMap.resize(w, h, true, 0);
 
     if ((depthMap.size() != w * h) || (simMap.size() != w * h))
     {
@@ -168,17 +443,14 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
     numOfPtsMap->reserve(w * h);
     numOfPtsMap->resize_with(w * h, 0);
 
-    StaticVector<int> tcams = _mp.findNearestCamsFromLandmarks(rc, nNearestCams);
-
     for (int c = 0; c < tcams.size(); c++)
     {
         numOfPtsMap->resize_with(w * h, 0);
         int tc = tcams[c];
 
-        image::Image<float> tcdepthMap;
-
         // read Tc depth map from depthMapEstimation folder
-        mvsUtils::readMap(tc, _mp, mvsUtils::EFileType::depthMap, tcdepthMap);
+        const mvsUtils::MapCache::MapSharedPtr tcdepthMapPtr = _mapCache.get(tc, mvsUtils::EFileType::depthMap);
+        const image::Image<float>& tcdepthMap = *tcdepthMapPtr;
 
         if (tcdepthMap.height() > 0 && tcdepthMap.width() > 0)
         {
@@ -203,50 +475,23 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
         }
     }
 
-    image::writeImageWithFloat(
-      getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap),
-      numOfModalsMap,
-      image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR).storageDataType(image::EStorageDataType::Float));
-
     delete numOfPtsMap;
-
-    ALICEVISION_LOG_DEBUG(rc << " solved.");
-    mvsUtils::printfElapsedTime(t1);
-
-    return true;
 }
 
-// minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
-void Fuser::filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, int minNumOfModalsWSP2SSP)
+void Fuser::writeNumOfModalsMap(int rc, const image::Image<unsigned char>& numOfModalsMap) const
 {
-    ALICEVISION_LOG_INFO("Filtering depth maps.");
-    long t1 = clock();
-
-#pragma omp parallel for
-    for (int c = 0; c < cams.size(); c++)
-    {
-        int rc = cams[c];
-        filterDepthMapsRC(rc, minNumOfModals, minNumOfModalsWSP2SSP);
-    }
-
-    mvsUtils::printfElapsedTime(t1);
+    image::writeImageWithFloat(
+      getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap),
+      numOfModalsMap,
+      image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR).storageDataType(image::EStorageDataType::Float));
 }
 
-// minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
-bool Fuser::filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2SSP)
+void Fuser::applyNumOfModalsMap(const image::Image<unsigned char>& numOfModalsMap,
+                                int minNumOfModals,
+                                int minNumOfModalsWSP2SSP,
+                                image::Image<float>& depthMap,
+                                image::Image<float>& simMap)
 {
-    long t1 = clock();
-
-    image::Image<float> depthMap;
-    image::Image<float> simMap;
-    image::Image<unsigned char> numOfModalsMap;
-
-    // read depth/sim maps from depthMapEstimation folder
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMap, depthMap);
-    mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::simMap, simMap);
-
-    image::readImage(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap), numOfModalsMap, image::EImageColorSpace::NO_CONVERSION);
-
     if (depthMap.width() != simMap.width() || depthMap.width() != numOfModalsMap.width() || depthMap.height() != simMap.height() ||
         depthMap.height() != numOfModalsMap.height())
     {
@@ -281,14 +526,6 @@ bool Fuser::filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2
             simMap(i) = 1.0f;
         }
     }
-
-    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, depthMap);
-    mvsUtils::writeMap(rc, _mp, mvsUtils::EFileType::simMapFiltered, simMap);
-
-    ALICEVISION_LOG_DEBUG(rc << " solved.");
-    mvsUtils::printfElapsedTime(t1);
-
-    return true;
 }
 
 float Fuser::computeAveragePixelSizeInHexahedron(Point3d* hexah, int step, int scale)
@@ -304,13 +541,23 @@ float Fuser::computeAveragePixelSizeInHexahedron(Point3d* hexah, int step, int s
     for (int c = 0; c < cams.size(); c++)
     {
         int rc = cams[c];
-        int h = _mp.getHeight(rc) / scaleuse;
-        int w = _mp.getWidth(rc) / scaleuse;
+
+        // only the depth map region seen through the hexahedron is read
+        const ROI roi = getHexahedronImageRoi(_mp, hexah, rc);
+
+        if (roi.isEmpty())
+            continue;
+
+        const ROI mapRoi(0, divideRoundUp(_mp.getWidth(rc), scaleuse), 0, divideRoundUp(_mp.getHeight(rc), scaleuse));
+        const ROI downscaledRoi = intersect(downscaleROI(roi, scaleuse), mapRoi);
 
         image::Image<float> rcdepthMap;
-        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, rcdepthMap, scale);
+        mvsUtils::readMap(rc, _mp, mvsUtils::EFileType::depthMapFiltered, roi, rcdepthMap, scaleuse);
+
+        const int w = rcdepthMap.width();
+        const int h = rcdepthMap.height();
 
-        if (rcdepthMap.size() < w * h)
+        if (rcdepthMap.size() < downscaledRoi.width() * downscaledRoi.height())
             throw std::runtime_error("Invalid image size");
 
         for (int y = 0; y < h; y++)
@@ -322,8 +569,9 @@ float Fuser::computeAveragePixelSizeInHexahedron(Point3d* hexah, int step, int s
                 {
                     if (j % step == 0)
                     {
-                        Point3d p =
-                          _mp.CArr[rc] + (_mp.iCamArr[rc] * Point2d((float)x * (float)scaleuse, (float)y * (float)scaleuse)).normalize() * depth;
+                        const float px = float(downscaledRoi.x.begin + x) * (float)scaleuse;
+                        const float py = float(downscaledRoi.y.begin + y) * (float)scaleuse;
+                        Point3d p = _mp.CArr[rc] + (_mp.iCamArr[rc] * Point2d(px, py)).normalize() * depth;
                         if (mvsUtils::isPointInHexahedron(p, hexah))
                         {
                             float v = _mp.getCamPixelSize(p, rc);
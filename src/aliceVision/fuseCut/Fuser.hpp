@@ -7,6 +7,7 @@
 #pragma once
 
 #include <aliceVision/image/Image.hpp>
+#include <aliceVision/mvsUtils/MapCache.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
@@ -14,6 +15,10 @@
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 
+#include <cstddef>
+#include <map>
+#include <vector>
+
 namespace aliceVision {
 
 namespace fuseCut {
@@ -26,6 +31,13 @@ class Fuser
     Fuser(const mvsUtils::MultiViewParams& mp);
     ~Fuser();
 
+    /**
+     * @brief Set the maximum number of depth/sim maps shared between the cameras filtered in parallel.
+     * @param[in] maxNbMaps the maximum number of maps kept in memory (0: automatic, depends on the number of threads,
+     *                      of nearest cameras and on the available memory)
+     */
+    void setMapCacheSize(std::size_t maxNbMaps) { _mapCacheSize = maxNbMaps; }
+
     // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,... default 3
     // pixSizeBall = default 2
     void filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams);
@@ -33,6 +45,25 @@ class Fuser
     void filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, int minNumOfModalsWSP2SSP);
     bool filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2SSP);
 
+    /**
+     * @brief Filter the depth maps in a single pass per camera: same result as filterGroups followed by filterDepthMaps,
+     *        but the number of consistent cameras stays in memory instead of being read back from the nmodMap files.
+     * @param[in] cams the cameras to filter
+     * @param[in] pixToleranceFactor the filtering tolerance size factor (in px)
+     * @param[in] pixSizeBall the filter ball size (in px)
+     * @param[in] pixSizeBallWSP the filter ball size (in px) when the similarity is weak or ambiguous
+     * @param[in] nNearestCams the number of nearest cameras
+     * @param[in] minNumOfModals the minimal number of consistent cameras to consider the pixel
+     * @param[in] minNumOfModalsWSP2SSP the minimal number of consistent cameras to consider the pixel when the similarity is weak
+     */
+    void filterGroupsAndDepthMaps(const std::vector<int>& cams,
+                                  float pixToleranceFactor,
+                                  int pixSizeBall,
+                                  int pixSizeBallWSP,
+                                  int nNearestCams,
+                                  int minNumOfModals,
+                                  int minNumOfModalsWSP2SSP);
+
     void divideSpaceFromDepthMaps(Point3d* hexah, float& minPixSize);
     void divideSpaceFromSfM(const sfmData::SfMData& sfmData, Point3d* hexah, std::size_t minObservations = 0, float minObservationAngle = 0.0f) const;
 
@@ -43,6 +74,61 @@ class Fuser
     Voxel estimateDimensions(Point3d* vox, Point3d* newSpace, int scale, int maxOcTreeDim, const sfmData::SfMData* sfmData = nullptr);
 
   private:
+    /**
+     * @brief Find the nearest cameras of each camera, set up the map cache and get the processing order of the cameras.
+     * @param[in] cams the cameras to filter
+     * @param[in] nNearestCams the number of nearest cameras
+     * @param[out] tcamsPerRc the nearest cameras of each camera
+     * @return the cameras in processing order
+     */
+    std::vector<int> prepareFiltering(const std::vector<int>& cams, int nNearestCams, std::map<int, StaticVector<int>>& tcamsPerRc);
+
+    bool filterGroupsRC(int rc, const StaticVector<int>& tcams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP);
+
+    bool filterGroupsAndDepthMapsRC(int rc,
+                                    const StaticVector<int>& tcams,
+                                    float pixToleranceFactor,
+                                    int pixSizeBall,
+                                    int pixSizeBallWSP,
+                                    int minNumOfModals,
+                                    int minNumOfModalsWSP2SSP);
+
+    /**
+     * @brief Count for each pixel of the R camera the number of nearest cameras with a consistent depth.
+     * @param[in] rc the R camera index
+     * @param[in] tcams the nearest cameras
+     * @param[in] depthMap the R camera depth map
+     * @param[in] simMap the R camera similarity map
+     * @param[in] pixToleranceFactor the filtering tolerance size factor (in px)
+     * @param[in] pixSizeBall the filter ball size (in px)
+     * @param[in] pixSizeBallWSP the filter ball size (in px) when the similarity is weak or ambiguous
+     * @param[out] numOfModalsMap the number of consistent cameras per pixel
+     */
+    void computeNumOfModalsMap(int rc,
+                               const StaticVector<int>& tcams,
+                               const image::Image<float>& depthMap,
+                               const image::Image<float>& simMap,
+                               float pixToleranceFactor,
+                               int pixSizeBall,
+                               int pixSizeBallWSP,
+                               image::Image<unsigned char>& numOfModalsMap);
+
+    void writeNumOfModalsMap(int rc, const image::Image<unsigned char>& numOfModalsMap) const;
+
+    /**
+     * @brief Remove the depth values that are not consistent in enough cameras.
+     * @param[in] numOfModalsMap the number of consistent cameras per pixel
+     * @param[in] minNumOfModals the minimal number of consistent cameras to consider the pixel
+     * @param[in] minNumOfModalsWSP2SSP the minimal number of consistent cameras to consider the pixel when the similarity is weak
+     * @param[in,out] depthMap the depth map to filter
+     * @param[in,out] simMap the similarity map to filter
+     */
+    static void applyNumOfModalsMap(const image::Image<unsigned char>& numOfModalsMap,
+                                    int minNumOfModals,
+                                    int minNumOfModalsWSP2SSP,
+                                    image::Image<float>& depthMap,
+                                    image::Image<float>& simMap);
+
     bool updateInSurr(float pixToleranceFactor,
                       int pixSizeBall,
                       int pixSizeBallWSP,
@@ -53,6 +139,13 @@ class Fuser
                       const image::Image<float>& depthMap,
                       const image::Image<float>& simMap,
                       int scale);
+
+    /// depth/sim maps read by the filtering of the cameras
+    mvsUtils::MapCache _mapCache;
+    /// maximum number of maps of the cache (0: automatic)
+    std::size_t _mapCacheSize = 0;
+    /// processing order of the cameras of the last filterGroups
+    std::vector<int> _camsOrder;
 };
 
 unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int scale);
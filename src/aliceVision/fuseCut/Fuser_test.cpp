@@ -0,0 +1,214 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/Fuser.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/image/io.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/mvsUtils/mapIO.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE fuser
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const int imageWidth = 80;
+const int imageHeight = 60;
+const double planeDepth = 5.0;
+
+/**
+ * @brief Create a row of cameras looking at the plane z = planeDepth, with landmarks of the plane seen by all the cameras.
+ * @param[in] nbViews the number of views
+ */
+sfmData::SfMData createPlaneScene(int nbViews)
+{
+    sfmData::SfMData sfmData;
+    sfmData.getIntrinsics().emplace(0, camera::createPinhole(camera::EINTRINSIC::PINHOLE_CAMERA, imageWidth, imageHeight, 80.0, 80.0, 0.0, 0.0));
+
+    for (IndexT viewId = 0; viewId < nbViews; ++viewId)
+    {
+        sfmData.getViews().emplace(viewId, std::make_shared<sfmData::View>("", viewId, 0, viewId, imageWidth, imageHeight));
+        const Vec3 center(-1.0 + 2.0 * viewId / (nbViews - 1), 0.0, 0.0);
+        sfmData.setPose(*sfmData.getViews().at(viewId), sfmData::CameraPose(geometry::Pose3(Mat3::Identity(), center)));
+    }
+
+    const camera::IntrinsicBase& intrinsic = *sfmData.getIntrinsics().at(0);
+    IndexT landmarkId = 0;
+    for (double x = -0.5; x <= 0.5; x += 0.25)
+    {
+        for (double y = -0.5; y <= 0.5; y += 0.25)
+        {
+            sfmData::Landmark landmark(Vec3(x, y, planeDepth));
+            for (const auto& viewPair : sfmData.getViews())
+            {
+                const geometry::Pose3 pose = sfmData.getPose(*viewPair.second).getTransform();
+                landmark.getObservations().emplace(viewPair.first, sfmData::Observation(intrinsic.project(pose, landmark.X.homogeneous()), landmarkId, 1.0));
+            }
+            sfmData.getLandmarks().emplace(landmarkId++, landmark);
+        }
+    }
+    return sfmData;
+}
+
+/**
+ * @brief Write the depth/sim maps of the plane, with some outliers, weak similarities and invalid pixels.
+ * @param[in] mp the multi-view parameters
+ */
+void writePlaneMaps(const mvsUtils::MultiViewParams& mp)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+    for (int rc = 0; rc < mp.getNbCameras(); ++rc)
+    {
+        const int width = mp.getWidth(rc);
+        const int height = mp.getHeight(rc);
+        image::Image<float> depthMap(width, height);
+        image::Image<float> simMap(width, height);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const Point3d direction = (mp.iCamArr[rc] * Point2d(x, y)).normalize();
+                float depth = static_cast<float>((planeDepth - mp.CArr[rc].z) / direction.z);
+                float sim = -0.8f;
+
+                const float r = uniform(generator);
+                if (r < 0.1f)
+                    depth *= 0.5f + uniform(generator);  // outlier
+                else if (r < 0.15f)
+                    depth = -1.f;  // invalid
+                if (uniform(generator) < 0.2f)
+                    sim = 1.5f;  // weak similarity
+
+                depthMap(y, x) = depth;
+                simMap(y, x) = sim;
+            }
+        }
+
+        mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::depthMap, depthMap);
+        mvsUtils::writeMap(rc, mp, mvsUtils::EFileType::simMap, simMap);
+    }
+}
+
+void checkMapsEqual(const image::Image<float>& a, const image::Image<float>& b)
+{
+    BOOST_REQUIRE_EQUAL(a.width(), b.width());
+    BOOST_REQUIRE_EQUAL(a.height(), b.height());
+    int nbDifferences = 0;
+    for (int i = 0; i < a.size(); ++i)
+        nbDifferences += (a(i) != b(i));
+    BOOST_CHECK_EQUAL(nbDifferences, 0);
+}
+
+int countValidDepths(const image::Image<float>& depthMap)
+{
+    int nbValid = 0;
+    for (int i = 0; i < depthMap.size(); ++i)
+        nbValid += (depthMap(i) > 0.f);
+    return nbValid;
+}
+
+}  // namespace
+
+// Test summary:
+// - Write the depth/sim maps of a plane seen by a row of cameras, with outliers
+// - Filter the depth maps in two passes (filterGroups then filterDepthMaps) and in a single pass
+// - Check that the filtered depth/sim maps and the nmodMaps are the same
+// - Check that the single pass reuses the existing nmodMaps
+BOOST_AUTO_TEST_CASE(Fuser_singlePassEqualsTwoPasses)
+{
+    const fs::path folder = fs::temp_directory_path() / "fuser_test";
+    fs::remove_all(folder);
+    const std::string depthMapsFolder = (folder / "depthMaps").string();
+    const std::string twoPassesFolder = (folder / "twoPasses").string();
+    const std::string singlePassFolder = (folder / "singlePass").string();
+    fs::create_directories(depthMapsFolder);
+    fs::create_directories(twoPassesFolder);
+    fs::create_directories(singlePassFolder);
+
+    const sfmData::SfMData sfmData = createPlaneScene(4);
+    const mvsUtils::MultiViewParams mpTwoPasses(sfmData, "", depthMapsFolder, twoPassesFolder);
+    const mvsUtils::MultiViewParams mpSinglePass(sfmData, "", depthMapsFolder, singlePassFolder);
+    writePlaneMaps(mpTwoPasses);
+
+    std::vector<int> cams(mpTwoPasses.getNbCameras());
+    for (int rc = 0; rc < cams.size(); ++rc)
+        cams[rc] = rc;
+
+    const float pixToleranceFactor = 2.0f;
+    const int pixSizeBall = 0;
+    const int pixSizeBallWSP = 0;
+    const int nNearestCams = 3;
+    const int minNumOfModals = 3;
+    const int minNumOfModalsWSP2SSP = 4;
+
+    {
+        fuseCut::Fuser fuser(mpTwoPasses);
+        fuser.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams);
+        fuser.filterDepthMaps(cams, minNumOfModals, minNumOfModalsWSP2SSP);
+    }
+    {
+        fuseCut::Fuser fuser(mpSinglePass);
+        fuser.filterGroupsAndDepthMaps(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams, minNumOfModals, minNumOfModalsWSP2SSP);
+    }
+
+    for (int rc : cams)
+    {
+        BOOST_TEST_CONTEXT("camera: " << rc)
+        {
+            image::Image<float> depthMapTwoPasses, depthMapSinglePass, simMapTwoPasses, simMapSinglePass;
+            mvsUtils::readMap(rc, mpTwoPasses, mvsUtils::EFileType::depthMapFiltered, depthMapTwoPasses);
+            mvsUtils::readMap(rc, mpSinglePass, mvsUtils::EFileType::depthMapFiltered, depthMapSinglePass);
+            mvsUtils::readMap(rc, mpTwoPasses, mvsUtils::EFileType::simMapFiltered, simMapTwoPasses);
+            mvsUtils::readMap(rc, mpSinglePass, mvsUtils::EFileType::simMapFiltered, simMapSinglePass);
+            checkMapsEqual(depthMapTwoPasses, depthMapSinglePass);
+            checkMapsEqual(simMapTwoPasses, simMapSinglePass);
+
+            image::Image<unsigned char> nmodMapTwoPasses, nmodMapSinglePass;
+            image::readImage(getFileNameFromIndex(mpTwoPasses, rc, mvsUtils::EFileType::nmodMap), nmodMapTwoPasses, image::EImageColorSpace::NO_CONVERSION);
+            image::readImage(getFileNameFromIndex(mpSinglePass, rc, mvsUtils::EFileType::nmodMap), nmodMapSinglePass, image::EImageColorSpace::NO_CONVERSION);
+            BOOST_REQUIRE_EQUAL(nmodMapTwoPasses.size(), nmodMapSinglePass.size());
+            BOOST_CHECK(nmodMapTwoPasses == nmodMapSinglePass);
+
+            // the filtering is not trivial: a part of the plane is kept and some depths are removed
+            image::Image<float> depthMap;
+            mvsUtils::readMap(rc, mpSinglePass, mvsUtils::EFileType::depthMap, depthMap);
+            BOOST_CHECK_GT(countValidDepths(depthMapSinglePass), 0);
+            BOOST_CHECK_LT(countValidDepths(depthMapSinglePass), countValidDepths(depthMap));
+        }
+    }
+
+    // resume: an existing nmodMap is not computed again
+    {
+        const int rc = cams.front();
+        image::Image<unsigned char> emptyNmodMap(mpSinglePass.getWidth(rc), mpSinglePass.getHeight(rc), true, 0);
+        image::writeImageWithFloat(getFileNameFromIndex(mpSinglePass, rc, mvsUtils::EFileType::nmodMap),
+                                   emptyNmodMap,
+                                   image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR).storageDataType(image::EStorageDataType::Float));
+
+        fuseCut::Fuser fuser(mpSinglePass);
+        fuser.filterGroupsAndDepthMaps({rc}, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams, minNumOfModals, minNumOfModalsWSP2SSP);
+
+        image::Image<float> depthMap;
+        mvsUtils::readMap(rc, mpSinglePass, mvsUtils::EFileType::depthMapFiltered, depthMap);
+        BOOST_CHECK_EQUAL(countValidDepths(depthMap), 0);
+    }
+
+    fs::remove_all(folder);
+}
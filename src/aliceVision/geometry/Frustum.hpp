@@ -10,6 +10,10 @@
 
 #include "aliceVision/geometry/HalfPlane.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace aliceVision {
 namespace geometry {
 
@@ -108,6 +112,40 @@ struct Frustum
     // Return the supporting frustum points (5 for the infinite, 8 for the truncated)
     const std::vector<Vec3>& frustum_points() const { return points; }
 
+    /**
+     * @brief Compute the axis aligned bounding box of the frustum
+     * @details Without a far plane, the frustum is unbounded along the directions of its rays:
+     *          the corresponding bounds are set to +/- infinity.
+     * @param[out] bbMin The minimum corner of the bounding box
+     * @param[out] bbMax The maximum corner of the bounding box
+     */
+    void boundingBox(Vec3& bbMin, Vec3& bbMax) const
+    {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        const double depthNear = (z_near > 0) ? z_near : 0.0;
+
+        // the camera centre is only part of the frustum without near plane
+        bbMin = (z_near > 0) ? Vec3::Constant(infinity) : cones[0];
+        bbMax = (z_near > 0) ? Vec3::Constant(-infinity) : cones[0];
+        for (int i = 1; i < 5; ++i)
+        {
+            // ray of the image corner at depth 1
+            const Vec3 ray = cones[i] - cones[0];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const double nearValue = cones[0](axis) + depthNear * ray(axis);
+                double farValue = nearValue;
+                if (z_far > 0)
+                    farValue = cones[0](axis) + z_far * ray(axis);
+                else if (ray(axis) != 0.0)
+                    farValue = std::copysign(infinity, ray(axis));
+
+                bbMin(axis) = std::min(bbMin(axis), std::min(nearValue, farValue));
+                bbMax(axis) = std::max(bbMax(axis), std::max(nearValue, farValue));
+            }
+        }
+    }
+
 };  // struct Frustum
 
 }  // namespace geometry
@@ -289,3 +289,57 @@ BOOST_AUTO_TEST_CASE(panorama_without_intersection)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(bounding_box)
+{
+    const int focal = 1000;
+    const int principal_Point = 500;
+    const int iNviews = 4;
+    const int iNbPoints = 6;
+    const NViewDataSet d = NRealisticCamerasRing(iNviews, iNbPoints, NViewDatasetConfigurator(focal, focal, principal_Point, principal_Point, 5, 0));
+
+    const auto contains = [](const Vec3& bbMin, const Vec3& bbMax, const Vec3& point) {
+        return (bbMin.array() <= point.array() + 1e-9).all() && (point.array() - 1e-9 <= bbMax.array()).all();
+    };
+
+    for (int i = 0; i < iNviews; ++i)
+    {
+        // Truncated frustum: finite box containing the 8 frustum points
+        {
+            const Frustum frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i], d._C[i], 1.0, 10.0);
+            Vec3 bbMin, bbMax;
+            frustum.boundingBox(bbMin, bbMax);
+            BOOST_CHECK(bbMin.allFinite() && bbMax.allFinite());
+            for (const Vec3& point : frustum.frustum_points())
+                BOOST_CHECK(contains(bbMin, bbMax, point));
+        }
+
+        // Infinite frustum: box containing the camera centre and unbounded along the rays
+        {
+            const Frustum frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i], d._C[i]);
+            Vec3 bbMin, bbMax;
+            frustum.boundingBox(bbMin, bbMax);
+            BOOST_CHECK(!(bbMin.allFinite() && bbMax.allFinite()));
+            for (const Vec3& point : frustum.frustum_points())
+                BOOST_CHECK(contains(bbMin, bbMax, point));
+        }
+    }
+
+    // The bounding boxes of intersecting frustums overlap
+    std::vector<Frustum> vec_frustum;
+    for (int i = 0; i < iNviews; ++i)
+        vec_frustum.push_back(Frustum(principal_Point * 2, principal_Point * 2, d._K[i], d._R[i], d._C[i], 0.1, -1.0));
+
+    for (int i = 0; i < iNviews; ++i)
+    {
+        Vec3 iMin, iMax;
+        vec_frustum[i].boundingBox(iMin, iMax);
+        for (int j = 0; j < iNviews; ++j)
+        {
+            Vec3 jMin, jMax;
+            vec_frustum[j].boundingBox(jMin, jMax);
+            if (vec_frustum[i].intersect(vec_frustum[j]))
+                BOOST_CHECK((iMin.array() <= jMax.array()).all() && (jMin.array() <= iMax.array()).all());
+        }
+    }
+}
@@ -8,6 +8,10 @@
 #include <aliceVision/sfmDataIO/viewIO.hpp>
 #include <aliceVision/system/Logger.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <random>
 #include <tuple>
 #include <cassert>
@@ -35,6 +39,133 @@ int getRandomInt()
     return randomDist(randomTwEngine);
 }
 
+namespace {
+
+/**
+ * @brief Convert an RGB image into a grayscale OpenCV matrix
+ * @param[in] image the RGB image
+ * @return the grayscale matrix
+ */
+cv::Mat convertToGrayscale(image::Image<image::RGBColor>& image)
+{
+    // Convert content to OpenCV
+    cv::Mat cvFrame(cv::Size(image.cols(), image.rows()), CV_8UC3, image.data(), image.cols() * 3);
+
+    // Convert to grayscale
+    cv::Mat cvGrayscale;
+    cv::cvtColor(cvFrame, cvGrayscale, cv::COLOR_BGR2GRAY);
+    return cvGrayscale;
+}
+
+/**
+ * @brief Resize a grayscale matrix to a smaller width, the height is adjusted with respect to the size ratio
+ * @param[in] grayscale the grayscale matrix
+ * @param[in] width the width to resize the matrix to (no resizing if it is equal to 0 or not smaller than the
+ *            current width)
+ * @return the rescaled matrix, sharing its data with the input one if no resizing is performed
+ */
+cv::Mat rescale(const cv::Mat& grayscale, std::size_t width)
+{
+    if (width == 0 || static_cast<std::size_t>(grayscale.cols) <= width)
+        return grayscale;
+
+    cv::Mat cvRescaled;
+    cv::resize(grayscale, cvRescaled, cv::Size(width, double(grayscale.rows) * double(width) / double(grayscale.cols)));
+    return cvRescaled;
+}
+
+/**
+ * @brief Get the width of the proxy from which the matrices of both scores can be derived
+ * @param[in] rescaledWidthSharpness the width used for the sharpness scores (0 for the full resolution)
+ * @param[in] rescaledWidthFlow the width used for the motion scores (0 for the full resolution)
+ * @param[in] skipSharpnessComputation true if the sharpness matrices are not needed
+ * @return the width of the proxy (0 for the full resolution)
+ */
+std::size_t getProxyWidth(std::size_t rescaledWidthSharpness, std::size_t rescaledWidthFlow, bool skipSharpnessComputation)
+{
+    if (skipSharpnessComputation)
+        return rescaledWidthFlow;
+    if (rescaledWidthSharpness == 0 || rescaledWidthFlow == 0)
+        return 0;
+    return std::max(rescaledWidthSharpness, rescaledWidthFlow);
+}
+
+/**
+ * @brief Blocking queue with a maximum size, used to pass the decoded frames to the scoring threads
+ */
+template<typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t maxSize)
+      : _maxSize(std::max<std::size_t>(maxSize, 1))
+    {}
+
+    /**
+     * @brief Add an element, wait while the queue is full
+     * @param[in] element the element to add
+     */
+    void push(T&& element)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] { return _queue.size() < _maxSize; });
+        _queue.push_back(std::move(element));
+        _notEmpty.notify_one();
+    }
+
+    /**
+     * @brief Remove the first element, wait while the queue is empty and not closed
+     * @param[out] element the removed element
+     * @return false if the queue is closed and empty
+     */
+    bool pop(T& element)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return !_queue.empty() || _closed; });
+        if (_queue.empty())
+            return false;
+        element = std::move(_queue.front());
+        _queue.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Close the queue: no element will be added anymore
+     */
+    void close()
+    {
+        const std::scoped_lock lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+  private:
+    std::size_t _maxSize;
+    bool _closed = false;
+    std::deque<T> _queue;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+/**
+ * @brief A decoded frame of a media waiting to be scored
+ */
+struct ScoringTask
+{
+    std::size_t mediaIndex = 0;
+    std::size_t frame = 0;
+    /// grayscale proxy of the frame
+    cv::Mat proxy;
+    /// grayscale proxy of the previous valid frame of the media, empty if there is none
+    cv::Mat previousProxy;
+    /// proxy of the mask of the frame, empty if no mask is provided
+    cv::Mat maskProxy;
+};
+
+}  // namespace
+
 /**
  * @brief Find the median value in an unsorted vector of double values.
  * @param[in] vec The unsorted vector of double values
@@ -299,44 +430,287 @@ void KeyframeSelector::processSmart(const float pxDisplacement,
     // Step 3: for each subsequence, find the keyframe
     for (std::size_t i = 1; i < subsequenceLimits.size(); ++i)
     {
-        double bestSharpness = 0.0;
-        std::size_t bestIndex = 0;
-        std::size_t subsequenceSize = subsequenceLimits.at(i) - subsequenceLimits.at(i - 1);
         ALICEVISION_LOG_DEBUG("Subsequence [" << subsequenceLimits.at(i - 1) << ", " << subsequenceLimits.at(i) << "]");
 
-        // Weights for the whole subsequence [1.0; 2.0] (1.0 is on the subsequence's limits, 2.0 on its center)
-        std::deque<double> weights;
-        const double weightStep = 1.f / (static_cast<double>(subsequenceSize - 1) / 2.f);
-        weights.push_back(2.0);  // The frame in the middle of the subsequence has the biggest weight
-        if (subsequenceSize % 2 == 0)
-            weights.push_back(2.0);  // For subsequences of even size, two frames are equally in the middle
+        std::deque<double> subsequenceSharpness;
+        for (std::size_t j = subsequenceLimits.at(i - 1); j < subsequenceLimits.at(i); ++j)
+            subsequenceSharpness.push_back(_sharpnessScores.at(j));
+
+        const std::size_t bestIndex = subsequenceLimits.at(i - 1) + selectBestFrame(subsequenceSharpness);
+        ALICEVISION_LOG_INFO("Selecting frame with ID " << bestIndex);
+        _selectedKeyframes.push_back(bestIndex);
+        _selectedFrames.at(bestIndex) = '1';  // The frame has been selected, flip it to 1
+    }
+
+    ALICEVISION_LOG_INFO("Finished selecting all the keyframes! " << _selectedKeyframes.size() << "/" << sequenceSize
+                                                                  << " frames have been selected.");
+}
+
+bool KeyframeSelector::processStreaming(const float pxDisplacement,
+                                        const std::size_t rescaledWidthSharpness,
+                                        const std::size_t rescaledWidthFlow,
+                                        const std::size_t sharpnessWindowSize,
+                                        const std::size_t flowCellSize,
+                                        const std::size_t maxSubsequenceSize,
+                                        const std::vector<std::string>& brands,
+                                        const std::vector<std::string>& models,
+                                        const std::vector<float>& mmFocals,
+                                        const bool renameKeyframes,
+                                        const std::string& outputExtension,
+                                        const image::EStorageDataType storageDataType,
+                                        const bool skipSharpnessComputation)
+{
+    _selectedKeyframes.clear();
+    _selectedFrames.clear();
+    _keyframesPaths.clear();
+    _outputSfmKeyframes.clear();
+    _outputSfmFrames.clear();
+
+    // The scores are not kept for the whole sequence
+    _sharpnessScores.clear();
+    _flowScores.clear();
+    _frameWidth = 0;
+    _frameHeight = 0;
+
+    const std::size_t nbMedias = _mediaPaths.size();
+    const bool masksProvided = _maskPaths.size() > 0;
+    const bool writeKeyframes = outputExtension != "none";
 
-        float currentWeight = 2.0;
-        while (weights.size() != subsequenceSize)
+    // The scoring feeds are read sequentially, the writing feeds only move forward to the selected keyframes
+    std::vector<std::unique_ptr<dataio::FeedProvider>> feeds;
+    std::vector<std::unique_ptr<dataio::FeedProvider>> maskFeeds;
+    std::vector<std::unique_ptr<dataio::FeedProvider>> writingFeeds;
+    std::size_t nbFrames = std::numeric_limits<std::size_t>::max();
+
+    for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+    {
+        const auto& path = _mediaPaths.at(mediaIndex);
+
+        feeds.push_back(std::make_unique<dataio::FeedProvider>(path));
+        if (!feeds.back()->isInit())
         {
-            currentWeight -= weightStep;
-            weights.push_front(currentWeight);
-            weights.push_back(currentWeight);
+            ALICEVISION_THROW(std::invalid_argument, "Cannot initialize the FeedProvider with " << path);
         }
+        feeds.back()->goToFrame(0);
 
-        std::size_t weightPosition = 0;
-        for (std::size_t j = subsequenceLimits.at(i - 1); j < subsequenceLimits.at(i); ++j)
+        // Number of frames in the rig might slightly differ
+        nbFrames = std::min(nbFrames, static_cast<std::size_t>(feeds.back()->nbFrames()));
+
+        if (masksProvided)
         {
-            auto sharpness = _sharpnessScores.at(j) * weights.at(weightPosition);
-            ++weightPosition;
-            if (sharpness > bestSharpness)
+            const auto& maskPath = _maskPaths.at(mediaIndex);
+            maskFeeds.push_back(std::make_unique<dataio::FeedProvider>(maskPath));
+            if (!maskFeeds.back()->isInit())
             {
-                bestIndex = j;
-                bestSharpness = sharpness;
+                ALICEVISION_THROW(std::invalid_argument, "Invalid path to masks: " << maskPath);
             }
+            maskFeeds.back()->goToFrame(0);
+        }
+
+        if (writeKeyframes)
+        {
+            writingFeeds.push_back(std::make_unique<dataio::FeedProvider>(path));
         }
-        ALICEVISION_LOG_INFO("Selecting frame with ID " << bestIndex);
-        _selectedKeyframes.push_back(bestIndex);
-        _selectedFrames.at(bestIndex) = '1';  // The frame has been selected, flip it to 1
     }
 
-    ALICEVISION_LOG_INFO("Finished selecting all the keyframes! " << _selectedKeyframes.size() << "/" << sequenceSize
-                                                                  << " frames have been selected.");
+    if (nbFrames == 0)
+    {
+        ALICEVISION_THROW(std::invalid_argument, "One or multiple medias can't be found or is empty!");
+    }
+
+    // All frames are unselected so far
+    _selectedFrames.assign(nbFrames, '0');
+
+    std::vector<std::string> keyframesFolders(nbMedias);
+    if (writeKeyframes)
+    {
+        for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+            keyframesFolders.at(mediaIndex) = getKeyframesFolder(mediaIndex);
+    }
+
+    image::Image<image::RGBColor> image;
+    image::Image<image::RGBColor> mask;
+    camera::Pinhole queryIntrinsics;
+    bool hasIntrinsics = false;
+    std::string currentImgName;
+
+    unsigned int outputKeyframeCnt = 0;  // Used if the "renameKeyframes" option is enabled
+
+    // Select the keyframe of the current subsequence and write it for all the medias
+    const auto emitKeyframe = [&](std::size_t frame) {
+        ALICEVISION_LOG_INFO("Selecting frame with ID " << frame);
+        _selectedKeyframes.push_back(frame);
+        _selectedFrames.at(frame) = '1';
+
+        if (!writeKeyframes)
+            return;
+
+        for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+        {
+            auto& feed = *writingFeeds.at(mediaIndex);
+            if (!feed.goToFrame(frame) || !feed.readImage(image, queryIntrinsics, currentImgName, hasIntrinsics))
+            {
+                ALICEVISION_THROW(std::invalid_argument, "Cannot read the selected keyframe " << frame << " of " << _mediaPaths.at(mediaIndex));
+            }
+
+            std::ostringstream filenameSS;
+            filenameSS << std::setw(5) << std::setfill('0') << (renameKeyframes ? outputKeyframeCnt : frame) << "." << outputExtension;
+            const auto filepath = (keyframesFolders.at(mediaIndex) / fs::path(filenameSS.str())).string();
+
+            writeKeyframe(image,
+                          currentImgName,
+                          feed.isVideo(),
+                          filepath,
+                          brands[mediaIndex],
+                          models[mediaIndex],
+                          mmFocals[mediaIndex],
+                          outputExtension,
+                          storageDataType);
+            ALICEVISION_LOG_DEBUG("Wrote selected keyframe " << frame);
+
+            _keyframesPaths[mediaIndex].push_back(filepath);
+        }
+        ++outputKeyframeCnt;
+    };
+
+    // Sliding window on the current subsequence
+    std::deque<double> subsequenceSharpness;
+    std::size_t subsequenceStart = 0;
+    float step = 0.f;
+    double motionAcc = 0.0;
+
+    std::vector<cv::Ptr<cv::DenseOpticalFlow>> ptrFlows(nbMedias);
+    std::vector<cv::Mat> previousMatFlows(nbMedias);
+    for (auto& ptrFlow : ptrFlows)
+        ptrFlow = cv::optflow::createOptFlow_DeepFlow();
+
+    /* The last frame closes the last subsequence without being part of it, as in processSmart:
+     * it does not need to be scored. */
+    const std::size_t lastFrame = nbFrames > 1 ? nbFrames - 1 : nbFrames;
+    for (std::size_t frame = 0; frame < lastFrame; ++frame)
+    {
+        double minimalSharpness = skipSharpnessComputation ? 1.0 : std::numeric_limits<double>::max();
+        double minimalFlow = std::numeric_limits<double>::max();
+        bool isValid = true;
+
+        for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+        {
+            auto& feed = *feeds.at(mediaIndex);
+            if (frame > 0)
+            {
+                feed.goToNextFrame();
+                if (masksProvided)
+                    maskFeeds.at(mediaIndex)->goToNextFrame();
+            }
+
+            if (!feed.readImage(image, queryIntrinsics, currentImgName, hasIntrinsics))
+            {
+                ALICEVISION_LOG_WARNING("Invalid or missing frame " << frame + 1 << " in media " << _mediaPaths.at(mediaIndex) << ".");
+                isValid = false;
+                continue;
+            }
+
+            const cv::Mat grayscale = convertToGrayscale(image);
+            cv::Mat grayscaleMask;
+            if (masksProvided)
+            {
+                if (!maskFeeds.at(mediaIndex)->readImage(mask, queryIntrinsics, currentImgName, hasIntrinsics))
+                {
+                    ALICEVISION_THROW(std::invalid_argument, "Cannot read mask '" << currentImgName << "'!");
+                }
+                grayscaleMask = convertToGrayscale(mask);
+            }
+
+            if (!skipSharpnessComputation)
+            {
+                const cv::Mat maskSharpness = masksProvided ? rescale(grayscaleMask, rescaledWidthSharpness) : cv::Mat();
+                const double sharpness = computeSharpness(rescale(grayscale, rescaledWidthSharpness), sharpnessWindowSize, maskSharpness);
+                minimalSharpness = std::min(minimalSharpness, sharpness);
+            }
+
+            const cv::Mat matFlow = rescale(grayscale, rescaledWidthFlow);
+            if (!previousMatFlows.at(mediaIndex).empty())
+            {
+                const cv::Mat maskFlow = masksProvided ? rescale(grayscaleMask, rescaledWidthFlow) : cv::Mat();
+                const double flow = estimateFlow(ptrFlows.at(mediaIndex), matFlow, previousMatFlows.at(mediaIndex), flowCellSize, maskFlow);
+                minimalFlow = std::min(minimalFlow, flow);
+            }
+            previousMatFlows.at(mediaIndex) = matFlow;
+
+            if (_frameWidth == 0)
+            {
+                // Used to determine the motion accumulation step
+                _frameWidth = matFlow.size().width;
+                _frameHeight = matFlow.size().height;
+                step = pxDisplacement * std::min(_frameWidth, _frameHeight) / 100.0;
+            }
+        }
+
+        const double sharpness = isValid ? minimalSharpness : -1.0;
+        const double flow = (isValid && frame > 0) ? minimalFlow : -1.0;
+
+        if (frame > 0)
+        {
+            motionAcc += flow > -1.f ? flow : 0.f;
+            const bool isWindowFull = maxSubsequenceSize > 0 && subsequenceSharpness.size() >= maxSubsequenceSize;
+            if (motionAcc >= step || isWindowFull)
+            {
+                // The subsequence [subsequenceStart, frame[ is complete
+                ALICEVISION_LOG_DEBUG("Subsequence [" << subsequenceStart << ", " << frame << "]");
+                emitKeyframe(subsequenceStart + selectBestFrame(subsequenceSharpness));
+                subsequenceSharpness.clear();
+                subsequenceStart = frame;
+                motionAcc = 0.0;  // Reset the motion accumulator
+
+                if (_maxOutFrames > 0 && _selectedKeyframes.size() >= _maxOutFrames)
+                {
+                    ALICEVISION_LOG_INFO("The maximum number of output keyframes has been reached at frame " << frame << ".");
+                    break;
+                }
+            }
+        }
+        subsequenceSharpness.push_back(sharpness);
+
+        ALICEVISION_LOG_INFO("Finished processing frame " << frame + 1 << "/" << nbFrames);
+    }
+
+    // Close the last subsequence
+    if (!subsequenceSharpness.empty() && !(_maxOutFrames > 0 && _selectedKeyframes.size() >= _maxOutFrames))
+    {
+        ALICEVISION_LOG_DEBUG("Subsequence [" << subsequenceStart << ", " << lastFrame << "]");
+        emitKeyframe(subsequenceStart + selectBestFrame(subsequenceSharpness));
+    }
+
+    if (_selectedKeyframes.size() < _minOutFrames)
+    {
+        ALICEVISION_LOG_WARNING("Only " << _selectedKeyframes.size() << " keyframes have been selected (minimum: " << _minOutFrames
+                                        << "). The minimum number of output keyframes cannot be enforced with the streaming selection.");
+    }
+
+    ALICEVISION_LOG_INFO("Finished selecting all the keyframes! " << _selectedKeyframes.size() << "/" << nbFrames << " frames have been selected.");
+
+    // Write the output SfMData files with the existing writers
+    for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+    {
+        const auto& path = _mediaPaths.at(mediaIndex);
+        dataio::FeedProvider feed(path);
+
+        // If the current media is a video and there is no output keyframe, the corresponding SfMData file will not be written
+        if (feed.isVideo() && !writeKeyframes)
+        {
+            ALICEVISION_THROW(std::invalid_argument,
+                              "The keyframes selected from the input video have not been "
+                                << "written on disk. The keyframes' SfMData file cannot be written.");
+        }
+
+        if (!writeSfMData(path, feed, brands, models, mmFocals))
+        {
+            ALICEVISION_LOG_ERROR("Failed to write the output SfMData files.");
+            return false;
+        }
+    }
+
+    return true;
 }
 
 bool KeyframeSelector::computeScores(const std::size_t rescaledWidthSharpness,
@@ -406,6 +780,12 @@ bool KeyframeSelector::computeScores(const std::size_t rescaledWidthSharpness,
         ALICEVISION_THROW(std::invalid_argument, "One or multiple medias can't be found or is empty!");
     }
 
+    if (_pipelinedScoring)
+    {
+        return computeScoresPipelined(nbFrames, rescaledWidthSharpness, rescaledWidthFlow, sharpnessWindowSize, flowCellSize,
+                                      skipSharpnessComputation);
+    }
+
     // With the number of threads available and the number of frames to process known,
     // blocks can be prepared for multi-threading
     int nbThreads = omp_get_max_threads();
@@ -664,6 +1044,194 @@ bool KeyframeSelector::computeScoresProc(const std::size_t startFrame,
     return true;
 }
 
+bool KeyframeSelector::computeScoresPipelined(const std::size_t nbFrames,
+                                              const std::size_t rescaledWidthSharpness,
+                                              const std::size_t rescaledWidthFlow,
+                                              const std::size_t sharpnessWindowSize,
+                                              const std::size_t flowCellSize,
+                                              const bool skipSharpnessComputation)
+{
+    const std::size_t nbMedias = _mediaPaths.size();
+    const bool masksProvided = _maskPaths.size() > 0;
+    const std::size_t proxyWidth = getProxyWidth(rescaledWidthSharpness, rescaledWidthFlow, skipSharpnessComputation);
+
+    // Scores per media and per frame, each element is written by a single thread
+    // (-1 for the frames that could not be read and the motion of the first frame)
+    std::vector<std::vector<double>> sharpnessScores(nbMedias, std::vector<double>(nbFrames, -1.0));
+    std::vector<std::vector<double>> flowScores(nbMedias, std::vector<double>(nbFrames, -1.0));
+    std::vector<std::vector<char>> validFrames(nbMedias, std::vector<char>(nbFrames, 0));
+
+    const int nbWorkers = std::max(1, omp_get_max_threads() - static_cast<int>(nbMedias));
+    BoundedQueue<ScoringTask> queue(2 * nbWorkers);
+
+    ALICEVISION_LOG_INFO("Scoring " << nbFrames << " frames with " << nbMedias << " decoding thread(s) and " << nbWorkers
+                                    << " scoring thread(s).");
+
+    // Decoding: each media is read sequentially by its own thread
+    std::atomic<std::size_t> nbRunningDecoders(nbMedias);
+    std::exception_ptr decodingException;
+    std::mutex exceptionMutex;
+
+    const auto decode = [&](std::size_t mediaIndex) {
+        try
+        {
+            dataio::FeedProvider feed(_mediaPaths.at(mediaIndex));
+            if (!feed.isInit())
+            {
+                ALICEVISION_THROW(std::invalid_argument, "Cannot initialize the FeedProvider with " << _mediaPaths.at(mediaIndex));
+            }
+
+            std::unique_ptr<dataio::FeedProvider> maskFeed;
+            if (masksProvided)
+            {
+                maskFeed = std::make_unique<dataio::FeedProvider>(_maskPaths.at(mediaIndex));
+                if (!maskFeed->isInit())
+                {
+                    ALICEVISION_THROW(std::invalid_argument, "Invalid path to masks: " << _maskPaths.at(mediaIndex));
+                }
+                maskFeed->setDecodingWidth(proxyWidth);
+                maskFeed->goToFrame(0);
+            }
+            // The frames are decoded at a reduced resolution when the media allows it
+            feed.setDecodingWidth(proxyWidth);
+            feed.goToFrame(0);
+
+            camera::Pinhole queryIntrinsics;
+            bool hasIntrinsics = false;
+            image::Image<image::RGBColor> image;
+            image::Image<image::RGBColor> mask;
+            std::string currentImgName;
+            cv::Mat previousProxy;
+
+            for (std::size_t frame = 0; frame < nbFrames; ++frame)
+            {
+                if (frame > 0)
+                {
+                    feed.goToNextFrame();
+                    if (masksProvided)
+                        maskFeed->goToNextFrame();
+                }
+
+                if (!feed.readImage(image, queryIntrinsics, currentImgName, hasIntrinsics))
+                {
+                    // The dummy scores are kept for the invalid or missing frame
+                    ALICEVISION_LOG_WARNING("Invalid or missing frame " << frame + 1 << " in media " << _mediaPaths.at(mediaIndex) << ".");
+                    continue;
+                }
+
+                ScoringTask task;
+                task.mediaIndex = mediaIndex;
+                task.frame = frame;
+                task.proxy = rescale(convertToGrayscale(image), proxyWidth);
+                task.previousProxy = previousProxy;
+                if (masksProvided)
+                {
+                    if (!maskFeed->readImage(mask, queryIntrinsics, currentImgName, hasIntrinsics))
+                    {
+                        ALICEVISION_THROW(std::invalid_argument, "Cannot read mask '" << currentImgName << "'!");
+                    }
+                    task.maskProxy = rescale(convertToGrayscale(mask), proxyWidth);
+                }
+
+                // The proxies are shared with the tasks, not copied
+                previousProxy = task.proxy;
+                queue.push(std::move(task));
+            }
+        }
+        catch (...)
+        {
+            const std::scoped_lock lock(exceptionMutex);
+            if (!decodingException)
+                decodingException = std::current_exception();
+        }
+
+        if (--nbRunningDecoders == 0)
+            queue.close();
+    };
+
+    // Scoring: the frames of all the medias are scored in any order
+    std::exception_ptr scoringException;
+    std::atomic<std::size_t> nbScoredFrames(0);
+
+    const auto score = [&]() {
+        // The optical flow object is not shared between the threads
+        auto ptrFlow = cv::optflow::createOptFlow_DeepFlow();
+        ScoringTask task;
+        while (queue.pop(task))
+        {
+            try
+            {
+                if (!skipSharpnessComputation)
+                {
+                    const cv::Mat matSharpness = rescale(task.proxy, rescaledWidthSharpness);
+                    const cv::Mat maskSharpness = masksProvided ? rescale(task.maskProxy, rescaledWidthSharpness) : cv::Mat();
+                    sharpnessScores[task.mediaIndex][task.frame] = computeSharpness(matSharpness, sharpnessWindowSize, maskSharpness);
+                }
+                else
+                {
+                    sharpnessScores[task.mediaIndex][task.frame] = 1.0;
+                }
+
+                if (!task.previousProxy.empty())
+                {
+                    const cv::Mat matFlow = rescale(task.proxy, rescaledWidthFlow);
+                    const cv::Mat previousMatFlow = rescale(task.previousProxy, rescaledWidthFlow);
+                    const cv::Mat maskFlow = masksProvided ? rescale(task.maskProxy, rescaledWidthFlow) : cv::Mat();
+                    flowScores[task.mediaIndex][task.frame] = estimateFlow(ptrFlow, matFlow, previousMatFlow, flowCellSize, maskFlow);
+                }
+                validFrames[task.mediaIndex][task.frame] = 1;
+            }
+            catch (...)
+            {
+                const std::scoped_lock lock(exceptionMutex);
+                if (!scoringException)
+                    scoringException = std::current_exception();
+            }
+
+            const std::string rigInfo =
+              nbMedias > 1 ? " (media " + std::to_string(task.mediaIndex + 1) + "/" + std::to_string(nbMedias) + ")" : "";
+            ALICEVISION_LOG_INFO("Finished processing frame " << task.frame + 1 << "/" << nbFrames << rigInfo << " ("
+                                                              << ++nbScoredFrames << " scored frames).");
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+        threads.emplace_back(decode, mediaIndex);
+    for (int i = 0; i < nbWorkers; ++i)
+        threads.emplace_back(score);
+
+    for (auto& th : threads)
+    {
+        th.join();
+    }
+
+    if (decodingException)
+        std::rethrow_exception(decodingException);
+    if (scoringException)
+        std::rethrow_exception(scoringException);
+
+    // The score of a frame is the minimal score across all the medias
+    const std::scoped_lock lock(_mutex);
+    for (std::size_t frame = 0; frame < nbFrames; ++frame)
+    {
+        double minimalSharpness = std::numeric_limits<double>::max();
+        double minimalFlow = std::numeric_limits<double>::max();
+        bool isValid = true;
+        for (std::size_t mediaIndex = 0; mediaIndex < nbMedias; ++mediaIndex)
+        {
+            isValid = isValid && validFrames[mediaIndex][frame];
+            minimalSharpness = std::min(minimalSharpness, sharpnessScores[mediaIndex][frame]);
+            minimalFlow = std::min(minimalFlow, flowScores[mediaIndex][frame]);
+        }
+
+        _sharpnessScores[frame] = isValid ? minimalSharpness : -1.0;
+        _flowScores[frame] = isValid ? minimalFlow : -1.0;
+    }
+
+    return true;
+}
+
 bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
                                       const std::vector<std::string>& models,
                                       const std::vector<float>& mmFocals,
@@ -693,21 +1261,7 @@ bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
         // Ensure that we do want to write the keyframes on disk before going through this
         if (outputExtension != "none")
         {
-            std::string processedOutputFolder = _outputFolder;
-            if (_mediaPaths.size() > 1)
-            {
-                const std::string rigFolder = _outputFolder + "/rig/";
-                if (!fs::exists(rigFolder))
-                {
-                    fs::create_directory(rigFolder);
-                }
-
-                processedOutputFolder = rigFolder + std::to_string(id);
-                if (!fs::exists(processedOutputFolder))
-                {
-                    fs::create_directory(processedOutputFolder);
-                }
-            }
+            const std::string processedOutputFolder = getKeyframesFolder(id);
 
             unsigned int outputKeyframeCnt = 0;  // Used if the "renameKeyframes" option is enabled
             for (const auto pos : _selectedKeyframes)
@@ -724,21 +1278,6 @@ bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
                     return false;
                 }
 
-                oiio::ImageSpec inputSpec;
-                inputSpec.extra_attribs = image::readImageMetadata(currentImgName);
-                int orientation = inputSpec.get_int_attribute("Orientation", 1);
-                float pixelAspectRatio = inputSpec.get_float_attribute("PixelAspectRatio", 1.0f);
-                std::string colorspace = inputSpec.get_string_attribute("oiio:Colorspace", "");
-
-                oiio::ParamValueList metadata;
-                metadata.push_back(oiio::ParamValue("Make", brands[id]));
-                metadata.push_back(oiio::ParamValue("Model", models[id]));
-                metadata.push_back(oiio::ParamValue("Exif:FocalLength", mmFocals[id]));
-                metadata.push_back(oiio::ParamValue("Exif:ImageUniqueID", std::to_string(getRandomInt())));
-                metadata.push_back(oiio::ParamValue("Orientation", orientation));  // Will not propagate for PNG outputs
-                metadata.push_back(oiio::ParamValue("PixelAspectRatio", pixelAspectRatio));
-
-                fs::path folder = _outputFolder;
                 std::ostringstream filenameSS;
                 if (renameKeyframes)
                     filenameSS << std::setw(5) << std::setfill('0') << outputKeyframeCnt++ << "." << outputExtension;
@@ -746,30 +1285,7 @@ bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
                     filenameSS << std::setw(5) << std::setfill('0') << pos << "." << outputExtension;
                 const auto filepath = (processedOutputFolder / fs::path(filenameSS.str())).string();
 
-                image::ImageWriteOptions options;
-                // If the feed is a video, frames are read as OpenCV RGB matrices before being converted to image::ImageRGB
-                if (feed.isVideo())
-                {
-                    options.fromColorSpace(image::EImageColorSpace::SRGB);
-                    options.toColorSpace(image::EImageColorSpace::AUTO);
-                }
-                else
-                {  // Otherwise, the frames have been read without any conversion, they should be written as such
-                    if (colorspace == "sRGB")
-                        options.fromColorSpace(image::EImageColorSpace::SRGB);
-
-                    if (outputExtension == "exr")
-                        options.toColorSpace(image::EImageColorSpace::NO_CONVERSION);
-                    else
-                        options.toColorSpace(image::EImageColorSpace::AUTO);
-                }
-
-                if (storageDataType != image::EStorageDataType::Undefined && outputExtension == "exr")
-                {
-                    options.storageDataType(storageDataType);
-                }
-
-                image::writeImage(filepath, image, options, metadata);
+                writeKeyframe(image, currentImgName, feed.isVideo(), filepath, brands[id], models[id], mmFocals[id], outputExtension, storageDataType);
                 ALICEVISION_LOG_DEBUG("Wrote selected keyframe " << pos);
 
                 _keyframesPaths[id].push_back(filepath);
@@ -791,6 +1307,108 @@ bool KeyframeSelector::writeSelection(const std::vector<std::string>& brands,
     return true;
 }
 
+std::string KeyframeSelector::getKeyframesFolder(std::size_t mediaIndex) const
+{
+    if (_mediaPaths.size() <= 1)
+        return _outputFolder;
+
+    const std::string rigFolder = _outputFolder + "/rig/";
+    if (!fs::exists(rigFolder))
+    {
+        fs::create_directory(rigFolder);
+    }
+
+    const std::string processedOutputFolder = rigFolder + std::to_string(mediaIndex);
+    if (!fs::exists(processedOutputFolder))
+    {
+        fs::create_directory(processedOutputFolder);
+    }
+    return processedOutputFolder;
+}
+
+void KeyframeSelector::writeKeyframe(const image::Image<image::RGBColor>& image,
+                                     const std::string& imagePath,
+                                     const bool isVideo,
+                                     const std::string& filepath,
+                                     const std::string& brand,
+                                     const std::string& model,
+                                     const float mmFocal,
+                                     const std::string& outputExtension,
+                                     const image::EStorageDataType storageDataType) const
+{
+    oiio::ImageSpec inputSpec;
+    inputSpec.extra_attribs = image::readImageMetadata(imagePath);
+    int orientation = inputSpec.get_int_attribute("Orientation", 1);
+    float pixelAspectRatio = inputSpec.get_float_attribute("PixelAspectRatio", 1.0f);
+    std::string colorspace = inputSpec.get_string_attribute("oiio:Colorspace", "");
+
+    oiio::ParamValueList metadata;
+    metadata.push_back(oiio::ParamValue("Make", brand));
+    metadata.push_back(oiio::ParamValue("Model", model));
+    metadata.push_back(oiio::ParamValue("Exif:FocalLength", mmFocal));
+    metadata.push_back(oiio::ParamValue("Exif:ImageUniqueID", std::to_string(getRandomInt())));
+    metadata.push_back(oiio::ParamValue("Orientation", orientation));  // Will not propagate for PNG outputs
+    metadata.push_back(oiio::ParamValue("PixelAspectRatio", pixelAspectRatio));
+
+    image::ImageWriteOptions options;
+    // If the feed is a video, frames are read as OpenCV RGB matrices before being converted to image::ImageRGB
+    if (isVideo)
+    {
+        options.fromColorSpace(image::EImageColorSpace::SRGB);
+        options.toColorSpace(image::EImageColorSpace::AUTO);
+    }
+    else
+    {  // Otherwise, the frames have been read without any conversion, they should be written as such
+        if (colorspace == "sRGB")
+            options.fromColorSpace(image::EImageColorSpace::SRGB);
+
+        if (outputExtension == "exr")
+            options.toColorSpace(image::EImageColorSpace::NO_CONVERSION);
+        else
+            options.toColorSpace(image::EImageColorSpace::AUTO);
+    }
+
+    if (storageDataType != image::EStorageDataType::Undefined && outputExtension == "exr")
+    {
+        options.storageDataType(storageDataType);
+    }
+
+    image::writeImage(filepath, image, options, metadata);
+}
+
+std::size_t KeyframeSelector::selectBestFrame(const std::deque<double>& sharpnessScores)
+{
+    const std::size_t subsequenceSize = sharpnessScores.size();
+
+    // Weights for the whole subsequence [1.0; 2.0] (1.0 is on the subsequence's limits, 2.0 on its center)
+    std::deque<double> weights;
+    const double weightStep = 1.f / (static_cast<double>(subsequenceSize - 1) / 2.f);
+    weights.push_back(2.0);  // The frame in the middle of the subsequence has the biggest weight
+    if (subsequenceSize % 2 == 0)
+        weights.push_back(2.0);  // For subsequences of even size, two frames are equally in the middle
+
+    float currentWeight = 2.0;
+    while (weights.size() < subsequenceSize)
+    {
+        currentWeight -= weightStep;
+        weights.push_front(currentWeight);
+        weights.push_back(currentWeight);
+    }
+
+    double bestSharpness = 0.0;
+    std::size_t bestIndex = 0;
+    for (std::size_t j = 0; j < subsequenceSize; ++j)
+    {
+        const double sharpness = sharpnessScores.at(j) * weights.at(j);
+        if (sharpness > bestSharpness)
+        {
+            bestIndex = j;
+            bestSharpness = sharpness;
+        }
+    }
+    return bestIndex;
+}
+
 bool KeyframeSelector::exportScoresToFile(const std::string& filename, const bool exportSelectedFrames) const
 {
     std::size_t sequenceSize = scoresMap.begin()->second->size();
@@ -972,24 +1590,8 @@ cv::Mat KeyframeSelector::readImage(dataio::FeedProvider& feed, std::size_t widt
         ALICEVISION_THROW(std::invalid_argument, "Cannot read frame '" << currentImgName << "'!");
     }
 
-    // Convert content to OpenCV
-    cv::Mat cvFrame(cv::Size(image.cols(), image.rows()), CV_8UC3, image.data(), image.cols() * 3);
-
-    // Convert to grayscale
-    cv::Mat cvGrayscale;
-    cv::cvtColor(cvFrame, cvGrayscale, cv::COLOR_BGR2GRAY);
-
-    // Resize to smaller size if requested
-    if (width == 0)
-        return cvGrayscale;
-
-    cv::Mat cvRescaled;
-    if (cvGrayscale.cols > width && width > 0)
-    {
-        cv::resize(cvGrayscale, cvRescaled, cv::Size(width, double(cvGrayscale.rows) * double(width) / double(cvGrayscale.cols)));
-    }
-
-    return cvRescaled;
+    // Convert to grayscale and resize to smaller size if requested
+    return rescale(convertToGrayscale(image), width);
 }
 
 double KeyframeSelector::computeSharpness(const cv::Mat& grayscaleImage, const std::size_t windowSize, const cv::Mat& mask)
@@ -16,6 +16,7 @@
 #include <opencv2/optflow.hpp>
 #include <opencv2/imgcodecs.hpp>
 
+#include <deque>
 #include <string>
 #include <map>
 #include <mutex>
@@ -102,6 +103,49 @@ class KeyframeSelector
                       const std::size_t flowCellSize,
                       const bool skipSharpnessComputation = false);
 
+    /**
+     * @brief Process media paths with the smart method in a single streaming pass: the scores are computed while the
+     *        frames are decoded, and each keyframe is selected and written as soon as its subsequence is complete.
+     *        Only the scores of the current subsequence are kept and no decoded frame is kept, so the memory used by
+     *        the scoring does not grow with the length of the sequence. The selection flags of all the frames (one
+     *        byte per frame), the list of keyframes and the output SfMData files still grow with it. Unlike
+     *        processSmart, the minimum number of output frames cannot be enforced since the number of subsequences is
+     *        not known in advance: the selection stops once the maximum number of output frames is reached.
+     * @param[in] pxDisplacement in percent, the minimum of displaced pixels in the image since the last selected frame
+     * @param[in] rescaledWidthSharpness the width to resize the input frames to before using them to compute the
+     *            sharpness scores (if equal to 0, no rescale will be performed)
+     * @param[in] rescaledWidthFlow the width to resize the input frames to before using them to compute the
+     *            motion scores (if equal to 0, no rescale will be performed)
+     * @param[in] sharpnessWindowSize the size of the sliding window used to compute sharpness scores, in pixels
+     * @param[in] flowCellSize the size of the cells within a frame that are used to compute the optical flow scores,
+     *            in pixels
+     * @param[in] maxSubsequenceSize the maximum number of frames in a subsequence: a subsequence is closed once it
+     *            reaches this size even if the motion accumulation is not reached (if equal to 0, no limit)
+     * @param[in] brands brand name for each camera
+     * @param[in] models model name for each camera
+     * @param[in] mmFocals focal in millimeters for each camera
+     * @param[in] renameKeyframes name output keyframes as consecutive frames instead of using their index as a name
+     * @param[in] outputExtension file extension of the written keyframes
+     * @param[in] storageDataType EXR storage data type for the output keyframes (ignored when the extension is not EXR)
+     * @param[in] skipSharpnessComputation if true, the sharpness score computations will not be performed and a fixed
+     *            sharpness score will be given to all the input frames
+     * @return true if all the selected keyframes and the output SfMData files were successfully written, false
+     *         otherwise
+     */
+    bool processStreaming(const float pxDisplacement,
+                          const std::size_t rescaledWidthSharpness,
+                          const std::size_t rescaledWidthFlow,
+                          const std::size_t sharpnessWindowSize,
+                          const std::size_t flowCellSize,
+                          const std::size_t maxSubsequenceSize,
+                          const std::vector<std::string>& brands,
+                          const std::vector<std::string>& models,
+                          const std::vector<float>& mmFocals,
+                          const bool renameKeyframes,
+                          const std::string& outputExtension,
+                          const image::EStorageDataType storageDataType = image::EStorageDataType::Undefined,
+                          const bool skipSharpnessComputation = false);
+
     /**
      * @brief Compute the sharpness and optical flow scores for the input media paths
      * @param[in] rescaledWidthSharpness the width to resize the input frames to before using them to compute the
@@ -184,6 +228,13 @@ class KeyframeSelector
      */
     void setMinBlockSize(std::size_t blockSize) { _minBlockSize = blockSize; }
 
+    /**
+     * @brief Enable the pipelined computation of the scores: each media is decoded once, sequentially, by its own
+     *        thread and the decoded frames are scored by a pool of worker threads
+     * @param[in] pipelined true to use the pipelined computation, false to split the frames into blocks
+     */
+    void setPipelinedScoring(bool pipelined) { _pipelinedScoring = pipelined; }
+
     /**
      * @brief Get the minimum frame step parameter for the processing algorithm
      * @return minimum number of frames between two keyframes
@@ -208,6 +259,30 @@ class KeyframeSelector
      */
     unsigned int getMaxOutFrames() const { return _maxOutFrames; }
 
+    /**
+     * @brief Get the keyframes selected by the last processing
+     * @return the frame indexes of the selected keyframes, in ascending order
+     */
+    const std::vector<unsigned int>& getSelectedKeyframes() const { return _selectedKeyframes; }
+
+    /**
+     * @brief Get the pipelined scoring parameter
+     * @return true if the scores are computed with the pipelined method
+     */
+    bool getPipelinedScoring() const { return _pipelinedScoring; }
+
+    /**
+     * @brief Get the sharpness scores computed by the last processing
+     * @return the sharpness score of each frame (-1 for the invalid or missing frames)
+     */
+    const std::map<std::size_t, double>& getSharpnessScores() const { return _sharpnessScores; }
+
+    /**
+     * @brief Get the optical flow scores computed by the last processing
+     * @return the motion score of each frame (-1 for the first frame and the invalid or missing frames)
+     */
+    const std::map<std::size_t, double>& getFlowScores() const { return _flowScores; }
+
   private:
     /**
      * @brief Read an image from a feed provider into a grayscale OpenCV matrix, and rescale it if a size is provided
@@ -243,6 +318,68 @@ class KeyframeSelector
                            const std::size_t flowCellSize,
                            const bool skipSharpnessComputation);
 
+    /**
+     * @brief Compute the sharpness and optical flow scores for the input media paths with a pipeline: a decoding
+     *        thread per media reads its frames sequentially (no seek, each frame is decoded once, at a reduced
+     *        resolution if the media allows it) and converts them into a grayscale proxy, downscaled once to the
+     *        largest requested width. A pool of worker threads
+     *        derives the sharpness and motion matrices from the proxies and computes the scores.
+     * @param[in] nbFrames the total number of frames in the sequence
+     * @param[in] rescaledWidthSharpness the width to resize the input frames to before using them to compute the
+     *            sharpness scores (if equal to 0, no rescale will be performed)
+     * @param[in] rescaledWidthFlow the width to resize the input frames to before using them to compute the
+     *            motion scores (if equal to 0, no rescale will be performed)
+     * @param[in] sharpnessWindowSize the size of the sliding window used to compute sharpness scores, in pixels
+     * @param[in] flowCellSize the size of the cells within a frame that are used to compute the optical flow scores,
+     *            in pixels
+     * @param[in] skipSharpnessComputation if true, the sharpness score computations will not be performed and a fixed
+     *            sharpness score will be given to all the input frames
+     * @return true if the scores have been successfully computed for all frames, false otherwise
+     */
+    bool computeScoresPipelined(const std::size_t nbFrames,
+                                const std::size_t rescaledWidthSharpness,
+                                const std::size_t rescaledWidthFlow,
+                                const std::size_t sharpnessWindowSize,
+                                const std::size_t flowCellSize,
+                                const bool skipSharpnessComputation);
+
+    /**
+     * @brief Get the output folder of the keyframes of a media, and create it if needed
+     * @param[in] mediaIndex the index of the media
+     * @return the output folder (the rig subfolder of the media if there are several medias)
+     */
+    std::string getKeyframesFolder(std::size_t mediaIndex) const;
+
+    /**
+     * @brief Write a selected keyframe in the output folder
+     * @param[in] image the keyframe image
+     * @param[in] imagePath the path of the keyframe image in the input feed
+     * @param[in] isVideo true if the input feed is a video
+     * @param[in] filepath the path of the written keyframe
+     * @param[in] brand brand name of the camera
+     * @param[in] model model name of the camera
+     * @param[in] mmFocal focal in millimeters of the camera
+     * @param[in] outputExtension file extension of the written keyframe
+     * @param[in] storageDataType EXR storage data type for the output keyframe (ignored when the extension is not EXR)
+     */
+    void writeKeyframe(const image::Image<image::RGBColor>& image,
+                       const std::string& imagePath,
+                       const bool isVideo,
+                       const std::string& filepath,
+                       const std::string& brand,
+                       const std::string& model,
+                       const float mmFocal,
+                       const std::string& outputExtension,
+                       const image::EStorageDataType storageDataType) const;
+
+    /**
+     * @brief Select the frame with the best weighted sharpness score in a subsequence. The weights favour the frames
+     *        at the center of the subsequence, from 1.0 on its limits to 2.0 on its center.
+     * @param[in] sharpnessScores the sharpness scores of the frames of the subsequence
+     * @return the position of the selected frame in the subsequence
+     */
+    static std::size_t selectBestFrame(const std::deque<double>& sharpnessScores);
+
     /**
      * @brief Compute the sharpness scores for an input grayscale frame with a sliding window
      * @param[in] grayscaleImage the input grayscale matrix of the frame
@@ -386,6 +523,8 @@ class KeyframeSelector
 
     /// Minimum block size for multi-threading
     std::size_t _minBlockSize = 10;
+    /// Compute the scores with a decoding thread per media feeding a pool of scoring threads
+    bool _pipelinedScoring = false;
 
     /// Sharpness scores for each frame
     std::map<std::size_t, double> _sharpnessScores;
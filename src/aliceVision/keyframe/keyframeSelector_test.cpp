@@ -0,0 +1,211 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/keyframe/KeyframeSelector.hpp>
+#include <aliceVision/image/all.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <filesystem>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE keyframeSelector
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::keyframe;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Write a synthetic image sequence: a random texture translated horizontally by a fixed step per frame
+ * @param[in] folder the output folder, created if needed
+ * @param[in] nbFrames the number of frames
+ * @param[in] pxStep the translation between two consecutive frames, in pixels
+ */
+void writeSequence(const fs::path& folder, int nbFrames, int pxStep)
+{
+    const int width = 160;
+    const int height = 120;
+
+    fs::create_directories(folder);
+
+    // blocky texture, wide enough to be translated over the whole sequence
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    const int textureWidth = width + nbFrames * pxStep;
+    const int blockSize = 4;
+    std::vector<unsigned char> texture((textureWidth / blockSize + 1) * (height / blockSize + 1));
+    for (unsigned char& value : texture)
+        value = static_cast<unsigned char>(distribution(generator));
+
+    for (int frame = 0; frame < nbFrames; ++frame)
+    {
+        image::Image<image::RGBColor> image(width, height);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const int u = x + frame * pxStep;
+                const unsigned char value = texture[(y / blockSize) * (textureWidth / blockSize + 1) + u / blockSize];
+                image(y, x) = image::RGBColor(value, value, value);
+            }
+        }
+
+        std::ostringstream filename;
+        filename << "frame_" << std::setw(5) << std::setfill('0') << frame << ".png";
+        image::writeImage((folder / filename.str()).string(),
+                          image,
+                          image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION));
+    }
+}
+
+}  // namespace
+
+// Test summary:
+// - Write a synthetic sequence with a constant motion
+// - Check that the streaming selection gives the same keyframes as the smart selection
+//   when the output frames constraints do not change the motion step
+BOOST_AUTO_TEST_CASE(KeyframeSelector_streamingMatchesSmart)
+{
+    const fs::path folder = fs::temp_directory_path() / "keyframeSelector_test_motion";
+    const int nbFrames = 30;
+    writeSequence(folder / "sequence", nbFrames, 2);
+
+    const float pxDisplacement = 5.f;  // 6 px on the 120 px high frames: a keyframe every 3 frames
+    const std::size_t sharpnessWindowSize = 64;
+    const std::size_t flowCellSize = 40;
+
+    KeyframeSelector smartSelector({(folder / "sequence").string()},
+                                   {},
+                                   "",
+                                   folder.string(),
+                                   (folder / "smartKeyframes.sfm").string(),
+                                   (folder / "smartFrames.sfm").string());
+    smartSelector.setMinOutFrames(1);
+    smartSelector.setMaxOutFrames(nbFrames);
+    smartSelector.processSmart(pxDisplacement, 0, 0, sharpnessWindowSize, flowCellSize);
+
+    KeyframeSelector streamingSelector({(folder / "sequence").string()},
+                                       {},
+                                       "",
+                                       folder.string(),
+                                       (folder / "streamingKeyframes.sfm").string(),
+                                       (folder / "streamingFrames.sfm").string());
+    streamingSelector.setMinOutFrames(1);
+    streamingSelector.setMaxOutFrames(nbFrames);
+    BOOST_CHECK(streamingSelector.processStreaming(pxDisplacement, 0, 0, sharpnessWindowSize, flowCellSize, 0, {""}, {""}, {0.f}, false, "none"));
+
+    BOOST_CHECK_GT(smartSelector.getSelectedKeyframes().size(), 1);
+    BOOST_CHECK(smartSelector.getSelectedKeyframes() == streamingSelector.getSelectedKeyframes());
+
+    fs::remove_all(folder);
+}
+
+// Test summary:
+// - Write a synthetic sequence without any motion
+// - Check that the streaming selection closed by the maximum subsequence size selects
+//   one keyframe in each window of the regular sampling with the same step
+BOOST_AUTO_TEST_CASE(KeyframeSelector_streamingWindowsMatchRegular)
+{
+    const fs::path folder = fs::temp_directory_path() / "keyframeSelector_test_static";
+    const int nbFrames = 25;
+    const unsigned int frameStep = 5;
+    writeSequence(folder / "sequence", nbFrames, 0);
+
+    KeyframeSelector regularSelector({(folder / "sequence").string()},
+                                     {},
+                                     "",
+                                     folder.string(),
+                                     (folder / "regularKeyframes.sfm").string(),
+                                     (folder / "regularFrames.sfm").string());
+    regularSelector.setMinFrameStep(frameStep);
+    regularSelector.setMaxFrameStep(0);
+    regularSelector.setMaxOutFrames(nbFrames);
+    regularSelector.processRegular();
+
+    KeyframeSelector streamingSelector({(folder / "sequence").string()},
+                                       {},
+                                       "",
+                                       folder.string(),
+                                       (folder / "streamingKeyframes.sfm").string(),
+                                       (folder / "streamingFrames.sfm").string());
+    streamingSelector.setMinOutFrames(1);
+    streamingSelector.setMaxOutFrames(nbFrames);
+    BOOST_CHECK(streamingSelector.processStreaming(5.f, 0, 0, 64, 40, frameStep, {""}, {""}, {0.f}, false, "none", image::EStorageDataType::Undefined, true));
+
+    const std::vector<unsigned int>& regularKeyframes = regularSelector.getSelectedKeyframes();
+    const std::vector<unsigned int>& streamingKeyframes = streamingSelector.getSelectedKeyframes();
+
+    BOOST_REQUIRE_EQUAL(regularKeyframes.size(), streamingKeyframes.size());
+    for (std::size_t i = 0; i < regularKeyframes.size(); ++i)
+    {
+        BOOST_CHECK_GE(streamingKeyframes[i], regularKeyframes[i]);
+        BOOST_CHECK_LT(streamingKeyframes[i], regularKeyframes[i] + frameStep);
+    }
+
+    fs::remove_all(folder);
+}
+
+// Test summary:
+// - Write a synthetic sequence with a constant motion
+// - Check that the pipelined scores are the scores of the frames blocks (computeScoresProc), with and without rescale,
+//   and without sharpness
+// - The sharpness and motion matrices are rescaled to the same width: the pipelined proxy is then the matrix itself
+BOOST_AUTO_TEST_CASE(KeyframeSelector_pipelinedScoresMatchBlockScores)
+{
+    const fs::path folder = fs::temp_directory_path() / "keyframeSelector_test_pipelined";
+    const int nbFrames = 12;
+    writeSequence(folder / "sequence", nbFrames, 2);
+
+    // rescaled width (sharpness and motion), skip sharpness
+    const std::vector<std::pair<std::size_t, bool>> configurations = {{0, false}, {80, false}, {80, true}};
+
+    for (const auto& [rescaledWidth, skipSharpness] : configurations)
+    {
+        KeyframeSelector blockSelector({(folder / "sequence").string()}, {}, "", folder.string(), "", "");
+        KeyframeSelector pipelinedSelector({(folder / "sequence").string()}, {}, "", folder.string(), "", "");
+        pipelinedSelector.setPipelinedScoring(true);
+
+        // a single block: the first frame of a block has no motion score
+        const int nbThreads = omp_get_max_threads();
+        omp_set_num_threads(1);
+        BOOST_CHECK(blockSelector.computeScores(rescaledWidth, rescaledWidth, 16, 10, skipSharpness));
+        omp_set_num_threads(nbThreads);
+
+        BOOST_CHECK(pipelinedSelector.computeScores(rescaledWidth, rescaledWidth, 16, 10, skipSharpness));
+
+        BOOST_TEST_CONTEXT("rescaled width: " << rescaledWidth << ", skip sharpness: " << skipSharpness)
+        {
+            const std::map<std::size_t, double>& blockSharpness = blockSelector.getSharpnessScores();
+            const std::map<std::size_t, double>& pipelinedSharpness = pipelinedSelector.getSharpnessScores();
+            const std::map<std::size_t, double>& blockFlow = blockSelector.getFlowScores();
+            const std::map<std::size_t, double>& pipelinedFlow = pipelinedSelector.getFlowScores();
+
+            BOOST_REQUIRE_EQUAL(blockSharpness.size(), nbFrames);
+            BOOST_REQUIRE_EQUAL(pipelinedSharpness.size(), nbFrames);
+            BOOST_REQUIRE_EQUAL(blockFlow.size(), nbFrames);
+            BOOST_REQUIRE_EQUAL(pipelinedFlow.size(), nbFrames);
+
+            for (int frame = 0; frame < nbFrames; ++frame)
+            {
+                BOOST_CHECK_CLOSE(blockSharpness.at(frame), pipelinedSharpness.at(frame), 1e-4);
+                BOOST_CHECK_CLOSE(blockFlow.at(frame), pipelinedFlow.at(frame), 1e-4);
+            }
+            // the motion is detected
+            BOOST_CHECK_GT(pipelinedFlow.at(nbFrames - 1), 0.0);
+        }
+    }
+
+    fs::remove_all(folder);
+}
@@ -6,9 +6,15 @@
 
 #include <expat.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <math.h>
+#include <random>
+#include <sstream>
 
 template<typename T>
 constexpr T interpolate(T a, T b, T c)
@@ -1126,7 +1132,85 @@ void LCPinfo::setVignetteModel(const std::string& name)
         currLensParam.vignParams.VignetteModelParam3 = std::stof(_currText.c_str());
 }
 
-void LCPdatabase::loadDirectory(const std::filesystem::path& p)
+namespace {
+
+// LCP index file layout (native byte order):
+//  - magic and version
+//  - number of LCP files
+//  - for each LCP file: path, file size and last write time, then the reduced header information
+const char lcpIndexMagic[8] = {'A', 'V', 'L', 'C', 'P', 'I', 'D', 'X'};
+const std::uint32_t lcpIndexVersion = 1;
+
+/// Upper bound of the strings and arrays sizes, to reject corrupted index files
+const std::uint32_t lcpIndexMaxSize = 1 << 20;
+
+template<typename V>
+inline void writeValue(std::ostream& out, const V& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+}
+
+template<typename V>
+inline void readValue(std::istream& in, V& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(V));
+}
+
+inline void writeString(std::ostream& out, const std::string& str)
+{
+    writeValue(out, static_cast<std::uint32_t>(str.size()));
+    out.write(str.data(), str.size());
+}
+
+inline bool readString(std::istream& in, std::string& str)
+{
+    std::uint32_t size = 0;
+    readValue(in, size);
+    if (!in || size > lcpIndexMaxSize)
+        return false;
+    str.resize(size);
+    in.read(&str[0], size);
+    return static_cast<bool>(in);
+}
+
+/**
+ * @brief Get the size and the last write time of a file, to detect the changes since the indexing.
+ */
+void getFileStamp(const std::filesystem::path& p, std::uint64_t& out_fileSize, std::int64_t& out_lastWriteTime)
+{
+    std::error_code ec;
+    out_fileSize = std::filesystem::file_size(p, ec);
+    out_lastWriteTime = std::filesystem::last_write_time(p, ec).time_since_epoch().count();
+}
+
+/**
+ * @brief Get the cache folder of the user for AliceVision, the temporary folder of the system if it is not defined.
+ */
+std::filesystem::path getUserCacheFolder()
+{
+#if defined(_WIN32)
+    const char* localAppData = std::getenv("LOCALAPPDATA");
+    if (localAppData && *localAppData)
+        return std::filesystem::path(localAppData) / "AliceVision" / "cache";
+#else
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    if (cacheHome && *cacheHome)
+        return std::filesystem::path(cacheHome) / "aliceVision";
+    const char* home = std::getenv("HOME");
+    if (home && *home)
+    #if defined(__APPLE__)
+        return std::filesystem::path(home) / "Library" / "Caches" / "aliceVision";
+    #else
+        return std::filesystem::path(home) / ".cache" / "aliceVision";
+    #endif
+#endif
+    std::error_code ec;
+    return std::filesystem::temp_directory_path(ec) / "aliceVision";
+}
+
+}  // namespace
+
+void LCPdatabase::listDirectory(const std::filesystem::path& p)
 {
     if (std::filesystem::is_directory(p))
     {
@@ -1138,7 +1222,7 @@ void LCPdatabase::loadDirectory(const std::filesystem::path& p)
             sortedPaths.push_back(x.path());
         std::sort(sortedPaths.begin(), sortedPaths.end());
         for (auto&& x : sortedPaths)
-            loadDirectory(x);
+            listDirectory(x);
     }
     else if (std::filesystem::is_regular_file(p) && (p.extension() == ".lcp"))
     {
@@ -1146,6 +1230,25 @@ void LCPdatabase::loadDirectory(const std::filesystem::path& p)
     }
 }
 
+void LCPdatabase::loadDirectory(const std::filesystem::path& p, const std::string& indexFilepath)
+{
+    if (p.empty())
+        return;
+
+    listDirectory(p);
+
+    // without index file, the headers are parsed on demand
+    _lcpHeadersParsed.reset(new std::once_flag[_lcpFilepaths.size()]);
+    _lcpIndexPerKey.clear();
+    if (!indexFilepath.empty())
+        buildIndex(indexFilepath);
+
+    // the profiles are loaded on demand
+    _lcpProfiles.clear();
+    _lcpProfiles.resize(_lcpFilepaths.size());
+    _lcpProfilesLoaded.reset(new std::once_flag[_lcpFilepaths.size()]);
+}
+
 std::string reduceString(const std::string& str)
 {
     std::string s = str;
@@ -1168,25 +1271,297 @@ std::vector<std::string> reduceStrings(const std::vector<std::string>& v_str)
     return v_localStr;
 }
 
-LCPinfo* LCPdatabase::retrieveLCP(const std::string& lcpFilepath)
+std::string getDefaultLCPIndexFilepath(const std::string& lcpFolder)
+{
+    std::error_code ec;
+    if (lcpFolder.empty() || !std::filesystem::is_directory(lcpFolder, ec))
+        return "";
+
+    // one index per database folder, named after a hash stable across runs and builds (FNV-1a)
+    const std::string folder = std::filesystem::weakly_canonical(lcpFolder, ec).string();
+    std::uint64_t folderHash = 14695981039346656037ull;
+    for (const char c : folder)
+    {
+        folderHash ^= static_cast<unsigned char>(c);
+        folderHash *= 1099511628211ull;
+    }
+    std::ostringstream filename;
+    filename << "lcpIndex_" << std::hex << std::setfill('0') << std::setw(16) << folderHash << ".bin";
+
+    return (getUserCacheFolder() / filename.str()).string();
+}
+
+void LCPdatabase::parseHeader(LcpPath& lcpPath)
+{
+    LcpHeader& header = lcpPath.header;
+
+    try
+    {
+        const LCPinfo lcpHeader(lcpPath.path.string(), false);
+
+        header.reducedCameraMaker = reduceString(lcpHeader.getCameraMaker());
+        header.reducedCameraModel = reduceString(lcpHeader.getCameraModel());
+        header.reducedCameraPrettyName = reduceString(lcpHeader.getCameraPrettyName());
+        header.reducedLensPrettyName = reduceString(lcpHeader.getLensPrettyName());
+
+        std::vector<std::string> lensModels;
+        lcpHeader.getLensModels(lensModels);
+        header.reducedLensModels = reduceStrings(lensModels);
+
+        lcpHeader.getLensIDs(header.lensIDs);
+        header.isRaw = lcpHeader.isRawProfile();
+        header.isValid = true;
+    }
+    catch (const std::exception& e)
+    {
+        ALICEVISION_LOG_WARNING("Cannot parse the LCP file header \"" << lcpPath.path.string() << "\": " << e.what());
+    }
+}
+
+const LCPdatabase::LcpHeader& LCPdatabase::getHeader(std::size_t lcpIndex)
+{
+    LcpPath& lcpPath = _lcpFilepaths[lcpIndex];
+    std::call_once(_lcpHeadersParsed[lcpIndex], [&]() { parseHeader(lcpPath); });
+    return lcpPath.header;
+}
+
+void LCPdatabase::buildIndex(const std::string& indexFilepath)
+{
+    std::map<std::string, LcpHeader> indexedHeaders;
+    if (std::filesystem::exists(indexFilepath))
+    {
+        if (!readIndex(indexFilepath, indexedHeaders))
+        {
+            ALICEVISION_LOG_WARNING("Invalid LCP index file, it will be rebuilt: \"" << indexFilepath << "\"");
+            indexedHeaders.clear();
+        }
+    }
+
+    // Reuse the indexed headers of the unchanged files
+    std::vector<std::size_t> filesToParse;
+    for (std::size_t i = 0; i < _lcpFilepaths.size(); ++i)
+    {
+        LcpPath& lcpPath = _lcpFilepaths[i];
+
+        std::uint64_t fileSize = 0;
+        std::int64_t lastWriteTime = 0;
+        getFileStamp(lcpPath.path, fileSize, lastWriteTime);
+
+        const auto headerIt = indexedHeaders.find(lcpPath.path.string());
+        if (headerIt != indexedHeaders.end() && headerIt->second.fileSize == fileSize && headerIt->second.lastWriteTime == lastWriteTime)
+        {
+            std::call_once(_lcpHeadersParsed[i], [&]() { lcpPath.header = headerIt->second; });
+        }
+        else
+        {
+            lcpPath.header = LcpHeader();
+            lcpPath.header.fileSize = fileSize;
+            lcpPath.header.lastWriteTime = lastWriteTime;
+            filesToParse.push_back(i);
+        }
+    }
+
+    ALICEVISION_LOG_DEBUG("LCP index: " << _lcpFilepaths.size() - filesToParse.size() << " header(s) reused, " << filesToParse.size()
+                                        << " header(s) to parse.");
+
+    // Parse the headers of the new or modified files
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(filesToParse.size()); ++i)
+    {
+        getHeader(filesToParse[i]);
+    }
+
+    // all the headers are parsed: the exact matches are found without scanning the database
+    buildProfileKeys();
+
+    if (!filesToParse.empty() || indexedHeaders.size() != _lcpFilepaths.size())
+    {
+        if (writeIndex(indexFilepath))
+        {
+            ALICEVISION_LOG_INFO("LCP index file updated: \"" << indexFilepath << "\"");
+        }
+        else
+        {
+            ALICEVISION_LOG_WARNING("Cannot write the LCP index file: \"" << indexFilepath << "\"");
+        }
+    }
+}
+
+void LCPdatabase::buildProfileKeys()
+{
+    _lcpIndexPerKey.clear();
+
+    for (std::size_t i = 0; i < _lcpFilepaths.size(); ++i)
+    {
+        const LcpPath& lcpPath = _lcpFilepaths[i];
+        const LcpHeader& lcpHeader = lcpPath.header;
+        // like in the search, the filepath must contain the camera maker
+        if (!lcpHeader.isValid || lcpPath.reducedPath.find(lcpHeader.reducedCameraMaker) == std::string::npos)
+            continue;
+
+        const std::string& reducedCameraModel = _omitCameraModel ? lcpHeader.reducedCameraMaker : lcpHeader.reducedCameraModel;
+        const std::string* cameraNames[] = {&reducedCameraModel, &lcpHeader.reducedCameraPrettyName};
+        std::vector<const std::string*> lensNames = {&lcpHeader.reducedLensPrettyName};
+        for (const std::string& reducedLensModel : lcpHeader.reducedLensModels)
+            lensNames.push_back(&reducedLensModel);
+        const int rawModes[] = {0, lcpHeader.isRaw ? 1 : 2};
+
+        // the files are sorted by name, the first file matching a key is kept like in the search
+        for (const std::string* cameraName : cameraNames)
+            for (const std::string* lensName : lensNames)
+                for (const int lensID : lcpHeader.lensIDs)
+                    for (const int rawMode : rawModes)
+                        _lcpIndexPerKey.emplace(LcpKey(lcpHeader.reducedCameraMaker, *cameraName, *lensName, lensID, rawMode), i);
+    }
+}
+
+bool LCPdatabase::readIndex(const std::string& indexFilepath, std::map<std::string, LcpHeader>& out_headers)
+{
+    std::ifstream in(indexFilepath, std::ios::binary);
+    if (!in)
+        return false;
+
+    char magic[sizeof(lcpIndexMagic)];
+    std::uint32_t version = 0;
+    std::uint32_t nbFiles = 0;
+    in.read(magic, sizeof(magic));
+    readValue(in, version);
+    readValue(in, nbFiles);
+
+    if (!in || std::memcmp(magic, lcpIndexMagic, sizeof(magic)) != 0 || version != lcpIndexVersion)
+        return false;
+
+    for (std::uint32_t i = 0; i < nbFiles; ++i)
+    {
+        std::string path;
+        LcpHeader header;
+        std::uint8_t isValid = 0;
+        std::uint8_t isRaw = 0;
+        std::uint32_t nbLensModels = 0;
+        std::uint32_t nbLensIDs = 0;
+
+        if (!readString(in, path))
+            return false;
+
+        readValue(in, header.fileSize);
+        readValue(in, header.lastWriteTime);
+        readValue(in, isValid);
+        readValue(in, isRaw);
+        header.isValid = (isValid != 0);
+        header.isRaw = (isRaw != 0);
+
+        if (!readString(in, header.reducedCameraMaker) || !readString(in, header.reducedCameraModel) ||
+            !readString(in, header.reducedCameraPrettyName) || !readString(in, header.reducedLensPrettyName))
+            return false;
+
+        readValue(in, nbLensModels);
+        if (!in || nbLensModels > lcpIndexMaxSize)
+            return false;
+        header.reducedLensModels.resize(nbLensModels);
+        for (std::string& lensModel : header.reducedLensModels)
+        {
+            if (!readString(in, lensModel))
+                return false;
+        }
+
+        readValue(in, nbLensIDs);
+        if (!in || nbLensIDs > lcpIndexMaxSize)
+            return false;
+        header.lensIDs.resize(nbLensIDs);
+        for (int& lensID : header.lensIDs)
+        {
+            std::int32_t value = 0;
+            readValue(in, value);
+            lensID = value;
+        }
+
+        if (!in)
+            return false;
+
+        out_headers.emplace(std::move(path), std::move(header));
+    }
+
+    return true;
+}
+
+bool LCPdatabase::writeIndex(const std::string& indexFilepath) const
 {
-    if (lcpFilepath.empty())
+    const std::filesystem::path indexPath(indexFilepath);
+    if (indexPath.has_parent_path())
     {
-        return nullptr;
+        std::error_code ec;
+        std::filesystem::create_directories(indexPath.parent_path(), ec);
     }
 
-    // Check if the LCP is already in the cache, or add it
-    auto lcpCacheIt = _lcpCache.find(lcpFilepath);
-    if (lcpCacheIt == _lcpCache.end())
+    // Write in a temporary file then rename it, so concurrent runs never read a partial index
+    const std::string tmpFilepath = indexFilepath + "." + std::to_string(std::random_device{}()) + ".tmp";
     {
-// If not already in the cache, add it.
-#pragma omp critical
-        _lcpCache[lcpFilepath] = LCPinfo(lcpFilepath, true);
-        lcpCacheIt = _lcpCache.find(lcpFilepath);
+        std::ofstream out(tmpFilepath, std::ios::binary);
+        if (!out)
+            return false;
+
+        out.write(lcpIndexMagic, sizeof(lcpIndexMagic));
+        writeValue(out, lcpIndexVersion);
+        writeValue(out, static_cast<std::uint32_t>(_lcpFilepaths.size()));
+
+        for (const LcpPath& lcpPath : _lcpFilepaths)
+        {
+            const LcpHeader& header = lcpPath.header;
+
+            writeString(out, lcpPath.path.string());
+            writeValue(out, header.fileSize);
+            writeValue(out, header.lastWriteTime);
+            writeValue(out, static_cast<std::uint8_t>(header.isValid));
+            writeValue(out, static_cast<std::uint8_t>(header.isRaw));
+            writeString(out, header.reducedCameraMaker);
+            writeString(out, header.reducedCameraModel);
+            writeString(out, header.reducedCameraPrettyName);
+            writeString(out, header.reducedLensPrettyName);
+
+            writeValue(out, static_cast<std::uint32_t>(header.reducedLensModels.size()));
+            for (const std::string& lensModel : header.reducedLensModels)
+                writeString(out, lensModel);
+
+            writeValue(out, static_cast<std::uint32_t>(header.lensIDs.size()));
+            for (const int lensID : header.lensIDs)
+                writeValue(out, static_cast<std::int32_t>(lensID));
+        }
+
+        if (!out)
+        {
+            out.close();
+            std::filesystem::remove(tmpFilepath);
+            return false;
+        }
     }
 
-    // return the LCPinfo from the cache
-    return &lcpCacheIt->second;
+    std::error_code ec;
+    std::filesystem::rename(tmpFilepath, indexFilepath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpFilepath, ec);
+        return false;
+    }
+    return true;
+}
+
+LCPinfo* LCPdatabase::loadLCP(std::size_t lcpIndex)
+{
+    // The profile is fully parsed by the first thread requesting it, the other ones wait for it
+    std::call_once(_lcpProfilesLoaded[lcpIndex],
+                   [&]() { _lcpProfiles[lcpIndex] = std::make_unique<LCPinfo>(_lcpFilepaths[lcpIndex].path.string(), true); });
+
+    return _lcpProfiles[lcpIndex].get();
+}
+
+LCPinfo* LCPdatabase::retrieveLCP(const std::string& lcpFilepath)
+{
+    for (std::size_t i = 0; i < _lcpFilepaths.size(); ++i)
+    {
+        if (_lcpFilepaths[i].path.string() == lcpFilepath)
+            return loadLCP(i);
+    }
+    return nullptr;
 }
 
 LCPinfo* LCPdatabase::findLCP(const std::string& cameraMake,
@@ -1199,62 +1574,41 @@ LCPinfo* LCPdatabase::findLCP(const std::string& cameraMake,
     const std::string reducedCameraModel = _omitCameraModel ? reducedCameraMake : reduceString(cameraModel);
     const std::string reducedLensModel = reduceString(lensModel);
 
-    const std::string lensUidStr = reducedCameraMake + reducedCameraModel + reducedLensModel;
-    const auto cachetoLcpPathIt = _lcpCameraMappingCache.find(lensUidStr);
-    if (cachetoLcpPathIt != _lcpCameraMappingCache.end())
-    {
-        return retrieveLCP(cachetoLcpPathIt->second);
-    }
+    // Exact match of the camera and lens names, available once the index is loaded
+    const auto keyIt = _lcpIndexPerKey.find(LcpKey(reducedCameraMake, reducedCameraModel, reducedLensModel, lensID, rawMode));
+    if (keyIt != _lcpIndexPerKey.end())
+        return loadLCP(keyIt->second);
 
-    for (const LcpPath& lcpPath : _lcpFilepaths)
+    // Partial match of the lens pretty name, or database without index
+    // Only the headers of the files of the camera maker are parsed
+    for (std::size_t i = 0; i < _lcpFilepaths.size(); ++i)
     {
+        const LcpPath& lcpPath = _lcpFilepaths[i];
+
         const bool filepathContainsMake = (lcpPath.reducedPath.find(reducedCameraMake) != std::string::npos);
         if (!filepathContainsMake)
             continue;
 
-        auto headerIt = _lcpHeaderCache.find(lcpPath.reducedPath);
-        if (headerIt == _lcpHeaderCache.end())
-        {
-            // If not already in the cache of LCP headers, add it.
-            _lcpHeaderCache[lcpPath.path.string()] = LCPinfo(lcpPath.path.string(), false);
-            headerIt = _lcpHeaderCache.find(lcpPath.path.string());
-        }
-
-        const LCPinfo& lcpHeader = headerIt->second;
-
-        const std::string reducedCameraModelLCP = reduceString(_omitCameraModel ? lcpHeader.getCameraMaker() : lcpHeader.getCameraModel());
-        const std::string reducedCameraPrettyNameLCP = reduceString(lcpHeader.getCameraPrettyName());
-        const std::string reducedLensPrettyNameLCP = reduceString(lcpHeader.getLensPrettyName());
-
-        std::vector<std::string> lensModelsLCP;
-        lcpHeader.getLensModels(lensModelsLCP);
-        const std::vector<std::string> reducedLensModelsLCP = reduceStrings(lensModelsLCP);
+        const LcpHeader& lcpHeader = getHeader(i);
+        if (!lcpHeader.isValid)
+            continue;
 
-        std::vector<int> lensIDsLCP;
-        lcpHeader.getLensIDs(lensIDsLCP);
+        const std::string& reducedCameraModelLCP = _omitCameraModel ? lcpHeader.reducedCameraMaker : lcpHeader.reducedCameraModel;
 
-        const bool cameraOK = ((reducedCameraModelLCP == reducedCameraModel) || (reducedCameraPrettyNameLCP == reducedCameraModel));
-        const bool lensOK = ((reducedLensPrettyNameLCP.find(reducedLensModel) != std::string::npos) ||
-                             (std::find(reducedLensModelsLCP.begin(), reducedLensModelsLCP.end(), reducedLensModel) != reducedLensModelsLCP.end()));
-        const bool lensIDOK = (std::find(lensIDsLCP.begin(), lensIDsLCP.end(), lensID) != lensIDsLCP.end());
-        const bool isRaw = lcpHeader.isRawProfile();
+        const bool cameraOK = ((reducedCameraModelLCP == reducedCameraModel) || (lcpHeader.reducedCameraPrettyName == reducedCameraModel));
+        const bool lensOK =
+          ((lcpHeader.reducedLensPrettyName.find(reducedLensModel) != std::string::npos) ||
+           (std::find(lcpHeader.reducedLensModels.begin(), lcpHeader.reducedLensModels.end(), reducedLensModel) != lcpHeader.reducedLensModels.end()));
+        const bool lensIDOK = (std::find(lcpHeader.lensIDs.begin(), lcpHeader.lensIDs.end(), lensID) != lcpHeader.lensIDs.end());
+        const bool isRaw = lcpHeader.isRaw;
 
         const bool lcpFound = (cameraOK && lensOK && lensIDOK && ((isRaw && rawMode < 2) || (!isRaw && (rawMode % 2 == 0))));
         if (!lcpFound)
             // The LCP does not match our image metadata
             continue;
 
-        // Add the mapping of the lens ID to the found LCP filepath
-        _lcpCameraMappingCache[lensUidStr] = lcpPath.path.string();
-
         // Return the LCP from file or cache
-        return retrieveLCP(lcpPath.path.string());
-    }
-
-    // No LCP has been found, add an empty path for that key in order to speed up next search of it
-    if (_lcpCameraMappingCache.find(lensUidStr) == _lcpCameraMappingCache.end())
-    {
-        _lcpCameraMappingCache[lensUidStr] = "";
+        return loadLCP(i);
     }
 
     return nullptr;
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <sstream>
 #include <map>
@@ -612,8 +616,22 @@ class LCPinfo
 std::string reduceString(const std::string& str);
 std::vector<std::string> reduceStrings(const std::vector<std::string>& v_str);
 
+/**
+ * @brief Get the default index filepath of a LCP database, in the cache folder of the user
+ *        (XDG_CACHE_HOME or ~/.cache on Linux, ~/Library/Caches on macOS, LOCALAPPDATA on Windows).
+ * @param[in] lcpFolder The folder containing all lcp files
+ * @return the index filepath, empty if the LCP database is not a folder
+ */
+std::string getDefaultLCPIndexFilepath(const std::string& lcpFolder);
+
 /**
  * @brief LCPdatabase allows to access all the LCP files in the database.
+ * @details Without index file, the header of a LCP file is parsed by the first search of its camera maker.
+ *          With an index file, the headers of all the LCP files are parsed once when the database is loaded (in parallel),
+ *          and stored in the binary index file to be reused by the next runs.
+ *          The profiles are then also keyed by their camera and lens names, so the exact matches are found without scanning the database.
+ *          Each header and each profile is parsed once by the first thread requesting it,
+ *          so the database can be used concurrently without locking.
  */
 class LCPdatabase
 {
@@ -622,24 +640,35 @@ class LCPdatabase
     /**
      * @brief LCPdatabase constructor
      * @param[in] folder The folder containing all lcp files
+     * @param[in] omitCameraModel The search considers only the camera maker and the lens (default is false)
+     * @param[in] indexFilepath The binary index of the LCP headers, reused and updated across runs (no index file if empty)
      */
-    LCPdatabase(const std::string& folder, bool omitCameraModel = false)
+    LCPdatabase(const std::string& folder, bool omitCameraModel = false, const std::string& indexFilepath = "")
       : _omitCameraModel(omitCameraModel)
     {
-        loadDirectory(folder);
+        loadDirectory(folder, indexFilepath);
     }
     ~LCPdatabase() = default;
 
+    LCPdatabase(const LCPdatabase&) = delete;
+    LCPdatabase& operator=(const LCPdatabase&) = delete;
+
     bool empty() const { return _lcpFilepaths.empty(); }
 
     size_t size() const { return _lcpFilepaths.size(); }
 
-    void loadDirectory(const std::filesystem::path& p);
+    /**
+     * @brief Add all the LCP files of a directory (or a single LCP file) to the database and index their headers.
+     * @param[in] p The LCP file or directory path
+     * @param[in] indexFilepath The binary index of the LCP headers, reused and updated across runs (no index file if empty)
+     */
+    void loadDirectory(const std::filesystem::path& p, const std::string& indexFilepath = "");
 
-    LCPinfo* retrieveLCP() { return retrieveLCP(_lcpFilepaths.begin()->path.string()); }
+    LCPinfo* retrieveLCP() { return loadLCP(0); }
 
     /**
-     * @brief Get the LCP from filepath. Retrieve it from cache or load it into the cache.
+     * @brief Get the LCP from filepath. Load it on the first call.
+     * @return nullptr if the file is not in the database
      */
     LCPinfo* retrieveLCP(const std::string& p);
 
@@ -655,12 +684,28 @@ class LCPdatabase
      *            0 : no matter about raw status
      *            1 : only raw profile are considered in the search
      *            2 : only non raw profile are considered in the search
-     * @param[in] omitCameraModel cameraModelOrMaker contains only the camera maker (default is false)
      * @return pointer to the found LCPinfo
      */
     LCPinfo* findLCP(const std::string& cameraMake, const std::string& cameraModel, const std::string& lensModel, const int lensID, int rawMode);
 
   private:
+    /// Reduced camera and lens information of a LCP file header, used by the search
+    struct LcpHeader
+    {
+        /// Size and last write time of the file when the header was parsed
+        std::uint64_t fileSize = 0;
+        std::int64_t lastWriteTime = 0;
+        /// The header has been successfully parsed
+        bool isValid = false;
+        bool isRaw = false;
+        std::string reducedCameraMaker;
+        std::string reducedCameraModel;
+        std::string reducedCameraPrettyName;
+        std::string reducedLensPrettyName;
+        std::vector<std::string> reducedLensModels;
+        std::vector<int> lensIDs;
+    };
+
     struct LcpPath
     {
         LcpPath(const std::filesystem::path& p)
@@ -669,16 +714,45 @@ class LCPdatabase
         {}
         std::filesystem::path path;
         std::string reducedPath;
+        LcpHeader header;
     };
 
+    /// List the LCP files of a directory
+    void listDirectory(const std::filesystem::path& p);
+
+    /// Get the headers of the listed files from the index file or by parsing the files, update the index file
+    void buildIndex(const std::string& indexFilepath);
+
+    /// Parse the reduced camera and lens information of a LCP file header
+    static void parseHeader(LcpPath& lcpPath);
+
+    /// Key the valid headers by reduced camera maker, camera model, lens, lens ID and raw mode, all the headers must be parsed
+    void buildProfileKeys();
+
+    /// Get the header of a LCP file from its index in the database. Parse it on the first call.
+    const LcpHeader& getHeader(std::size_t lcpIndex);
+
+    /// Read the LCP headers stored in an index file, per LCP filepath
+    static bool readIndex(const std::string& indexFilepath, std::map<std::string, LcpHeader>& out_headers);
+
+    /// Write the LCP headers of the database in an index file
+    bool writeIndex(const std::string& indexFilepath) const;
+
+    /// Get the LCP from its index in the database. Load it on the first call.
+    LCPinfo* loadLCP(std::size_t lcpIndex);
+
     /// List of all LCP files
     std::vector<LcpPath> _lcpFilepaths;
-    /// Cache the header of LCP files
-    std::map<std::string, LCPinfo> _lcpHeaderCache;
-    /// Cache of fully loaded LCP files
-    std::map<std::string, LCPinfo> _lcpCache;
-    /// Map the label from the camera to the matching LCP filepath
-    std::map<std::string, std::string> _lcpCameraMappingCache;
+    /// Parse each LCP file header once
+    std::unique_ptr<std::once_flag[]> _lcpHeadersParsed;
+    /// Fully loaded LCP files, loaded on demand
+    std::vector<std::unique_ptr<LCPinfo>> _lcpProfiles;
+    /// Load each LCP file once
+    std::unique_ptr<std::once_flag[]> _lcpProfilesLoaded;
+    /// Reduced camera maker, camera model, lens, lens ID and raw mode of a profile
+    using LcpKey = std::tuple<std::string, std::string, std::string, int, int>;
+    /// Index in the database of the first LCP file matching a key, built when the index file is loaded
+    std::map<LcpKey, std::size_t> _lcpIndexPerKey;
     /// The matching could be strict and fully match the camera Make, Model and Lens.
     /// As we are looking for lens information, we can omit the CameraModel to get generic values valid for more lenses.
     bool _omitCameraModel = false;
@@ -0,0 +1,170 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/lensCorrectionProfile/lcp.hpp>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define BOOST_TEST_MODULE lensCorrectionProfile
+
+#include <boost/test/unit_test.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Write a minimal LCP file with a single camera profile.
+ * @param[in] path the LCP file path
+ * @param[in] lens the lens model
+ * @param[in] lensID the lens ID
+ */
+void writeLCP(const fs::path& path, const std::string& lens, int lensID)
+{
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path.string());
+    out << "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\">"
+        << "<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">"
+        << "<rdf:Description><photoshop:CameraProfiles><rdf:Seq><rdf:li>"
+        << "<rdf:Description stCamera:Make=\"Canon\" stCamera:Model=\"Canon EOS 5D\" stCamera:Lens=\"" << lens << "\""
+        << " stCamera:LensID=\"" << lensID << "\" stCamera:CameraRawProfile=\"True\""
+        << " stCamera:LensPrettyName=\"Canon " << lens << "\" stCamera:CameraPrettyName=\"Canon EOS 5D\"/>"
+        << "</rdf:li></rdf:Seq></photoshop:CameraProfiles></rdf:Description></rdf:RDF></x:xmpmeta>\n";
+}
+
+bool findLens(LCPdatabase& database, const std::string& lens, int lensID)
+{
+    LCPinfo* lcp = database.findLCP("Canon", "Canon EOS 5D", lens, lensID, 1);
+    return lcp != nullptr && lcp->getLensPrettyName() == "Canon " + lens;
+}
+
+}  // namespace
+
+// Test summary:
+// - Search the profiles of a database without index file
+// - Check that the headers are parsed on demand
+BOOST_AUTO_TEST_CASE(LCPdatabase_withoutIndex)
+{
+    const fs::path folder = fs::temp_directory_path() / "lcp_test_withoutIndex";
+    fs::remove_all(folder);
+    writeLCP(folder / "db" / "Canon" / "lens1.lcp", "EF1 50mm", 1);
+    writeLCP(folder / "db" / "Canon" / "lens2.lcp", "EF2 50mm", 2);
+
+    LCPdatabase database((folder / "db").string());
+
+    BOOST_CHECK_EQUAL(database.size(), 2);
+    BOOST_CHECK(findLens(database, "EF2 50mm", 2));
+    BOOST_CHECK(!findLens(database, "EF2 50mm", 1));
+    BOOST_CHECK(database.findLCP("Nikon", "Nikon D800", "EF1 50mm", 1, 1) == nullptr);
+
+    fs::remove_all(folder);
+}
+
+// Test summary:
+// - Write the index file of a database, then load the database again with this index
+// - Check that the indexed headers of the unchanged files are reused
+// - Check that the modified, added and removed files invalidate their indexed headers
+// - Check that an invalid index file is rebuilt
+BOOST_AUTO_TEST_CASE(LCPdatabase_index)
+{
+    const fs::path folder = fs::temp_directory_path() / "lcp_test_index";
+    fs::remove_all(folder);
+    const fs::path dbFolder = folder / "db";
+    const std::string indexFilepath = (folder / "index" / "lcp.index").string();
+
+    writeLCP(dbFolder / "Canon" / "lens1.lcp", "EF1 50mm", 1);
+    writeLCP(dbFolder / "Canon" / "lens2.lcp", "EF2 50mm", 2);
+
+    // write the index
+    {
+        LCPdatabase database(dbFolder.string(), false, indexFilepath);
+        BOOST_CHECK(fs::exists(indexFilepath));
+        BOOST_CHECK(findLens(database, "EF1 50mm", 1));
+        BOOST_CHECK(findLens(database, "EF2 50mm", 2));
+        // the camera pretty name, any raw status, a raw profile for non raw images
+        BOOST_CHECK(database.findLCP("Canon", "Canon EOS 5D", "EF1 50mm", 1, 0) == database.findLCP("Canon", "Canon EOS 5D", "EF1 50mm", 1, 1));
+        BOOST_CHECK(database.findLCP("Canon", "Canon EOS 5D", "EF1 50mm", 1, 2) == nullptr);
+        // partial match of the lens pretty name, found by the scan of the database
+        BOOST_CHECK(database.findLCP("Canon", "Canon EOS 5D", "EF1", 1, 1) == database.findLCP("Canon", "Canon EOS 5D", "EF1 50mm", 1, 1));
+        BOOST_CHECK(database.findLCP("Nikon", "Canon EOS 5D", "EF1 50mm", 1, 1) == nullptr);
+    }
+
+    // same file size and last write time: the indexed header is reused, the file is not parsed again
+    const fs::path lens2Path = dbFolder / "Canon" / "lens2.lcp";
+    const fs::file_time_type lens2WriteTime = fs::last_write_time(lens2Path);
+    writeLCP(lens2Path, "EF2 50mm", 3);
+    fs::last_write_time(lens2Path, lens2WriteTime);
+    {
+        LCPdatabase database(dbFolder.string(), false, indexFilepath);
+        BOOST_CHECK(findLens(database, "EF2 50mm", 2));
+        BOOST_CHECK(!findLens(database, "EF2 50mm", 3));
+    }
+
+    // modified, added and removed files
+    writeLCP(lens2Path, "EF2 50mm", 30);
+    writeLCP(dbFolder / "Canon" / "lens3.lcp", "EF3 50mm", 4);
+    fs::remove(dbFolder / "Canon" / "lens1.lcp");
+    {
+        LCPdatabase database(dbFolder.string(), false, indexFilepath);
+        BOOST_CHECK_EQUAL(database.size(), 2);
+        BOOST_CHECK(!findLens(database, "EF1 50mm", 1));
+        BOOST_CHECK(!findLens(database, "EF2 50mm", 2));
+        BOOST_CHECK(findLens(database, "EF2 50mm", 30));
+        BOOST_CHECK(findLens(database, "EF3 50mm", 4));
+    }
+
+    // invalid index file
+    {
+        std::ofstream out(indexFilepath, std::ios::binary | std::ios::trunc);
+        out << "not an index";
+    }
+    {
+        LCPdatabase database(dbFolder.string(), false, indexFilepath);
+        BOOST_CHECK(findLens(database, "EF2 50mm", 30));
+        BOOST_CHECK(findLens(database, "EF3 50mm", 4));
+    }
+    {
+        // the rebuilt index is valid
+        LCPdatabase database(dbFolder.string(), false, indexFilepath);
+        BOOST_CHECK(findLens(database, "EF3 50mm", 4));
+    }
+
+    fs::remove_all(folder);
+}
+
+// Test summary:
+// - Check the default index filepath of a database folder, in the cache folder of the user
+BOOST_AUTO_TEST_CASE(LCPdatabase_defaultIndexFilepath)
+{
+    const fs::path folder = fs::temp_directory_path() / "lcp_test_defaultIndex";
+    fs::remove_all(folder);
+    writeLCP(folder / "db" / "Canon" / "lens1.lcp", "EF1 50mm", 1);
+
+    const std::string indexFilepath = getDefaultLCPIndexFilepath((folder / "db").string());
+    BOOST_CHECK(!indexFilepath.empty());
+    BOOST_CHECK_EQUAL(indexFilepath, getDefaultLCPIndexFilepath((folder / "db" / "Canon" / "..").string()));
+
+    // no index for a single file or an empty path
+    BOOST_CHECK(getDefaultLCPIndexFilepath((folder / "db" / "Canon" / "lens1.lcp").string()).empty());
+    BOOST_CHECK(getDefaultLCPIndexFilepath("").empty());
+
+#ifndef _WIN32
+    // in the cache folder of the user
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    const std::string previousCacheHome = cacheHome ? cacheHome : "";
+    setenv("XDG_CACHE_HOME", (folder / "cache").string().c_str(), 1);
+    BOOST_CHECK_EQUAL(fs::path(getDefaultLCPIndexFilepath((folder / "db").string())).parent_path(), folder / "cache" / "aliceVision");
+    if (cacheHome)
+        setenv("XDG_CACHE_HOME", previousCacheHome.c_str(), 1);
+    else
+        unsetenv("XDG_CACHE_HOME");
+#endif
+
+    fs::remove_all(folder);
+}
@@ -28,7 +28,9 @@ struct LocalizerParameters
         _resectionEstimator(robustEstimation::ERobustEstimator::ACRANSAC),
         _matchingEstimator(robustEstimation::ERobustEstimator::ACRANSAC),
         _useLocalizeRigNaive(false),
-        _angularThreshold(degreeToRadian(0.1))
+        _angularThreshold(degreeToRadian(0.1)),
+        _nbRansacThreads(1),
+        _useSPRT(false)
     {
         _featurePreset.setDescPreset(feature::EImageDescriberPreset::ULTRA);
     }
@@ -53,6 +55,10 @@ struct LocalizerParameters
     bool _useLocalizeRigNaive;
     /// in rad, it is the maximum angular error for the opengv rig resection
     double _angularThreshold;
+    /// number of threads evaluating the hypotheses of the robust estimations (1: sequential, 0: all the available cores)
+    std::size_t _nbRansacThreads;
+    /// stop the scoring of the bad hypotheses early with a SPRT (LORANSAC resection and matching)
+    bool _useSPRT;
 };
 
 inline LocalizerParameters::~LocalizerParameters() {}
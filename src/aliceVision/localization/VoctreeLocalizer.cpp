@@ -448,7 +448,9 @@ bool VoctreeLocalizer::localizeFirstBestResult(const feature::MapRegionsPerDesc&
                                           std::make_pair(matchedView->getImage().getWidth(), matchedView->getImage().getHeight()),
                                           randomNumberGenerator,
                                           featureMatches,
-                                          param._matchingEstimator);
+                                          param._matchingEstimator,
+                                          param._nbRansacThreads,
+                                          param._useSPRT);
         if (!matchWorked)
         {
             ALICEVISION_LOG_DEBUG("[matching]\tMatching with " << matchedView->getImage().getImagePath() << " failed! Skipping image");
@@ -515,6 +517,8 @@ bool VoctreeLocalizer::localizeFirstBestResult(const feature::MapRegionsPerDesc&
         // estimate the pose
         // Do the resectioning: compute the camera pose.
         resectionData.error_max = param._errorMax;
+        resectionData.nbThreads = param._nbRansacThreads;
+        resectionData.useSPRT = param._useSPRT;
         ALICEVISION_LOG_DEBUG("[poseEstimation]\tEstimating camera pose...");
         bool bResection = sfm::SfMLocalizer::localize(queryImageSize,
                                                       // pass the input intrinsic if they are valid, null otherwise
@@ -632,6 +636,8 @@ bool VoctreeLocalizer::localizeAllResults(const feature::MapRegionsPerDesc& quer
     // estimate the pose
     // Do the resectioning: compute the camera pose.
     resectionData.error_max = param._errorMax;
+    resectionData.nbThreads = param._nbRansacThreads;
+    resectionData.useSPRT = param._useSPRT;
     ALICEVISION_LOG_DEBUG("[poseEstimation]\tEstimating camera pose...");
     const bool bResection = sfm::SfMLocalizer::localize(queryImageSize,
                                                         // pass the input intrinsic if they are valid, null otherwise
@@ -816,7 +822,9 @@ void VoctreeLocalizer::getAllAssociations(const feature::MapRegionsPerDesc& quer
                                                 std::make_pair(matchedView->getImage().getWidth(), matchedView->getImage().getHeight()),
                                                 randomNumberGenerator,
                                                 featureMatches,
-                                                param._matchingEstimator);
+                                                param._matchingEstimator,
+                                                param._nbRansacThreads,
+                                                param._useSPRT);
         if (!matchWorked)
         {
             //      ALICEVISION_LOG_DEBUG("[matching]\tMatching with " << matchedView->getImage().getImagePath() << " failed! Skipping image");
@@ -986,7 +994,9 @@ void VoctreeLocalizer::getAssociationsFromBuffer(matching::RegionsDatabaseMatche
                                           frameImageSize,
                                           randomNumberGenerator,
                                           featureMatches,
-                                          param._matchingEstimator);
+                                          param._matchingEstimator,
+                                          param._nbRansacThreads,
+                                          param._useSPRT);
         if (!matchWorked)
         {
             continue;
@@ -1039,7 +1049,9 @@ bool VoctreeLocalizer::robustMatching(
   const std::pair<std::size_t, std::size_t>& imageSizeJ,  // size of the second image
   std::mt19937& randomNumberGenerator,
   matching::MatchesPerDescType& out_featureMatches,
-  robustEstimation::ERobustEstimator estimator) const
+  robustEstimation::ERobustEstimator estimator,
+  std::size_t nbRansacThreads,
+  bool useSPRT) const
 {
     // get the intrinsics of the query camera
     if ((queryIntrinsicsBase != nullptr) && !isPinhole(queryIntrinsicsBase->getType()))
@@ -1080,6 +1092,8 @@ bool VoctreeLocalizer::robustMatching(
 
     // perform the geometric filtering
     matchingImageCollection::GeometricFilterMatrix_F_AC geometricFilter(matchingError, 5000, estimator);
+    geometricFilter.m_nbThreads = nbRansacThreads;
+    geometricFilter.m_useSPRT = useSPRT;
 
     matching::MatchesPerDescType geometricInliersPerType;
     EstimationStatus estimationState = geometricFilter.geometricEstimation(matchers.getDatabaseRegionsPerDesc(),
@@ -300,6 +300,8 @@ class VoctreeLocalizer : public ILocalizer
      * @param[in] imageSizeJ
      * @param[out] vec_featureMatches
      * @param[in] estimator
+     * @param[in] nbRansacThreads number of threads evaluating the robust estimation hypotheses (1: sequential, 0: all the available cores)
+     * @param[in] useSPRT stop the scoring of the bad hypotheses early with a SPRT (LORANSAC only)
      * @return
      */
     bool robustMatching(matching::RegionsDatabaseMatcherPerDesc& matchers,
@@ -314,7 +316,9 @@ class VoctreeLocalizer : public ILocalizer
                         const std::pair<size_t, size_t>& imageSizeJ,  // size of the query image
                         std::mt19937& randomNumberGenerator,
                         matching::MatchesPerDescType& out_featureMatches,
-                        robustEstimation::ERobustEstimator estimator = robustEstimation::ERobustEstimator::ACRANSAC) const;
+                        robustEstimation::ERobustEstimator estimator = robustEstimation::ERobustEstimator::ACRANSAC,
+                        std::size_t nbRansacThreads = 1,
+                        bool useSPRT = false) const;
 
     void getAssociationsFromBuffer(matching::RegionsDatabaseMatcherPerDesc& matchers,
                                    const std::pair<std::size_t, std::size_t>& imageSize,
@@ -28,7 +28,9 @@ struct GeometricFilterMatrix
     GeometricFilterMatrix(double precision, double precisionRobust, std::size_t stIteration)
       : m_dPrecision(precision),
         m_dPrecision_robust(precisionRobust),
-        m_stIteration(stIteration)
+        m_stIteration(stIteration),
+        m_nbThreads(1),
+        m_useSPRT(false)
     {}
 
     /**
@@ -49,6 +51,8 @@ struct GeometricFilterMatrix
     double m_dPrecision;  // upper_bound precision used for robust estimation
     double m_dPrecision_robust;
     std::size_t m_stIteration;  // maximal number of iteration for robust estimation
+    std::size_t m_nbThreads;    // number of threads evaluating the robust estimation hypotheses (1: sequential, 0: all the cores)
+    bool m_useSPRT;             // stop the scoring of the bad hypotheses early with a SPRT (LORANSAC only)
 };
 
 }  // namespace matchingImageCollection
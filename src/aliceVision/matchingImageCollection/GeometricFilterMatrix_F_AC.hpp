@@ -240,7 +240,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         robustEstimation::Mat3Model model;
         const std::pair<double, double> ACRansacOut =
-          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision);
+          ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upper_bound_precision, m_nbThreads);
 
         m_F = model.getMatrix();
 
@@ -287,7 +287,7 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         ModelT_ model;
         const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision);
+          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, out_inliers, m_stIteration, &model, upperBoundPrecision, m_nbThreads);
         m_F = model.getMatrix();
 
         if (out_inliers.empty())
@@ -332,9 +332,18 @@ struct GeometricFilterMatrix_F_AC : public GeometricFilterMatrix
 
         //@fixme scorer should be using the pixel error, not the squared version, refactoring needed
         const double normalizedThreshold = Square(m_dPrecision * kernel.thresholdNormalizer());
-        robustEstimation::ScoreEvaluator<KernelT> scorer(normalizedThreshold);
+        robustEstimation::Mat3Model model;
 
-        robustEstimation::Mat3Model model = robustEstimation::LO_RANSAC(kernel, scorer, randomNumberGenerator, &out_inliers);
+        if (m_useSPRT)
+        {
+            const robustEstimation::SPRTScoreEvaluator<KernelT> scorer(normalizedThreshold);
+            model = robustEstimation::LO_RANSAC(kernel, scorer, randomNumberGenerator, &out_inliers, nullptr, false, 100, 1e-2, m_nbThreads);
+        }
+        else
+        {
+            const robustEstimation::ScoreEvaluator<KernelT> scorer(normalizedThreshold);
+            model = robustEstimation::LO_RANSAC(kernel, scorer, randomNumberGenerator, &out_inliers, nullptr, false, 100, 1e-2, m_nbThreads);
+        }
         m_F = model.getMatrix();
 
         if (out_inliers.empty())
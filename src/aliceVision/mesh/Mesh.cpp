@@ -6,7 +6,9 @@
 
 #include "Mesh.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mesh/MeshConnectivity.hpp>
 #include <aliceVision/mesh/meshVisibility.hpp>
+#include <aliceVision/mesh/triangleRasterization.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
@@ -35,6 +37,23 @@ Mesh::Mesh() {}
 
 Mesh::~Mesh() {}
 
+const MeshConnectivity& Mesh::getConnectivity() const
+{
+    std::lock_guard<std::mutex> lock(_connectivityCache.mutex);
+
+    std::shared_ptr<const MeshConnectivity>& connectivity = _connectivityCache.connectivity;
+    // rebuild if the mesh has been resized without releasing the connectivity
+    if (!connectivity || connectivity->getNbPoints() != pts.size() || connectivity->getNbTriangles() != tris.size())
+        connectivity = std::make_shared<const MeshConnectivity>(*this);
+    return *connectivity;
+}
+
+void Mesh::clearConnectivity()
+{
+    std::lock_guard<std::mutex> lock(_connectivityCache.mutex);
+    _connectivityCache.connectivity.reset();
+}
+
 std::string EFileType_enumToString(const EFileType meshFileType)
 {
     switch (meshFileType)
@@ -157,6 +176,8 @@ void Mesh::save(const std::string& filepath)
 
 bool Mesh::loadFromBin(const std::string& binFilepath)
 {
+    clearConnectivity();
+
     FILE* f = fopen(binFilepath.c_str(), "rb");
 
     if (f == nullptr)
@@ -205,6 +226,8 @@ void Mesh::saveToBin(const std::string& binFilepath)
 
 void Mesh::addMesh(const Mesh& mesh)
 {
+    clearConnectivity();
+
     const std::size_t npts = pts.size();
 
     pts.reserveAdd(mesh.pts.size());
@@ -539,88 +562,35 @@ bool Mesh::doesTriangleIntersectsRectangle(Mesh::triangle_proj& tp, Mesh::rectan
 
 void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
 {
-    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
-    StaticVector<Voxel> vertexNeighborhoodPairs;
-    vertexNeighborhoodPairs.reserve(tris.size() * 3);
-    for (int i = 0; i < tris.size(); ++i)
-    {
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[0], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[1], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[2], i, 0));
-    }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    const MeshConnectivity& connectivity = getConnectivity();
 
-    int i = 0;  // index of the unique pair of <vertex, neighborhood>
-    int j = 0;  // index of the vertex
-    int k = 0;  // number of neighbors
-    int firstid = 0;
-    while (i < vertexNeighborhoodPairs.size())
-    {
-        ++k;
-        // (*vertexNeighborhoodPairs)[i].z = j;
-        if ((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
-        {
-            vertexNeighborhoodPairs[firstid].z = k;  // store the number of neighbors
-            ++j;
-            firstid = i + 1;
-            k = 0;
-        }
-        ++i;
-    }
-    int npts = j;
-
-    out_ptsNeighTris.reserve(pts.size());
     out_ptsNeighTris.resize(pts.size());
 
-    i = 0;
-    for (j = 0; j < npts; ++j)
-    {
-        int middlePtId = vertexNeighborhoodPairs[i].x;
-        int nbNeighbors = vertexNeighborhoodPairs[i].z;
-        int i0 = i;
-        int i1 = i + nbNeighbors;
-        i = i1;
-
-        StaticVector<int>& triTmp = out_ptsNeighTris[middlePtId];
-        triTmp.reserve(nbNeighbors);
-        for (int l = i0; l < i1; ++l)
-        {
-            triTmp.push_back(vertexNeighborhoodPairs[l].y);  // index of triangle
-        }
-    }
-}
-
-void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
-{
-    out_ptsNeigh.resize(pts.size());
-    for (int triangleId = 0; triangleId < tris.size(); ++triangleId)
+#pragma omp parallel for
+    for (int ptId = 0; ptId < pts.size(); ++ptId)
     {
-        const Mesh::triangle& triangle = tris[triangleId];
-        for (int k = 0; k < 3; ++k)
-        {
-            int ptId = triangle.v[k];
-            std::vector<int>& ptNeigh = out_ptsNeigh[ptId];
-            if (std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k + 1) % 3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k + 1) % 3]);
-            if (std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k + 2) % 3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k + 2) % 3]);
-        }
+        const MeshConnectivity::Range ptTris = connectivity.getPointTriangles(ptId);
+        out_ptsNeighTris[ptId].getDataWritable().assign(ptTris.begin(), ptTris.end());
     }
 }
 
 void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPts) const
 {
-    StaticVector<StaticVector<int>> ptsNeighborTriangles;
-    getPtsNeighborTriangles(ptsNeighborTriangles);
+    const MeshConnectivity& connectivity = getConnectivity();
 
     out_ptsNeighPts.resize(pts.size());
 
+#pragma omp parallel for schedule(dynamic, 1024)
     for (int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
     {
-        StaticVector<int>& neighborTriangles = ptsNeighborTriangles[middlePtId];
-        if (neighborTriangles.empty())
+        const MeshConnectivity::Range ptTris = connectivity.getPointTriangles(middlePtId);
+        if (ptTris.empty())
             continue;
 
+        // local copy, the triangles are removed while walking around the point
+        StaticVector<int> neighborTriangles;
+        neighborTriangles.getDataWritable().assign(ptTris.begin(), ptTris.end());
+
         StaticVector<int> vhid;
         vhid.reserve(neighborTriangles.size() * 2);
         int currentTriPtId = tris[neighborTriangles[0]].v[0];
@@ -703,18 +673,8 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out, const mvsUtils::Mult
         triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
         if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
         {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        nmap[pix.x * h + pix.y] += 1;
-                    }
-                }  // for y
-            }      // for x
+            // pixels of the triangle bounding box intersected by the triangle
+            rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int x, int y) { nmap[x * h + y] += 1; });
         }          // isthere
         mvsUtils::printfEstimate(i, tris.size(), t1);
     }  // for i ntris
@@ -738,18 +698,8 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out, const mvsUtils::Mult
         triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
         if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
         {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        out[pix.x * h + pix.y].push_back(i);
-                    }
-                }  // for y
-            }      // for x
+            // pixels of the triangle bounding box intersected by the triangle
+            rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int x, int y) { out[x * h + y].push_back(i); });
         }          // isthere
         mvsUtils::printfEstimate(i, tris.size(), t1);
     }  // for i ntris
@@ -780,18 +730,8 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out,
         triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
         if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
         {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        nmap[pix.x * h + pix.y] += 1;
-                    }
-                }  // for y
-            }      // for x
+            // pixels of the triangle bounding box intersected by the triangle
+            rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int x, int y) { nmap[x * h + y] += 1; });
         }          // isthere
         mvsUtils::printfEstimate(i, tris.size(), t1);
     }  // for i ntris
@@ -815,18 +755,8 @@ void Mesh::getTrisMap(StaticVector<StaticVector<int>>& out,
         triangle_proj tp = getTriangleProjection(i, mp, rc, w, h);
         if ((isTriangleProjectionInImage(mp, tp, rc, 0)))
         {
-            Pixel pix;
-            for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
-            {
-                for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
-                {
-                    Mesh::rectangle re = Mesh::rectangle(pix, 1);
-                    if (doesTriangleIntersectsRectangle(tp, re))
-                    {
-                        out[pix.x * h + pix.y].push_back(i);
-                    }
-                }  // for y
-            }      // for x
+            // pixels of the triangle bounding box intersected by the triangle
+            rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int x, int y) { out[x * h + y].push_back(i); });
         }          // isthere
         mvsUtils::printfEstimate(i, tris.size(), t1);
     }  // for i ntris
@@ -1105,6 +1035,8 @@ void Mesh::getVisibleTrianglesIndexes(StaticVector<int>& out_visTri,
 
 void Mesh::generateMeshFromTrianglesSubset(const StaticVector<int>& visTris, Mesh& outMesh, StaticVector<int>& out_ptIdToNewPtId) const
 {
+    outMesh.clearConnectivity();
+
     out_ptIdToNewPtId.resize_with(pts.size(), -1);  // -1 means unused
     for (int i = 0; i < visTris.size(); ++i)
     {
@@ -1308,11 +1240,57 @@ double Mesh::computeTriangleMinEdgeLength(int idTri) const
     return std::min({(pts[t.v[0]] - pts[t.v[1]]).size(), (pts[t.v[1]] - pts[t.v[2]]).size(), (pts[t.v[2]] - pts[t.v[0]]).size()});
 }
 
+namespace {
+
+/**
+ * @brief Compute the normal of a point as the mean of the normals of its triangles.
+ * @param[in] mesh the mesh
+ * @param[in] ptTris the triangles of the point
+ * @return the point normal, null if it cannot be computed
+ */
+template<typename TrianglesRange>
+Point3d computeNormalFromTriangles(const Mesh& mesh, const TrianglesRange& ptTris)
+{
+    Point3d n = Point3d(0.0f, 0.0f, 0.0f);
+    float nn = 0.0f;
+    for (int j = 0; j < ptTris.size(); ++j)
+    {
+        Point3d n1 = mesh.computeTriangleNormal(ptTris[j]);
+        n1 = n1.normalize();
+        if (!std::isnan(n1.x) && !std::isnan(n1.y) && !std::isnan(n1.z))  // check if is not NaN
+        {
+            n = n + mesh.computeTriangleNormal(ptTris[j]);
+            nn += 1.0f;
+        }
+    }
+    n = n / nn;
+
+    n = n.normalize();
+    if (std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z))  // check if is not NaN
+    {
+        n = Point3d(0.0f, 0.0f, 0.0f);
+    }
+    return n;
+}
+
+}  // namespace
+
 void Mesh::computeNormalsForPts(StaticVector<Point3d>& out_nms) const
 {
-    StaticVector<StaticVector<int>> ptsNeighTris;
-    getPtsNeighborTriangles(ptsNeighTris);
-    computeNormalsForPts(ptsNeighTris, out_nms);
+    const MeshConnectivity& connectivity = getConnectivity();
+
+    out_nms.reserve(pts.size());
+    out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
+
+#pragma omp parallel for
+    for (int i = 0; i < pts.size(); ++i)
+    {
+        const MeshConnectivity::Range ptTris = connectivity.getPointTriangles(i);
+        if (!ptTris.empty())
+        {
+            out_nms[i] = computeNormalFromTriangles(*this, ptTris);
+        }
+    }
 }
 
 void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, StaticVector<Point3d>& out_nms) const
@@ -1325,27 +1303,7 @@ void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, S
         StaticVector<int>& triTmp = ptsNeighTris[i];
         if (!triTmp.empty())
         {
-            Point3d n = Point3d(0.0f, 0.0f, 0.0f);
-            float nn = 0.0f;
-            for (int j = 0; j < triTmp.size(); ++j)
-            {
-                Point3d n1 = computeTriangleNormal(triTmp[j]);
-                n1 = n1.normalize();
-                if (!std::isnan(n1.x) && !std::isnan(n1.y) && !std::isnan(n1.z))  // check if is not NaN
-                {
-                    n = n + computeTriangleNormal(triTmp[j]);
-                    nn += 1.0f;
-                }
-            }
-            n = n / nn;
-
-            n = n.normalize();
-            if (std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z))  // check if is not NaN
-            {
-                n = Point3d(0.0f, 0.0f, 0.0f);
-            }
-
-            out_nms[i] = n;
+            out_nms[i] = computeNormalFromTriangles(*this, triTmp);
         }
     }
 }
@@ -1373,6 +1331,8 @@ void Mesh::smoothNormals(StaticVector<Point3d>& nms, StaticVector<StaticVector<i
 
 void Mesh::removeFreePointsFromMesh(StaticVector<int>& out_ptIdToNewPtId)
 {
+    clearConnectivity();
+
     ALICEVISION_LOG_INFO("remove free points from mesh.");
 
     // declare all triangles as used
@@ -1718,6 +1678,8 @@ int Mesh::subdivideMesh(const Mesh& refMesh, float ratioSubdiv, bool remapVisibi
 
 int Mesh::subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refMesh_kdTree, float lengthRatio)
 {
+    clearConnectivity();
+
     StaticVector<StaticVector<int>> edgesNeighTris;
     StaticVector<Pixel> edgesPointsPairs;
     getNotOrientedEdges(edgesNeighTris, edgesPointsPairs);
@@ -1865,12 +1827,12 @@ double Mesh::computeAverageEdgeLength() const
     return (s / n);
 }
 
-double Mesh::computeLocalAverageEdgeLength(const std::vector<std::vector<int>>& ptsNeighbors, int ptId) const
+double Mesh::computeLocalAverageEdgeLength(int ptId) const
 {
     double localAverageEdgeLength = 0.0;
 
     const Point3d& point = pts[ptId];
-    const std::vector<int>& ptNeighbors = ptsNeighbors[ptId];
+    const MeshConnectivity::Range ptNeighbors = getConnectivity().getPointNeighbors(ptId);
     const int nbNeighbors = ptNeighbors.size();
 
     if (nbNeighbors == 0)
@@ -1888,6 +1850,8 @@ double Mesh::computeLocalAverageEdgeLength(const std::vector<std::vector<int>>&
 
 void Mesh::letJustTringlesIdsInMesh(StaticVector<int>& trisIdsToStay)
 {
+    clearConnectivity();
+
     StaticVector<Mesh::triangle> trisTmp;
     trisTmp.reserve(trisIdsToStay.size());
 
@@ -1900,6 +1864,8 @@ void Mesh::letJustTringlesIdsInMesh(StaticVector<int>& trisIdsToStay)
 
 void Mesh::letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay)
 {
+    clearConnectivity();
+
     int nbTris = 0;
     for (int i = 0; i < trisToStay.size(); ++i)
         if (trisToStay[i])
@@ -2007,6 +1973,8 @@ void Mesh::initFromDepthMap(const mvsUtils::MultiViewParams& mp, float* depthMap
 
 void Mesh::initFromDepthMap(int stepDetail, const mvsUtils::MultiViewParams& mp, float* depthMap, int rc, int scale, int step, float alpha)
 {
+    clearConnectivity();
+
     int w = mp.getWidth(rc) / (scale * step);
     int h = mp.getHeight(rc) / (scale * step);
 
@@ -2190,6 +2158,8 @@ void Mesh::filterTrianglesByRatio(double ratio, const StaticVectorBool& trisToCo
 
 void Mesh::invertTriangleOrientations()
 {
+    clearConnectivity();
+
     ALICEVISION_LOG_INFO("Invert triangle orientations.");
     for (int i = 0; i < tris.size(); ++i)
     {
@@ -2200,6 +2170,8 @@ void Mesh::invertTriangleOrientations()
 
 void Mesh::changeTriPtId(int triId, int oldPtId, int newPtId)
 {
+    clearConnectivity();
+
     for (int k = 0; k < 3; ++k)
     {
         if (oldPtId == tris[triId].v[k])
@@ -2275,8 +2247,8 @@ bool Mesh::isTriangleObtuse(int triId) const
 
 void Mesh::getLargestConnectedComponentTrisIds(StaticVector<int>& out) const
 {
-    StaticVector<StaticVector<int>> ptsNeighPtsOrdered;
-    getPtsNeighPtsOrdered(ptsNeighPtsOrdered);
+    // the connected components only need the neighbor points, not their order around each point
+    const MeshConnectivity& connectivity = getConnectivity();
 
     StaticVector<int> colors;
     colors.reserve(pts.size());
@@ -2311,9 +2283,8 @@ void Mesh::getLargestConnectedComponentTrisIds(StaticVector<int>& out) const
                     throw std::runtime_error("getLargestConnectedComponentTrisIds: bad condition.");
                 }
             }
-            for (int j = 0; j < sizeOfStaticVector<int>(ptsNeighPtsOrdered[ptid]); ++j)
+            for (const int nptid : connectivity.getPointNeighbors(ptid))
             {
-                int nptid = ptsNeighPtsOrdered[ptid][j];
                 if ((nptid > -1) && (colors[nptid] == -1))
                 {
                     if (buff.size() >= buff.capacity())  // should not happen but no problem
@@ -2346,6 +2317,8 @@ void Mesh::getLargestConnectedComponentTrisIds(StaticVector<int>& out) const
 
 void Mesh::load(const std::string& filepath, bool mergeCoincidentVerts, Material* material)
 {
+    clearConnectivity();
+
     Assimp::Importer importer;
 
     pts.clear();
@@ -16,6 +16,9 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/stl/bitmask.hpp>
 
+#include <memory>
+#include <mutex>
+
 namespace GEO {
 class AdaptiveKdTree;
 }
@@ -23,6 +26,8 @@ class AdaptiveKdTree;
 namespace aliceVision {
 namespace mesh {
 
+class MeshConnectivity;
+
 using PointVisibility = StaticVector<int>;
 using PointsVisibility = StaticVector<PointVisibility>;
 
@@ -148,6 +153,26 @@ class Mesh
     std::vector<rgb> _colors;
     /// Per triangle material id
     std::vector<int> _trisMtlIds;
+    /**
+     * @brief Connectivity of the points, built on demand.
+     * @note A copied mesh builds its own connectivity on demand.
+     */
+    struct ConnectivityCache
+    {
+        std::mutex mutex;
+        std::shared_ptr<const MeshConnectivity> connectivity;
+
+        ConnectivityCache() = default;
+        ConnectivityCache(const ConnectivityCache&) {}
+        ConnectivityCache& operator=(const ConnectivityCache&)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            connectivity.reset();
+            return *this;
+        }
+    };
+
+    mutable ConnectivityCache _connectivityCache;
 
   public:
     StaticVector<Point3d> pts;
@@ -171,6 +196,22 @@ class Mesh
 
     void addMesh(const Mesh& mesh);
 
+    /**
+     * @brief Get the neighbor triangles and the neighbor points of each point, built on first use.
+     * @note Concurrent calls are thread-safe, the connectivity is built once.
+     *       The Mesh methods changing the points or the triangles release the connectivity,
+     *       the returned reference is valid until then. The pts and tris arrays are public:
+     *       clearConnectivity must be called after editing them directly, only a change of their sizes is detected.
+     * @return the mesh connectivity
+     */
+    const MeshConnectivity& getConnectivity() const;
+
+    /**
+     * @brief Release the mesh connectivity, it is built again on next use.
+     * @note Must not be called while a reference returned by getConnectivity is in use.
+     */
+    void clearConnectivity();
+
     void getTrisMap(StaticVector<StaticVector<int>>& out, const mvsUtils::MultiViewParams& mp, int rc, int scale, int w, int h);
     void getTrisMap(StaticVector<StaticVector<int>>& out,
                     StaticVector<int>& visTris,
@@ -197,7 +238,6 @@ class Mesh
                      int w,
                      int h);
 
-    void getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeighTris) const;
     void getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
     void getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
 
@@ -250,7 +290,7 @@ class Mesh
     void letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay);
 
     double computeAverageEdgeLength() const;
-    double computeLocalAverageEdgeLength(const std::vector<std::vector<int>>& ptsNeighbors, int ptId) const;
+    double computeLocalAverageEdgeLength(int ptId) const;
 
     bool isTriangleAngleAtVetexObtuse(int vertexIdInTriangle, int triId) const;
     bool isTriangleObtuse(int triId) const;
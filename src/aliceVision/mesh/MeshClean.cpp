@@ -6,6 +6,7 @@
 
 #include "MeshClean.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mesh/MeshConnectivity.hpp>
 
 namespace aliceVision {
 namespace mesh {
@@ -633,14 +634,15 @@ void MeshClean::init()
 {
     deallocateCleaningAttributes();
 
-    getPtsNeighborTriangles(ptsNeighTrisSortedAsc);
-    for (int i = 0; i < pts.size(); i++)
+    // editable copy of the neighbor triangles, sorted by ascending index in the mesh connectivity
+    const MeshConnectivity& connectivity = getConnectivity();
+    ptsNeighTrisSortedAsc.resize(pts.size());
+
+#pragma omp parallel for
+    for (int ptId = 0; ptId < pts.size(); ++ptId)
     {
-        StaticVector<int>& ptNeigTris = ptsNeighTrisSortedAsc[i];
-        if (sizeOfStaticVector<int>(ptNeigTris) > 1)
-        {
-            qsort(&ptNeigTris[0], ptNeigTris.size(), sizeof(int), qSortCompareIntAsc);
-        }
+        const MeshConnectivity::Range ptTris = connectivity.getPointTriangles(ptId);
+        ptsNeighTrisSortedAsc[ptId].getDataWritable().assign(ptTris.begin(), ptTris.end());
     }
 
     ptsNeighPtsOrdered.reserve(pts.size());
@@ -851,6 +853,9 @@ int MeshClean::cleanMesh()
         path pth(this, i);
         nWrongPts += static_cast<int>(pth.deployAll() > 0);
     }
+    // the triangles of the wrong points now use the duplicated points
+    clearConnectivity();
+
     // update vertex color data (if any) if points were modified
     if (!_colors.empty() && !newPtsOldPtId.empty())
     {
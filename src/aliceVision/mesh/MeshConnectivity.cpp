@@ -0,0 +1,137 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MeshConnectivity.hpp"
+
+#include <aliceVision/mesh/Mesh.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace mesh {
+
+MeshConnectivity::MeshConnectivity(const Mesh& mesh)
+{
+    build(mesh);
+}
+
+void MeshConnectivity::build(const Mesh& mesh)
+{
+    clear();
+
+    const int nbPoints = mesh.pts.size();
+    const int nbTriangles = mesh.tris.size();
+
+    // count the triangles of each point
+    std::vector<std::size_t> nbPtsTris(nbPoints, 0);
+
+#pragma omp parallel for
+    for (int triId = 0; triId < nbTriangles; ++triId)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+#pragma omp atomic
+            ++nbPtsTris[mesh.tris[triId].v[k]];
+        }
+    }
+
+    _ptsTrisOffsets.resize(nbPoints + 1);
+    _ptsTrisOffsets[0] = 0;
+    for (int ptId = 0; ptId < nbPoints; ++ptId)
+        _ptsTrisOffsets[ptId + 1] = _ptsTrisOffsets[ptId] + nbPtsTris[ptId];
+
+    // fill the triangles of each point, the counters are reused as insertion positions
+    std::copy(_ptsTrisOffsets.begin(), _ptsTrisOffsets.end() - 1, nbPtsTris.begin());
+    _ptsTris.resize(_ptsTrisOffsets[nbPoints]);
+
+#pragma omp parallel for
+    for (int triId = 0; triId < nbTriangles; ++triId)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            std::size_t position;
+#pragma omp atomic capture
+            position = nbPtsTris[mesh.tris[triId].v[k]]++;
+
+            _ptsTris[position] = triId;
+        }
+    }
+
+    // the insertion order depends on the threads
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int ptId = 0; ptId < nbPoints; ++ptId)
+        std::sort(_ptsTris.begin() + _ptsTrisOffsets[ptId], _ptsTris.begin() + _ptsTrisOffsets[ptId + 1]);
+
+    // gather the other vertices of the triangles of a point
+    const auto getNeighbors = [&](int ptId, std::vector<int>& out_neighbors) {
+        out_neighbors.clear();
+        for (const int triId : getPointTriangles(ptId))
+        {
+            const Mesh::triangle& t = mesh.tris[triId];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (t.v[k] != ptId)
+                    out_neighbors.push_back(t.v[k]);
+            }
+        }
+        std::sort(out_neighbors.begin(), out_neighbors.end());
+        out_neighbors.erase(std::unique(out_neighbors.begin(), out_neighbors.end()), out_neighbors.end());
+    };
+
+    std::vector<std::size_t> nbPtsNeighPts(nbPoints, 0);
+
+#pragma omp parallel
+    {
+        std::vector<int> neighbors;
+
+#pragma omp for schedule(dynamic, 1024)
+        for (int ptId = 0; ptId < nbPoints; ++ptId)
+        {
+            getNeighbors(ptId, neighbors);
+            nbPtsNeighPts[ptId] = neighbors.size();
+        }
+    }
+
+    _ptsNeighPtsOffsets.resize(nbPoints + 1);
+    _ptsNeighPtsOffsets[0] = 0;
+    for (int ptId = 0; ptId < nbPoints; ++ptId)
+        _ptsNeighPtsOffsets[ptId + 1] = _ptsNeighPtsOffsets[ptId] + nbPtsNeighPts[ptId];
+
+    _ptsNeighPts.resize(_ptsNeighPtsOffsets[nbPoints]);
+
+#pragma omp parallel
+    {
+        std::vector<int> neighbors;
+
+#pragma omp for schedule(dynamic, 1024)
+        for (int ptId = 0; ptId < nbPoints; ++ptId)
+        {
+            getNeighbors(ptId, neighbors);
+            std::copy(neighbors.begin(), neighbors.end(), _ptsNeighPts.begin() + _ptsNeighPtsOffsets[ptId]);
+        }
+    }
+}
+
+void MeshConnectivity::clear()
+{
+    _ptsTrisOffsets.clear();
+    _ptsTrisOffsets.shrink_to_fit();
+    _ptsTris.clear();
+    _ptsTris.shrink_to_fit();
+    _ptsNeighPtsOffsets.clear();
+    _ptsNeighPtsOffsets.shrink_to_fit();
+    _ptsNeighPts.clear();
+    _ptsNeighPts.shrink_to_fit();
+}
+
+std::size_t MeshConnectivity::getMemorySize() const
+{
+    return (_ptsTrisOffsets.capacity() + _ptsNeighPtsOffsets.capacity()) * sizeof(std::size_t) +
+           (_ptsTris.capacity() + _ptsNeighPts.capacity()) * sizeof(int);
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
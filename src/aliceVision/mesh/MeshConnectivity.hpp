@@ -0,0 +1,110 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+class Mesh;
+
+/**
+ * @class MeshConnectivity
+ * @brief Compact connectivity of a triangle mesh.
+ * @details The neighborhoods of the points are stored in compressed sparse rows (CSR):
+ *          a single array of indexes for all the points and the offset of each point in this array.
+ *          The structure is built in parallel and does not follow the later changes of the mesh,
+ *          see Mesh::getConnectivity for the connectivity kept by the mesh.
+ */
+class MeshConnectivity
+{
+  public:
+    /**
+     * @brief Range of indexes of a point neighborhood.
+     */
+    class Range
+    {
+      public:
+        Range(const int* begin, const int* end)
+          : _begin(begin),
+            _end(end)
+        {}
+
+        inline const int* begin() const { return _begin; }
+        inline const int* end() const { return _end; }
+        inline int size() const { return static_cast<int>(_end - _begin); }
+        inline bool empty() const { return _begin == _end; }
+        inline int operator[](int i) const { return _begin[i]; }
+
+      private:
+        const int* _begin;
+        const int* _end;
+    };
+
+    MeshConnectivity() = default;
+
+    /**
+     * @brief MeshConnectivity constructor
+     * @see build
+     */
+    explicit MeshConnectivity(const Mesh& mesh);
+
+    /**
+     * @brief Build the neighbor triangles and the neighbor points of each point of a mesh.
+     * @param[in] mesh the input mesh
+     */
+    void build(const Mesh& mesh);
+
+    /**
+     * @brief Release the connectivity.
+     */
+    void clear();
+
+    inline int getNbPoints() const { return _ptsTrisOffsets.empty() ? 0 : static_cast<int>(_ptsTrisOffsets.size() - 1); }
+    inline int getNbTriangles() const { return static_cast<int>(_ptsTris.size() / 3); }
+
+    /**
+     * @brief Get the triangles containing a point.
+     * @param[in] ptId the point index
+     * @return the triangle indexes, sorted by ascending index
+     */
+    inline Range getPointTriangles(int ptId) const
+    {
+        return Range(_ptsTris.data() + _ptsTrisOffsets[ptId], _ptsTris.data() + _ptsTrisOffsets[ptId + 1]);
+    }
+
+    /**
+     * @brief Get the points sharing a triangle with a point.
+     * @param[in] ptId the point index
+     * @return the point indexes, sorted by ascending index
+     */
+    inline Range getPointNeighbors(int ptId) const
+    {
+        return Range(_ptsNeighPts.data() + _ptsNeighPtsOffsets[ptId], _ptsNeighPts.data() + _ptsNeighPtsOffsets[ptId + 1]);
+    }
+
+    /**
+     * @brief Get the memory used by the connectivity.
+     * @return size in bytes
+     */
+    std::size_t getMemorySize() const;
+
+  private:
+    /// offsets of the points in the neighbor triangles array (number of points + 1)
+    std::vector<std::size_t> _ptsTrisOffsets;
+    /// neighbor triangles of all the points
+    std::vector<int> _ptsTris;
+    /// offsets of the points in the neighbor points array (number of points + 1)
+    std::vector<std::size_t> _ptsNeighPtsOffsets;
+    /// neighbor points of all the points
+    std::vector<int> _ptsNeighPts;
+};
+
+}  // namespace mesh
+}  // namespace aliceVision
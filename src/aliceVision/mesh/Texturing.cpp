@@ -7,7 +7,9 @@
 #include "Texturing.hpp"
 #include "geoMesh.hpp"
 #include "UVAtlas.hpp"
+#include "triangleRasterization.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/utils/filesIO.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/image/io.hpp>
@@ -15,6 +17,7 @@
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/Pixel.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 
 #include <geogram/basic/common.h>
@@ -37,8 +40,11 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <deque>
 #include <filesystem>
+#include <future>
 #include <map>
+#include <memory>
 #include <set>
 
 // Debug mode: save atlases decomposition in frequency bands and
@@ -133,30 +139,9 @@ std::istream& operator>>(std::istream& in, EBumpMappingType& bumpMappingType)
     return in;
 }
 
-/**
- * @brief Return whether a pixel is contained in or intersected by a 2D triangle.
- * @param[in] triangle the triangle as an array of 3 point2Ds
- * @param[in] pixel the pixel to test
- * @param[out] barycentricCoords the barycentric
- *  coordinates of this pixel relative to \p triangle
- * @return
- */
-bool isPixelInTriangle(const Point2d* triangle, const Pixel& pixel, Point2d& barycentricCoords)
-{
-    // get pixel center
-    GEO::vec2 p(pixel.x + 0.5, pixel.y + 0.5);
-    GEO::vec2 V0(triangle[0].x, triangle[0].y);
-    GEO::vec2 V1(triangle[1].x, triangle[1].y);
-    GEO::vec2 V2(triangle[2].x, triangle[2].y);
-    GEO::vec2 closestPoint;
-    double l1, l2, l3;
-    double dist = GEO::Geom::point_triangle_squared_distance<GEO::vec2>(p, V0, V1, V2, closestPoint, l1, l2, l3);
-    // fill barycentric coordinates as expected by other internal methods
-    barycentricCoords.x = l3;
-    barycentricCoords.y = l2;
-    // tolerance threshold of 1/2 pixel for pixels on the edges of the triangle
-    return dist < 0.5 + std::numeric_limits<double>::epsilon();
-}
+/// squared distance from a pixel center to a triangle to consider the pixel in the triangle:
+/// tolerance threshold of 1/2 pixel for pixels on the edges of the triangle
+const double pixelInTriangleMaxSquaredDistance = 0.5 + std::numeric_limits<double>::epsilon();
 
 Point2d barycentricToCartesian(const Point2d* triangle, const Point2d& coords)
 {
@@ -342,11 +327,17 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
         nbAtlasMax -= 1;
     nbAtlasMax = std::max(1, nbAtlasMax);  // if not enough memory, do it one by one
 
+    // the remaining memory is used to prepare the images and laplacian pyramids of the next cameras in background
+    const int prefetchMem = availableMem - nbAtlasMax * atlasPyramidMaxMemSize - 1000;  // keep 1 GB margin in memory
+    const int nbPrefetchedCameras =
+      clamp(prefetchMem / std::max<int>(1, imageMaxMemSize + imagePyramidMaxMemSize), 0, static_cast<int>(texParams.maxNbPrefetchedCameras));
+
     ALICEVISION_LOG_INFO("Total amount of available RAM: " << availableRam << " MB.");
     ALICEVISION_LOG_INFO("Total amount of memory remaining for the computation: " << availableMem << " MB.");
     ALICEVISION_LOG_INFO("Total amount of an image in memory: " << imageMaxMemSize << " MB.");
     ALICEVISION_LOG_INFO("Total amount of an atlas pyramid in memory: " << atlasPyramidMaxMemSize << " MB.");
     ALICEVISION_LOG_INFO("Processing " << nbAtlas << " atlases by chunks of " << nbAtlasMax);
+    ALICEVISION_LOG_INFO("Number of cameras prepared in background: " << nbPrefetchedCameras);
 
     // generateTexture for the maximum number of atlases, and iterate
     const std::div_t divresult = div(nbAtlas, nbAtlasMax);
@@ -364,7 +355,7 @@ void Texturing::generateTextures(const mvsUtils::MultiViewParams& mp,
             atlasIDs.push_back(atlasID);
         }
         ALICEVISION_LOG_INFO("Generating texture for atlases " << n * nbAtlasMax + 1 << " to " << n * nbAtlasMax + imax);
-        generateTexturesSubSet(mp, atlasIDs, imageCache, outPath, textureFileType);
+        generateTexturesSubSet(mp, atlasIDs, imageCache, outPath, textureFileType, nbPrefetchedCameras);
     }
 }
 
@@ -372,7 +363,8 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                                        const std::vector<size_t>& atlasIDs,
                                        mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
                                        const fs::path& outPath,
-                                       image::EImageFileType textureFileType)
+                                       image::EImageFileType textureFileType,
+                                       int nbPrefetchedCameras)
 {
     if (atlasIDs.size() > _atlases.size())
         throw std::runtime_error("Invalid atlas IDs ");
@@ -385,131 +377,162 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
     using ScorePerTriangle = std::vector<std::pair<unsigned int, float>>;  // list of <triangleId, score>
     std::vector<std::map<AtlasIndex, std::vector<ScorePerTriangle>>> contributionsPerCamera(mp.ncams);
 
+    // contribution of a triangle to the texture of a camera, at a given frequency band
+    struct TriangleContribution
+    {
+        int camId;
+        int band;
+        unsigned int triangleId;
+        float score;
+    };
+
     // for each atlasID, calculate contributionPerCamera
     for (const size_t atlasID : atlasIDs)
     {
-        ALICEVISION_LOG_INFO("Generating texture for atlas " << atlasID + 1 << "/" << _atlases.size() << " (" << _atlases[atlasID].size()
+        const std::vector<int>& atlasTriangles = _atlases[atlasID];
+
+        ALICEVISION_LOG_INFO("Generating texture for atlas " << atlasID + 1 << "/" << _atlases.size() << " (" << atlasTriangles.size()
                                                              << " triangles).");
 
-        // iterate over atlas' triangles
-        for (size_t i = 0; i < _atlases[atlasID].size(); ++i)
-        {
-            int triangleID = _atlases[atlasID][i];
+        // the triangles are scored in parallel, each thread stores its contributions in its own buffer.
+        // the static schedule gives contiguous ranges of triangles to the threads: merging the buffers
+        // in the thread order keeps the triangles order of the atlas.
+        std::vector<std::vector<TriangleContribution>> contributionsPerThread(omp_get_max_threads());
 
-            // Fuse visibilities of the 3 vertices
+#pragma omp parallel
+        {
+            std::vector<TriangleContribution>& threadContributions = contributionsPerThread[omp_get_thread_num()];
             std::vector<int> allTriCams;
-            for (int k = 0; k < 3; ++k)
-            {
-                const int pointIndex = mesh->tris[triangleID].v[k];
-                const StaticVector<int> pointVisibilities = mesh->pointsVisibilities[pointIndex];
-                if (!pointVisibilities.empty())
-                {
-                    std::copy(pointVisibilities.begin(), pointVisibilities.end(), std::inserter(allTriCams, allTriCams.end()));
-                }
-            }
-            if (allTriCams.empty())
-            {
-                // triangle without visibility
-                ALICEVISION_LOG_TRACE("No visibility for triangle " << triangleID << " in texture atlas " << atlasID << ".");
-                continue;
-            }
-            std::sort(allTriCams.begin(), allTriCams.end());
-
             std::vector<std::pair<int, int>> selectedTriCams;  // <camId, nbVertices>
-            selectedTriCams.emplace_back(allTriCams.front(), 1);
-            for (int j = 1; j < allTriCams.size(); ++j)
+            using ScoreCamId = std::tuple<int, double, int>;    // <nbVertex, score, camId>
+            std::vector<ScoreCamId> scorePerCamId;
+
+#pragma omp for schedule(static)
+            for (int i = 0; i < atlasTriangles.size(); ++i)
             {
-                const unsigned int camId = allTriCams[j];
-                if (selectedTriCams.back().first == camId)
+                const int triangleID = atlasTriangles[i];
+
+                // Fuse visibilities of the 3 vertices
+                allTriCams.clear();
+                for (int k = 0; k < 3; ++k)
                 {
-                    ++selectedTriCams.back().second;
+                    const int pointIndex = mesh->tris[triangleID].v[k];
+                    const StaticVector<int>& pointVisibilities = mesh->pointsVisibilities[pointIndex];
+                    allTriCams.insert(allTriCams.end(), pointVisibilities.begin(), pointVisibilities.end());
                 }
-                else
+                if (allTriCams.empty())
                 {
-                    selectedTriCams.emplace_back(camId, 1);
+                    // triangle without visibility
+                    ALICEVISION_LOG_TRACE("No visibility for triangle " << triangleID << " in texture atlas " << atlasID << ".");
+                    continue;
                 }
-            }
+                std::sort(allTriCams.begin(), allTriCams.end());
 
-            assert(!selectedTriCams.empty());
+                selectedTriCams.clear();
+                selectedTriCams.emplace_back(allTriCams.front(), 1);
+                for (int j = 1; j < allTriCams.size(); ++j)
+                {
+                    const unsigned int camId = allTriCams[j];
+                    if (selectedTriCams.back().first == camId)
+                    {
+                        ++selectedTriCams.back().second;
+                    }
+                    else
+                    {
+                        selectedTriCams.emplace_back(camId, 1);
+                    }
+                }
 
-            // Select the N best views for texturing
-            Point3d triangleNormal;
-            Point3d triangleCenter;
-            if (texParams.angleHardThreshold != 0.0)
-            {
-                triangleNormal = mesh->computeTriangleNormal(triangleID);
-                triangleCenter = mesh->computeTriangleCenterOfGravity(triangleID);
-            }
-            using ScoreCamId = std::tuple<int, double, int>;  // <nbVertex, score, camId>
-            std::vector<ScoreCamId> scorePerCamId;
-            for (const auto& itCamVis : selectedTriCams)
-            {
-                const int camId = itCamVis.first;
-                const int verticesSupport = itCamVis.second;
-                if (texParams.forceVisibleByAllVertices && verticesSupport < 3)
-                    continue;
+                assert(!selectedTriCams.empty());
 
+                // Select the N best views for texturing
+                Point3d triangleNormal;
+                Point3d triangleCenter;
                 if (texParams.angleHardThreshold != 0.0)
                 {
-                    const Point3d vecPointToCam = (mp.CArr[camId] - triangleCenter).normalize();
-                    const double angle = angleBetwV1andV2(triangleNormal, vecPointToCam);
-                    if (angle > texParams.angleHardThreshold)
-                        continue;
+                    triangleNormal = mesh->computeTriangleNormal(triangleID);
+                    triangleCenter = mesh->computeTriangleCenterOfGravity(triangleID);
                 }
+                scorePerCamId.clear();
+                for (const auto& itCamVis : selectedTriCams)
+                {
+                    const int camId = itCamVis.first;
+                    const int verticesSupport = itCamVis.second;
+                    if (texParams.forceVisibleByAllVertices && verticesSupport < 3)
+                        continue;
 
-                const int w = mp.getWidth(camId);
-                const int h = mp.getHeight(camId);
+                    if (texParams.angleHardThreshold != 0.0)
+                    {
+                        const Point3d vecPointToCam = (mp.CArr[camId] - triangleCenter).normalize();
+                        const double angle = angleBetwV1andV2(triangleNormal, vecPointToCam);
+                        if (angle > texParams.angleHardThreshold)
+                            continue;
+                    }
 
-                const Mesh::triangle_proj tProj = mesh->getTriangleProjection(triangleID, mp, camId, w, h);
-                const int nbVertex = mesh->getTriangleNbVertexInImage(mp, tProj, camId, 20);
-                if (nbVertex == 0)
-                    // No triangle vertex in the image
-                    continue;
+                    const int w = mp.getWidth(camId);
+                    const int h = mp.getHeight(camId);
 
-                const double area = mesh->computeTriangleProjectionArea(tProj);
-                const double score = area * double(verticesSupport);
-                scorePerCamId.emplace_back(nbVertex, score, camId);
-            }
-            if (scorePerCamId.empty())
-            {
-                // triangle without visibility
-                ALICEVISION_LOG_TRACE("No visibility for triangle " << triangleID << " in texture atlas " << atlasID << " after scoring!!");
-                continue;
-            }
+                    const Mesh::triangle_proj tProj = mesh->getTriangleProjection(triangleID, mp, camId, w, h);
+                    const int nbVertex = mesh->getTriangleNbVertexInImage(mp, tProj, camId, 20);
+                    if (nbVertex == 0)
+                        // No triangle vertex in the image
+                        continue;
+
+                    const double area = mesh->computeTriangleProjectionArea(tProj);
+                    const double score = area * double(verticesSupport);
+                    scorePerCamId.emplace_back(nbVertex, score, camId);
+                }
+                if (scorePerCamId.empty())
+                {
+                    // triangle without visibility
+                    ALICEVISION_LOG_TRACE("No visibility for triangle " << triangleID << " in texture atlas " << atlasID << " after scoring!!");
+                    continue;
+                }
 
-            std::sort(scorePerCamId.begin(), scorePerCamId.end(), std::greater<ScoreCamId>());
-            const double minScore = texParams.bestScoreThreshold * std::get<1>(scorePerCamId.front());  // bestScoreThreshold * bestScore
-            const bool bestIsPartial = (std::get<0>(scorePerCamId.front()) < 3);
+                std::sort(scorePerCamId.begin(), scorePerCamId.end(), std::greater<ScoreCamId>());
+                const double minScore = texParams.bestScoreThreshold * std::get<1>(scorePerCamId.front());  // bestScoreThreshold * bestScore
+                const bool bestIsPartial = (std::get<0>(scorePerCamId.front()) < 3);
 
-            int nbContribMax = std::min(texParams.multiBandNbContrib.back(), static_cast<int>(scorePerCamId.size()));
-            int nbCumulatedVertices = 0;
-            int band = 0;
-            for (int contrib = 0; nbCumulatedVertices < 3 * nbContribMax && contrib < nbContribMax; ++contrib)
-            {
-                nbCumulatedVertices += std::get<0>(scorePerCamId[contrib]);
-                if (!bestIsPartial && contrib != 0)
+                int nbContribMax = std::min(texParams.multiBandNbContrib.back(), static_cast<int>(scorePerCamId.size()));
+                int nbCumulatedVertices = 0;
+                int band = 0;
+                for (int contrib = 0; nbCumulatedVertices < 3 * nbContribMax && contrib < nbContribMax; ++contrib)
                 {
-                    if (std::get<1>(scorePerCamId[contrib]) < minScore)
+                    nbCumulatedVertices += std::get<0>(scorePerCamId[contrib]);
+                    if (!bestIsPartial && contrib != 0)
                     {
-                        // The best image fully see the triangle and has a much better score, so only rely on the first ones
-                        break;
+                        if (std::get<1>(scorePerCamId[contrib]) < minScore)
+                        {
+                            // The best image fully see the triangle and has a much better score, so only rely on the first ones
+                            break;
+                        }
                     }
-                }
 
-                // for the camera camId : add triangle score to the corresponding texture, at the right frequency band
-                const int camId = std::get<2>(scorePerCamId[contrib]);
-                const int triangleScore = std::get<1>(scorePerCamId[contrib]);
-                auto& camContribution = contributionsPerCamera[camId];
-                if (camContribution.find(atlasID) == camContribution.end())
-                    camContribution[atlasID].resize(texParams.nbBand);
-                camContribution.at(atlasID)[band].emplace_back(triangleID, triangleScore);
+                    // for the camera camId : add triangle score to the corresponding texture, at the right frequency band
+                    const int camId = std::get<2>(scorePerCamId[contrib]);
+                    const int triangleScore = std::get<1>(scorePerCamId[contrib]);
+                    threadContributions.push_back({camId, band, static_cast<unsigned int>(triangleID), static_cast<float>(triangleScore)});
 
-                if (contrib + 1 == texParams.multiBandNbContrib[band])
-                {
-                    ++band;
+                    if (contrib + 1 == texParams.multiBandNbContrib[band])
+                    {
+                        ++band;
+                    }
                 }
             }
         }
+
+        // merge the thread contributions per camera
+        for (const std::vector<TriangleContribution>& threadContributions : contributionsPerThread)
+        {
+            for (const TriangleContribution& contribution : threadContributions)
+            {
+                auto& camContribution = contributionsPerCamera[contribution.camId];
+                auto it = camContribution.find(atlasID);
+                if (it == camContribution.end())
+                    it = camContribution.emplace(atlasID, std::vector<ScorePerTriangle>(texParams.nbBand)).first;
+                it->second[contribution.band].emplace_back(contribution.triangleId, contribution.score);
+            }
+        }
     }
 
     ALICEVISION_LOG_INFO("Reading pixel color.");
@@ -519,26 +542,74 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
     for (std::size_t atlasID : atlasIDs)
         accuPyramids[atlasID].init(texParams.nbBand, texParams.textureSide, texParams.textureSide);
 
-    // for each camera, for each texture, iterate over triangles and fill the accuPyramids map
-    for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
+    // camera image and its laplacian pyramid
+    struct CameraPyramid
     {
-        const std::map<AtlasIndex, std::vector<ScorePerTriangle>>& cameraContributions = contributionsPerCamera[camId];
+        std::shared_ptr<image::Image<image::RGBfColor>> img;
+        std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
+    };
+    using CameraPyramidPtr = std::shared_ptr<const CameraPyramid>;
+
+    // load a camera image and calculate its laplacian pyramid
+    // the images cache reuses its image buffers and cannot be shared with the background threads:
+    // the prefetched images are read directly from their files
+    const auto loadCameraPyramid = [&](int camId, bool prefetch) -> CameraPyramidPtr {
+        auto cameraPyramid = std::make_shared<CameraPyramid>();
+        if (prefetch)
+        {
+            cameraPyramid->img = std::make_shared<image::Image<image::RGBfColor>>();
+            mvsUtils::loadImage(mp.getImagePath(camId), mp, camId, *cameraPyramid->img, texParams.workingColorSpace, texParams.correctEV);
+        }
+        else
+        {
+            cameraPyramid->img = imageCache.getImg_sync(camId);
+        }
+        imageAlgo::laplacianPyramid(cameraPyramid->pyramidL, *cameraPyramid->img, texParams.nbBand, texParams.multiBandDownscale);
+        return cameraPyramid;
+    };
 
-        if (cameraContributions.empty())
+    // cameras with contributions, in processing order
+    std::vector<int> usedCams;
+    for (int camId = 0; camId < contributionsPerCamera.size(); ++camId)
+    {
+        if (contributionsPerCamera[camId].empty())
         {
             ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") unused.");
             continue;
         }
-        ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") with contributions to "
-                                         << cameraContributions.size() << " texture files:");
+        usedCams.push_back(camId);
+    }
 
-        // Load camera image from cache
-        auto imgPtr = imageCache.getImg_sync(camId);
-        const image::Image<image::RGBfColor>& camImg = *imgPtr;
+    // the images and pyramids of the next cameras are prepared in background while the current camera is processed
+    std::deque<std::future<CameraPyramidPtr>> prefetchedPyramids;
+    std::size_t nbRequestedCams = 0;
 
-        // Calculate laplacianPyramid
-        std::vector<image::Image<image::RGBfColor>> pyramidL;  // laplacian pyramid
-        imageAlgo::laplacianPyramid(pyramidL, camImg, texParams.nbBand, texParams.multiBandDownscale);
+    // for each camera, for each texture, iterate over triangles and fill the accuPyramids map
+    for (std::size_t i = 0; i < usedCams.size(); ++i)
+    {
+        const int camId = usedCams[i];
+        const std::map<AtlasIndex, std::vector<ScorePerTriangle>>& cameraContributions = contributionsPerCamera[camId];
+
+        // Load camera image and calculate laplacianPyramid
+        CameraPyramidPtr cameraPyramid;
+        if (nbPrefetchedCameras > 0)
+        {
+            for (; nbRequestedCams < usedCams.size() && nbRequestedCams <= i + nbPrefetchedCameras; ++nbRequestedCams)
+                prefetchedPyramids.push_back(std::async(std::launch::async, loadCameraPyramid, usedCams[nbRequestedCams], true));
+
+            cameraPyramid = prefetchedPyramids.front().get();
+            prefetchedPyramids.pop_front();
+        }
+        else
+        {
+            cameraPyramid = loadCameraPyramid(camId, false);
+        }
+
+        const image::Image<image::RGBfColor>& camImg = *cameraPyramid->img;
+        const std::vector<image::Image<image::RGBfColor>>& pyramidL = cameraPyramid->pyramidL;
+
+        ALICEVISION_LOG_INFO("- camera " << mp.getViewId(camId) << " (" << camId + 1 << "/" << mp.ncams << ") with contributions to "
+                                         << cameraContributions.size() << " texture files:");
 
         // for each output texture file
         for (const auto& c : cameraContributions)
@@ -557,9 +628,9 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                 {
                     const unsigned int triangleId = std::get<0>(trianglesId[ti]);
                     const float triangleScore = texParams.useScore ? std::get<1>(trianglesId[ti]) : 1.0f;
-                    // retrieve triangle 3D and UV coordinates
+                    // retrieve triangle UV coordinates and vertices projections in the camera
                     Point2d triPixs[3];
-                    Point3d triPts[3];
+                    Point3d triProjs[3];
                     auto& triangleUvIds = mesh->trisUvIds[triangleId];
                     // compute the Bottom-Left minima of the current UDIM for [0,1] range remapping
                     Point2d udimBL;
@@ -570,7 +641,9 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                     for (int k = 0; k < 3; ++k)
                     {
                         const int pointIndex = mesh->tris[triangleId].v[k];
-                        triPts[k] = mesh->pts[pointIndex];  // 3D coordinates
+                        // homogeneous projection of the vertex, the projection of the triangle points is
+                        // the barycentric interpolation of the vertices projections
+                        triProjs[k] = mp.camArr[camId] * mesh->pts[pointIndex];
                         const int uvPointIndex = triangleUvIds.m[k];
                         Point2d uv = uvCoords[uvPointIndex];
                         // UDIM: remap coordinates between [0,1]
@@ -595,54 +668,41 @@ void Texturing::generateTexturesSubSet(const mvsUtils::MultiViewParams& mp,
                     RD.x = clamp(RD.x, 0, texSide);
                     RD.y = clamp(RD.y, 0, texSide);
 
-                    // iterate over pixels of the triangle's bounding box
-                    for (int y = LU.y; y < RD.y; ++y)
-                    {
-                        for (int x = LU.x; x < RD.x; ++x)
+                    // iterate over pixels inside or intersected by the triangle,
+                    // with the barycentric coordinates of their center (or of the closest point of the triangle)
+                    rasterizeTriangle(triPixs, LU.x, LU.y, RD.x, RD.y, pixelInTriangleMaxSquaredDistance, [&](int x, int y, const Point2d& barycCoords) {
+                        // remap 'y' to image coordinates system (inverted Y axis)
+                        const unsigned int y_ = (texParams.textureSide - 1) - y;
+                        // 1D pixel index
+                        unsigned int xyoffset = y_ * texParams.textureSide + x;
+                        // get 2D coordinates in source image
+                        const Point3d projRC = barycentricToCartesian(triProjs, barycCoords);
+                        // exclude points behind the camera and out of bounds pixels
+                        if (projRC.z <= 0.0)
+                            return;
+                        const Point2d pixRC(projRC.x / projRC.z, projRC.y / projRC.z);
+                        if (!mp.isPixelInImage(pixRC, camId))
+                            return;
+
+                        // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
+                        if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
+                            return;
+
+                        // Fill the accumulated pyramid for this pixel
+                        // each frequency band also contributes to lower frequencies (higher band indexes)
+                        AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
+                        for (std::size_t bandContrib = band; bandContrib < pyramidL.size(); ++bandContrib)
                         {
-                            Pixel pix(x, y);  // top-left corner of the pixel
-                            Point2d barycCoords;
-
-                            // test if the pixel is inside triangle
-                            // and retrieve its barycentric coordinates
-                            if (!isPixelInTriangle(triPixs, pix, barycCoords))
-                            {
-                                continue;
-                            }
-
-                            // remap 'y' to image coordinates system (inverted Y axis)
-                            const unsigned int y_ = (texParams.textureSide - 1) - y;
-                            // 1D pixel index
-                            unsigned int xyoffset = y_ * texParams.textureSide + x;
-                            // get 3D coordinates
-                            Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
-                            // get 2D coordinates in source image
-                            Point2d pixRC;
-                            mp.getPixelFor3DPoint(&pixRC, pt3d, camId);
-                            // exclude out of bounds pixels
-                            if (!mp.isPixelInImage(pixRC, camId))
-                                continue;
-
-                            // If the color is pure zero (ie. no contributions), we consider it as an invalid pixel.
-                            if (getInterpolateColor(camImg, pixRC.y, pixRC.x) == image::RGBfColor(0.f, 0.f, 0.f))
-                                continue;
-
-                            // Fill the accumulated pyramid for this pixel
-                            // each frequency band also contributes to lower frequencies (higher band indexes)
-                            AccuPyramid& accuPyramid = accuPyramids.at(atlasID);
-                            for (std::size_t bandContrib = band; bandContrib < pyramidL.size(); ++bandContrib)
-                            {
-                                int downscaleCoef = std::pow(texParams.multiBandDownscale, bandContrib);
-                                AccuImage& accuImage = accuPyramid.pyramid[bandContrib];
-
-                                // fill the accumulated color map for this pixel
-                                const auto pixDownscaled = pixRC / downscaleCoef;
-                                accuImage.img(xyoffset) +=
-                                  getInterpolateColor(pyramidL[bandContrib], pixDownscaled.y, pixDownscaled.x) * triangleScore;
-                                accuImage.imgCount[xyoffset] += triangleScore;
-                            }
+                            int downscaleCoef = std::pow(texParams.multiBandDownscale, bandContrib);
+                            AccuImage& accuImage = accuPyramid.pyramid[bandContrib];
+
+                            // fill the accumulated color map for this pixel
+                            const auto pixDownscaled = pixRC / downscaleCoef;
+                            accuImage.img(xyoffset) +=
+                              getInterpolateColor(pyramidL[bandContrib], pixDownscaled.y, pixDownscaled.x) * triangleScore;
+                            accuImage.imgCount[xyoffset] += triangleScore;
                         }
-                    }
+                    });
                 }
             }
         }
@@ -1392,65 +1452,51 @@ void Texturing::_generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp
         const Eigen::Matrix3d worldToTriangleMatrix = computeTriangleTransform(*mesh, triangleId, triPixs);
         // const Point3d triangleNormal = me->computeTriangleNormal(triangleId);
 
-        // iterate over bounding box's pixels
-        for (int y = LU.y; y < RD.y; ++y)
-        {
-            for (int x = LU.x; x < RD.x; ++x)
+        // iterate over pixels inside or intersected by the triangle
+        rasterizeTriangle(triPixs, LU.x, LU.y, RD.x, RD.y, pixelInTriangleMaxSquaredDistance, [&](int x, int y, const Point2d& barycCoords) {
+            // remap 'y' to image coordinates system (inverted Y axis)
+            const unsigned int y_ = (texParams.textureSide - 1) - y;
+            // 1D pixel index
+            unsigned int xyoffset = y_ * texParams.textureSide + x;
+            // get 3D coordinates
+            // Point3d pt3d = barycentricToCartesian(triPts, Point2d(barycCoords.z, barycCoords.y));
+            Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
+            GEO::vec3 q(pt3d.x, pt3d.y, pt3d.z);
+
+            // Texel normal (weighted normal from the 3 vertices normals), instead of face normal for better
+            // transitions (reduce seams)
+            const GEO::vec3 triangleNormal_p = mesh_facet_interpolate_normal_at_point(sparseMesh, triangleId, q);
+            // const GEO::vec3 triangleNormal_p = GEO::vec3(triangleNormal.m); // to use the triangle normal instead
+            const GEO::vec3 scaledTriangleNormal = triangleNormal_p * minEdgeLength * 10;
+
+            const double epsilon = 0.00001;
+            GEO::vec3 qA1 = q - (scaledTriangleNormal * epsilon);
+            GEO::vec3 qB1 = q + scaledTriangleNormal;
+            double t = 0.0;
+            GEO::index_t f = 0.0;
+            bool intersection = denseMeshAABB.segment_nearest_intersection(qA1, qB1, t, f);
+            if (intersection)
             {
-                Pixel pix(x, y);  // top-left corner of the pixel
-                Point2d barycCoords;
-
-                // test if the pixel is inside triangle
-                // and retrieve its barycentric coordinates
-                if (!isPixelInTriangle(triPixs, pix, barycCoords))
-                {
-                    continue;
-                }
-
-                // remap 'y' to image coordinates system (inverted Y axis)
-                const unsigned int y_ = (texParams.textureSide - 1) - y;
-                // 1D pixel index
-                unsigned int xyoffset = y_ * texParams.textureSide + x;
-                // get 3D coordinates
-                // Point3d pt3d = barycentricToCartesian(triPts, Point2d(barycCoords.z, barycCoords.y));
-                Point3d pt3d = barycentricToCartesian(triPts, barycCoords);
-                GEO::vec3 q(pt3d.x, pt3d.y, pt3d.z);
-
-                // Texel normal (weighted normal from the 3 vertices normals), instead of face normal for better
-                // transitions (reduce seams)
-                const GEO::vec3 triangleNormal_p = mesh_facet_interpolate_normal_at_point(sparseMesh, triangleId, q);
-                // const GEO::vec3 triangleNormal_p = GEO::vec3(triangleNormal.m); // to use the triangle normal instead
-                const GEO::vec3 scaledTriangleNormal = triangleNormal_p * minEdgeLength * 10;
-
-                const double epsilon = 0.00001;
-                GEO::vec3 qA1 = q - (scaledTriangleNormal * epsilon);
-                GEO::vec3 qB1 = q + scaledTriangleNormal;
-                double t = 0.0;
-                GEO::index_t f = 0.0;
-                bool intersection = denseMeshAABB.segment_nearest_intersection(qA1, qB1, t, f);
+                computeNormalHeight(
+                  *denseMeshAABB.mesh(), 1.0, t, f, worldToTriangleMatrix, q, qA1, qB1, heightMap(xyoffset), normalMap(xyoffset));
+            }
+            else
+            {
+                GEO::vec3 qA2 = q + (scaledTriangleNormal * epsilon);
+                GEO::vec3 qB2 = q - scaledTriangleNormal;
+                bool intersection = denseMeshAABB.segment_nearest_intersection(qA2, qB2, t, f);
                 if (intersection)
                 {
                     computeNormalHeight(
-                      *denseMeshAABB.mesh(), 1.0, t, f, worldToTriangleMatrix, q, qA1, qB1, heightMap(xyoffset), normalMap(xyoffset));
+                      *denseMeshAABB.mesh(), -1.0, t, f, worldToTriangleMatrix, q, qA2, qB2, heightMap(xyoffset), normalMap(xyoffset));
                 }
                 else
                 {
-                    GEO::vec3 qA2 = q + (scaledTriangleNormal * epsilon);
-                    GEO::vec3 qB2 = q - scaledTriangleNormal;
-                    bool intersection = denseMeshAABB.segment_nearest_intersection(qA2, qB2, t, f);
-                    if (intersection)
-                    {
-                        computeNormalHeight(
-                          *denseMeshAABB.mesh(), -1.0, t, f, worldToTriangleMatrix, q, qA2, qB2, heightMap(xyoffset), normalMap(xyoffset));
-                    }
-                    else
-                    {
-                        heightMap(xyoffset) = 0.0f;
-                        normalMap(xyoffset) = image::RGBfColor(0.0f, 0.0f, 0.0f);
-                    }
+                    heightMap(xyoffset) = 0.0f;
+                    normalMap(xyoffset) = image::RGBfColor(0.0f, 0.0f, 0.0f);
                 }
             }
-        }
+        });
     }
 
     // Save Normal Map
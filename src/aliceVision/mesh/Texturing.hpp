@@ -98,6 +98,10 @@ struct TexturingParams
     EVisibilityRemappingMethod visibilityRemappingMethod = EVisibilityRemappingMethod::PullPush;
 
     float subdivisionTargetRatio = 0.8;
+
+    /// maximum number of cameras whose images and laplacian pyramids are prepared in background
+    /// while the current camera is processed (bounded by the available memory, 0 to disable)
+    unsigned int maxNbPrefetchedCameras = 2;
 };
 
 struct Texturing
@@ -203,7 +207,8 @@ struct Texturing
                                 const std::vector<size_t>& atlasIDs,
                                 mvsUtils::ImagesCache<image::Image<image::RGBfColor>>& imageCache,
                                 const fs::path& outPath,
-                                image::EImageFileType textureFileType = image::EImageFileType::PNG);
+                                image::EImageFileType textureFileType = image::EImageFileType::PNG,
+                                int nbPrefetchedCameras = 0);
 
     void generateNormalAndHeightMaps(const mvsUtils::MultiViewParams& mp,
                                      const Mesh& denseMesh,
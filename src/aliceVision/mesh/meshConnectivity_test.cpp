@@ -0,0 +1,229 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/MeshConnectivity.hpp>
+#include <aliceVision/mvsData/structures.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE meshConnectivity
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/**
+ * @brief Neighbor triangles of each point as previously computed by the mesh:
+ *        (point, triangle) pairs sorted by point with qsort.
+ */
+std::vector<std::vector<int>> getPtsNeighborTrianglesQSort(const Mesh& mesh)
+{
+    StaticVector<Voxel> vertexNeighborhoodPairs;
+    vertexNeighborhoodPairs.reserve(mesh.tris.size() * 3);
+    for (int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+            vertexNeighborhoodPairs.push_back(Voxel(mesh.tris[i].v[k], i, 0));
+    }
+    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+
+    std::vector<std::vector<int>> ptsNeighTris(mesh.pts.size());
+    for (int i = 0; i < vertexNeighborhoodPairs.size(); ++i)
+        ptsNeighTris[vertexNeighborhoodPairs[i].x].push_back(vertexNeighborhoodPairs[i].y);
+
+    // the order of the triangles of a point is not defined by qsort
+    for (std::vector<int>& ptNeighTris : ptsNeighTris)
+        std::sort(ptNeighTris.begin(), ptNeighTris.end());
+
+    return ptsNeighTris;
+}
+
+/**
+ * @brief Neighbor points of each point as previously computed by the mesh: linear search of each triangle vertex.
+ */
+std::vector<std::vector<int>> getPtsNeighborsFind(const Mesh& mesh, const std::vector<std::vector<int>>& ptsNeighTris)
+{
+    std::vector<std::vector<int>> ptsNeigh(mesh.pts.size());
+    for (int ptId = 0; ptId < mesh.pts.size(); ++ptId)
+    {
+        std::vector<int>& ptNeigh = ptsNeigh[ptId];
+        for (const int triId : ptsNeighTris[ptId])
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                const int neighPtId = mesh.tris[triId].v[k];
+                if (neighPtId != ptId && std::find(ptNeigh.begin(), ptNeigh.end(), neighPtId) == ptNeigh.end())
+                    ptNeigh.push_back(neighPtId);
+            }
+        }
+        std::sort(ptNeigh.begin(), ptNeigh.end());
+    }
+    return ptsNeigh;
+}
+
+/**
+ * @brief Check the compressed rows of the connectivity against the previous per-point arrays.
+ */
+void checkConnectivity(const Mesh& mesh, const MeshConnectivity& connectivity)
+{
+    const std::vector<std::vector<int>> ptsNeighTris = getPtsNeighborTrianglesQSort(mesh);
+    const std::vector<std::vector<int>> ptsNeigh = getPtsNeighborsFind(mesh, ptsNeighTris);
+
+    BOOST_REQUIRE_EQUAL(connectivity.getNbPoints(), mesh.pts.size());
+    BOOST_REQUIRE_EQUAL(connectivity.getNbTriangles(), mesh.tris.size());
+
+    for (int ptId = 0; ptId < mesh.pts.size(); ++ptId)
+    {
+        const MeshConnectivity::Range ptTris = connectivity.getPointTriangles(ptId);
+        BOOST_CHECK_EQUAL_COLLECTIONS(ptTris.begin(), ptTris.end(), ptsNeighTris[ptId].begin(), ptsNeighTris[ptId].end());
+
+        const MeshConnectivity::Range ptNeighPts = connectivity.getPointNeighbors(ptId);
+        BOOST_CHECK_EQUAL_COLLECTIONS(ptNeighPts.begin(), ptNeighPts.end(), ptsNeigh[ptId].begin(), ptsNeigh[ptId].end());
+    }
+}
+
+/**
+ * @brief Regular grid of size x size points, two triangles per cell, the triangles are shuffled.
+ */
+Mesh createGridMesh(int size)
+{
+    Mesh mesh;
+    mesh.pts.reserve(size * size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+            mesh.pts.push_back(Point3d(x, y, 0.0));
+    }
+
+    std::vector<Mesh::triangle> triangles;
+    for (int y = 0; y + 1 < size; ++y)
+    {
+        for (int x = 0; x + 1 < size; ++x)
+        {
+            const int a = y * size + x;
+            triangles.emplace_back(a, a + 1, a + size + 1);
+            triangles.emplace_back(a, a + size + 1, a + size);
+        }
+    }
+    // interleave the triangles so that the triangles of a point are not contiguous
+    for (std::size_t i = 0; i < triangles.size(); i += 2)
+        std::swap(triangles[i], triangles[triangles.size() - 1 - i]);
+
+    mesh.tris.reserve(triangles.size());
+    for (const Mesh::triangle& t : triangles)
+        mesh.tris.push_back(t);
+
+    return mesh;
+}
+
+}  // namespace
+
+// Test summary:
+// - Build the connectivity of a manifold grid mesh
+// - Check the triangles and the neighbor points of each point against the previous qsort adjacency
+BOOST_AUTO_TEST_CASE(MeshConnectivity_manifold)
+{
+    const Mesh mesh = createGridMesh(12);
+    const MeshConnectivity connectivity(mesh);
+
+    checkConnectivity(mesh, connectivity);
+
+    // inner points have 6 triangles and 6 neighbor points
+    const int innerPtId = 5 * 12 + 5;
+    BOOST_CHECK_EQUAL(connectivity.getPointTriangles(innerPtId).size(), 6);
+    BOOST_CHECK_EQUAL(connectivity.getPointNeighbors(innerPtId).size(), 6);
+}
+
+// Test summary:
+// - Build the connectivity of a non-manifold mesh: three triangles sharing an edge, two fans sharing a single point,
+//   a degenerated triangle and a free point
+// - Check the triangles and the neighbor points of each point against the previous qsort adjacency
+BOOST_AUTO_TEST_CASE(MeshConnectivity_nonManifold)
+{
+    Mesh mesh;
+    for (int i = 0; i < 11; ++i)
+        mesh.pts.push_back(Point3d(i, i % 3, i % 2));
+
+    // edge (0, 1) shared by three triangles
+    mesh.tris.push_back(Mesh::triangle(0, 1, 2));
+    mesh.tris.push_back(Mesh::triangle(1, 0, 3));
+    mesh.tris.push_back(Mesh::triangle(0, 1, 4));
+    // point 5 shared by two fans without any common edge
+    mesh.tris.push_back(Mesh::triangle(5, 6, 7));
+    mesh.tris.push_back(Mesh::triangle(5, 8, 9));
+    // degenerated triangle, listed twice for the point 6
+    mesh.tris.push_back(Mesh::triangle(6, 6, 2));
+    // point 10 is not used by any triangle
+
+    const MeshConnectivity connectivity(mesh);
+
+    checkConnectivity(mesh, connectivity);
+
+    BOOST_CHECK_EQUAL(connectivity.getPointNeighbors(0).size(), 4);
+    BOOST_CHECK_EQUAL(connectivity.getPointTriangles(5).size(), 2);
+    BOOST_CHECK_EQUAL(connectivity.getPointNeighbors(5).size(), 4);
+    BOOST_CHECK_EQUAL(connectivity.getPointTriangles(6).size(), 3);
+    BOOST_CHECK(connectivity.getPointTriangles(10).empty());
+    BOOST_CHECK(connectivity.getPointNeighbors(10).empty());
+}
+
+// Test summary:
+// - Get the connectivity kept by the mesh, then change the triangles with the mesh methods
+// - Check that the connectivity follows the new triangles
+BOOST_AUTO_TEST_CASE(MeshConnectivity_meshUpdates)
+{
+    Mesh mesh = createGridMesh(6);
+    checkConnectivity(mesh, mesh.getConnectivity());
+
+    // same number of points and triangles, different topology
+    mesh.changeTriPtId(0, mesh.tris[0].v[0], 35);
+    checkConnectivity(mesh, mesh.getConnectivity());
+
+    StaticVector<int> trisIdsToStay;
+    for (int i = 0; i < mesh.tris.size(); i += 2)
+        trisIdsToStay.push_back(i);
+    mesh.letJustTringlesIdsInMesh(trisIdsToStay);
+    checkConnectivity(mesh, mesh.getConnectivity());
+
+    // direct edition of the triangles
+    std::swap(mesh.tris[0].v[0], mesh.tris[1].v[0]);
+    mesh.clearConnectivity();
+    checkConnectivity(mesh, mesh.getConnectivity());
+}
+
+// Test summary:
+// - Get the connectivity of a mesh from several threads at the same time
+// - Check that it is built once and shared by all the threads
+// - Check that a copied mesh builds its own connectivity
+BOOST_AUTO_TEST_CASE(MeshConnectivity_concurrentFirstUse)
+{
+    const Mesh mesh = createGridMesh(40);
+
+    const int nbThreads = 8;
+    std::vector<const MeshConnectivity*> connectivities(nbThreads, nullptr);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nbThreads; ++i)
+        threads.emplace_back([&, i]() { connectivities[i] = &mesh.getConnectivity(); });
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (const MeshConnectivity* connectivity : connectivities)
+        BOOST_CHECK(connectivity == connectivities.front());
+    checkConnectivity(mesh, *connectivities.front());
+
+    Mesh meshCopy = mesh;
+    BOOST_CHECK(&meshCopy.getConnectivity() != &mesh.getConnectivity());
+    meshCopy.invertTriangleOrientations();
+    checkConnectivity(meshCopy, meshCopy.getConnectivity());
+    BOOST_CHECK(&mesh.getConnectivity() == connectivities.front());
+}
@@ -0,0 +1,245 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point2d.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Get the horizontal extent of the part of a 2D triangle inside a horizontal strip.
+ * @param[in] triangle the triangle as an array of 3 point2Ds
+ * @param[in] beginY the strip lower bound
+ * @param[in] endY the strip upper bound
+ * @param[out] minX the minimum abscissa of the triangle in the strip
+ * @param[out] maxX the maximum abscissa of the triangle in the strip
+ * @return false if the triangle does not intersect the strip
+ */
+inline bool getTriangleExtentInStrip(const Point2d* triangle, double beginY, double endY, double& minX, double& maxX)
+{
+    minX = std::numeric_limits<double>::max();
+    maxX = std::numeric_limits<double>::lowest();
+
+    const double stripY[2] = {beginY, endY};
+
+    // the part of the triangle in the strip is a convex polygon:
+    // its vertices are the triangle vertices in the strip and the intersections of the edges with the strip bounds
+    for (int k = 0; k < 3; ++k)
+    {
+        const Point2d& a = triangle[k];
+        const Point2d& b = triangle[(k + 1) % 3];
+
+        if (a.y >= beginY && a.y <= endY)
+        {
+            minX = std::min(minX, a.x);
+            maxX = std::max(maxX, a.x);
+        }
+
+        for (const double y : stripY)
+        {
+            if ((a.y - y) * (b.y - y) < 0.0)
+            {
+                const double x = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+            }
+        }
+    }
+    return minX <= maxX;
+}
+
+/**
+ * @brief Compute the squared distance between a point and a 2D triangle.
+ * @param[in] triangle the triangle as an array of 3 point2Ds
+ * @param[in] point the point
+ * @param[out] barycentricCoords the barycentric coordinates of the closest point of the triangle:
+ *             x is the weight of the third vertex, y the weight of the second vertex
+ * @return the squared distance
+ */
+inline double pointTriangleSquaredDistance(const Point2d* triangle, const Point2d& point, Point2d& barycentricCoords)
+{
+    // weights of the second and third vertices
+    double l1 = 0.0;
+    double l2 = 0.0;
+
+    const Point2d ab = triangle[1] - triangle[0];
+    const Point2d ac = triangle[2] - triangle[0];
+    const Point2d ap = point - triangle[0];
+    const double d1 = dot(ab, ap);
+    const double d2 = dot(ac, ap);
+
+    // closest feature search by Voronoi regions (Ericson, Real-Time Collision Detection)
+    if (d1 > 0.0 || d2 > 0.0)
+    {
+        const Point2d bp = point - triangle[1];
+        const double d3 = dot(ab, bp);
+        const double d4 = dot(ac, bp);
+        const double vc = d1 * d4 - d3 * d2;
+
+        const Point2d cp = point - triangle[2];
+        const double d5 = dot(ab, cp);
+        const double d6 = dot(ac, cp);
+        const double vb = d5 * d2 - d1 * d6;
+        const double va = d3 * d6 - d5 * d4;
+
+        if (d3 >= 0.0 && d4 <= d3)
+        {
+            l1 = 1.0;
+        }
+        else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        {
+            l1 = d1 / (d1 - d3);
+        }
+        else if (d6 >= 0.0 && d5 <= d6)
+        {
+            l2 = 1.0;
+        }
+        else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        {
+            l2 = d2 / (d2 - d6);
+        }
+        else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+        {
+            l2 = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            l1 = 1.0 - l2;
+        }
+        else if (va + vb + vc > 0.0)
+        {
+            l1 = vb / (va + vb + vc);
+            l2 = vc / (va + vb + vc);
+        }
+        else
+        {
+            // degenerated triangle: closest point on the first edge containing the point projection
+            const double abLength = dot(ab, ab);
+            l1 = (abLength > 0.0) ? std::clamp(d1 / abLength, 0.0, 1.0) : 0.0;
+        }
+    }
+
+    const Point2d closestPoint = triangle[0] + ab * l1 + ac * l2;
+    const Point2d diff = point - closestPoint;
+
+    barycentricCoords.x = l2;
+    barycentricCoords.y = l1;
+    return dot(diff, diff);
+}
+
+/**
+ * @brief Rasterize a 2D triangle in a pixel grid.
+ * @details The functor is called for each pixel of [beginX, endX[ x [beginY, endY[ whose center is closer to
+ *          the triangle than the given distance, with the barycentric coordinates of the closest point of the triangle.
+ *          Each row is only scanned on the extent of the triangle, the barycentric coordinates of the pixels
+ *          inside the triangle are updated incrementally along the row from the edge functions.
+ *          Only the pixels outside of the triangle need a distance computation.
+ * @param[in] triangle the triangle as an array of 3 point2Ds
+ * @param[in] beginX the first column
+ * @param[in] beginY the first row
+ * @param[in] endX the column after the last one
+ * @param[in] endY the row after the last one
+ * @param[in] maxSquaredDistance the pixels are selected if their squared distance to the triangle is lower than this value
+ * @param[in] f the functor called as f(x, y, barycentricCoords), x is the weight of the third vertex, y the weight of the second vertex
+ */
+template<typename Functor>
+void rasterizeTriangle(const Point2d* triangle, int beginX, int beginY, int endX, int endY, double maxSquaredDistance, Functor&& f)
+{
+    const double maxDistance = std::sqrt(maxSquaredDistance);
+
+    // twice the signed area of the triangle
+    const double area = (triangle[1].x - triangle[0].x) * (triangle[2].y - triangle[0].y) -
+                        (triangle[1].y - triangle[0].y) * (triangle[2].x - triangle[0].x);
+    const bool isDegenerated = (std::abs(area) <= std::numeric_limits<double>::epsilon());
+
+    // normalized edge functions: e[k](x, y) = a[k] * x + b[k] * y + c[k] is the barycentric coordinate of the vertex k
+    double a[3] = {0.0, 0.0, 0.0};
+    double b[3] = {0.0, 0.0, 0.0};
+    double c[3] = {0.0, 0.0, 0.0};
+
+    if (!isDegenerated)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const Point2d& pi = triangle[(k + 1) % 3];
+            const Point2d& pj = triangle[(k + 2) % 3];
+            a[k] = (pi.y - pj.y) / area;
+            b[k] = (pj.x - pi.x) / area;
+            c[k] = (pi.x * pj.y - pj.x * pi.y) / area;
+        }
+    }
+
+    for (int y = beginY; y < endY; ++y)
+    {
+        const double centerY = y + 0.5;
+
+        // the selected pixels of the row are in the extent of the triangle within the distance
+        double minX, maxX;
+        if (!getTriangleExtentInStrip(triangle, centerY - maxDistance, centerY + maxDistance, minX, maxX))
+            continue;
+
+        const int rowBeginX = std::max(beginX, static_cast<int>(std::ceil(minX - maxDistance - 0.5)));
+        const int rowEndX = std::min(endX, static_cast<int>(std::floor(maxX + maxDistance - 0.5)) + 1);
+
+        double e[3];
+        for (int k = 0; k < 3; ++k)
+            e[k] = a[k] * (rowBeginX + 0.5) + b[k] * centerY + c[k];
+
+        for (int x = rowBeginX; x < rowEndX; ++x)
+        {
+            if (!isDegenerated && e[0] >= 0.0 && e[1] >= 0.0 && e[2] >= 0.0)
+            {
+                // inside the triangle
+                f(x, y, Point2d(e[2], e[1]));
+            }
+            else
+            {
+                Point2d barycentricCoords;
+                if (pointTriangleSquaredDistance(triangle, Point2d(x + 0.5, centerY), barycentricCoords) < maxSquaredDistance)
+                    f(x, y, barycentricCoords);
+            }
+
+            for (int k = 0; k < 3; ++k)
+                e[k] += a[k];
+        }
+    }
+}
+
+/**
+ * @brief Conservative rasterization of a 2D triangle in a pixel grid.
+ * @details The functor is called for each pixel of [beginX, endX[ x [beginY, endY[ whose square [x, x+1] x [y, y+1]
+ *          intersects the triangle. Each row is only scanned on the extent of the triangle.
+ * @param[in] triangle the triangle as an array of 3 point2Ds
+ * @param[in] beginX the first column
+ * @param[in] beginY the first row
+ * @param[in] endX the column after the last one
+ * @param[in] endY the row after the last one
+ * @param[in] f the functor called as f(x, y)
+ */
+template<typename Functor>
+void rasterizeTriangleConservative(const Point2d* triangle, int beginX, int beginY, int endX, int endY, Functor&& f)
+{
+    for (int y = beginY; y < endY; ++y)
+    {
+        // the part of the triangle in the row is convex: a pixel square intersects it
+        // if and only if its horizontal range intersects the horizontal extent of this part
+        double minX, maxX;
+        if (!getTriangleExtentInStrip(triangle, y, y + 1.0, minX, maxX))
+            continue;
+
+        const int rowBeginX = std::max(beginX, static_cast<int>(std::ceil(minX)) - 1);
+        const int rowEndX = std::min(endX, static_cast<int>(std::floor(maxX)) + 1);
+
+        for (int x = rowBeginX; x < rowEndX; ++x)
+            f(x, y);
+    }
+}
+
+}  // namespace mesh
+}  // namespace aliceVision
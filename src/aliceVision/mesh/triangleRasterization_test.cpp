@@ -0,0 +1,175 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/triangleRasterization.hpp>
+
+#include <geogram/basic/geometry_nd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE triangleRasterization
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+const double pixelInTriangleMaxSquaredDistance = 0.5 + std::numeric_limits<double>::epsilon();
+
+/**
+ * @brief Per-pixel test previously used by the texturing: distance from the pixel center to the triangle.
+ */
+bool isPixelInTriangle(const Point2d* triangle, const Pixel& pixel, Point2d& barycentricCoords)
+{
+    GEO::vec2 p(pixel.x + 0.5, pixel.y + 0.5);
+    GEO::vec2 V0(triangle[0].x, triangle[0].y);
+    GEO::vec2 V1(triangle[1].x, triangle[1].y);
+    GEO::vec2 V2(triangle[2].x, triangle[2].y);
+    GEO::vec2 closestPoint;
+    double l1, l2, l3;
+    const double dist = GEO::Geom::point_triangle_squared_distance<GEO::vec2>(p, V0, V1, V2, closestPoint, l1, l2, l3);
+    barycentricCoords.x = l3;
+    barycentricCoords.y = l2;
+    return dist < pixelInTriangleMaxSquaredDistance;
+}
+
+/**
+ * @brief Random triangles in a 64x64 pixels area: regular, thin (sliver) and needle triangles.
+ */
+std::vector<std::array<Point2d, 3>> getRandomTriangles(int nbTriangles)
+{
+    std::mt19937 generator(0);
+    // the vertices stay in the texture area
+    std::uniform_real_distribution<double> position(20.0, 44.0);
+    std::uniform_real_distribution<double> offset(-18.0, 18.0);
+    std::uniform_real_distribution<double> thinOffset(-0.05, 0.05);
+
+    std::vector<std::array<Point2d, 3>> triangles;
+    for (int i = 0; i < nbTriangles; ++i)
+    {
+        const Point2d a(position(generator), position(generator));
+        const Point2d b(a.x + offset(generator), a.y + offset(generator));
+        Point2d c(a.x + offset(generator), a.y + offset(generator));
+
+        switch (i % 3)
+        {
+            case 1:
+                // thin triangle: third vertex close to the first edge
+                c = (a + b) * 0.5 + Point2d(thinOffset(generator), thinOffset(generator));
+                break;
+            case 2:
+                // needle triangle: two vertices close to each other
+                c = b + Point2d(thinOffset(generator), thinOffset(generator));
+                break;
+            default:
+                break;
+        }
+
+        triangles.push_back({a, b, c});
+    }
+    return triangles;
+}
+
+}  // namespace
+
+// Test summary:
+// - Rasterize random, thin and needle triangles with the row spans rasterizer
+// - Check that the selected pixels and their barycentric coordinates match the per-pixel test on the bounding box
+BOOST_AUTO_TEST_CASE(TriangleRasterization_matchesPixelInTriangle)
+{
+    const int textureSide = 64;
+
+    for (const auto& triangle : getRandomTriangles(3000))
+    {
+        const Point2d* triPixs = triangle.data();
+
+        // same bounding box as the texturing
+        const int luX = std::clamp(static_cast<int>(std::floor(std::min({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, textureSide);
+        const int luY = std::clamp(static_cast<int>(std::floor(std::min({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, textureSide);
+        const int rdX = std::clamp(static_cast<int>(std::ceil(std::max({triPixs[0].x, triPixs[1].x, triPixs[2].x}))), 0, textureSide);
+        const int rdY = std::clamp(static_cast<int>(std::ceil(std::max({triPixs[0].y, triPixs[1].y, triPixs[2].y}))), 0, textureSide);
+
+        std::map<std::pair<int, int>, Point2d> expectedPixels;
+        for (int y = luY; y < rdY; ++y)
+        {
+            for (int x = luX; x < rdX; ++x)
+            {
+                Point2d barycCoords;
+                if (isPixelInTriangle(triPixs, Pixel(x, y), barycCoords))
+                    expectedPixels.emplace(std::make_pair(x, y), barycCoords);
+            }
+        }
+
+        std::map<std::pair<int, int>, Point2d> pixels;
+        rasterizeTriangle(triPixs, luX, luY, rdX, rdY, pixelInTriangleMaxSquaredDistance, [&](int x, int y, const Point2d& barycCoords) {
+            // each pixel is given once
+            BOOST_CHECK(pixels.emplace(std::make_pair(x, y), barycCoords).second);
+        });
+
+        BOOST_REQUIRE_EQUAL(pixels.size(), expectedPixels.size());
+
+        for (const auto& [pixel, barycCoords] : pixels)
+        {
+            const auto it = expectedPixels.find(pixel);
+            BOOST_REQUIRE(it != expectedPixels.end());
+            BOOST_CHECK_SMALL(barycCoords.x - it->second.x, 1e-6);
+            BOOST_CHECK_SMALL(barycCoords.y - it->second.y, 1e-6);
+        }
+    }
+}
+
+// Test summary:
+// - Rasterize random, thin and needle triangles with the conservative row spans rasterizer
+// - Check that the selected pixels match the triangle/pixel square overlap test on the bounding box
+BOOST_AUTO_TEST_CASE(TriangleRasterization_conservativeMatchesTriangleRectangleIntersection)
+{
+    Mesh mesh;
+
+    for (const auto& triangle : getRandomTriangles(3000))
+    {
+        Mesh::triangle_proj tp;
+        tp.lu = Pixel(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        tp.rd = Pixel(0, 0);
+        for (int j = 0; j < 3; ++j)
+        {
+            tp.tp2ds[j] = triangle[j];
+            tp.lu.x = std::min(tp.lu.x, static_cast<int>(triangle[j].x));
+            tp.lu.y = std::min(tp.lu.y, static_cast<int>(triangle[j].y));
+            tp.rd.x = std::max(tp.rd.x, static_cast<int>(triangle[j].x));
+            tp.rd.y = std::max(tp.rd.y, static_cast<int>(triangle[j].y));
+        }
+
+        std::set<std::pair<int, int>> expectedPixels;
+        for (int x = tp.lu.x; x <= tp.rd.x; ++x)
+        {
+            for (int y = tp.lu.y; y <= tp.rd.y; ++y)
+            {
+                Mesh::rectangle re(Pixel(x, y), 1);
+                if (mesh.doesTriangleIntersectsRectangle(tp, re))
+                    expectedPixels.emplace(x, y);
+            }
+        }
+
+        std::set<std::pair<int, int>> pixels;
+        rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int x, int y) {
+            BOOST_CHECK(pixels.emplace(x, y).second);
+        });
+
+        BOOST_CHECK(pixels == expectedPixels);
+    }
+}
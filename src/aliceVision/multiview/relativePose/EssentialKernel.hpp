@@ -69,6 +69,15 @@ class EssentialKernel : public robustEstimation::PointFittingKernel<SolverT, Err
         return KernelBase::_errorEstimator.error(modelF, KernelBase::_x1.col(sample), KernelBase::_x2.col(sample));
     }
 
+    void errors(const ModelT& model, std::vector<double>& errors) const override
+    {
+        // compute F once for all the samples
+        Mat3 F;
+        fundamentalFromEssential(model.getMatrix(), _K1, _K2, &F);
+        const robustEstimation::Mat3Model modelF(F);
+        KernelBase::_errorEstimator.errors(modelF, KernelBase::_x1, KernelBase::_x2, errors);
+    }
+
   protected:
     // The two camera calibrated camera matrix
     Mat3 _K1, _K2;
@@ -31,6 +31,20 @@ struct FundamentalSampsonError : public ISolverErrorRelativePose<robustEstimatio
 
         return Square(y.dot(F_x)) / (F_x.head<2>().squaredNorm() + Ft_y.head<2>().squaredNorm());
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const Mat3& f = F.getMatrix();
+
+        // epipolar lines of all the points at once
+        const Mat F_x = (f.leftCols<2>() * x1).colwise() + f.col(2);
+        const Mat Ft_y = (f.transpose().leftCols<2>() * x2).colwise() + f.row(2).transpose();
+        const Vec yFx = (x2.array() * F_x.topRows<2>().array()).colwise().sum().transpose() + F_x.row(2).transpose().array();
+
+        errors.resize(x1.cols());
+        Eigen::Map<Vec>(errors.data(), errors.size()) =
+          yFx.array().square() / (F_x.topRows<2>().colwise().squaredNorm() + Ft_y.topRows<2>().colwise().squaredNorm()).transpose().array();
+    }
 };
 
 struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -47,6 +61,22 @@ struct FundamentalSymmetricEpipolarDistanceError : public ISolverErrorRelativePo
         // @note the divide by 4 is to make this match the Sampson distance.
         return Square(y.dot(F_x)) * (1.0 / F_x.head<2>().squaredNorm() + 1.0 / Ft_y.head<2>().squaredNorm()) / 4.0;
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const Mat3& f = F.getMatrix();
+
+        // epipolar lines of all the points at once
+        const Mat F_x = (f.leftCols<2>() * x1).colwise() + f.col(2);
+        const Mat Ft_y = (f.transpose().leftCols<2>() * x2).colwise() + f.row(2).transpose();
+        const Vec yFx = (x2.array() * F_x.topRows<2>().array()).colwise().sum().transpose() + F_x.row(2).transpose().array();
+
+        errors.resize(x1.cols());
+        Eigen::Map<Vec>(errors.data(), errors.size()) =
+          yFx.array().square() *
+          (F_x.topRows<2>().colwise().squaredNorm().cwiseInverse() + Ft_y.topRows<2>().colwise().squaredNorm().cwiseInverse()).transpose().array() /
+          4.0;
+    }
 };
 
 struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robustEstimation::Mat3Model>
@@ -61,6 +91,18 @@ struct FundamentalEpipolarDistanceError : public ISolverErrorRelativePose<robust
 
         return Square(F_x.dot(y)) / F_x.head<2>().squaredNorm();
     }
+
+    void errors(const robustEstimation::Mat3Model& F, const Mat& x1, const Mat& x2, std::vector<double>& errors) const override
+    {
+        const Mat3& f = F.getMatrix();
+
+        // epipolar lines in image 2 of all the points at once
+        const Mat F_x = (f.leftCols<2>() * x1).colwise() + f.col(2);
+        const Vec yFx = (x2.array() * F_x.topRows<2>().array()).colwise().sum().transpose() + F_x.row(2).transpose().array();
+
+        errors.resize(x1.cols());
+        Eigen::Map<Vec>(errors.data(), errors.size()) = yFx.array().square() / F_x.topRows<2>().colwise().squaredNorm().transpose().array();
+    }
 };
 
 struct EpipolarSphericalDistanceError
@@ -122,3 +122,31 @@ BOOST_AUTO_TEST_CASE(NormalizedFundamental8PKernel_EasyCase)
 
     BOOST_CHECK(expectKernelProperties<relativePose::NormalizedFundamental8PKernel>(x1, x2));
 }
+
+// check that the errors of all the correspondences at once match the error of each correspondence
+template<typename ErrorT>
+void checkBatchErrors(const robustEstimation::Mat3Model& model, const Mat& x1, const Mat& x2)
+{
+    const ErrorT errorEstimator;
+    std::vector<double> errors;
+    errorEstimator.errors(model, x1, x2, errors);
+
+    BOOST_CHECK_EQUAL(errors.size(), x1.cols());
+    for (Mat::Index i = 0; i < x1.cols(); ++i)
+        BOOST_CHECK_SMALL(errors[i] - errorEstimator.error(model, x1.col(i), x2.col(i)), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(FundamentalError_BatchErrors)
+{
+    Mat x1(2, 8), x2(2, 8);
+    x1 << 0, 0, 0, 1, 1, 1, 2, 2, 0, 1, 2, 0, 1, 2, 0, 1;
+    x2 << 0, 0, 0, 1, 1, 1, 2, 2, 1, 2, 3, 1, 2, 3, 1, 2;
+
+    Mat3 F;
+    F << 0.1, -0.7, 0.3, 0.5, 0.2, -0.4, -0.3, 0.6, 0.9;
+    const robustEstimation::Mat3Model model(F);
+
+    checkBatchErrors<relativePose::FundamentalSampsonError>(model, x1, x2);
+    checkBatchErrors<relativePose::FundamentalSymmetricEpipolarDistanceError>(model, x1, x2);
+    checkBatchErrors<relativePose::FundamentalEpipolarDistanceError>(model, x1, x2);
+}
@@ -90,3 +90,22 @@ BOOST_AUTO_TEST_CASE(Homography4PKernel_Fitting)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(HomographyAsymmetricError_BatchErrors)
+{
+    Mat x1(2, 9), x2(2, 9);
+    x1 << 0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2;
+    x2 << 1, 0, 2, 1, 3, 1, 2, 4, 2, 0, 2, 2, 1, 1, 3, 0, 1, 5;
+
+    Mat3 H;
+    H << 1, -2, 3, 4, 5, -6, -7, 8, 1;
+    const robustEstimation::Mat3Model model(H);
+
+    const relativePose::HomographyAsymmetricError errorEstimator;
+    std::vector<double> errors;
+    errorEstimator.errors(model, x1, x2, errors);
+
+    BOOST_CHECK_EQUAL(errors.size(), x1.cols());
+    for (Mat::Index i = 0; i < x1.cols(); ++i)
+        BOOST_CHECK_SMALL(errors[i] - errorEstimator.error(model, x1.col(i), x2.col(i)), 1e-9);
+}
@@ -29,6 +29,8 @@
 #include "ceres/ceres.h"
 #include "ceres/rotation.h"
 
+#include <Eigen/SparseCholesky>
+
 #include <map>
 #include <queue>
 #include <stdint.h>
@@ -59,6 +61,44 @@ namespace l1 {
 // the decoder can use (PA) to recover x exactly. When x, A, y have real-valued entries,
 // (PA) can be recast as an LP.
 //
+
+// Linear solver of the normal equations (At * W * A) x = At * W * b:
+// dense LDLT for a dense A, sparse LDLT for a sparse A (the normal matrix keeps the sparsity of the view graph)
+template<typename MATRIX_TYPE>
+struct NormalEquationsSolver
+{
+    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
+
+    bool compute(const Matrix& H)
+    {
+        solver.compute(H);
+        return solver.info() == Eigen::Success;
+    }
+
+    Eigen::LDLT<Matrix> solver;
+};
+
+template<>
+struct NormalEquationsSolver<Eigen::SparseMatrix<REAL, Eigen::ColMajor>>
+{
+    typedef Eigen::SparseMatrix<REAL, Eigen::ColMajor> Matrix;
+
+    bool compute(const Matrix& H)
+    {
+        // the sparsity pattern only depends on the view graph: it is analyzed once and reused by the next iterations
+        if (!patternAnalyzed)
+        {
+            solver.analyzePattern(H);
+            patternAnalyzed = true;
+        }
+        solver.factorize(H);
+        return solver.info() == Eigen::Success;
+    }
+
+    Eigen::SimplicialLDLT<Matrix> solver;
+    bool patternAnalyzed = false;
+};
+
 template<typename MATRIX_TYPE>
 inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
                                   const Eigen::Matrix<REAL, Eigen::Dynamic, 1>& y,
@@ -66,7 +106,7 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
                                   REAL pdtol,
                                   unsigned pdmaxiter)
 {
-    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
+    typedef typename NormalEquationsSolver<MATRIX_TYPE>::Matrix Matrix;
     typedef Eigen::Matrix<REAL, Eigen::Dynamic, 1> Vector;
     const unsigned M = (unsigned)y.size();
     const unsigned N = (unsigned)xp.size();
@@ -101,6 +141,7 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
     Vector Axp(M), Atvp(M);
     Vector &Adx(sigx), &du(w2), &w1p(dx);
     Matrix H11p(N, N);
+    NormalEquationsSolver<MATRIX_TYPE> solver;
     Vector &dlamu1(tmpM3), &dlamu2(tmpM4);
     for (unsigned pditer = 0; pditer < pdmaxiter; ++pditer)
     {
@@ -133,7 +174,8 @@ inline bool TRobustRegressionL1PD(const MATRIX_TYPE& A,
         w1p = At * (tmpM4 - tmpM3 - (sig2.cwiseQuotient(sig1).cwiseProduct(w2)));
 
         // optimized solver as A is positive definite and symmetric
-        dx = H11p.ldlt().solve(w1p);
+        solver.compute(H11p);
+        dx = solver.solver.solve(w1p);
 
         Adx = A * dx;
 
@@ -248,13 +290,13 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
                                                REAL sigma,
                                                REAL eps)
 {
-    typedef Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Matrix;
     typedef Eigen::Matrix<REAL, Eigen::Dynamic, 1> Vector;
     const unsigned m = (unsigned)b.size();
     const unsigned n = (unsigned)x.size();
     assert(A.rows() == m && A.cols() == n);
 
     // iterate optimization till the desired precision is reached
+    NormalEquationsSolver<MATRIX_TYPE> solver;
     Vector xp(n), e(m);
     const REAL sigmaSq(Square(sigma));
     unsigned iter = 0;
@@ -265,7 +307,8 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
         // compute error vector
         e = A * x - b;
         // compute robust errors using the Huber-like loss function
-        for (unsigned i = 0; i < m; ++i)
+#pragma omp parallel for if (m > 4096)
+        for (int i = 0; i < (int)m; ++i)
         {
             REAL& err = e(i);
             const REAL errSq(Square(err));
@@ -273,14 +316,14 @@ inline bool TIterativelyReweightedLeastSquares(const MATRIX_TYPE& A,
         }
         // solve the linear system using l2 norm
         const MATRIX_TYPE AtF(A.transpose() * e.asDiagonal());
-        const Eigen::LDLT<Matrix> solver(AtF * A);  // compute the Cholesky decomposition
-        if (solver.info() != Eigen::Success)
+        // compute the Cholesky decomposition
+        if (!solver.compute(AtF * A))
         {
             ALICEVISION_LOG_WARNING("error: decomposing linear system failed");
             return false;
         }
-        x = solver.solve(AtF * b);
-        if (solver.info() != Eigen::Success)
+        x = solver.solver.solve(AtF * b);
+        if (solver.solver.info() != Eigen::Success)
         {
             ALICEVISION_LOG_WARNING("error: solving linear system failed");
             return false;
@@ -624,7 +667,8 @@ inline void _FillMappingMatrix(const RelativeRotations& RelRs, const size_t nMai
 // compute errors for each relative rotation
 inline void _FillErrorMatrix(const RelativeRotations& RelRs, const Matrix3x3Arr& Rs, Eigen::Matrix<REAL, Eigen::Dynamic, 1>& b)
 {
-    for (size_t r = 0; r < RelRs.size(); ++r)
+#pragma omp parallel for if (RelRs.size() > 1024)
+    for (int r = 0; r < (int)RelRs.size(); ++r)
     {
         const RelativeRotation& relR = RelRs[r];
         const Matrix3x3& Ri = Rs[relR.i];
@@ -640,12 +684,13 @@ inline void _FillErrorMatrix(const RelativeRotations& RelRs, const Matrix3x3Arr&
 // apply correction to global rotations
 inline void _CorrectMatrix(const Eigen::Matrix<REAL, Eigen::Dynamic, 1>& x, const size_t nMainViewID, Matrix3x3Arr& Rs)
 {
-    for (size_t r = 0; r < Rs.size(); ++r)
+#pragma omp parallel for if (Rs.size() > 1024)
+    for (int r = 0; r < (int)Rs.size(); ++r)
     {
-        if (r == nMainViewID)
+        if (static_cast<size_t>(r) == nMainViewID)
             continue;
         Matrix3x3& Ri = Rs[r];
-        const size_t i = (r < nMainViewID ? r : r - 1);
+        const size_t i = (static_cast<size_t>(r) < nMainViewID ? r : r - 1);
         aliceVision::Vec3 eRid = aliceVision::Vec3(x.block<3, 1>(3 * i, 0));
         const Mat3 eRi;
         ceres::AngleAxisToRotationMatrix((const double*)eRid.data(), (double*)eRi.data());
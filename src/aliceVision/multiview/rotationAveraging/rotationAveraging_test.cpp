@@ -8,6 +8,7 @@
 #include "aliceVision/multiview/rotationAveraging/rotationAveraging.hpp"
 #include "aliceVision/multiview/essential.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include "aliceVision/multiview/NViewDataSet.hpp"
 
 #include <iostream>
@@ -311,6 +312,75 @@ BOOST_AUTO_TEST_CASE(rotationAveraging_RefineRotationsAvgL1IRLS_CompleteGraph_ou
     }
 }
 
+// Compare the dense and sparse solvers of the L1RA and IRLS steps on the view graph of a ring of cameras,
+// each camera being linked to the next ones. The timings are logged as a benchmark.
+BOOST_AUTO_TEST_CASE(rotationAveraging_SparseDenseSolvers)
+{
+    makeRandomOperationsReproducible();
+
+    const std::size_t nbNeighbors = 4;
+
+    for (const std::size_t nbViews : {20, 200})
+    {
+        // Mapping matrix of the relative rotations (i, i + k), the first view is kept constant
+        const std::size_t nbRelRotations = nbViews * nbNeighbors;
+        const std::size_t m = 3 * nbRelRotations;
+        const std::size_t n = 3 * (nbViews - 1);
+
+        Eigen::SparseMatrix<REAL, Eigen::ColMajor> sparseA(m, n);
+        std::vector<Eigen::Triplet<REAL>> triplets;
+        std::size_t row = 0;
+        for (std::size_t i = 0; i < nbViews; ++i)
+        {
+            for (std::size_t k = 1; k <= nbNeighbors; ++k, row += 3)
+            {
+                const std::size_t j = (i + k) % nbViews;
+                for (std::size_t c = 0; c < 3; ++c)
+                {
+                    if (i != 0)
+                        triplets.emplace_back(row + c, 3 * (i - 1) + c, REAL(-1));
+                    if (j != 0)
+                        triplets.emplace_back(row + c, 3 * (j - 1) + c, REAL(1));
+                }
+            }
+        }
+        sparseA.setFromTriplets(triplets.begin(), triplets.end());
+        sparseA.makeCompressed();
+        const Eigen::Matrix<REAL, Eigen::Dynamic, Eigen::Dynamic> denseA(sparseA);
+
+        // Small rotation errors with a few outliers
+        Vec b = Vec::Random(m) * 0.01;
+        for (std::size_t i = 0; i < m; i += 37)
+            b(i) = 0.5;
+
+        {
+            Vec xDense(Vec::Zero(n)), xSparse(Vec::Zero(n));
+            system::Timer timer;
+            BOOST_CHECK(RobustRegressionL1PD(denseA, b, xDense));
+            const double denseTime = timer.elapsedMs();
+            timer.reset();
+            BOOST_CHECK(RobustRegressionL1PD(sparseA, b, xSparse));
+            const double sparseTime = timer.elapsedMs();
+
+            ALICEVISION_LOG_INFO("L1RA with " << nbViews << " views: dense " << denseTime << " ms, sparse " << sparseTime << " ms.");
+            BOOST_CHECK_SMALL((xDense - xSparse).norm(), 1e-6);
+        }
+        {
+            Vec xDense(Vec::Zero(n)), xSparse(Vec::Zero(n));
+            const REAL sigma = degreeToRadian(5.0);
+            system::Timer timer;
+            BOOST_CHECK(IterativelyReweightedLeastSquares(denseA, b, xDense, sigma));
+            const double denseTime = timer.elapsedMs();
+            timer.reset();
+            BOOST_CHECK(IterativelyReweightedLeastSquares(sparseA, b, xSparse, sigma));
+            const double sparseTime = timer.elapsedMs();
+
+            ALICEVISION_LOG_INFO("IRLS with " << nbViews << " views: dense " << denseTime << " ms, sparse " << sparseTime << " ms.");
+            BOOST_CHECK_SMALL((xDense - xSparse).norm(), 1e-8);
+        }
+    }
+}
+
 /*
 template<typename TYPE, int N>
 inline REAL ComputePSNR(const Eigen::Matrix<REAL, N,1>& x0, const Eigen::Matrix<REAL, N,1>& x)
@@ -25,6 +25,39 @@ bool solve_translations_problem_l2_chordal(const int* edges,
                                            double parameter_tolerance,
                                            int max_iterations);
 
+/**
+ * @brief Compute camera center positions from relative translation directions
+ *        with a baseline desensitized robust cost.
+ *
+ * Implementation of [3]: the cost sum_ij w_ij * rho(||s_ij * (X_j - X_i) - v_ij||) is minimized
+ * by Iteratively Reweighted Least Squares on the camera centers, the baseline scales s_ij being
+ * eliminated in closed form. It is initialized with unit baselines (a sparse graph Laplacian solve)
+ * and each damped Gauss-Newton step solves a sparse system whose pattern is analyzed once.
+ *
+ * [3] "Baseline Desensitizing In Translation Averaging."
+ * Authors: Bingbing Zhuang, Loong-Fah Cheong and Gim Hee Lee.
+ * Date: 2018.
+ * Conference: CVPR.
+ *
+ * @param[in] edges pairs of camera indexes (2 * num_edges)
+ * @param[in] poses unit direction from the first to the second camera center of each edge (3 * num_edges)
+ * @param[in] weights weight of each edge
+ * @param[in] num_edges number of edges
+ * @param[in] loss_width scale of the Cauchy robust loss (0: no robust loss)
+ * @param[out] X camera centers (3 * number of cameras), the first camera is fixed in {0,0,0}
+ * @param[in] tolerance stop when the relative change of the camera centers is below this threshold
+ * @param[in] max_iterations maximum number of reweighting iterations
+ * @return True if the graph of the edges is connected and a solution is found
+ */
+bool solve_translations_problem_bata(const int* edges,
+                                     const double* poses,
+                                     const double* weights,
+                                     int num_edges,
+                                     double loss_width,
+                                     double* X,
+                                     double tolerance,
+                                     int max_iterations);
+
 /**
  * @brief Registration of relative translations to global translations. It implements LInf minimization of  [2]
  *  as a SoftL1 minimization. It can use 2/3 views relative translation vectors (bearing, or triplets of translations).
@@ -0,0 +1,292 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/multiview/translationAveraging/common.hpp>
+#include <aliceVision/multiview/translationAveraging/solver.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace aliceVision {
+namespace translationAveraging {
+
+void reindex_problem(int* edges, int num_edges, std::vector<int>& reindex_lookup);
+
+namespace {
+
+/**
+ * @brief Compute the residual s * delta - v of an edge, with the optimal baseline scale s = <delta, v> / |delta|^2,
+ *        and its Jacobian with respect to delta (the scale is eliminated in closed form).
+ * @param[in] delta The difference of the camera centers X_j - X_i
+ * @param[in] v The unit direction of the edge
+ * @param[out] residual The residual of the edge
+ * @param[out] jacobian The Jacobian of the residual with respect to delta
+ * @note Merged camera centers have a null scale, so their residual -v has the maximum norm 1.
+ *       Their Jacobian is the one of the unit baseline residual delta - v, that pulls the centers apart along v.
+ */
+void computeEdgeResidual(const Vec3& delta, const Vec3& v, Vec3& residual, Mat3* jacobian)
+{
+    const double squaredNorm = delta.squaredNorm();
+    if (squaredNorm <= std::numeric_limits<double>::epsilon())
+    {
+        residual = -v;
+        if (jacobian)
+            *jacobian = Mat3::Identity();
+        return;
+    }
+
+    const double projection = delta.dot(v);
+    const double scale = std::max(projection, 0.0) / squaredNorm;
+    residual = scale * delta - v;
+
+    if (jacobian)
+    {
+        *jacobian = scale * Mat3::Identity();
+        // a reversed direction has a null scale: its residual does not depend on the camera centers
+        if (projection > 0.0)
+        {
+            const Vec3 scaleGradient = v / squaredNorm - 2.0 * projection / (squaredNorm * squaredNorm) * delta;
+            *jacobian += delta * scaleGradient.transpose();
+        }
+    }
+}
+
+/**
+ * @brief Robust cost of a residual
+ * @param[in] squaredResidual The squared norm of the residual
+ * @param[in] lossWidth The scale of the Cauchy loss (0: squared loss)
+ * @return the cost
+ */
+inline double robustCost(double squaredResidual, double lossWidth)
+{
+    if (lossWidth <= 0.0)
+        return squaredResidual;
+    const double squaredWidth = lossWidth * lossWidth;
+    return squaredWidth * std::log1p(squaredResidual / squaredWidth);
+}
+
+/**
+ * @brief IRLS weight of a residual
+ * @param[in] squaredResidual The squared norm of the residual
+ * @param[in] lossWidth The scale of the Cauchy loss (0: squared loss)
+ * @return the weight
+ */
+inline double robustWeight(double squaredResidual, double lossWidth)
+{
+    if (lossWidth <= 0.0)
+        return 1.0;
+    return 1.0 / (1.0 + squaredResidual / (lossWidth * lossWidth));
+}
+
+}  // namespace
+
+bool solve_translations_problem_bata(const int* edges,
+                                     const double* poses,
+                                     const double* weights,
+                                     int num_edges,
+                                     double loss_width,
+                                     double* X,
+                                     double tolerance,
+                                     int max_iterations)
+{
+    if (num_edges <= 0)
+        return false;
+
+    // re index the edges to be a sequential set
+    std::vector<int> _edges(edges, edges + 2 * num_edges);
+    std::vector<int> reindex_lookup;
+    reindex_problem(&_edges[0], num_edges, reindex_lookup);
+    const int num_nodes = reindex_lookup.size();
+
+    // the first camera is fixed in {0,0,0}: the unknowns are the other camera centers
+    const int num_unknowns = num_nodes - 1;
+    std::vector<Vec3> centers(num_nodes, Vec3::Zero());
+
+    auto direction = [&](int e) { return Eigen::Map<const Vec3>(poses + 3 * e); };
+
+    // Initialization with unit baselines: X_j - X_i = v_ij.
+    // The normal equations are the same for each axis: a weighted graph Laplacian with 3 right hand sides.
+    {
+        std::vector<Eigen::Triplet<double>> coefficients;
+        coefficients.reserve(4 * num_edges);
+        Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(num_unknowns, 3);
+        for (int e = 0; e < num_edges; ++e)
+        {
+            const int a = _edges[2 * e + 0] - 1;
+            const int b = _edges[2 * e + 1] - 1;
+            const double w = weights[e];
+            if (a >= 0)
+            {
+                coefficients.emplace_back(a, a, w);
+                rhs.row(a) -= w * direction(e).transpose();
+            }
+            if (b >= 0)
+            {
+                coefficients.emplace_back(b, b, w);
+                rhs.row(b) += w * direction(e).transpose();
+            }
+            if (a >= 0 && b >= 0)
+            {
+                coefficients.emplace_back(a, b, -w);
+                coefficients.emplace_back(b, a, -w);
+            }
+        }
+        Eigen::SparseMatrix<double> laplacian(num_unknowns, num_unknowns);
+        laplacian.setFromTriplets(coefficients.begin(), coefficients.end());
+
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(laplacian);
+        if (solver.info() != Eigen::Success)
+        {
+            ALICEVISION_LOG_WARNING("BATA translation averaging: the graph of the relative translations is not connected.");
+            return false;
+        }
+        const Eigen::MatrixXd solution = solver.solve(rhs);
+        if (solver.info() != Eigen::Success || !solution.allFinite())
+            return false;
+        for (int i = 0; i < num_unknowns; ++i)
+            centers[i + 1] = solution.row(i).transpose();
+    }
+
+    auto computeCost = [&](const std::vector<Vec3>& x) {
+        double cost = 0.0;
+        Vec3 residual;
+        for (int e = 0; e < num_edges; ++e)
+        {
+            computeEdgeResidual(x[_edges[2 * e + 1]] - x[_edges[2 * e + 0]], direction(e), residual, nullptr);
+            cost += weights[e] * robustCost(residual.squaredNorm(), loss_width);
+        }
+        return cost;
+    };
+
+    // Iteratively Reweighted Least Squares on the camera centers, the baseline scales are eliminated in closed form.
+    // Each linearized system is damped (Levenberg-Marquardt) since the cost is invariant to a global scale of the centers.
+    // The sparsity pattern of the system only depends on the edges, it is analyzed once.
+    std::vector<Eigen::Triplet<double>> coefficients;
+    coefficients.reserve(4 * 9 * num_edges);
+    Eigen::SparseMatrix<double> hessian(3 * num_unknowns, 3 * num_unknowns);
+    Eigen::VectorXd gradient(3 * num_unknowns);
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
+    bool patternAnalyzed = false;
+
+    double cost = computeCost(centers);
+    double damping = 1e-6;
+    int nbIterations = 0;
+    while (nbIterations < max_iterations)
+    {
+        ++nbIterations;
+        coefficients.clear();
+        gradient.setZero();
+
+        for (int e = 0; e < num_edges; ++e)
+        {
+            const int a = _edges[2 * e + 0] - 1;
+            const int b = _edges[2 * e + 1] - 1;
+            Vec3 residual;
+            Mat3 jacobian;
+            computeEdgeResidual(centers[b + 1] - centers[a + 1], direction(e), residual, &jacobian);
+
+            const double w = weights[e] * robustWeight(residual.squaredNorm(), loss_width);
+            const Mat3 h = w * jacobian.transpose() * jacobian;
+            const Vec3 g = w * jacobian.transpose() * residual;
+
+            for (int r = 0; r < 3; ++r)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    if (a >= 0)
+                        coefficients.emplace_back(3 * a + r, 3 * a + c, h(r, c));
+                    if (b >= 0)
+                        coefficients.emplace_back(3 * b + r, 3 * b + c, h(r, c));
+                    if (a >= 0 && b >= 0)
+                    {
+                        coefficients.emplace_back(3 * a + r, 3 * b + c, -h(r, c));
+                        coefficients.emplace_back(3 * b + r, 3 * a + c, -h(r, c));
+                    }
+                }
+            }
+            if (a >= 0)
+                gradient.segment<3>(3 * a) -= g;
+            if (b >= 0)
+                gradient.segment<3>(3 * b) += g;
+        }
+        hessian.setFromTriplets(coefficients.begin(), coefficients.end());
+        const Eigen::VectorXd diagonal = hessian.diagonal();
+
+        if (!patternAnalyzed)
+        {
+            solver.analyzePattern(hessian);
+            patternAnalyzed = true;
+        }
+
+        // increase the damping until the step decreases the cost
+        bool improved = false;
+        double stepNorm = 0.0;
+        while (!improved && damping < 1e8)
+        {
+            Eigen::SparseMatrix<double> damped = hessian;
+            for (int i = 0; i < damped.rows(); ++i)
+                damped.coeffRef(i, i) += damping * std::max(diagonal(i), 1e-12);
+
+            solver.factorize(damped);
+            if (solver.info() != Eigen::Success)
+            {
+                damping *= 10.0;
+                continue;
+            }
+            const Eigen::VectorXd step = solver.solve(-gradient);
+
+            std::vector<Vec3> candidates = centers;
+            for (int i = 0; i < num_unknowns; ++i)
+                candidates[i + 1] += step.segment<3>(3 * i);
+
+            const double candidateCost = computeCost(candidates);
+            if (std::isfinite(candidateCost) && candidateCost <= cost)
+            {
+                improved = true;
+                stepNorm = step.norm();
+                cost = candidateCost;
+                centers.swap(candidates);
+                damping = std::max(damping / 10.0, 1e-12);
+            }
+            else
+            {
+                damping *= 10.0;
+            }
+        }
+
+        if (!improved)
+            break;
+
+        double centersNorm = 0.0;
+        for (const Vec3& center : centers)
+            centersNorm += center.squaredNorm();
+        if (stepNorm <= tolerance * std::max(std::sqrt(centersNorm), 1.0))
+            break;
+    }
+
+    ALICEVISION_LOG_DEBUG("BATA translation averaging: " << num_nodes << " cameras, " << num_edges << " edges, " << nbIterations
+                                                         << " iterations, final cost: " << cost);
+
+    // undo the re indexing
+    for (int i = 0; i < num_nodes; ++i)
+    {
+        const int j = reindex_lookup[i];
+        X[3 * j + 0] = centers[i](0);
+        X[3 * j + 1] = centers[i](1);
+        X[3 * j + 2] = centers[i](2);
+    }
+    return true;
+}
+
+}  // namespace translationAveraging
+}  // namespace aliceVision
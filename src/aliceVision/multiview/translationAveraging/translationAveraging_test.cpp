@@ -195,3 +195,67 @@ BOOST_AUTO_TEST_CASE(translation_averaging_globalTi_from_tijs_Triplets_l2_chorda
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(translation_averaging_globalTi_from_tijs_Triplets_bata)
+{
+    makeRandomOperationsReproducible();
+
+    const int focal = 1000;
+    const int principal_Point = 500;
+    //-- Setup a circular camera rig or "cardiod".
+    const int iNviews = 12;
+    const int iNbPoints = 6;
+
+    const bool bCardiod = true;
+    const bool bRelative_Translation_PerTriplet = true;
+    std::vector<aliceVision::translationAveraging::relativeInfo> vec_relative_estimates;
+
+    const NViewDataSet d = Setup_RelativeTranslations_AndNviewDataset(
+      vec_relative_estimates, focal, principal_Point, iNviews, iNbPoints, bCardiod, bRelative_Translation_PerTriplet);
+
+    //-- Compute the global translations from the triplets of heading directions
+    //-   with the baseline desensitized IRLS minimization, with some corrupted directions
+    std::vector<int> vec_edges;
+    std::vector<double> vec_poses;
+    std::vector<double> vec_weights;
+
+    for (int i = 0; i < vec_relative_estimates.size(); ++i)
+    {
+        const aliceVision::translationAveraging::relativeInfo& rel = vec_relative_estimates[i];
+        vec_edges.push_back(rel.first.first);
+        vec_edges.push_back(rel.first.second);
+
+        Vec3 EdgeDirection = -(d._R[rel.first.second].transpose() * rel.second.second.normalized());
+        // the direction of one edge out of ten is reversed
+        if (i % 10 == 5)
+            EdgeDirection = -EdgeDirection;
+
+        vec_poses.push_back(EdgeDirection(0));
+        vec_poses.push_back(EdgeDirection(1));
+        vec_poses.push_back(EdgeDirection(2));
+
+        vec_weights.push_back(1.0);
+    }
+
+    const double loss_width = 0.1;
+    const double tolerance = 1e-10;
+    const int max_iterations = 500;
+
+    std::vector<double> X(iNviews * 3);
+
+    BOOST_CHECK(solve_translations_problem_bata(
+      &vec_edges[0], &vec_poses[0], &vec_weights[0], vec_relative_estimates.size(), loss_width, &X[0], tolerance, max_iterations));
+
+    // Get back the camera translations in the global frame:
+    const Vec3 C0(X[0], X[1], X[2]);
+    BOOST_CHECK_SMALL(DistanceLInfinity(C0, Vec3(0, 0, 0)), 1e-6);
+
+    for (size_t i = 1; i < iNviews; ++i)
+    {
+        const Vec3 t_GT = (d._C[i] - d._C[0]);
+        const Vec3 t_computed = Vec3(X[i * 3], X[i * 3 + 1], X[i * 3 + 2]) - C0;
+
+        //-- Check that vector are colinear
+        BOOST_CHECK_SMALL(DistanceLInfinity(t_computed.normalized(), t_GT.normalized()), 1e-6);
+    }
+}
@@ -0,0 +1,416 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "ChunkedMap.hpp"
+
+#include <aliceVision/system/Logger.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace aliceVision {
+namespace mvsUtils {
+
+namespace {
+
+// file layout (native byte order):
+//  - magic and version
+//  - header fields
+//  - chunk index: offset, number of bytes and flags of each chunk, row-major
+//  - chunk data, each chunk is stored row-major and interleaved channels
+const char chunkedMapMagic[8] = {'A', 'V', 'C', 'H', 'M', 'A', 'P', '\0'};
+const std::uint32_t chunkedMapVersion = 2;
+
+const std::uint64_t headerSize = sizeof(chunkedMapMagic) + sizeof(std::uint32_t) + 7 * sizeof(std::int32_t) + 2 * sizeof(float) + 2 * sizeof(std::int64_t);
+const std::uint64_t indexEntrySize = sizeof(std::uint64_t) + 2 * sizeof(std::uint32_t);
+
+/// the chunk is filled with a single value, stored once
+const std::uint32_t chunkFlagConstant = 1;
+
+struct ChunkIndexEntry
+{
+    std::uint64_t offset = 0;
+    std::uint32_t nbBytes = 0;
+    std::uint32_t flags = 0;
+};
+
+template<typename T>
+struct ChunkedMapPixel;
+
+template<>
+struct ChunkedMapPixel<float>
+{
+    static constexpr int nbChannels = 1;
+    static inline float get(const float& pixel, int) { return pixel; }
+    static inline void set(float& pixel, int, float value) { pixel = value; }
+};
+
+template<>
+struct ChunkedMapPixel<image::RGBfColor>
+{
+    static constexpr int nbChannels = 3;
+    static inline float get(const image::RGBfColor& pixel, int c) { return pixel(c); }
+    static inline void set(image::RGBfColor& pixel, int c, float value) { pixel(c) = value; }
+};
+
+template<typename V>
+inline void writeValue(std::ostream& out, const V& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+}
+
+template<typename V>
+inline void readValue(std::istream& in, V& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(V));
+}
+
+inline std::size_t getValueSize(EChunkedMapStorage storage) { return (storage == EChunkedMapStorage::Half) ? sizeof(Eigen::half) : sizeof(float); }
+
+inline void encodeValue(float value, EChunkedMapStorage storage, unsigned char* out_data)
+{
+    if (storage == EChunkedMapStorage::Half)
+    {
+        const Eigen::half halfValue(value);
+        std::memcpy(out_data, &halfValue, sizeof(Eigen::half));
+    }
+    else
+    {
+        std::memcpy(out_data, &value, sizeof(float));
+    }
+}
+
+inline float decodeValue(const unsigned char* data, EChunkedMapStorage storage)
+{
+    if (storage == EChunkedMapStorage::Half)
+    {
+        Eigen::half halfValue;
+        std::memcpy(&halfValue, data, sizeof(Eigen::half));
+        return static_cast<float>(halfValue);
+    }
+    float value;
+    std::memcpy(&value, data, sizeof(float));
+    return value;
+}
+
+/**
+ * @brief Get the region of a chunk in the map coordinates.
+ */
+inline ROI getChunkRoi(const ChunkedMapHeader& header, int chunkX, int chunkY)
+{
+    const int beginX = chunkX * header.chunkSize;
+    const int beginY = chunkY * header.chunkSize;
+    return ROI(beginX, std::min(beginX + header.chunkSize, header.width), beginY, std::min(beginY + header.chunkSize, header.height));
+}
+
+bool readHeader(std::istream& in, ChunkedMapHeader& out_header)
+{
+    char magic[sizeof(chunkedMapMagic)];
+    std::uint32_t version = 0;
+    in.read(magic, sizeof(magic));
+    readValue(in, version);
+
+    if (!in || std::memcmp(magic, chunkedMapMagic, sizeof(magic)) != 0 || version != chunkedMapVersion)
+        return false;
+
+    std::int32_t storage = 0;
+    readValue(in, out_header.width);
+    readValue(in, out_header.height);
+    readValue(in, out_header.nbChannels);
+    readValue(in, out_header.chunkSize);
+    readValue(in, storage);
+    readValue(in, out_header.downscale);
+    readValue(in, out_header.nbDepthValues);
+    readValue(in, out_header.minDepth);
+    readValue(in, out_header.maxDepth);
+    readValue(in, out_header.sourceFileSize);
+    readValue(in, out_header.sourceWriteTime);
+    if (storage != static_cast<std::int32_t>(EChunkedMapStorage::Float) && storage != static_cast<std::int32_t>(EChunkedMapStorage::Half))
+        return false;
+    out_header.storage = static_cast<EChunkedMapStorage>(storage);
+
+    return in && (out_header.width >= 0) && (out_header.height >= 0) && (out_header.chunkSize > 0);
+}
+
+void writeHeader(std::ostream& out, const ChunkedMapHeader& header)
+{
+    out.write(chunkedMapMagic, sizeof(chunkedMapMagic));
+    writeValue(out, chunkedMapVersion);
+    writeValue(out, std::int32_t(header.width));
+    writeValue(out, std::int32_t(header.height));
+    writeValue(out, std::int32_t(header.nbChannels));
+    writeValue(out, std::int32_t(header.chunkSize));
+    writeValue(out, std::int32_t(header.storage));
+    writeValue(out, std::int32_t(header.downscale));
+    writeValue(out, std::int32_t(header.nbDepthValues));
+    writeValue(out, header.minDepth);
+    writeValue(out, header.maxDepth);
+    writeValue(out, header.sourceFileSize);
+    writeValue(out, header.sourceWriteTime);
+}
+
+template<typename T>
+void writeChunkedMapImpl(const std::string& path, const image::Image<T>& in_map, const ChunkedMapHeader& in_header)
+{
+    using Pixel = ChunkedMapPixel<T>;
+
+    ChunkedMapHeader header = in_header;
+    header.width = in_map.width();
+    header.height = in_map.height();
+    header.nbChannels = Pixel::nbChannels;
+
+    if (header.chunkSize <= 0)
+        ALICEVISION_THROW_ERROR("Invalid chunk size (" << header.chunkSize << ") for chunked map file: " << path);
+
+    const std::size_t valueSize = getValueSize(header.storage);
+    const int nbChunksX = header.getNbChunksX();
+    const int nbChunksY = header.getNbChunksY();
+
+    std::vector<ChunkIndexEntry> chunkIndex(nbChunksX * nbChunksY);
+    std::vector<unsigned char> chunkData;
+
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary);
+
+    if (!out)
+        ALICEVISION_THROW_ERROR("Cannot open chunked map file for writing: " << tmpPath);
+
+    writeHeader(out, header);
+
+    // the chunk index is written once all the chunks are stored
+    std::uint64_t offset = headerSize + chunkIndex.size() * indexEntrySize;
+    out.seekp(offset);
+
+    for (int chunkY = 0; chunkY < nbChunksY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < nbChunksX; ++chunkX)
+        {
+            const ROI roi = getChunkRoi(header, chunkX, chunkY);
+            const T& firstPixel = in_map(roi.y.begin, roi.x.begin);
+
+            bool isConstant = true;
+            for (unsigned int y = roi.y.begin; y < roi.y.end && isConstant; ++y)
+            {
+                for (unsigned int x = roi.x.begin; x < roi.x.end; ++x)
+                {
+                    if (in_map(y, x) != firstPixel)
+                    {
+                        isConstant = false;
+                        break;
+                    }
+                }
+            }
+
+            const std::size_t nbPixels = isConstant ? 1 : roi.width() * roi.height();
+            chunkData.resize(nbPixels * Pixel::nbChannels * valueSize);
+
+            unsigned char* data = chunkData.data();
+            for (unsigned int y = roi.y.begin; y < roi.y.end; ++y)
+            {
+                for (unsigned int x = roi.x.begin; x < roi.x.end; ++x)
+                {
+                    for (int c = 0; c < Pixel::nbChannels; ++c)
+                    {
+                        encodeValue(Pixel::get(in_map(y, x), c), header.storage, data);
+                        data += valueSize;
+                    }
+                    if (isConstant)
+                        break;
+                }
+                if (isConstant)
+                    break;
+            }
+
+            ChunkIndexEntry& entry = chunkIndex.at(chunkY * nbChunksX + chunkX);
+            entry.offset = offset;
+            entry.nbBytes = static_cast<std::uint32_t>(chunkData.size());
+            entry.flags = isConstant ? chunkFlagConstant : 0;
+
+            out.write(reinterpret_cast<const char*>(chunkData.data()), chunkData.size());
+            offset += chunkData.size();
+        }
+    }
+
+    out.seekp(headerSize);
+    for (const ChunkIndexEntry& entry : chunkIndex)
+    {
+        writeValue(out, entry.offset);
+        writeValue(out, entry.nbBytes);
+        writeValue(out, entry.flags);
+    }
+
+    out.close();
+
+    if (!out)
+        ALICEVISION_THROW_ERROR("Cannot write chunked map file: " << tmpPath);
+
+    fs::rename(tmpPath, path);
+}
+
+template<typename T>
+void readChunkedMapImpl(const std::string& path, const ROI* roiPtr, image::Image<T>& out_map)
+{
+    using Pixel = ChunkedMapPixel<T>;
+
+    std::ifstream in(path, std::ios::binary);
+    ChunkedMapHeader header;
+
+    if (!in || !readHeader(in, header))
+        ALICEVISION_THROW_ERROR("Cannot read chunked map file: " << path);
+
+    if (header.nbChannels != Pixel::nbChannels)
+        ALICEVISION_THROW_ERROR("Invalid number of channels (" << header.nbChannels << ") in chunked map file: " << path);
+
+    const ROI roi = (roiPtr != nullptr) ? *roiPtr : ROI(0, header.width, 0, header.height);
+
+    if (roi.isEmpty())
+    {
+        out_map.resize(0, 0);
+        return;
+    }
+
+    if (!checkImageROI(roi, header.width, header.height))
+        ALICEVISION_THROW_ERROR("Invalid region of interest " << roi << " for chunked map file: " << path);
+
+    const int nbChunksX = header.getNbChunksX();
+    const int nbChunksY = header.getNbChunksY();
+
+    std::vector<ChunkIndexEntry> chunkIndex(nbChunksX * nbChunksY);
+    for (ChunkIndexEntry& entry : chunkIndex)
+    {
+        readValue(in, entry.offset);
+        readValue(in, entry.nbBytes);
+        readValue(in, entry.flags);
+    }
+
+    if (!in)
+        ALICEVISION_THROW_ERROR("Cannot read chunk index of chunked map file: " << path);
+
+    out_map.resize(roi.width(), roi.height(), false);
+
+    const std::size_t valueSize = getValueSize(header.storage);
+    std::vector<unsigned char> chunkData;
+
+    // only the chunks intersecting the roi are read
+    for (int chunkY = roi.y.begin / header.chunkSize, chunkYEnd = (roi.y.end - 1) / header.chunkSize; chunkY <= chunkYEnd; ++chunkY)
+    {
+        for (int chunkX = roi.x.begin / header.chunkSize, chunkXEnd = (roi.x.end - 1) / header.chunkSize; chunkX <= chunkXEnd; ++chunkX)
+        {
+            const ROI chunkRoi = getChunkRoi(header, chunkX, chunkY);
+            const ROI readRoi = intersect(chunkRoi, roi);
+            const ChunkIndexEntry& entry = chunkIndex.at(chunkY * nbChunksX + chunkX);
+            const bool isConstant = (entry.flags & chunkFlagConstant);
+            const std::size_t nbPixels = isConstant ? 1 : chunkRoi.width() * chunkRoi.height();
+
+            if (entry.nbBytes != nbPixels * Pixel::nbChannels * valueSize)
+                ALICEVISION_THROW_ERROR("Invalid chunk (" << chunkX << ", " << chunkY << ") in chunked map file: " << path);
+
+            chunkData.resize(entry.nbBytes);
+            in.seekg(entry.offset);
+            in.read(reinterpret_cast<char*>(chunkData.data()), chunkData.size());
+
+            if (!in)
+                ALICEVISION_THROW_ERROR("Cannot read chunk (" << chunkX << ", " << chunkY << ") in chunked map file: " << path);
+
+            if (isConstant)
+            {
+                T value;
+                for (int c = 0; c < Pixel::nbChannels; ++c)
+                    Pixel::set(value, c, decodeValue(chunkData.data() + c * valueSize, header.storage));
+
+                for (unsigned int y = readRoi.y.begin; y < readRoi.y.end; ++y)
+                    for (unsigned int x = readRoi.x.begin; x < readRoi.x.end; ++x)
+                        out_map(y - roi.y.begin, x - roi.x.begin) = value;
+                continue;
+            }
+
+            for (unsigned int y = readRoi.y.begin; y < readRoi.y.end; ++y)
+            {
+                const unsigned char* data =
+                  chunkData.data() + ((y - chunkRoi.y.begin) * chunkRoi.width() + (readRoi.x.begin - chunkRoi.x.begin)) * Pixel::nbChannels * valueSize;
+
+                for (unsigned int x = readRoi.x.begin; x < readRoi.x.end; ++x)
+                {
+                    T& pixel = out_map(y - roi.y.begin, x - roi.x.begin);
+                    for (int c = 0; c < Pixel::nbChannels; ++c)
+                    {
+                        Pixel::set(pixel, c, decodeValue(data, header.storage));
+                        data += valueSize;
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+std::string getChunkedMapPath(const std::string& mapPath) { return fs::path(mapPath).replace_extension(".avmap").string(); }
+
+bool readChunkedMapHeader(const std::string& path, ChunkedMapHeader& out_header)
+{
+    std::ifstream in(path, std::ios::binary);
+    return in && readHeader(in, out_header);
+}
+
+bool setChunkedMapSource(const std::string& sourcePath, ChunkedMapHeader& header)
+{
+    std::error_code ec;
+    const std::uintmax_t fileSize = fs::file_size(sourcePath, ec);
+    const fs::file_time_type writeTime = ec ? fs::file_time_type() : fs::last_write_time(sourcePath, ec);
+
+    if (ec)
+    {
+        header.sourceFileSize = -1;
+        header.sourceWriteTime = 0;
+        return false;
+    }
+
+    header.sourceFileSize = static_cast<std::int64_t>(fileSize);
+    header.sourceWriteTime = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+bool isChunkedMapUpToDate(const std::string& path, const std::string& sourcePath)
+{
+    ChunkedMapHeader header;
+    ChunkedMapHeader sourceHeader;
+
+    if (!readChunkedMapHeader(path, header) || !setChunkedMapSource(sourcePath, sourceHeader))
+        return false;
+
+    return (header.sourceFileSize == sourceHeader.sourceFileSize) && (header.sourceWriteTime == sourceHeader.sourceWriteTime);
+}
+
+void writeChunkedMap(const std::string& path, const image::Image<float>& in_map, const ChunkedMapHeader& header)
+{
+    writeChunkedMapImpl(path, in_map, header);
+}
+
+void writeChunkedMap(const std::string& path, const image::Image<image::RGBfColor>& in_map, const ChunkedMapHeader& header)
+{
+    writeChunkedMapImpl(path, in_map, header);
+}
+
+void readChunkedMap(const std::string& path, const ROI& roi, image::Image<float>& out_map) { readChunkedMapImpl(path, &roi, out_map); }
+
+void readChunkedMap(const std::string& path, const ROI& roi, image::Image<image::RGBfColor>& out_map) { readChunkedMapImpl(path, &roi, out_map); }
+
+void readChunkedMap(const std::string& path, image::Image<float>& out_map) { readChunkedMapImpl(path, nullptr, out_map); }
+
+void readChunkedMap(const std::string& path, image::Image<image::RGBfColor>& out_map) { readChunkedMapImpl(path, nullptr, out_map); }
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
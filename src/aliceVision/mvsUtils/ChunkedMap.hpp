@@ -0,0 +1,127 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/ROI.hpp>
+#include <aliceVision/image/Image.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+/**
+ * @brief Pixel storage type of a chunked map file.
+ */
+enum class EChunkedMapStorage : int
+{
+    Float = 0,
+    Half = 1
+};
+
+/**
+ * @struct ChunkedMapHeader
+ * @brief Description of a map stored in a chunked map file.
+ */
+struct ChunkedMapHeader
+{
+    /// map width
+    int width = 0;
+    /// map height
+    int height = 0;
+    /// number of channels per pixel (1 or 3)
+    int nbChannels = 1;
+    /// chunk side in pixels
+    int chunkSize = 256;
+    /// pixel storage type
+    EChunkedMapStorage storage = EChunkedMapStorage::Float;
+    /// map downscale factor compared to the original image
+    int downscale = 1;
+    /// number of valid depth values (depth map only, -1 if unknown)
+    int nbDepthValues = -1;
+    /// minimum depth (depth map only)
+    float minDepth = std::numeric_limits<float>::max();
+    /// maximum depth (depth map only)
+    float maxDepth = -1.0f;
+    /// size in bytes of the map file the chunked map has been written from (-1 if none)
+    std::int64_t sourceFileSize = -1;
+    /// last write time of the map file the chunked map has been written from
+    std::int64_t sourceWriteTime = 0;
+
+    inline int getNbChunksX() const { return (width + chunkSize - 1) / chunkSize; }
+    inline int getNbChunksY() const { return (height + chunkSize - 1) / chunkSize; }
+};
+
+/**
+ * @brief Get the chunked map file path corresponding to a map file path.
+ * @param[in] mapPath the map file path
+ * @return the chunked map file path
+ */
+std::string getChunkedMapPath(const std::string& mapPath);
+
+/**
+ * @brief Read the header of a chunked map file.
+ * @param[in] path the chunked map file path
+ * @param[out] out_header the chunked map header
+ * @return false if the file cannot be read or is not a chunked map file
+ */
+bool readChunkedMapHeader(const std::string& path, ChunkedMapHeader& out_header);
+
+/**
+ * @brief Record the size and last write time of the map file a chunked map is written from.
+ * @param[in] sourcePath the map file path
+ * @param[in,out] header the chunked map header to update
+ * @return false if the map file cannot be found
+ */
+bool setChunkedMapSource(const std::string& sourcePath, ChunkedMapHeader& header);
+
+/**
+ * @brief Check if a chunked map file has been written from the current version of a map file.
+ * @note The chunked map file is out of date if the map file is missing or has been rewritten since.
+ * @param[in] path the chunked map file path
+ * @param[in] sourcePath the map file path
+ * @return true if the chunked map file exists and matches the map file
+ */
+bool isChunkedMapUpToDate(const std::string& path, const std::string& sourcePath);
+
+/**
+ * @brief Write a fullsize map in a chunked map file.
+ * @note The chunks are stored row-major, each chunk has its own entry in the file index.
+ *       A chunk filled with a single value is stored as this value.
+ *       The file is written next to its final path and renamed, concurrent readers never see a partial file.
+ * @param[in] path the chunked map file path
+ * @param[in] in_map the input map to write
+ * @param[in] header the map description, the dimensions and number of channels are taken from the map
+ */
+void writeChunkedMap(const std::string& path, const image::Image<float>& in_map, const ChunkedMapHeader& header);
+
+void writeChunkedMap(const std::string& path, const image::Image<image::RGBfColor>& in_map, const ChunkedMapHeader& header);
+
+/**
+ * @brief Read a region of interest of a chunked map file.
+ * @note Only the chunks intersecting the region of interest are read.
+ * @param[in] path the chunked map file path
+ * @param[in] roi the 2d region of interest in the stored map coordinates
+ * @param[out] out_map the output map of the region of interest size
+ */
+void readChunkedMap(const std::string& path, const ROI& roi, image::Image<float>& out_map);
+
+void readChunkedMap(const std::string& path, const ROI& roi, image::Image<image::RGBfColor>& out_map);
+
+/**
+ * @brief Read a full chunked map file.
+ * @param[in] path the chunked map file path
+ * @param[out] out_map the output map
+ */
+void readChunkedMap(const std::string& path, image::Image<float>& out_map);
+
+void readChunkedMap(const std::string& path, image::Image<image::RGBfColor>& out_map);
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
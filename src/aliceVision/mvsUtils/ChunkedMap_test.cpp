@@ -0,0 +1,279 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mvsUtils/ChunkedMap.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#define BOOST_TEST_MODULE chunkedMap
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mvsUtils;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string getTestPath(const std::string& filename) { return (fs::temp_directory_path() / filename).string(); }
+
+/**
+ * @brief Get a random float map, the map size is not a multiple of the chunk size.
+ */
+image::Image<float> getRandomMap(int width, int height)
+{
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+
+    image::Image<float> map(width, height);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            map(y, x) = distribution(generator);
+    return map;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_fullRead)
+{
+    const std::string path = getTestPath("chunkedMap_test_full.avmap");
+    const image::Image<float> map = getRandomMap(70, 45);
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    header.downscale = 2;
+    header.nbDepthValues = 42;
+    header.minDepth = 1.5f;
+    header.maxDepth = 12.f;
+    writeChunkedMap(path, map, header);
+
+    ChunkedMapHeader readHeader;
+    BOOST_REQUIRE(readChunkedMapHeader(path, readHeader));
+    BOOST_CHECK_EQUAL(readHeader.width, 70);
+    BOOST_CHECK_EQUAL(readHeader.height, 45);
+    BOOST_CHECK_EQUAL(readHeader.nbChannels, 1);
+    BOOST_CHECK_EQUAL(readHeader.chunkSize, 16);
+    BOOST_CHECK_EQUAL(readHeader.downscale, 2);
+    BOOST_CHECK_EQUAL(readHeader.nbDepthValues, 42);
+    BOOST_CHECK_EQUAL(readHeader.minDepth, 1.5f);
+    BOOST_CHECK_EQUAL(readHeader.maxDepth, 12.f);
+
+    image::Image<float> readMap;
+    readChunkedMap(path, readMap);
+
+    BOOST_REQUIRE_EQUAL(readMap.width(), map.width());
+    BOOST_REQUIRE_EQUAL(readMap.height(), map.height());
+    for (int y = 0; y < map.height(); ++y)
+        for (int x = 0; x < map.width(); ++x)
+            BOOST_REQUIRE_EQUAL(readMap(y, x), map(y, x));
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_roiRead)
+{
+    const std::string path = getTestPath("chunkedMap_test_roi.avmap");
+    const image::Image<float> map = getRandomMap(70, 45);
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    writeChunkedMap(path, map, header);
+
+    // regions inside a chunk, across chunks and on the map borders
+    const std::vector<ROI> rois = {ROI(3, 9, 2, 7), ROI(10, 50, 14, 35), ROI(60, 70, 40, 45), ROI(0, 70, 0, 45)};
+
+    for (const ROI& roi : rois)
+    {
+        image::Image<float> readMap;
+        readChunkedMap(path, roi, readMap);
+
+        BOOST_REQUIRE_EQUAL(readMap.width(), roi.width());
+        BOOST_REQUIRE_EQUAL(readMap.height(), roi.height());
+        for (unsigned int y = roi.y.begin; y < roi.y.end; ++y)
+            for (unsigned int x = roi.x.begin; x < roi.x.end; ++x)
+                BOOST_REQUIRE_EQUAL(readMap(y - roi.y.begin, x - roi.x.begin), map(y, x));
+    }
+
+    // region outside of the map
+    image::Image<float> readMap;
+    BOOST_CHECK_THROW(readChunkedMap(path, ROI(60, 80, 0, 10), readMap), std::exception);
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_constantChunks)
+{
+    const std::string constantPath = getTestPath("chunkedMap_test_constant.avmap");
+    const std::string randomPath = getTestPath("chunkedMap_test_random.avmap");
+
+    // a constant map with a single textured chunk
+    image::Image<float> map(64, 64, true, -1.f);
+    const image::Image<float> randomMap = getRandomMap(64, 64);
+    for (int y = 16; y < 32; ++y)
+        for (int x = 32; x < 48; ++x)
+            map(y, x) = randomMap(y, x);
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    writeChunkedMap(constantPath, map, header);
+    writeChunkedMap(randomPath, randomMap, header);
+
+    // 15 of the 16 chunks are stored as a single value
+    BOOST_CHECK_LT(fs::file_size(constantPath), fs::file_size(randomPath) / 4);
+
+    image::Image<float> readMap;
+    readChunkedMap(constantPath, ROI(8, 56, 8, 40), readMap);
+
+    for (int y = 8; y < 40; ++y)
+        for (int x = 8; x < 56; ++x)
+            BOOST_REQUIRE_EQUAL(readMap(y - 8, x - 8), map(y, x));
+
+    fs::remove(constantPath);
+    fs::remove(randomPath);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_halfStorage)
+{
+    const std::string path = getTestPath("chunkedMap_test_half.avmap");
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+
+    image::Image<image::RGBfColor> map(40, 30);
+    for (int y = 0; y < map.height(); ++y)
+        for (int x = 0; x < map.width(); ++x)
+            map(y, x) = image::RGBfColor(distribution(generator), distribution(generator), distribution(generator));
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    header.storage = EChunkedMapStorage::Half;
+    writeChunkedMap(path, map, header);
+
+    ChunkedMapHeader readHeader;
+    BOOST_REQUIRE(readChunkedMapHeader(path, readHeader));
+    BOOST_CHECK_EQUAL(readHeader.nbChannels, 3);
+    BOOST_CHECK(readHeader.storage == EChunkedMapStorage::Half);
+
+    // 16-bit storage: 3 channels of 2 bytes per pixel
+    BOOST_CHECK_LT(fs::file_size(path), 40 * 30 * 3 * sizeof(float) / 2 + 1024);
+
+    image::Image<image::RGBfColor> readMap;
+    readChunkedMap(path, ROI(5, 35, 5, 25), readMap);
+
+    for (int y = 5; y < 25; ++y)
+        for (int x = 5; x < 35; ++x)
+            for (int c = 0; c < 3; ++c)
+                BOOST_REQUIRE_SMALL(readMap(y - 5, x - 5)(c) - map(y, x)(c), 1e-3f);
+
+    // a single channel map cannot be read from a 3 channels file
+    image::Image<float> singleChannelMap;
+    BOOST_CHECK_THROW(readChunkedMap(path, singleChannelMap), std::exception);
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_truncatedFile)
+{
+    const std::string path = getTestPath("chunkedMap_test_truncated.avmap");
+    const image::Image<float> map = getRandomMap(64, 64);
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    writeChunkedMap(path, map, header);
+
+    // the last chunks are missing
+    fs::resize_file(path, fs::file_size(path) - 100);
+
+    image::Image<float> readMap;
+    BOOST_CHECK_THROW(readChunkedMap(path, readMap), std::exception);
+
+    // the first chunk is still available
+    readChunkedMap(path, ROI(0, 16, 0, 16), readMap);
+    BOOST_CHECK_EQUAL(readMap(0, 0), map(0, 0));
+
+    // the header is incomplete
+    fs::resize_file(path, 10);
+    ChunkedMapHeader readHeader;
+    BOOST_CHECK(!readChunkedMapHeader(path, readHeader));
+    BOOST_CHECK_THROW(readChunkedMap(path, readMap), std::exception);
+
+    // not a chunked map file
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a chunked map file, only some text";
+    }
+    BOOST_CHECK(!readChunkedMapHeader(path, readHeader));
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_unknownStorage)
+{
+    const std::string path = getTestPath("chunkedMap_test_unknownStorage.avmap");
+    const image::Image<float> map = getRandomMap(32, 32);
+
+    ChunkedMapHeader header;
+    header.chunkSize = 16;
+    writeChunkedMap(path, map, header);
+
+    // storage field after the magic, the version, the width, the height, the number of channels and the chunk size
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8 + sizeof(std::uint32_t) + 4 * sizeof(std::int32_t));
+        const std::int32_t unknownStorage = 7;
+        file.write(reinterpret_cast<const char*>(&unknownStorage), sizeof(unknownStorage));
+    }
+
+    ChunkedMapHeader readHeader;
+    BOOST_CHECK(!readChunkedMapHeader(path, readHeader));
+    image::Image<float> readMap;
+    BOOST_CHECK_THROW(readChunkedMap(path, readMap), std::exception);
+
+    fs::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedMap_sourceStamp)
+{
+    const std::string sourcePath = getTestPath("chunkedMap_test_source.exr");
+    const std::string path = getChunkedMapPath(sourcePath);
+    const image::Image<float> map = getRandomMap(32, 32);
+
+    BOOST_CHECK_EQUAL(fs::path(path).extension().string(), ".avmap");
+
+    {
+        std::ofstream out(sourcePath, std::ios::binary | std::ios::trunc);
+        out << "map file content";
+    }
+
+    ChunkedMapHeader header;
+    BOOST_REQUIRE(setChunkedMapSource(sourcePath, header));
+    writeChunkedMap(path, map, header);
+
+    BOOST_CHECK(isChunkedMapUpToDate(path, sourcePath));
+
+    // map file rewritten after the chunked map export
+    {
+        std::ofstream out(sourcePath, std::ios::binary | std::ios::trunc);
+        out << "new map file content";
+    }
+    BOOST_CHECK(!isChunkedMapUpToDate(path, sourcePath));
+
+    // map file removed
+    fs::remove(sourcePath);
+    BOOST_CHECK(!isChunkedMapUpToDate(path, sourcePath));
+
+    // no source recorded
+    BOOST_CHECK(!setChunkedMapSource(sourcePath, header));
+    BOOST_CHECK_EQUAL(header.sourceFileSize, -1);
+
+    fs::remove(path);
+}
@@ -0,0 +1,121 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "MapCache.hpp"
+
+#include <aliceVision/mvsUtils/mapIO.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+MapCache::MapCache(const MultiViewParams& mp, std::size_t maxNbMaps)
+  : MapCache([&mp](int rc, EFileType fileType, image::Image<float>& map) { readMap(rc, mp, fileType, map); }, maxNbMaps)
+{}
+
+MapCache::MapCache(ReadMapFunction readMapFunction, std::size_t maxNbMaps)
+  : _readMap(std::move(readMapFunction)),
+    _maxNbMaps(std::max<std::size_t>(maxNbMaps, 1))
+{}
+
+MapCache::MapSharedPtr MapCache::get(int rc, EFileType fileType)
+{
+    const Key key(rc, fileType);
+    std::promise<MapSharedPtr> promise;
+    std::shared_future<MapSharedPtr> map;
+    bool load = false;
+    std::size_t readId = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _entries.find(key);
+        if (it != _entries.end())
+        {
+            ++_nbHits;
+            _lru.splice(_lru.begin(), _lru, it->second.lruIt);
+            map = it->second.map;
+        }
+        else
+        {
+            ++_nbMisses;
+            load = true;
+            readId = _nbReads++;
+            map = promise.get_future().share();
+            _lru.push_front(key);
+            _entries.emplace(key, Entry{map, _lru.begin(), readId});
+            evict();
+        }
+    }
+
+    // the map is read outside of the lock, the other threads requesting it wait for the shared future
+    if (load)
+    {
+        try
+        {
+            auto newMap = std::make_shared<image::Image<float>>();
+            _readMap(rc, fileType, *newMap);
+            promise.set_value(std::move(newMap));
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+
+            // do not keep the failure in the cache,
+            // unless the entry has been evicted and added again by another read in the meantime
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _entries.find(key);
+            if (it != _entries.end() && it->second.readId == readId)
+            {
+                _lru.erase(it->second.lruIt);
+                _entries.erase(it);
+            }
+        }
+    }
+
+    return map.get();
+}
+
+void MapCache::setMaxNbMaps(std::size_t maxNbMaps)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxNbMaps = std::max<std::size_t>(maxNbMaps, 1);
+    evict();
+}
+
+double MapCache::getHitRate() const
+{
+    const std::size_t nbRequests = _nbHits + _nbMisses;
+    return (nbRequests == 0) ? 0.0 : static_cast<double>(_nbHits) / static_cast<double>(nbRequests);
+}
+
+void MapCache::resetStatistics()
+{
+    _nbHits = 0;
+    _nbMisses = 0;
+}
+
+void MapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+}
+
+void MapCache::evict()
+{
+    // the released maps stay alive as long as they are used
+    while (_lru.size() > _maxNbMaps)
+    {
+        _entries.erase(_lru.back());
+        _lru.pop_back();
+    }
+}
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
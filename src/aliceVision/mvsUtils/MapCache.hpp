@@ -0,0 +1,135 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/image/Image.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace aliceVision {
+namespace mvsUtils {
+
+/**
+ * @brief Thread-safe cache of the fullsize maps (depth, similarity, ...) read from files.
+ * @details The maps are identified by their camera index and file type and are decoded only once
+ *          while they stay in the cache. The least recently used maps are released when the
+ *          maximum number of maps is reached. Concurrent requests of the same map wait for
+ *          a single read.
+ */
+class MapCache
+{
+  public:
+    using MapSharedPtr = std::shared_ptr<const image::Image<float>>;
+    using ReadMapFunction = std::function<void(int rc, EFileType fileType, image::Image<float>& map)>;
+
+    /**
+     * @brief MapCache constructor
+     * @param[in] mp the multi-view parameters
+     * @param[in] maxNbMaps the maximum number of maps kept in memory
+     */
+    MapCache(const MultiViewParams& mp, std::size_t maxNbMaps);
+
+    /**
+     * @brief MapCache constructor
+     * @param[in] readMapFunction the function reading a map, it may be called concurrently for different maps
+     * @param[in] maxNbMaps the maximum number of maps kept in memory
+     */
+    MapCache(ReadMapFunction readMapFunction, std::size_t maxNbMaps);
+
+    MapCache(const MapCache&) = delete;
+    MapCache& operator=(const MapCache&) = delete;
+
+    /**
+     * @brief Get a fullsize map, read it from file(s) if it is not in the cache.
+     * @param[in] rc the related R camera index
+     * @param[in] fileType the map fileType enum
+     * @return the map shared with the other users of the cache
+     */
+    MapSharedPtr get(int rc, EFileType fileType);
+
+    /**
+     * @brief Set the maximum number of maps kept in memory.
+     * @param[in] maxNbMaps the maximum number of maps
+     */
+    void setMaxNbMaps(std::size_t maxNbMaps);
+
+    /**
+     * @brief Get the maximum number of maps kept in memory.
+     * @return the maximum number of maps
+     */
+    inline std::size_t getMaxNbMaps() const { return _maxNbMaps; }
+
+    /**
+     * @brief Get the number of requests served from the cache since the last statistics reset.
+     * @return number of hits
+     */
+    inline std::size_t getNbHits() const { return _nbHits; }
+
+    /**
+     * @brief Get the number of requests read from file(s) since the last statistics reset.
+     * @return number of misses
+     */
+    inline std::size_t getNbMisses() const { return _nbMisses; }
+
+    /**
+     * @brief Get the ratio of the requests served from the cache since the last statistics reset.
+     * @return hit rate in [0, 1]
+     */
+    double getHitRate() const;
+
+    /**
+     * @brief Reset the number of hits and misses.
+     */
+    void resetStatistics();
+
+    /**
+     * @brief Release all the maps of the cache.
+     */
+    void clear();
+
+  private:
+    using Key = std::pair<int, EFileType>;
+
+    struct Entry
+    {
+        std::shared_future<MapSharedPtr> map;
+        std::list<Key>::iterator lruIt;
+        /// identifier of the read of the map, an entry evicted then added again is a different read
+        std::size_t readId;
+    };
+
+    /**
+     * @brief Release the least recently used maps above the maximum number of maps.
+     * @note The cache mutex must be locked.
+     */
+    void evict();
+
+    const ReadMapFunction _readMap;
+    std::size_t _maxNbMaps;
+
+    std::mutex _mutex;
+    std::map<Key, Entry> _entries;
+    /// keys of the entries, from the most to the least recently used
+    std::list<Key> _lru;
+    /// number of reads started, used as identifier of the next read
+    std::size_t _nbReads = 0;
+
+    std::atomic<std::size_t> _nbHits{0};
+    std::atomic<std::size_t> _nbMisses{0};
+};
+
+}  // namespace mvsUtils
+}  // namespace aliceVision
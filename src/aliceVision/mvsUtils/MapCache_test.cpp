@@ -0,0 +1,216 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mvsUtils/MapCache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE mapCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mvsUtils;
+
+namespace {
+
+/**
+ * @brief Map reader counting the reads per camera, the value of the map pixels is the camera index.
+ */
+class CountingReader
+{
+  public:
+    void operator()(int rc, EFileType fileType, image::Image<float>& map)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_nbReads[rc];
+        }
+        map.resize(4, 3);
+        map.fill(static_cast<float>(rc));
+    }
+
+    int getNbReads(int rc) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = _nbReads.find(rc);
+        return (it == _nbReads.end()) ? 0 : it->second;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<int, int> _nbReads;
+};
+
+}  // namespace
+
+// Test summary:
+// - Request more maps than the cache capacity
+// - Check that the least recently used maps are released and read again, and that the recently used ones are kept
+BOOST_AUTO_TEST_CASE(MapCache_lruEviction)
+{
+    CountingReader reader;
+    MapCache cache([&reader](int rc, EFileType fileType, image::Image<float>& map) { reader(rc, fileType, map); }, 2);
+
+    const MapCache::MapSharedPtr map0 = cache.get(0, EFileType::depthMap);
+    BOOST_CHECK_EQUAL((*map0)(0, 0), 0.f);
+    cache.get(1, EFileType::depthMap);
+    // 0 becomes the most recently used map
+    BOOST_CHECK(cache.get(0, EFileType::depthMap) == map0);
+    // 1 is released
+    cache.get(2, EFileType::depthMap);
+
+    BOOST_CHECK(cache.get(0, EFileType::depthMap) == map0);
+    BOOST_CHECK_EQUAL(reader.getNbReads(0), 1);
+
+    cache.get(1, EFileType::depthMap);
+    BOOST_CHECK_EQUAL(reader.getNbReads(1), 2);
+    BOOST_CHECK_EQUAL(reader.getNbReads(2), 1);
+
+    // the file type is part of the key
+    cache.get(1, EFileType::simMap);
+    BOOST_CHECK_EQUAL(reader.getNbReads(1), 3);
+
+    BOOST_CHECK_EQUAL(cache.getNbHits(), 2);
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), 5);
+
+    // a smaller capacity releases the least recently used maps, a released map stays valid while it is used
+    cache.setMaxNbMaps(1);
+    cache.get(0, EFileType::depthMap);
+    BOOST_CHECK_EQUAL(reader.getNbReads(0), 2);
+    BOOST_CHECK_EQUAL((*map0)(2, 3), 0.f);
+}
+
+// Test summary:
+// - Request the same map from several threads while it is read
+// - Check that the map is read once and shared by all the threads
+BOOST_AUTO_TEST_CASE(MapCache_concurrentGetSingleRead)
+{
+    std::atomic<int> nbReads{0};
+    std::promise<void> readStarted;
+    std::promise<void> finishRead;
+    std::shared_future<void> canFinishRead = finishRead.get_future().share();
+
+    MapCache cache(
+      [&](int rc, EFileType fileType, image::Image<float>& map) {
+          if (nbReads++ == 0)
+              readStarted.set_value();
+          canFinishRead.wait();
+          map.resize(4, 3);
+          map.fill(static_cast<float>(rc));
+      },
+      4);
+
+    const int nbThreads = 8;
+    std::vector<MapCache::MapSharedPtr> maps(nbThreads);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() { maps[0] = cache.get(5, EFileType::depthMap); });
+
+    // the other threads request the map while the first read is pending
+    readStarted.get_future().wait();
+    for (int i = 1; i < nbThreads; ++i)
+        threads.emplace_back([&, i]() { maps[i] = cache.get(5, EFileType::depthMap); });
+
+    // wait for all the requests before finishing the read
+    while (cache.getNbHits() + cache.getNbMisses() < nbThreads)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    finishRead.set_value();
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    BOOST_CHECK_EQUAL(nbReads, 1);
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), 1);
+    BOOST_CHECK_EQUAL(cache.getNbHits(), nbThreads - 1);
+    for (const MapCache::MapSharedPtr& map : maps)
+    {
+        BOOST_REQUIRE(map != nullptr);
+        BOOST_CHECK(map == maps.front());
+        BOOST_CHECK_EQUAL((*map)(0, 0), 5.f);
+    }
+}
+
+// Test summary:
+// - Fail the read of a map
+// - Check that the error is forwarded to the caller and that the failure is not kept in the cache
+BOOST_AUTO_TEST_CASE(MapCache_readFailure)
+{
+    int nbReads = 0;
+    MapCache cache(
+      [&](int rc, EFileType fileType, image::Image<float>& map) {
+          if (nbReads++ == 0)
+              throw std::runtime_error("Cannot read the map.");
+          map.resize(4, 3);
+          map.fill(static_cast<float>(rc));
+      },
+      2);
+
+    BOOST_CHECK_THROW(cache.get(0, EFileType::depthMap), std::runtime_error);
+
+    const MapCache::MapSharedPtr map = cache.get(0, EFileType::depthMap);
+    BOOST_CHECK_EQUAL((*map)(0, 0), 0.f);
+    BOOST_CHECK_EQUAL(nbReads, 2);
+
+    BOOST_CHECK(cache.get(0, EFileType::depthMap) == map);
+    BOOST_CHECK_EQUAL(nbReads, 2);
+}
+
+// Test summary:
+// - Fail the read of a map after its entry has been evicted and read again by another request
+// - Check that the failure does not release the map of the other request
+BOOST_AUTO_TEST_CASE(MapCache_readFailureAfterEviction)
+{
+    std::atomic<int> nbReads0{0};
+    std::promise<void> readStarted;
+    std::promise<void> failRead;
+    std::shared_future<void> canFailRead = failRead.get_future().share();
+
+    MapCache cache(
+      [&](int rc, EFileType fileType, image::Image<float>& map) {
+          if (rc == 0 && nbReads0++ == 0)
+          {
+              readStarted.set_value();
+              canFailRead.wait();
+              throw std::runtime_error("Cannot read the map.");
+          }
+          map.resize(4, 3);
+          map.fill(static_cast<float>(rc));
+      },
+      1);
+
+    // the test assertions are not thread-safe, the failure is checked after the join
+    bool failed = false;
+    std::thread failingThread([&]() {
+        try
+        {
+            cache.get(0, EFileType::depthMap);
+        }
+        catch (const std::runtime_error&)
+        {
+            failed = true;
+        }
+    });
+    readStarted.get_future().wait();
+
+    // evict the pending map, then read it again
+    cache.get(1, EFileType::depthMap);
+    const MapCache::MapSharedPtr map = cache.get(0, EFileType::depthMap);
+    BOOST_CHECK_EQUAL(nbReads0, 2);
+
+    failRead.set_value();
+    failingThread.join();
+    BOOST_CHECK(failed);
+
+    BOOST_CHECK(cache.get(0, EFileType::depthMap) == map);
+    BOOST_CHECK_EQUAL(nbReads0, 2);
+}
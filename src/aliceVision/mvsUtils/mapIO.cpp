@@ -7,6 +7,7 @@
 #include "mapIO.hpp"
 
 #include <aliceVision/mvsData/Point2d.hpp>
+#include <aliceVision/mvsUtils/ChunkedMap.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/numeric/numeric.hpp>
 #include <aliceVision/image/io.hpp>
@@ -181,9 +182,9 @@ void weightTileBorder(int a, int b, int c, int d, int borderWidth, int borderHei
     const double borderWidth_m = borderWidth - 2.0 * margin;
     const double borderHeight_m = borderHeight - 2.0 * margin;
 
-    for (int x = lu.x; x < endX; ++x)
+    for (int y = lu.y; y < endY; ++y)
     {
-        for (int y = lu.y; y < endY; ++y)
+        for (int x = lu.x; x < endX; ++x)
         {
             // bilinear interpolation
             const float r_x = clamp((rd_m.x - x) / borderWidth_m, 0.0, 1.0);
@@ -297,9 +298,10 @@ void addSingleTileMapWeighted(int rc,
     }
 
     // add weighted tile to the depth/sim map
-    for (int x = downscaledRoi.x.begin; x < downscaledRoi.x.end; ++x)
+    // row-major traversal, the maps are stored row by row
+    for (int y = downscaledRoi.y.begin; y < downscaledRoi.y.end; ++y)
     {
-        for (int y = downscaledRoi.y.begin; y < downscaledRoi.y.end; ++y)
+        for (int x = downscaledRoi.x.begin; x < downscaledRoi.x.end; ++x)
         {
             const int tx = x - downscaledRoi.x.begin;
             const int ty = y - downscaledRoi.y.begin;
@@ -309,6 +311,15 @@ void addSingleTileMapWeighted(int rc,
     }
 }
 
+/**
+ * @brief Check if a map should be read from its chunked map file.
+ * @note The chunked map file is ignored if the map file is missing or has been rewritten since the chunked map export.
+ * @param[in] mapPath the single file fullsize map path
+ * @param[in] chunkedMapPath the chunked map file path
+ * @return true if the chunked map file exists and is up to date
+ */
+bool useChunkedMapFile(const std::string& mapPath, const std::string& chunkedMapPath) { return isChunkedMapUpToDate(chunkedMapPath, mapPath); }
+
 template<typename T>
 void readMapFromFileOrTiles(int rc,
                             const MultiViewParams& mp,
@@ -324,6 +335,15 @@ void readMapFromFileOrTiles(int rc,
 
     // single file fullsize map path
     const std::string mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix);
+    const std::string chunkedMapPath = getChunkedMapPath(mapPath);
+
+    // check chunked map file exists, no image decoding needed
+    if (useChunkedMapFile(mapPath, chunkedMapPath))
+    {
+        ALICEVISION_LOG_TRACE("Load map (chunked file): " << chunkedMapPath << ", scale: " << scale << ", step: " << step);
+        readChunkedMap(chunkedMapPath, out_map);
+        return;
+    }
 
     // check single file fullsize map exists
     if (fs::exists(mapPath))
@@ -398,6 +418,47 @@ void readMapFromFileOrTiles(int rc,
     }
 }
 
+template<typename T>
+void readMapRoiFromFileOrTiles(int rc,
+                               const MultiViewParams& mp,
+                               EFileType fileType,
+                               const ROI& roi,
+                               image::Image<T>& out_map,
+                               int scale,
+                               int step,
+                               const std::string& customSuffix)
+{
+    const int scaleStep = scale * step;
+    const ROI mapRoi(0, divideRoundUp(mp.getWidth(rc), scaleStep), 0, divideRoundUp(mp.getHeight(rc), scaleStep));
+    const ROI downscaledRoi = intersect(downscaleROI(roi, scaleStep), mapRoi);
+
+    const std::string mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix);
+    const std::string chunkedMapPath = getChunkedMapPath(mapPath);
+
+    // partial read of the chunked map file
+    if (useChunkedMapFile(mapPath, chunkedMapPath))
+    {
+        readChunkedMap(chunkedMapPath, downscaledRoi, out_map);
+        return;
+    }
+
+    // read the fullsize map and crop it
+    image::Image<T> map;
+    readMapFromFileOrTiles(rc, mp, fileType, map, scale, step, customSuffix);
+
+    if (downscaledRoi.isEmpty() || map.size() == 0)
+    {
+        out_map.resize(0, 0);
+        return;
+    }
+
+    out_map.resize(downscaledRoi.width(), downscaledRoi.height(), false);
+
+    for (unsigned int y = downscaledRoi.y.begin; y < downscaledRoi.y.end; ++y)
+        for (unsigned int x = downscaledRoi.x.begin; x < downscaledRoi.x.end; ++x)
+            out_map(y - downscaledRoi.y.begin, x - downscaledRoi.x.begin) = map(y, x);
+}
+
 template<typename T>
 void writeMapToFileOrTile(int rc,
                           const MultiViewParams& mp,
@@ -435,8 +496,9 @@ void writeMapToFileOrTile(int rc,
 
     // output map path
     std::string mapPath;
+    const bool isTile = (downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight);
 
-    if (downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight)  // is a tile
+    if (isTile)
     {
         // tiled map
         mapPath = getFileNameFromIndex(mp, rc, fileType, customSuffix, roi.x.begin, roi.y.begin);
@@ -453,6 +515,10 @@ void writeMapToFileOrTile(int rc,
     // downscale metadata
     metadata.push_back(oiio::ParamValue("AliceVision:downscale", mp.getDownscaleFactor(rc) * scaleStep));
 
+    // chunked map file description
+    ChunkedMapHeader chunkedMapHeader;
+    chunkedMapHeader.downscale = mp.getDownscaleFactor(rc) * scaleStep;
+
     // roi metadata
     {
         metadata.push_back(oiio::ParamValue("AliceVision:roiBeginX", int(roi.x.begin)));
@@ -518,6 +584,10 @@ void writeMapToFileOrTile(int rc,
         metadata.push_back(oiio::ParamValue("AliceVision:nbDepthValues", nbDepthValues));
         metadata.push_back(oiio::ParamValue("AliceVision:minDepth", minDepth));
         metadata.push_back(oiio::ParamValue("AliceVision:maxDepth", maxDepth));
+
+        chunkedMapHeader.nbDepthValues = nbDepthValues;
+        chunkedMapHeader.minDepth = minDepth;
+        chunkedMapHeader.maxDepth = maxDepth;
     }
 
     // set colorspace
@@ -528,14 +598,22 @@ void writeMapToFileOrTile(int rc,
     if ((fileType == EFileType::depthMap) || (fileType == EFileType::depthMapFiltered))
     {
         mapWriteOptions.storageDataType(image::EStorageDataType::Float);
+        chunkedMapHeader.storage = EChunkedMapStorage::Float;
     }
     else
     {
         mapWriteOptions.storageDataType(image::EStorageDataType::Half);
+        chunkedMapHeader.storage = EChunkedMapStorage::Half;
     }
 
     // write map
     image::writeImage(mapPath, in_map, mapWriteOptions, metadata, displayRoi, pixelRoi);
+
+    // write chunked map file after the map file, for fast and partial reads of the fullsize map
+    if (!isTile && mp.userParams.get<bool>("global.exportChunkedMaps", false) && setChunkedMapSource(mapPath, chunkedMapHeader))
+    {
+        writeChunkedMap(getChunkedMapPath(mapPath), in_map, chunkedMapHeader);
+    }
 }
 
 void addTileMapWeighted(int rc,
@@ -571,6 +649,30 @@ void readMap(int rc,
     readMapFromFileOrTiles(rc, mp, fileType, out_map, scale, step, customSuffix);
 }
 
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<float>& out_map,
+             int scale,
+             int step,
+             const std::string& customSuffix)
+{
+    readMapRoiFromFileOrTiles(rc, mp, fileType, roi, out_map, scale, step, customSuffix);
+}
+
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<image::RGBfColor>& out_map,
+             int scale,
+             int step,
+             const std::string& customSuffix)
+{
+    readMapRoiFromFileOrTiles(rc, mp, fileType, roi, out_map, scale, step, customSuffix);
+}
+
 void writeMap(int rc,
               const MultiViewParams& mp,
               const EFileType fileType,
@@ -600,12 +702,19 @@ void writeMap(int rc,
 unsigned long getNbDepthValuesFromDepthMap(int rc, const MultiViewParams& mp, int scale, int step, const std::string& customSuffix)
 {
     const std::string depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMapFiltered, customSuffix);
+    const std::string chunkedDepthMapPath = getChunkedMapPath(depthMapPath);
     int nbDepthValues = -1;
     bool fileExists = false;
     bool fromTiles = false;
 
-    // get nbDepthValues from metadata
-    if (fs::exists(depthMapPath))  // untilled
+    // get nbDepthValues from chunked map header or metadata
+    ChunkedMapHeader chunkedMapHeader;
+    if (useChunkedMapFile(depthMapPath, chunkedDepthMapPath) && readChunkedMapHeader(chunkedDepthMapPath, chunkedMapHeader))
+    {
+        fileExists = true;
+        nbDepthValues = chunkedMapHeader.nbDepthValues;
+    }
+    else if (fs::exists(depthMapPath))  // untilled
     {
         fileExists = true;
         const oiio::ParamValueList metadata = image::readImageMetadata(depthMapPath);
@@ -35,6 +35,7 @@ void addTileMapWeighted(int rc,
 
 /**
  * @brief Read a fullsize map from file(s).
+ * @note The map is read from its chunked map file if it is up to date, from its image file or from its tiles otherwise.
  * @param[in] rc the related R camera index
  * @param[in] mp the multi-view parameters
  * @param[in] fileType the map fileType enum
@@ -59,8 +60,41 @@ void readMap(int rc,
              int step = 1,
              const std::string& customSuffix = "");
 
+/**
+ * @brief Read a region of interest of a fullsize map from file(s).
+ * @note Only the chunks intersecting the region of interest are read from a chunked map file,
+ *       otherwise the fullsize map is read and cropped.
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] fileType the map fileType enum
+ * @param[in] roi the 2d region of interest without any downscale apply
+ * @param[out] out_map the output map of the downscaled region of interest
+ * @param[in] scale the map downscale factor
+ * @param[in] step the map step factor
+ * @param[in] customSuffix the map filename custom suffix
+ */
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<float>& out_map,
+             int scale = 1,
+             int step = 1,
+             const std::string& customSuffix = "");
+
+void readMap(int rc,
+             const MultiViewParams& mp,
+             const EFileType fileType,
+             const ROI& roi,
+             image::Image<image::RGBfColor>& out_map,
+             int scale = 1,
+             int step = 1,
+             const std::string& customSuffix = "");
+
 /**
  * @brief Write a fullsize or tile map in a file.
+ * @note A fullsize map is also written in a chunked map file if the "global.exportChunkedMaps" user parameter is enabled,
+ *       the next reads of the map use this file instead of decoding the image.
  * @param[in] rc the related R camera index
  * @param[in] mp the multi-view parameters
  * @param[in] fileType the map fileType enum
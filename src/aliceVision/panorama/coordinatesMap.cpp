@@ -24,6 +24,12 @@ bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
     int min_x = std::numeric_limits<int>::max();
     int min_y = std::numeric_limits<int>::max();
 
+    const Eigen::Matrix4d poseMatrix = pose.getHomogeneous();
+
+    // rays and projections of a row, projected with a single call
+    Mat4X rays(4, coarseBbox.width);
+    Mat2X pixs_disto;
+
     for (int y = 0; y < coarseBbox.height; y++)
     {
         int cy = y + coarseBbox.top;
@@ -36,23 +42,29 @@ bool CoordinatesMap::build(const std::pair<int, int>& panoramaSize,
         {
             int cx = x + coarseBbox.left;
 
-            Vec3 ray = SphericalMapping::fromEquirectangular(Vec2(cx, cy), panoramaSize.first, panoramaSize.second);
+            rays.col(x) = SphericalMapping::fromEquirectangular(Vec2(cx, cy), panoramaSize.first, panoramaSize.second).homogeneous();
+        }
+
+        /**
+         * Project the rays to camera pixel coordinates
+         */
+        intrinsics.projectPoints(poseMatrix, rays, pixs_disto, true);
+        const Mat3X transformedRays = pose(rays.topRows<3>());
+
+        for (int x = 0; x < coarseBbox.width; x++)
+        {
+            int cx = x + coarseBbox.left;
 
             /**
              * Check that this ray should be visible.
              * This test is camera type dependent
              */
-            Vec3 transformedRay = pose(ray);
-            if (!intrinsics.isVisibleRay(transformedRay))
+            if (!intrinsics.isVisibleRay(transformedRays.col(x)))
             {
                 continue;
             }
 
-            /**
-             * Project this ray to camera pixel coordinates
-             */
-            const Vec2 pix_disto_d = intrinsics.project(pose, ray.homogeneous(), true);
-            const Vec2f pix_disto = pix_disto_d.cast<float>();
+            const Vec2f pix_disto = pixs_disto.col(x).cast<float>();
 
             /**
              * Ignore invalid coordinates
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/robustEstimation/randSampling.hpp>
+#include <aliceVision/robustEstimation/ransacTools.hpp>
 #include <aliceVision/system/Logger.hpp>
 
 #include <algorithm>
@@ -111,6 +113,116 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
     return bestIndex;
 }
 
+/**
+ * @brief Find best NFA in the range [first, last[ of the partially ordered residuals.
+ * @see bestNFASelect
+ */
+inline void bestNFAInRange(std::size_t first,
+                           std::size_t last,
+                           int startIndex,
+                           double logalpha0,
+                           std::vector<ErrorIndex>& e,
+                           double loge0,
+                           const std::vector<float>& logc_n,
+                           const std::vector<float>& logc_k,
+                           double errorVectorDimension,
+                           double maxNFA,
+                           ErrorIndex& bestIndex)
+{
+    // number of residuals sorted at once, smaller ranges are not worth to be split again
+    constexpr std::size_t leafSize = 32;
+
+    // ranks that cannot be evaluated, they only have to stay before the next ones
+    const std::size_t kBegin = std::max(first, static_cast<std::size_t>(startIndex)) + 1;
+    if (kBegin > last)
+        return;
+
+    // lower bound of the NFA in the range:
+    // logalpha increases with the residual and (k - startIndex) is positive,
+    // so the smallest residual of the range gives a lower bound of each NFA
+    const double minSquaredResidual = std::min_element(e.begin() + first, e.begin() + last)->first;
+    const double minLogalpha = logalpha0 + errorVectorDimension * log10(sqrt(minSquaredResidual) + std::numeric_limits<float>::epsilon());
+
+    double lowerBound = std::numeric_limits<double>::infinity();
+    for (std::size_t k = kBegin; k <= last; ++k)
+        lowerBound = std::min(lowerBound, loge0 + minLogalpha * (double)(k - startIndex) + logc_n[k] + logc_k[k]);
+
+    // no NFA of this range can improve the best one
+    if (lowerBound >= std::min(bestIndex.first, maxNFA))
+        return;
+
+    if (last - first <= leafSize)
+    {
+        std::sort(e.begin() + first, e.begin() + last);
+
+        for (std::size_t k = kBegin; k <= last; ++k)
+        {
+            const double residual = sqrt(e[k - 1].first) + std::numeric_limits<float>::epsilon();
+            const double logalpha = logalpha0 + errorVectorDimension * log10(residual);
+            const double nfa = loge0 + logalpha * (double)(k - startIndex) + logc_n[k] + logc_k[k];
+
+            if (nfa < std::min(bestIndex.first, maxNFA))
+                bestIndex = ErrorIndex(nfa, k);
+        }
+        return;
+    }
+
+    // split the range around its median, the first half first to keep the smallest index of the best NFA
+    const std::size_t middle = first + (last - first) / 2;
+    std::nth_element(e.begin() + first, e.begin() + middle, e.begin() + last);
+
+    bestNFAInRange(first, middle, startIndex, logalpha0, e, loge0, logc_n, logc_k, errorVectorDimension, maxNFA, bestIndex);
+    bestNFAInRange(middle, last, startIndex, logalpha0, e, loge0, logc_n, logc_k, errorVectorDimension, maxNFA, bestIndex);
+}
+
+/**
+ * @brief Find best NFA and its index wrt square error threshold in e, without sorting all the residuals.
+ *
+ * The residuals are recursively split around their median (partial selection) and a range
+ * is discarded as soon as the lower bound of its NFA is not better than the best NFA found so far
+ * or than \p maxNFA. Only the ranges that may contain the best NFA end up sorted,
+ * which avoids the full O(n log n) sort for most of the candidate models.
+ *
+ * The result is the same as bestNFA on the sorted residuals if it is lower than \p maxNFA.
+ * In that case, the first best.second residuals of \p e are also the sorted smallest residuals.
+ *
+ * @param[in] startIndex number of point required for estimation
+ * @param[in] logalpha0 the log of the model probability
+ * @param[in,out] e the residuals (reordered)
+ * @param[in] loge0 the log of the number of tests
+ * @param[in] maxThreshold the upper bound of the square error
+ * @param[in] logc_n the tabulated logcombi(.,n)
+ * @param[in] logc_k the tabulated logcombi(k,.)
+ * @param[in] errorVectorDimension the dimension of the error
+ * @param[in] maxNFA only the NFA lower than this value are searched (typically the best NFA of the previous models)
+ * @return the best NFA and its index, or an infinite NFA if there is none lower than \p maxNFA
+ */
+inline ErrorIndex bestNFASelect(int startIndex,
+                                double logalpha0,
+                                std::vector<ErrorIndex>& e,
+                                double loge0,
+                                double maxThreshold,
+                                const std::vector<float>& logc_n,
+                                const std::vector<float>& logc_k,
+                                double errorVectorDimension = 1.0,
+                                double maxNFA = std::numeric_limits<double>::infinity())
+{
+    ErrorIndex bestIndex(std::numeric_limits<double>::infinity(), startIndex);
+
+    // only the residuals below the threshold can be inliers
+    std::size_t n = e.size();
+    if (maxThreshold != std::numeric_limits<double>::infinity())
+        n = std::distance(e.begin(), std::partition(e.begin(), e.end(), [&](const ErrorIndex& r) { return r.first <= maxThreshold; }));
+
+    bestNFAInRange(0, n, startIndex, logalpha0, e, loge0, logc_n, logc_k, errorVectorDimension, maxNFA, bestIndex);
+
+    // the ranks before the start index are never evaluated
+    if (bestIndex.first < maxNFA)
+        std::sort(e.begin(), e.begin() + bestIndex.second);
+
+    return bestIndex;
+}
+
 /**
  * @brief An implementation of the "Random Sample Consensus" algorithm based on a-contrario estimator
  * to automatically estimate the error threshold.
@@ -139,6 +251,14 @@ inline ErrorIndex bestNFA(int startIndex,  // number of point required for estim
  * @param[in] nIter maximum number of consecutive iterations
  * @param[out] model returned model if found
  * @param[in] precision upper bound of the precision
+ * @param[in] nbThreads number of threads evaluating the hypotheses (1: sequential, 0: all the available cores)
+ *
+ * @note In the multi-threaded mode (nbThreads != 1), the samples of a batch of hypotheses are drawn sequentially
+ *       and the hypotheses are evaluated concurrently, then reduced in the order of the draws.
+ *       The batch size does not depend on the number of threads, so the result only depends on the seed.
+ *       The focused sampling on the best inliers is updated between the batches.
+ *       The sequential mode (nbThreads == 1) evaluates the hypotheses one by one: it gives the same results
+ *       as the previous versions, but they can differ from the multi-threaded mode for the same seed.
  *
  * @return (errorMax, minNFA)
  */
@@ -148,7 +268,8 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                    std::vector<size_t>& vec_inliers,
                                    std::size_t nIter = 1024,
                                    typename Kernel::ModelT* model = nullptr,
-                                   double precision = std::numeric_limits<double>::infinity())
+                                   double precision = std::numeric_limits<double>::infinity(),
+                                   std::size_t nbThreads = 1)
 {
     vec_inliers.clear();
 
@@ -161,9 +282,6 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
                                   ? std::numeric_limits<double>::infinity()
                                   : precision * precision * kernel.thresholdNormalizer() * kernel.thresholdNormalizer();
 
-    std::vector<ErrorIndex> vec_residuals(nData);  // [residual,index]
-    std::vector<double> vec_residuals_(nData);
-
     // Possible sampling indices [0,..,nData] (will change in the optimization phase)
     std::vector<size_t> vec_index(nData);
     std::iota(vec_index.begin(), vec_index.end(), 0);
@@ -183,91 +301,172 @@ std::pair<double, double> ACRANSAC(const Kernel& kernel,
 
     bool bACRansacMode = (precision == std::numeric_limits<double>::infinity());
 
+    // Hypotheses drawn and evaluated together
+    // the batch size only depends on the requested mode, not on the number of available cores
+    const int nbWorkers = (nbThreads == 0) ? omp_get_max_threads() : static_cast<int>(nbThreads);
+    const std::size_t batchSize = (nbThreads != 1) ? parallelHypothesesBatchSize : 1;
+
+    /// Evaluation of a model
+    struct Evaluation
+    {
+        /// number of residuals below the threshold
+        std::size_t nbInliers = 0;
+        /// true if the NFA has been evaluated
+        bool hasNFA = false;
+        /// best NFA and its number of inliers, only evaluated if it may improve the best NFA
+        ErrorIndex best;
+        /// the corresponding inliers
+        std::vector<std::size_t> inliers;
+        /// the corresponding error threshold
+        double errorMax = std::numeric_limits<double>::infinity();
+    };
+
+    // Workspaces reused by all the iterations
+    std::vector<std::vector<std::size_t>> samples(batchSize, std::vector<std::size_t>(sizeSample));  // Sample indices
+    std::vector<std::vector<typename Kernel::ModelT>> models(batchSize);                            // Up to max_models solutions
+    std::vector<std::vector<Evaluation>> evaluations(batchSize);
+    std::vector<std::vector<ErrorIndex>> residualsPerThread(nbWorkers, std::vector<ErrorIndex>(nData));  // [residual,index]
+    std::vector<std::vector<double>> residualsPerThread_(nbWorkers, std::vector<double>(nData));
+
+    // Most meaningful discrimination inliers/outliers
+    // only the residuals that can beat the given NFA are sorted
+    const auto evaluateNFA = [&](const std::vector<double>& vec_residuals_, std::vector<ErrorIndex>& vec_residuals, double maxNFA, Evaluation& evaluation) {
+        for (size_t i = 0; i < nData; ++i)
+            vec_residuals[i] = ErrorIndex(vec_residuals_[i], i);
+
+        evaluation.hasNFA = true;
+        evaluation.best = bestNFASelect(
+          sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, kernel.errorVectorDimension(), maxNFA);
+
+        if (evaluation.best.first < maxNFA)
+        {
+            evaluation.inliers.resize(evaluation.best.second);
+            for (size_t i = 0; i < evaluation.best.second; ++i)
+                evaluation.inliers[i] = vec_residuals[i].second;
+            evaluation.errorMax = vec_residuals[evaluation.best.second - 1].first;  // Error threshold
+        }
+    };
+
     // Main estimation loop.
-    for (std::size_t iter = 0; iter < nIter; ++iter)
+    std::size_t iter = 0;
+    bool stop = false;
+    while (iter < nIter && !stop)
     {
-        std::vector<std::size_t> vec_sample(sizeSample);  // Sample indices
-        if (bACRansacMode)
-            uniformSample(randomNumberGenerator, sizeSample, vec_index, vec_sample);  // Get random sample
-        else
-            uniformSample(randomNumberGenerator, sizeSample, nData, vec_sample);  // Get random sample
-
-        std::vector<typename Kernel::ModelT> vec_models;  // Up to max_models solutions
-        kernel.fit(vec_sample, vec_models);
-
-        // Evaluate models
-        bool better = false;
-        for (std::size_t k = 0; k < vec_models.size(); ++k)
+        const std::size_t nbHypotheses = std::min(batchSize, nIter - iter);
+
+        // Draw the samples sequentially to keep the results reproducible
+        for (std::size_t h = 0; h < nbHypotheses; ++h)
         {
-            // Residuals computation and ordering
-            kernel.errors(vec_models[k], vec_residuals_);
+            if (bACRansacMode)
+                uniformSample(randomNumberGenerator, sizeSample, vec_index, samples[h]);  // Get random sample
+            else
+                uniformSample(randomNumberGenerator, sizeSample, nData, samples[h]);  // Get random sample
+        }
 
-            if (!bACRansacMode)
+        // Fit and evaluate the models
+        const bool bACRansacModeBatch = bACRansacMode;
+        const double minNFABatch = minNFA;
+
+#pragma omp parallel for num_threads(nbWorkers) schedule(dynamic) if (nbHypotheses > 1)
+        for (int h = 0; h < static_cast<int>(nbHypotheses); ++h)
+        {
+            std::vector<double>& vec_residuals_ = residualsPerThread_[omp_get_thread_num()];
+
+            models[h].clear();
+            kernel.fit(samples[h], models[h]);
+            evaluations[h].assign(models[h].size(), Evaluation());
+
+            for (std::size_t k = 0; k < models[h].size(); ++k)
             {
-                unsigned int nInlier = 0;
-                for (std::size_t i = 0; i < nData; ++i)
+                Evaluation& evaluation = evaluations[h][k];
+
+                // Residuals computation
+                kernel.errors(models[h][k], vec_residuals_);
+
+                if (!bACRansacModeBatch)
                 {
-                    if (vec_residuals_[i] <= maxThreshold)
-                        ++nInlier;
+                    for (std::size_t i = 0; i < nData; ++i)
+                    {
+                        if (vec_residuals_[i] <= maxThreshold)
+                            ++evaluation.nbInliers;
+                    }
                 }
-                if (nInlier > 2.5 * sizeSample)  // does the model is meaningful
-                    bACRansacMode = true;
+                if (bACRansacModeBatch || evaluation.nbInliers > 2.5 * sizeSample)
+                    evaluateNFA(vec_residuals_, residualsPerThread[omp_get_thread_num()], minNFABatch, evaluation);
             }
-            if (bACRansacMode)
+        }
+
+        // Reduce the hypotheses in the order of the draws
+        for (std::size_t h = 0; h < nbHypotheses; ++h, ++iter)
+        {
+            bool better = false;
+            for (std::size_t k = 0; k < models[h].size(); ++k)
             {
-                for (size_t i = 0; i < nData; ++i)
+                Evaluation& evaluation = evaluations[h][k];
+
+                if (!bACRansacMode && evaluation.nbInliers > 2.5 * sizeSample)  // does the model is meaningful
+                    bACRansacMode = true;
+
+                if (!bACRansacMode)
+                    continue;
+
+                // the mode has been enabled by a previous hypothesis of the batch
+                if (!evaluation.hasNFA)
                 {
-                    const double error = vec_residuals_[i];
-                    vec_residuals[i] = ErrorIndex(error, i);
+                    kernel.errors(models[h][k], residualsPerThread_.front());
+                    evaluateNFA(residualsPerThread_.front(), residualsPerThread.front(), minNFA, evaluation);
                 }
-                std::sort(vec_residuals.begin(), vec_residuals.end());
 
-                // Most meaningful discrimination inliers/outliers
-                const ErrorIndex best =
-                  bestNFA(sizeSample, kernel.logalpha0(), vec_residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, kernel.errorVectorDimension());
-
-                if (best.first < minNFA /*&& vec_residuals[best.second-1].first < errorMax*/)
+                if (evaluation.best.first < minNFA /*&& vec_residuals[best.second-1].first < errorMax*/)
                 {
                     // A better model was found
                     better = true;
-                    minNFA = best.first;
-                    vec_inliers.resize(best.second);
-                    for (size_t i = 0; i < best.second; ++i)
-                        vec_inliers[i] = vec_residuals[i].second;
-                    errorMax = vec_residuals[best.second - 1].first;  // Error threshold
+                    minNFA = evaluation.best.first;
+                    vec_inliers.swap(evaluation.inliers);
+                    errorMax = evaluation.errorMax;
                     if (model)
-                        *model = vec_models[k];
+                        *model = models[h][k];
 
-                    ALICEVISION_LOG_TRACE("  nfa=" << minNFA << " inliers=" << best.second << "/" << nData << " precisionNormalized=" << errorMax
+                    ALICEVISION_LOG_TRACE("  nfa=" << minNFA << " inliers=" << vec_inliers.size() << "/" << nData << " precisionNormalized=" << errorMax
                                                    << " precision=" << kernel.unormalizeError(errorMax) << " (iter=" << iter
-                                                   << ",sample=" << vec_sample << ")");
+                                                   << ",sample=" << samples[h] << ")");
                 }
-            }  // if(bACRansacMode)
-        }      // for(size_t k...
-
-        // Early exit test -> no meaningful model found after nIterReserve*2 iterations
-        if (!bACRansacMode && iter > nIterReserve * 2)
-            break;
+            }  // for(size_t k...
 
-        // ACRANSAC optimization: draw samples among best set of inliers so far
-        if (bACRansacMode && ((better && minNFA < 0) || (iter + 1 == nIter && nIterReserve)))
-        {
-            if (vec_inliers.empty())
+            // Early exit test -> no meaningful model found after nIterReserve*2 iterations
+            if (!bACRansacMode && iter > nIterReserve * 2)
             {
-                // No model found at all so far
-                ++nIter;  // Continue to look for any model, even not meaningful
-                --nIterReserve;
+                stop = true;
+                break;
             }
-            else
+
+            // ACRANSAC optimization: draw samples among best set of inliers so far
+            if (bACRansacMode && ((better && minNFA < 0) || (iter + 1 == nIter && nIterReserve)))
             {
-                // ACRANSAC optimization: draw samples among best set of inliers so far
-                vec_index = vec_inliers;
-                if (nIterReserve)
+                if (vec_inliers.empty())
+                {
+                    // No model found at all so far
+                    ++nIter;  // Continue to look for any model, even not meaningful
+                    --nIterReserve;
+                }
+                else
                 {
-                    nIter = iter + 1 + nIterReserve;
-                    nIterReserve = 0;
+                    // ACRANSAC optimization: draw samples among best set of inliers so far
+                    vec_index = vec_inliers;
+                    if (nIterReserve)
+                    {
+                        nIter = iter + 1 + nIterReserve;
+                        nIterReserve = 0;
+                    }
                 }
             }
+
+            // the remaining hypotheses of the batch are beyond the last iteration
+            if (iter + 1 >= nIter)
+            {
+                ++iter;
+                break;
+            }
         }
     }
 
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/robustEstimation/randSampling.hpp>
 #include <aliceVision/robustEstimation/ACRansac.hpp>
 #include <aliceVision/robustEstimation/ransacTools.hpp>
 #include <aliceVision/robustEstimation/IRansacKernel.hpp>
+#include <aliceVision/robustEstimation/ScoreEvaluator.hpp>
 #include <limits>
 #include <numeric>
 #include <iostream>
@@ -297,6 +299,14 @@ double localOptimization(const Kernel& kernel,
  * @param[in] bVerbose Enable/Disable log messages
  * @param[in] max_iterations Maximum number of iterations for the ransac part.
  * @param[in] outliers_probability The wanted probability of picking outliers.
+ * @param[in] nbThreads Number of threads scoring the hypotheses (1: sequential, 0: all the available cores).
+ * In the multi-threaded mode (nbThreads != 1), the samples of a batch of hypotheses are drawn sequentially and
+ * the hypotheses are fitted and scored concurrently, then reduced (with the local optimization)
+ * in the order of the draws: the result only depends on the seed, whatever the number of threads.
+ * An adaptive scorer (@see isAdaptiveScorer) is updated with each reduced model, and the local optimization
+ * always evaluates the models on all the samples.
+ * The sequential mode (nbThreads == 1) scores the hypotheses one by one and stops as soon as possible:
+ * for the same seed, its result can differ from the multi-threaded mode.
  * @return The best model found.
  */
 template<typename Kernel, typename Scorer>
@@ -307,7 +317,8 @@ typename Kernel::ModelT LO_RANSAC(const Kernel& kernel,
                                   double* best_score = NULL,
                                   bool bVerbose = false,
                                   std::size_t max_iterations = 100,
-                                  double outliers_probability = 1e-2)
+                                  double outliers_probability = 1e-2,
+                                  std::size_t nbThreads = 1)
 {
     assert(outliers_probability < 1.0);
     assert(outliers_probability > 0.0);
@@ -336,69 +347,128 @@ typename Kernel::ModelT LO_RANSAC(const Kernel& kernel,
     std::vector<std::size_t> all_samples(total_samples);
     std::iota(all_samples.begin(), all_samples.end(), 0);
 
-    for (iteration = 0; iteration < max_iterations; ++iteration)
+    // Hypotheses drawn and scored together
+    // the batch size only depends on the requested mode, not on the number of available cores
+    const int nbWorkers = (nbThreads == 0) ? omp_get_max_threads() : static_cast<int>(nbThreads);
+    const std::size_t batchSize = (nbThreads != 1) ? parallelHypothesesBatchSize : 1;
+
+    std::vector<std::vector<std::size_t>> samples(batchSize);
+    std::vector<std::vector<typename Kernel::ModelT>> modelsPerHypothesis(batchSize);
+    std::vector<std::vector<std::vector<std::size_t>>> inliersPerHypothesis(batchSize);
+    std::vector<std::vector<double>> scoresPerHypothesis(batchSize);
+
+    // the scorer of the hypotheses adapts its test to the models evaluated so far
+    Scorer hypothesisScorer(scorer);
+    using Evaluation = typename std::conditional_t<isAdaptiveScorer<Scorer>::value, Scorer, SPRTScoreEvaluator<Kernel>>::Evaluation;
+    std::vector<std::vector<Evaluation>> evaluationsPerHypothesis(batchSize);
+
+    // the local optimization refits the models on their inliers: it needs the full evaluation
+    const ScoreEvaluator<Kernel> localScorer(scorer.getThreshold());
+
+    while (iteration < max_iterations)
     {
-        std::vector<std::size_t> sample;
-        uniformSample(randomNumberGenerator, min_samples, total_samples, sample);
+        const std::size_t nbHypotheses = std::min(batchSize, max_iterations - iteration);
 
-        std::vector<typename Kernel::ModelT> models;
-        kernel.fit(sample, models);
+        // Draw the samples sequentially to keep the results reproducible
+        for (std::size_t h = 0; h < nbHypotheses; ++h)
+            uniformSample(randomNumberGenerator, min_samples, total_samples, samples[h]);
 
-        // Compute the inlier list for each fit.
-        for (std::size_t i = 0; i < models.size(); ++i)
+#pragma omp parallel for num_threads(nbWorkers) schedule(dynamic) if (nbHypotheses > 1)
+        for (int h = 0; h < static_cast<int>(nbHypotheses); ++h)
         {
-            std::vector<std::size_t> inliers;
-            double score = scorer.score(kernel, models.at(i), all_samples, inliers);
-            if (bVerbose)
+            modelsPerHypothesis[h].clear();
+            kernel.fit(samples[h], modelsPerHypothesis[h]);
+
+            inliersPerHypothesis[h].assign(modelsPerHypothesis[h].size(), std::vector<std::size_t>());
+            scoresPerHypothesis[h].resize(modelsPerHypothesis[h].size());
+            evaluationsPerHypothesis[h].resize(modelsPerHypothesis[h].size());
+            for (std::size_t i = 0; i < modelsPerHypothesis[h].size(); ++i)
             {
-                ALICEVISION_LOG_DEBUG("sample=" << sample);
-                ALICEVISION_LOG_DEBUG("model " << i << " e: " << score);
+                if constexpr (isAdaptiveScorer<Scorer>::value)
+                    scoresPerHypothesis[h][i] = hypothesisScorer.score(kernel,
+                                                                       modelsPerHypothesis[h][i],
+                                                                       all_samples,
+                                                                       inliersPerHypothesis[h][i],
+                                                                       hypothesisScorer.getThreshold(),
+                                                                       evaluationsPerHypothesis[h][i]);
+                else
+                    scoresPerHypothesis[h][i] = hypothesisScorer.score(kernel, modelsPerHypothesis[h][i], all_samples, inliersPerHypothesis[h][i]);
             }
+        }
 
-            if (bestNumInliers <= inliers.size())
+        // Reduce the hypotheses in the order of the draws
+        for (std::size_t h = 0; h < nbHypotheses && iteration < max_iterations; ++h, ++iteration)
+        {
+            const std::vector<std::size_t>& sample = samples[h];
+            const std::vector<typename Kernel::ModelT>& models = modelsPerHypothesis[h];
+            std::vector<std::vector<std::size_t>>& inliersPerModel = inliersPerHypothesis[h];
+            const std::vector<double>& scores = scoresPerHypothesis[h];
+
+            // Compute the inlier list for each fit.
+            for (std::size_t i = 0; i < models.size(); ++i)
             {
-                bestModel = models[i];
-                //** LOCAL OPTIMIZATION
+                std::vector<std::size_t>& inliers = inliersPerModel[i];
+                double score = scores[i];
                 if (bVerbose)
                 {
-                    ALICEVISION_LOG_DEBUG("Before Optim: num inliers: " << inliers.size() << " score: " << score
-                                                                        << " kernel minimum nb required samples LS: "
-                                                                        << kernel.getMinimumNbRequiredSamplesLS());
-
-                    ALICEVISION_LOG_DEBUG("Model:\n" << bestModel.getMatrix());
+                    ALICEVISION_LOG_DEBUG("sample=" << sample);
+                    ALICEVISION_LOG_DEBUG("model " << i << " e: " << score);
                 }
 
-                if (inliers.size() > kernel.getMinimumNbRequiredSamplesLS())
+                // a model rejected by the scorer has no inliers
+                if (!inliers.empty() && bestNumInliers <= inliers.size())
                 {
-                    score = localOptimization(kernel, scorer, randomNumberGenerator, bestModel, inliers);
-                }
+                    bestModel = models[i];
+                    //** LOCAL OPTIMIZATION
+                    if (bVerbose)
+                    {
+                        ALICEVISION_LOG_DEBUG("Before Optim: num inliers: " << inliers.size() << " score: " << score
+                                                                            << " kernel minimum nb required samples LS: "
+                                                                            << kernel.getMinimumNbRequiredSamplesLS());
 
-                if (bVerbose)
-                {
-                    ALICEVISION_LOG_DEBUG("After Optim: num inliers: " << inliers.size() << " score: " << score);
-                    ALICEVISION_LOG_DEBUG("Model:\n" << bestModel.getMatrix());
-                }
+                        ALICEVISION_LOG_DEBUG("Model:\n" << bestModel.getMatrix());
+                    }
 
-                bestNumInliers = inliers.size();
-                bestInlierRatio = inliers.size() / double(total_samples);
+                    if (inliers.size() > kernel.getMinimumNbRequiredSamplesLS())
+                    {
+                        score = localOptimization(kernel, localScorer, randomNumberGenerator, bestModel, inliers);
+                    }
 
-                if (best_inliers)
-                {
-                    best_inliers->swap(inliers);
-                }
+                    if (bVerbose)
+                    {
+                        ALICEVISION_LOG_DEBUG("After Optim: num inliers: " << inliers.size() << " score: " << score);
+                        ALICEVISION_LOG_DEBUG("Model:\n" << bestModel.getMatrix());
+                    }
 
-                if (bVerbose)
-                {
-                    ALICEVISION_LOG_DEBUG(" inliers=" << bestNumInliers << "/" << total_samples << " (iter=" << iteration << " ,i=" << i
-                                                      << " ,sample=" << sample << ")");
+                    bestNumInliers = inliers.size();
+                    bestInlierRatio = inliers.size() / double(total_samples);
+
+                    if constexpr (isAdaptiveScorer<Scorer>::value)
+                        hypothesisScorer.updateFromBestModel(bestNumInliers, total_samples);
+
+                    if (best_inliers)
+                    {
+                        best_inliers->swap(inliers);
+                    }
+
+                    if (bVerbose)
+                    {
+                        ALICEVISION_LOG_DEBUG(" inliers=" << bestNumInliers << "/" << total_samples << " (iter=" << iteration << " ,i=" << i
+                                                          << " ,sample=" << sample << ")");
+                    }
+                    if (bestInlierRatio)
+                    {
+                        max_iterations = iterationsRequired(min_samples, outliers_probability, bestInlierRatio);
+                        // safeguard to not get stuck in a big number of iterations
+                        max_iterations = std::min(max_iterations, really_max_iterations);
+                        if (bVerbose)
+                            ALICEVISION_LOG_DEBUG("New max_iteration: " << max_iterations);
+                    }
                 }
-                if (bestInlierRatio)
+                else
                 {
-                    max_iterations = iterationsRequired(min_samples, outliers_probability, bestInlierRatio);
-                    // safeguard to not get stuck in a big number of iterations
-                    max_iterations = std::min(max_iterations, really_max_iterations);
-                    if (bVerbose)
-                        ALICEVISION_LOG_DEBUG("New max_iteration: " << max_iterations);
+                    if constexpr (isAdaptiveScorer<Scorer>::value)
+                        hypothesisScorer.updateFromBadModel(evaluationsPerHypothesis[h][i]);
                 }
             }
         }
@@ -14,10 +14,29 @@
 
 #include <vector>
 #include <cassert>
+#include <type_traits>
+#include <utility>
 
 namespace aliceVision {
 namespace robustEstimation {
 
+/**
+ * @brief Check if an error functor can compute the errors of all the samples at once
+ *        with errors(model, x1, x2, errors).
+ */
+template<typename ErrorT, typename ModelT, typename = void>
+struct HasBatchErrors : std::false_type
+{};
+
+template<typename ErrorT, typename ModelT>
+struct HasBatchErrors<
+  ErrorT,
+  ModelT,
+  std::void_t<decltype(std::declval<const ErrorT&>().errors(
+    std::declval<const ModelT&>(), std::declval<const Mat&>(), std::declval<const Mat&>(), std::declval<std::vector<double>&>()))>>
+  : std::true_type
+{};
+
 /**
  * @brief This is one example (targeted at solvers that operate on correspondences
  * between two views) that shows the "kernel" part of a robust fitting
@@ -94,14 +113,23 @@ class PointFittingKernel
 
     /**
      * @brief Return the errors associated to the model and each sample point
+     * @note If the error functor supports it, all the samples are evaluated at once (vectorized),
+     *       so a kernel overriding error() must also override errors().
      * @param[in] model
      * @param[out] errors
      */
     inline virtual void errors(const ModelT& model, std::vector<double>& errors) const
     {
-        errors.resize(_x1.cols());
-        for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
-            errors.at(sample) = error(sample, model);
+        if constexpr (HasBatchErrors<ErrorT, ModelT>::value)
+        {
+            _errorEstimator.errors(model, _x1, _x2, errors);
+        }
+        else
+        {
+            errors.resize(_x1.cols());
+            for (std::size_t sample = 0; sample < _x1.cols(); ++sample)
+                errors.at(sample) = error(sample, model);
+        }
     }
 
     /**
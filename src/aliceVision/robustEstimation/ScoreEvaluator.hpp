@@ -7,6 +7,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
 namespace aliceVision {
 namespace robustEstimation {
 
@@ -55,5 +62,272 @@ class ScoreEvaluator
     double _threshold;
 };
 
+/**
+ * @brief Templated Functor class to evaluate a given model over a set of samples,
+ *        with an early termination of the evaluation of the bad models.
+ *
+ * The evaluation is a Wald Sequential Probability Ratio Test (SPRT): after each sample,
+ * the likelihood ratio between the "bad model" and the "good model" hypotheses is updated
+ * and the evaluation stops as soon as it exceeds the decision threshold A.
+ * The models accepted by the test are evaluated on all the samples, so their score and inliers
+ * are the same as with the ScoreEvaluator.
+ *
+ * The test is adaptive (WaldSAC): the probability epsilon for a sample to be consistent with a good model
+ * is the inlier ratio of the best model so far and the probability delta for a sample to be consistent
+ * with a bad model is estimated from the other evaluated models (@see updateFromBestModel, updateFromBadModel).
+ * As long as epsilon is not above delta, the models are evaluated on all the samples.
+ *
+ * @ref [1] Jiri Matas, Ondrej Chum.
+ *          Randomized RANSAC with Sequential Probability Ratio Test.
+ *          ICCV 2005.
+ * @ref [2] Ondrej Chum, Jiri Matas.
+ *          Optimal Randomized RANSAC.
+ *          IEEE Transactions on Pattern Analysis and Machine Intelligence, 2008.
+ */
+template<typename Kernel>
+class SPRTScoreEvaluator
+{
+  public:
+    /**
+     * @brief Statistics of the evaluation of a model, used to estimate delta
+     */
+    struct Evaluation
+    {
+        /// number of samples evaluated before the decision
+        std::size_t nbTested = 0;
+        /// number of evaluated samples consistent with the model
+        std::size_t nbConsistent = 0;
+    };
+
+    /**
+     * @brief SPRTScoreEvaluator constructor
+     * @param[in] threshold The inlier threshold
+     * @param[in] epsilon The initial probability for a sample to be consistent with a good model
+     *            (0: unknown, the test starts with the first best model)
+     * @param[in] delta The initial probability for a sample to be consistent with a bad model
+     * @param[in] timeRatio The time to compute the models of a sample, in number of evaluated samples
+     * @param[in] nbModelsPerSample The average number of models computed from a sample
+     */
+    explicit SPRTScoreEvaluator(double threshold, double epsilon = 0.0, double delta = 0.01, double timeRatio = 200.0, double nbModelsPerSample = 1.0)
+      : _threshold(threshold),
+        _timeRatio(timeRatio),
+        _nbModelsPerSample(nbModelsPerSample)
+    {
+        designTest(epsilon, delta);
+    }
+
+    /**
+     * @brief Evaluate a model over a set of samples.
+     * @details The test assumes the samples are visited in a random order: they are visited with a
+     *          stride coprime with their number, so that sorted or grouped samples (e.g. the outliers
+     *          first) do not reject a good model. The inliers are returned in the order of the samples.
+     * @param[in] kernel The kernel
+     * @param[in] model The model to evaluate
+     * @param[in] samples The samples to evaluate
+     * @param[out] inliers The samples consistent with the model, appended (left unchanged if the model is rejected)
+     * @param[in] threshold The inlier threshold
+     * @param[out] evaluation The statistics of the evaluation
+     * @return the cost of the model, infinity if the model is rejected by the test
+     */
+    template<typename T>
+    double score(const Kernel& kernel,
+                 const typename Kernel::ModelT& model,
+                 const std::vector<T>& samples,
+                 std::vector<T>& inliers,
+                 double threshold,
+                 Evaluation& evaluation) const
+    {
+        const std::size_t nbSamples = samples.size();
+        const std::size_t stride = coprimeStride(nbSamples);
+        std::vector<char> isConsistent(nbSamples, 0);
+        double logLikelihoodRatio = 0.0;
+        double cost = 0.0;
+
+        evaluation = Evaluation();
+
+        for (std::size_t j = 0, index = 0; j < nbSamples; ++j, index = (index + stride) % nbSamples)
+        {
+            const double error = kernel.error(samples[index], model);
+            cost += error;
+            ++evaluation.nbTested;
+
+            if (error < threshold)
+            {
+                isConsistent[index] = 1;
+                ++evaluation.nbConsistent;
+                logLikelihoodRatio += _logConsistentRatio;
+            }
+            else
+            {
+                logLikelihoodRatio += _logInconsistentRatio;
+
+                // bad model, stop the evaluation
+                if (_isTestEnabled && logLikelihoodRatio > _logDecisionThreshold)
+                    return std::numeric_limits<double>::infinity();
+            }
+        }
+
+        for (std::size_t j = 0; j < nbSamples; ++j)
+        {
+            if (isConsistent[j])
+                inliers.push_back(samples[j]);
+        }
+        return cost;
+    }
+
+    template<typename T>
+    double score(const Kernel& kernel, const typename Kernel::ModelT& model, const std::vector<T>& samples, std::vector<T>& inliers, double threshold)
+      const
+    {
+        Evaluation evaluation;
+        return score(kernel, model, samples, inliers, threshold, evaluation);
+    }
+
+    template<typename T>
+    double score(const Kernel& kernel, const typename Kernel::ModelT& model, const std::vector<T>& samples, std::vector<T>& inliers) const
+    {
+        return score(kernel, model, samples, inliers, _threshold);
+    }
+
+    /**
+     * @brief Update epsilon with the inlier ratio of a new best model and design the new test
+     * @param[in] nbInliers The number of inliers of the best model
+     * @param[in] nbSamples The number of samples
+     */
+    void updateFromBestModel(std::size_t nbInliers, std::size_t nbSamples)
+    {
+        if (nbSamples == 0)
+            return;
+        designTest(static_cast<double>(nbInliers) / static_cast<double>(nbSamples), _delta);
+    }
+
+    /**
+     * @brief Update the estimation of delta with the evaluation of a model which is not the best one
+     * @note The test is designed again when delta changes by more than 5%, see [2].
+     * @param[in] evaluation The statistics of the evaluation of the model
+     */
+    void updateFromBadModel(const Evaluation& evaluation)
+    {
+        _nbBadTested += evaluation.nbTested;
+        _nbBadConsistent += evaluation.nbConsistent;
+
+        if (_nbBadTested == 0)
+            return;
+
+        const double delta = std::max(minDelta, static_cast<double>(_nbBadConsistent) / static_cast<double>(_nbBadTested));
+        if (std::abs(delta - _delta) > 0.05 * _delta)
+            designTest(_epsilon, delta);
+    }
+
+    double getThreshold() const { return _threshold; }
+
+    /**
+     * @brief Get the current probability for a sample to be consistent with a good model
+     * @return epsilon
+     */
+    double getEpsilon() const { return _epsilon; }
+
+    /**
+     * @brief Get the current probability for a sample to be consistent with a bad model
+     * @return delta
+     */
+    double getDelta() const { return _delta; }
+
+    /**
+     * @brief Check if the bad models are rejected early, i.e. epsilon is above delta
+     * @return true if the test is enabled
+     */
+    bool isTestEnabled() const { return _isTestEnabled; }
+
+    /**
+     * @brief Get the decision threshold A of the test
+     * @return decision threshold, infinity if the test is disabled
+     */
+    double getDecisionThreshold() const { return _isTestEnabled ? std::exp(_logDecisionThreshold) : std::numeric_limits<double>::infinity(); }
+
+  private:
+    /// lower bound of delta, the likelihood ratio of a consistent sample is not defined for 0
+    static constexpr double minDelta = 1e-4;
+
+    /**
+     * @brief Compute the likelihood ratio updates and the decision threshold for the given epsilon and delta
+     * @param[in] epsilon The probability for a sample to be consistent with a good model
+     * @param[in] delta The probability for a sample to be consistent with a bad model
+     */
+    void designTest(double epsilon, double delta)
+    {
+        _epsilon = epsilon;
+        _delta = std::max(minDelta, delta);
+
+        // a good model cannot be told apart from a bad one
+        _isTestEnabled = (_epsilon > _delta && _epsilon < 1.0);
+        if (!_isTestEnabled)
+            return;
+
+        _logConsistentRatio = std::log(_delta / _epsilon);
+        _logInconsistentRatio = std::log((1.0 - _delta) / (1.0 - _epsilon));
+
+        // optimal decision threshold, see equation (2) of [1]
+        const double C = (1.0 - _delta) * _logInconsistentRatio + _delta * _logConsistentRatio;
+        const double A0 = _timeRatio * C / _nbModelsPerSample + 1.0;
+
+        double A = A0;
+        for (int i = 0; i < 10; ++i)
+            A = A0 + std::log(A);
+
+        _logDecisionThreshold = std::log(A);
+    }
+
+    /**
+     * @brief Get a stride visiting all the samples once, close to the golden ratio of their number
+     * @param[in] nbSamples The number of samples
+     * @return the stride, coprime with the number of samples
+     */
+    static std::size_t coprimeStride(std::size_t nbSamples)
+    {
+        if (nbSamples < 3)
+            return 1;
+
+        std::size_t stride = static_cast<std::size_t>(0.618 * nbSamples);
+        while (std::gcd(stride, nbSamples) != 1)
+            --stride;
+        return stride;
+    }
+
+    double _threshold;
+    /// time to compute the models of a sample, in number of evaluated samples
+    double _timeRatio;
+    /// average number of models computed from a sample
+    double _nbModelsPerSample;
+    /// probability for a sample to be consistent with a good model
+    double _epsilon = 0.0;
+    /// probability for a sample to be consistent with a bad model
+    double _delta = 0.0;
+    /// samples evaluated on the bad models, used to estimate delta
+    std::size_t _nbBadTested = 0;
+    /// samples consistent with the bad models, used to estimate delta
+    std::size_t _nbBadConsistent = 0;
+    /// the bad models are rejected early only if epsilon is above delta
+    bool _isTestEnabled = false;
+    /// log of the likelihood ratio update for a consistent sample: log(delta / epsilon)
+    double _logConsistentRatio = 0.0;
+    /// log of the likelihood ratio update for an inconsistent sample: log((1 - delta) / (1 - epsilon))
+    double _logInconsistentRatio = 0.0;
+    /// log of the decision threshold A
+    double _logDecisionThreshold = 0.0;
+};
+
+/**
+ * @brief Scorers adapting their test to the models evaluated so far (@see SPRTScoreEvaluator)
+ *        define an Evaluation type, collected for each model by the robust estimators.
+ */
+template<typename Scorer, typename = void>
+struct isAdaptiveScorer : std::false_type
+{};
+
+template<typename Scorer>
+struct isAdaptiveScorer<Scorer, std::void_t<typename Scorer::Evaluation>> : std::true_type
+{};
+
 }  // namespace robustEstimation
 }  // namespace aliceVision
@@ -267,3 +267,91 @@ BOOST_AUTO_TEST_CASE(RansacLineFitter_ACRANSACSimu)
         BOOST_CHECK(vec_inliers.size() <= expectedInliers);
     }
 }
+
+// check the partial selection of the best NFA against the evaluation on the fully sorted residuals
+BOOST_AUTO_TEST_CASE(ACRansac_BestNFASelect)
+{
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> inlierDistribution(0.0, 1e-4);
+    std::uniform_real_distribution<double> outlierDistribution(0.0, 1.0);
+    std::bernoulli_distribution isInlier(0.3);
+
+    const std::size_t nData = 1000;
+    const std::size_t sizeSample = 2;
+    const double logalpha0 = log10(0.5);
+    const double loge0 = log10(static_cast<double>(nData - sizeSample));
+
+    std::vector<float> vec_logc_n, vec_logc_k;
+    makelogcombi(sizeSample, nData, vec_logc_k, vec_logc_n);
+
+    for (const double maxThreshold : {std::numeric_limits<double>::infinity(), 0.5, 1e-5})
+    {
+        for (int trial = 0; trial < 20; ++trial)
+        {
+            std::vector<ErrorIndex> residuals(nData);
+            for (std::size_t i = 0; i < nData; ++i)
+                residuals[i] = ErrorIndex(isInlier(gen) ? inlierDistribution(gen) : outlierDistribution(gen), i);
+
+            std::vector<ErrorIndex> sortedResiduals = residuals;
+            std::sort(sortedResiduals.begin(), sortedResiduals.end());
+
+            const ErrorIndex expected = bestNFA(sizeSample, logalpha0, sortedResiduals, loge0, maxThreshold, vec_logc_n, vec_logc_k);
+            const ErrorIndex best = bestNFASelect(sizeSample, logalpha0, residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k);
+
+            BOOST_CHECK_EQUAL(expected.first, best.first);
+            BOOST_CHECK_EQUAL(expected.second, best.second);
+
+            if (best.first == std::numeric_limits<double>::infinity())
+                continue;
+
+            // the inliers are the sorted smallest residuals
+            for (std::size_t i = 0; i < best.second; ++i)
+                BOOST_CHECK(sortedResiduals[i] == residuals[i]);
+
+            // a model that cannot beat the current best NFA is discarded
+            const ErrorIndex discarded = bestNFASelect(sizeSample, logalpha0, residuals, loge0, maxThreshold, vec_logc_n, vec_logc_k, 1.0, expected.first);
+            BOOST_CHECK_EQUAL(std::numeric_limits<double>::infinity(), discarded.first);
+        }
+    }
+}
+
+// check that the multi-threaded mode gives the same result for a given seed
+BOOST_AUTO_TEST_CASE(RansacLineFitter_MultiThreadedReproducible)
+{
+    const int W = 1000;
+    const int H = 1000;
+    const double outlierRatio = .5;
+    const std::size_t numPoints = 5000;
+
+    Vec2 GTModel;
+    GTModel << -2, .3;
+
+    std::mt19937 gen;
+    Mat2X points(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, 1.0, GTModel, gen, points, vec_inliersGT);
+
+    LineKernel lineKernel(points, W, H);
+
+    std::vector<std::vector<std::size_t>> inliersPerRun;
+    std::vector<double> nfaPerRun;
+    // 0 uses all the available cores, which may be a single one
+    for (const std::size_t nbThreads : {2, 4, 4, 0})
+    {
+        std::mt19937 runGenerator(42);
+        std::vector<std::size_t> vec_inliers;
+        robustEstimation::MatrixModel<Vec2> model;
+        const std::pair<double, double> ret = ACRANSAC(lineKernel, runGenerator, vec_inliers, 1024, &model, std::numeric_limits<double>::infinity(), nbThreads);
+
+        BOOST_CHECK(vec_inliers.size() <= vec_inliersGT.size());
+        BOOST_CHECK(vec_inliers.size() > 0.9 * vec_inliersGT.size());
+        inliersPerRun.push_back(vec_inliers);
+        nfaPerRun.push_back(ret.second);
+    }
+
+    BOOST_CHECK(inliersPerRun[0] == inliersPerRun[1]);
+    BOOST_CHECK(inliersPerRun[1] == inliersPerRun[2]);
+    BOOST_CHECK(inliersPerRun[2] == inliersPerRun[3]);
+    BOOST_CHECK_EQUAL(nfaPerRun[0], nfaPerRun[2]);
+    BOOST_CHECK_EQUAL(nfaPerRun[0], nfaPerRun[3]);
+}
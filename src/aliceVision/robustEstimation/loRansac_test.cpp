@@ -14,6 +14,7 @@
 #include <iostream>
 #include <random>
 #include <fstream>
+#include <numeric>
 #include <vector>
 #include <string>
 
@@ -105,3 +106,155 @@ BOOST_AUTO_TEST_CASE(LoRansacLineFitter_RealCaseLoRansac)
         BOOST_CHECK_EQUAL(expectedInliers, inliers.size());
     }
 }
+
+BOOST_AUTO_TEST_CASE(LoRansacLineFitter_MultiThreadedReproducible)
+{
+    const std::size_t numPoints = 5000;
+    const double outlierRatio = .5;
+    const double gaussianNoiseLevel = 0.01;
+
+    Vec2 GTModel;  // y = 2x + 1
+    GTModel << -2, .3;
+
+    std::mt19937 gen;
+    Mat2X xy(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, gaussianNoiseLevel, GTModel, gen, xy, vec_inliersGT);
+
+    LineKernel kernel(xy);
+    const ScoreEvaluator<LineKernel> scorer(3 * gaussianNoiseLevel);
+    const std::size_t expectedInliers = numPoints - (std::size_t)numPoints * outlierRatio;
+
+    std::vector<std::vector<std::size_t>> inliersPerRun;
+    // 0 uses all the available cores, which may be a single one
+    for (const std::size_t nbThreads : {2, 4, 4, 0})
+    {
+        std::mt19937 runGenerator(42);
+        std::vector<std::size_t> inliers;
+        const LineKernel::ModelT model = LO_RANSAC(kernel, scorer, runGenerator, &inliers, nullptr, false, 100, 1e-2, nbThreads);
+
+        BOOST_CHECK_EQUAL(expectedInliers, inliers.size());
+        BOOST_CHECK_SMALL(GTModel[0] - model.getMatrix()[0], 1e-2);
+        BOOST_CHECK_SMALL(GTModel[1] - model.getMatrix()[1], 1e-2);
+        inliersPerRun.push_back(inliers);
+    }
+
+    // the same seed gives the same result whatever the number of threads
+    BOOST_CHECK(inliersPerRun[0] == inliersPerRun[1]);
+    BOOST_CHECK(inliersPerRun[1] == inliersPerRun[2]);
+    BOOST_CHECK(inliersPerRun[2] == inliersPerRun[3]);
+}
+
+BOOST_AUTO_TEST_CASE(LoRansacLineFitter_SPRTScoreEvaluator)
+{
+    const std::size_t numPoints = 5000;
+    const double outlierRatio = .5;
+    const double gaussianNoiseLevel = 0.01;
+
+    Vec2 GTModel;  // y = 2x + 1
+    GTModel << -2, .3;
+
+    std::mt19937 gen;
+    Mat2X xy(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, gaussianNoiseLevel, GTModel, gen, xy, vec_inliersGT);
+
+    LineKernel kernel(xy);
+    const double threshold = 3 * gaussianNoiseLevel;
+    const std::size_t expectedInliers = numPoints - (std::size_t)numPoints * outlierRatio;
+
+    std::vector<std::size_t> samples(numPoints);
+    std::iota(samples.begin(), samples.end(), 0);
+
+    // without any estimation of epsilon, the models are evaluated on all the samples
+    {
+        const SPRTScoreEvaluator<LineKernel> scorer(threshold);
+        BOOST_CHECK(!scorer.isTestEnabled());
+        LineKernel::ModelT badModel(Vec2(10.0, -50.0));
+        std::vector<std::size_t> inliers;
+        BOOST_CHECK(std::isfinite(scorer.score(kernel, badModel, samples, inliers)));
+    }
+
+    // a model far from the line is rejected after a few samples
+    {
+        SPRTScoreEvaluator<LineKernel> scorer(threshold);
+        scorer.updateFromBestModel(expectedInliers, numPoints);
+        BOOST_CHECK(scorer.isTestEnabled());
+        LineKernel::ModelT badModel(Vec2(10.0, -50.0));
+        std::vector<std::size_t> inliers;
+        const double cost = scorer.score(kernel, badModel, samples, inliers);
+        BOOST_CHECK(std::isinf(cost));
+        BOOST_CHECK(inliers.empty());
+    }
+
+    // the good model is accepted and gets the same inliers as with the full evaluation
+    {
+        SPRTScoreEvaluator<LineKernel> scorer(threshold);
+        scorer.updateFromBestModel(expectedInliers, numPoints);
+        LineKernel::ModelT goodModel(GTModel);
+        std::vector<std::size_t> inliers;
+        std::vector<std::size_t> inliersRef;
+        const double cost = scorer.score(kernel, goodModel, samples, inliers);
+        const double costRef = ScoreEvaluator<LineKernel>(threshold).score(kernel, goodModel, samples, inliersRef);
+        BOOST_CHECK_CLOSE(cost, costRef, 1e-6);
+        BOOST_CHECK(inliers == inliersRef);
+    }
+
+    // the robust estimation finds the same consensus as with the full evaluation
+    for (std::size_t trial = 0; trial < 10; ++trial)
+    {
+        std::mt19937 generatorRef(trial);
+        std::vector<std::size_t> inliersRef;
+        LO_RANSAC(kernel, ScoreEvaluator<LineKernel>(threshold), generatorRef, &inliersRef);
+
+        std::mt19937 generator(trial);
+        std::vector<std::size_t> inliers;
+        const LineKernel::ModelT model = LO_RANSAC(kernel, SPRTScoreEvaluator<LineKernel>(threshold), generator, &inliers);
+
+        BOOST_CHECK_EQUAL(expectedInliers, inliers.size());
+        BOOST_CHECK_EQUAL(inliersRef.size(), inliers.size());
+        BOOST_CHECK_SMALL(GTModel[1] - model.getMatrix()[1], 1e-2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LoRansacLineFitter_SPRTScoreEvaluator_LowInlierRatio)
+{
+    // less inliers than the former fixed epsilon of 0.1
+    const std::size_t numPoints = 2000;
+    const double outlierRatio = .94;
+    const double gaussianNoiseLevel = 0.01;
+
+    Vec2 GTModel;
+    GTModel << -2, .3;
+
+    std::mt19937 gen;
+    Mat2X xy(2, numPoints);
+    std::vector<std::size_t> vec_inliersGT;
+    generateLine(numPoints, outlierRatio, gaussianNoiseLevel, GTModel, gen, xy, vec_inliersGT);
+
+    LineKernel kernel(xy);
+    const double threshold = 3 * gaussianNoiseLevel;
+
+    for (std::size_t trial = 0; trial < 5; ++trial)
+    {
+        std::mt19937 generatorRef(trial);
+        std::vector<std::size_t> inliersRef;
+        const LineKernel::ModelT modelRef = LO_RANSAC(kernel, ScoreEvaluator<LineKernel>(threshold), generatorRef, &inliersRef, nullptr, false, 4096);
+
+        std::mt19937 generator(trial);
+        std::vector<std::size_t> inliers;
+        const LineKernel::ModelT model = LO_RANSAC(kernel, SPRTScoreEvaluator<LineKernel>(threshold), generator, &inliers, nullptr, false, 4096);
+
+        // the correct model is found and its local optimization gets all its inliers
+        BOOST_CHECK_GE(inliers.size(), vec_inliersGT.size());
+        BOOST_CHECK_EQUAL(inliersRef.size(), inliers.size());
+        BOOST_CHECK_SMALL(modelRef.getMatrix()[0] - model.getMatrix()[0], 1e-2);
+        BOOST_CHECK_SMALL(GTModel[1] - model.getMatrix()[1], 1e-2);
+    }
+
+    // the adaptive test rejects the bad models once the correct one is known
+    SPRTScoreEvaluator<LineKernel> scorer(threshold);
+    scorer.updateFromBestModel(vec_inliersGT.size(), numPoints);
+    BOOST_CHECK(scorer.isTestEnabled());
+    BOOST_CHECK_CLOSE(scorer.getEpsilon(), vec_inliersGT.size() / double(numPoints), 1e-6);
+}
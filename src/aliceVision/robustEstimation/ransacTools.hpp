@@ -13,6 +13,12 @@
 namespace aliceVision {
 namespace robustEstimation {
 
+/**
+ * @brief Number of hypotheses drawn and evaluated together by the multi-threaded robust estimators.
+ * @note It does not depend on the number of threads to keep the results reproducible for a given seed.
+ */
+constexpr std::size_t parallelHypothesesBatchSize = 32;
+
 /**
  * @brief Number of samplings to have at least \a minProba probability of absence of
  *        outlier in a sample of \a sampleSize elements.
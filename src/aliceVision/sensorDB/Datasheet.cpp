@@ -16,33 +16,27 @@
 namespace aliceVision {
 namespace sensorDB {
 
-bool Datasheet::operator==(const Datasheet& other) const
+std::string Datasheet::getComparisonKey(const std::string& str)
 {
-    std::string brandA = _brand;
-    std::string brandB = other._brand;
+    std::string key = str;
+
+    boost::algorithm::to_lower(key);
 
-    boost::algorithm::to_lower(brandA);
-    boost::algorithm::to_lower(brandB);
+    key.erase(std::remove_if(key.begin(), key.end(), ::ispunct), key.end());  // remove punctuation
+    key.erase(std::remove_if(key.begin(), key.end(), ::isspace), key.end());  // remove spaces
 
-    brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::ispunct), brandA.end());  // remove punctuation
-    brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::ispunct), brandB.end());  // remove punctuation
+    return key;
+}
 
-    brandA.erase(std::remove_if(brandA.begin(), brandA.end(), ::isspace), brandA.end());  // remove spaces
-    brandB.erase(std::remove_if(brandB.begin(), brandB.end(), ::isspace), brandB.end());  // remove spaces
+bool Datasheet::operator==(const Datasheet& other) const
+{
+    const std::string& brandA = _brandKey;
+    const std::string& brandB = other._brandKey;
 
     if ((brandA == brandB) || (boost::algorithm::starts_with(brandA, brandB)) || (boost::algorithm::starts_with(brandB, brandA)))
     {
-        std::string modelA = _model;
-        std::string modelB = other._model;
-
-        boost::algorithm::to_lower(modelA);
-        boost::algorithm::to_lower(modelB);
-
-        modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::ispunct), modelA.end());  // remove punctuation
-        modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::ispunct), modelB.end());  // remove punctuation
-
-        modelA.erase(std::remove_if(modelA.begin(), modelA.end(), ::isspace), modelA.end());  // remove spaces
-        modelB.erase(std::remove_if(modelB.begin(), modelB.end(), ::isspace), modelB.end());  // remove spaces
+        const std::string& modelA = _modelKey;
+        const std::string& modelB = other._modelKey;
 
         if ((modelA == modelB) || (boost::algorithm::ends_with(modelA, modelB)) || (boost::algorithm::ends_with(modelB, modelA)))
             return true;
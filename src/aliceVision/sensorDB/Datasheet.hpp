@@ -28,14 +28,27 @@ struct Datasheet
     Datasheet(const std::string& brand, const std::string& model, const double& sensorWidth)
       : _brand(brand),
         _model(model),
-        _sensorWidth(sensorWidth)
+        _sensorWidth(sensorWidth),
+        _brandKey(getComparisonKey(brand)),
+        _modelKey(getComparisonKey(model))
     {}
 
     bool operator==(const Datasheet& other) const;
 
+    /**
+     * @brief Get the normalized string used to compare the brands and models
+     * @param[in] str The brand or model
+     * @return The string in lower case without punctuation and spaces
+     */
+    static std::string getComparisonKey(const std::string& str);
+
     std::string _brand;
     std::string _model;
     double _sensorWidth;
+
+    /// Normalized brand and model, computed once so the database lookups do not allocate
+    std::string _brandKey;
+    std::string _modelKey;
 };
 
 }  // namespace sensorDB
@@ -10,11 +10,14 @@
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/stl/mapUtils.hpp>
+#include <aliceVision/stl/parallelFor.hpp>
 #include <aliceVision/types.hpp>
 #include <aliceVision/geometry/HalfPlane.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -56,34 +59,184 @@ void FrustumFilter::initFrustum(const sfmData::SfMData& sfmData)
     }
 }
 
-PairSet FrustumFilter::getFrustumIntersectionPairs() const
+namespace {
+
+/// Axis aligned bounding box of the frustum of a view
+struct FrustumBox
+{
+    IndexT viewId;
+    Vec3 bbMin;
+    Vec3 bbMax;
+    /// split key of the hierarchy: unlike the box centre, the camera centre is always finite
+    Vec3 centre;
+};
+
+/// relative enlargement of the frustum bounding boxes
+constexpr double boxTolerance = 1e-5;
+
+inline bool overlap(const Vec3& aMin, const Vec3& aMax, const Vec3& bMin, const Vec3& bMax)
 {
-    PairSet pairs;
-    // List active view Id
-    std::vector<IndexT> viewIds;
-    viewIds.reserve(z_near_z_far_perView.size());
-    std::transform(z_near_z_far_perView.begin(), z_near_z_far_perView.end(), std::back_inserter(viewIds), stl::RetrieveKey());
-
-    auto progressDisplay =
-      system::createConsoleProgressDisplay(viewIds.size() * (viewIds.size() - 1) / 2, std::cout, "\nCompute frustum intersection\n");
-
-// Exhaustive comparison (use the fact that the intersect function is symmetric)
-#pragma omp parallel for
-    for (int i = 0; i < (int)viewIds.size(); ++i)
+    return (aMin.array() <= bMax.array()).all() && (bMin.array() <= aMax.array()).all();
+}
+
+/**
+ * @brief Bounding volume hierarchy over the frustum bounding boxes.
+ * @details The boxes are recursively split at the median camera centre along the axis of largest extent.
+ *          A query returns the frustums whose box overlaps the query box, the exact intersection test
+ *          is left to the caller.
+ */
+class FrustumBVH
+{
+  public:
+    explicit FrustumBVH(std::vector<FrustumBox>& boxes)
+      : _boxes(boxes)
+    {
+        if (!_boxes.empty())
+            build(0, _boxes.size());
+    }
+
+    /**
+     * @brief Call a function on each frustum box overlapping the query box
+     * @param[in] bbMin The minimum corner of the query box
+     * @param[in] bbMax The maximum corner of the query box
+     * @param[in] function The function called with each overlapping FrustumBox
+     */
+    template<typename Function>
+    void query(const Vec3& bbMin, const Vec3& bbMax, Function&& function) const
     {
-        for (size_t j = i + 1; j < viewIds.size(); ++j)
+        if (_nodes.empty())
+            return;
+
+        std::vector<std::size_t> stack(1, 0);
+        while (!stack.empty())
         {
-            if (frustum_perView.at(viewIds[i]).intersect(frustum_perView.at(viewIds[j])))
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+
+            if (!overlap(node.bbMin, node.bbMax, bbMin, bbMax))
+                continue;
+
+            if (node.isLeaf)
             {
-#pragma omp critical
+                for (std::size_t i = node.first; i < node.first + node.count; ++i)
                 {
-                    pairs.insert(std::make_pair(viewIds[i], viewIds[j]));
+                    if (overlap(_boxes[i].bbMin, _boxes[i].bbMax, bbMin, bbMax))
+                        function(_boxes[i]);
                 }
             }
-            ++progressDisplay;
+            else
+            {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
+
+  private:
+    struct Node
+    {
+        Vec3 bbMin;
+        Vec3 bbMax;
+        std::size_t first = 0;
+        std::size_t count = 0;
+        std::size_t left = 0;
+        std::size_t right = 0;
+        bool isLeaf = true;
+    };
+
+    static constexpr std::size_t maxLeafSize = 4;
+
+    /**
+     * @brief Build the node of a range of boxes and its children
+     * @param[in] first The index of the first box of the node
+     * @param[in] count The number of boxes of the node
+     * @return the index of the node
+     */
+    std::size_t build(std::size_t first, std::size_t count)
+    {
+        Node node;
+        node.first = first;
+        node.count = count;
+        node.bbMin = _boxes[first].bbMin;
+        node.bbMax = _boxes[first].bbMax;
+        Vec3 centreMin = _boxes[first].centre;
+        Vec3 centreMax = _boxes[first].centre;
+        for (std::size_t i = first + 1; i < first + count; ++i)
+        {
+            node.bbMin = node.bbMin.cwiseMin(_boxes[i].bbMin);
+            node.bbMax = node.bbMax.cwiseMax(_boxes[i].bbMax);
+            centreMin = centreMin.cwiseMin(_boxes[i].centre);
+            centreMax = centreMax.cwiseMax(_boxes[i].centre);
         }
+
+        const std::size_t nodeIndex = _nodes.size();
+        _nodes.push_back(node);
+
+        if (count <= maxLeafSize)
+            return nodeIndex;
+
+        int axis;
+        (centreMax - centreMin).maxCoeff(&axis);
+
+        const std::size_t half = count / 2;
+        std::nth_element(_boxes.begin() + first,
+                         _boxes.begin() + first + half,
+                         _boxes.begin() + first + count,
+                         [axis](const FrustumBox& a, const FrustumBox& b) { return a.centre(axis) < b.centre(axis); });
+
+        const std::size_t left = build(first, half);
+        const std::size_t right = build(first + half, count - half);
+
+        _nodes[nodeIndex].left = left;
+        _nodes[nodeIndex].right = right;
+        _nodes[nodeIndex].isLeaf = false;
+        return nodeIndex;
     }
-    return pairs;
+
+    std::vector<FrustumBox>& _boxes;
+    std::vector<Node> _nodes;
+};
+
+}  // namespace
+
+PairSet FrustumFilter::getFrustumIntersectionPairs() const
+{
+    // Bounding box of each valid view frustum
+    std::vector<FrustumBox> boxes;
+    boxes.reserve(frustum_perView.size());
+    for (const auto& frustumPair : frustum_perView)
+    {
+        FrustumBox box;
+        box.viewId = frustumPair.first;
+        box.centre = frustumPair.second.cones[0];
+        frustumPair.second.boundingBox(box.bbMin, box.bbMax);
+        // the linear program of the intersection test accepts frustums touching within its tolerance
+        // (e.g. cameras sharing the same centre), so the boxes are slightly enlarged
+        box.bbMin -= boxTolerance * (Vec3::Ones() + box.bbMin.cwiseAbs());
+        box.bbMax += boxTolerance * (Vec3::Ones() + box.bbMax.cwiseAbs());
+        boxes.push_back(box);
+    }
+
+    // The hierarchy reorders the boxes
+    const FrustumBVH bvh(boxes);
+
+    auto progressDisplay = system::createConsoleProgressDisplay(boxes.size(), std::cout, "\nCompute frustum intersection\n");
+
+    // Only the frustums with overlapping bounding boxes are tested (use the fact that the intersect function is symmetric).
+    // Each thread collects its pairs in its own buffer.
+    const std::vector<Pair> intersectingPairs = parallelForEachCollect<Pair>(
+      boxes,
+      [&](const FrustumBox& box, std::vector<Pair>& buffer) {
+          const Frustum& frustum = frustum_perView.at(box.viewId);
+          bvh.query(box.bbMin, box.bbMax, [&](const FrustumBox& otherBox) {
+              if (otherBox.viewId > box.viewId && frustum.intersect(frustum_perView.at(otherBox.viewId)))
+                  buffer.emplace_back(box.viewId, otherBox.viewId);
+          });
+          ++progressDisplay;
+      },
+      16);
+
+    return PairSet(intersectingPairs.begin(), intersectingPairs.end());
 }
 
 // Export defined frustum in PLY file for viewing
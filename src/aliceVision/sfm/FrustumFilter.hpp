@@ -30,6 +30,7 @@ class FrustumFilter
     void initFrustum(const sfmData::SfMData& sfmData);
 
     /// return intersecting View frustum pairs
+    /// (only the frustums with overlapping bounding boxes, found with a bounding volume hierarchy, are tested)
     PairSet getFrustumIntersectionPairs() const;
 
     /// export defined frustum in PLY file for viewing
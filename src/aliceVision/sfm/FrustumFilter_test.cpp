@@ -0,0 +1,145 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/FrustumFilter.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/geometry/Frustum.hpp>
+
+#include <random>
+
+#define BOOST_TEST_MODULE FrustumFilter
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::sfmData;
+
+namespace {
+
+const int imageWidth = 1000;
+const int imageHeight = 800;
+
+/**
+ * @brief Random rotation, optionally aligned with the axes so that some frustum rays have null components
+ */
+Mat3 randomRotation(std::mt19937& randomNumberGenerator, bool axisAligned)
+{
+    if (axisAligned)
+    {
+        // permutations of the axes with a valid determinant
+        static const Mat3 rotations[] = {Mat3::Identity(),
+                                         (Mat3() << 0, 1, 0, 0, 0, 1, 1, 0, 0).finished(),
+                                         (Mat3() << 0, 0, 1, 1, 0, 0, 0, 1, 0).finished(),
+                                         (Mat3() << -1, 0, 0, 0, 1, 0, 0, 0, -1).finished()};
+        std::uniform_int_distribution<int> index(0, 3);
+        return rotations[index(randomNumberGenerator)];
+    }
+
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const Eigen::Quaterniond q(normal(randomNumberGenerator), normal(randomNumberGenerator), normal(randomNumberGenerator), normal(randomNumberGenerator));
+    return q.normalized().toRotationMatrix();
+}
+
+/**
+ * @brief Create a scene of randomized cameras, including near-degenerate ones:
+ *        very narrow fields of view, cameras sharing the same centre and axis aligned cameras
+ * @param[in] nbViews the number of views
+ * @param[in] seed the seed of the random number generator
+ */
+SfMData createRandomScene(int nbViews, std::mt19937::result_type seed)
+{
+    std::mt19937 randomNumberGenerator(seed);
+    std::uniform_real_distribution<double> position(-10.0, 10.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    SfMData sfmData;
+
+    // wide, standard and very narrow fields of view
+    const double focals[] = {200.0, 1000.0, 1e5};
+    for (IndexT intrinsicId = 0; intrinsicId < 3; ++intrinsicId)
+    {
+        sfmData.getIntrinsics().emplace(
+          intrinsicId,
+          camera::createPinhole(camera::EINTRINSIC::PINHOLE_CAMERA, imageWidth, imageHeight, focals[intrinsicId], focals[intrinsicId], 0, 0));
+    }
+
+    Vec3 previousCentre = Vec3::Zero();
+    for (IndexT viewId = 0; viewId < nbViews; ++viewId)
+    {
+        const IndexT intrinsicId = static_cast<IndexT>(uniform(randomNumberGenerator) * 3.0) % 3;
+        sfmData.getViews().emplace(viewId, std::make_shared<View>("", viewId, intrinsicId, viewId, imageWidth, imageHeight));
+
+        // some cameras share the centre of the previous one
+        const Vec3 centre = (viewId > 0 && uniform(randomNumberGenerator) < 0.2)
+                              ? previousCentre
+                              : Vec3(position(randomNumberGenerator), position(randomNumberGenerator), position(randomNumberGenerator));
+        const Mat3 rotation = randomRotation(randomNumberGenerator, uniform(randomNumberGenerator) < 0.3);
+
+        sfmData.setPose(*sfmData.getViews().at(viewId), CameraPose(geometry::Pose3(rotation, centre)));
+        previousCentre = centre;
+    }
+
+    return sfmData;
+}
+
+/**
+ * @brief Exhaustive N² frustum intersection pairs
+ */
+PairSet getExhaustiveIntersectionPairs(const SfMData& sfmData, double zNear, double zFar)
+{
+    std::map<IndexT, geometry::Frustum> frustums;
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        const View& view = *viewPair.second;
+        const camera::Pinhole* cam = dynamic_cast<const camera::Pinhole*>(sfmData.getIntrinsics().at(view.getIntrinsicId()).get());
+        const geometry::Pose3 pose = sfmData.getPose(view).getTransform();
+        frustums.emplace(view.getViewId(), geometry::Frustum(cam->w(), cam->h(), cam->K(), pose.rotation(), pose.center(), zNear, zFar));
+    }
+
+    PairSet pairs;
+    for (auto it = frustums.begin(); it != frustums.end(); ++it)
+    {
+        for (auto otherIt = std::next(it); otherIt != frustums.end(); ++otherIt)
+        {
+            if (it->second.intersect(otherIt->second))
+                pairs.insert(Pair(it->first, otherIt->first));
+        }
+    }
+    return pairs;
+}
+
+}  // namespace
+
+// Test summary:
+// - Create scenes of randomized cameras with near-degenerate frustums
+// - Check that the pairs found with the bounding volume hierarchy are the exhaustive intersection pairs,
+//   for infinite frustums, truncated frustums and very thin truncated frustums
+BOOST_AUTO_TEST_CASE(FrustumFilter_bvhPairsEqualExhaustivePairs)
+{
+    // zNear, zFar
+    const std::pair<double, double> depthRanges[] = {{-1.0, -1.0}, {0.5, 8.0}, {2.0, 2.0 + 1e-6}};
+
+    for (std::mt19937::result_type seed = 0; seed < 5; ++seed)
+    {
+        const SfMData sfmData = createRandomScene(60, seed);
+
+        for (const auto& depthRange : depthRanges)
+        {
+            const sfm::FrustumFilter frustumFilter(sfmData, depthRange.first, depthRange.second);
+
+            const PairSet bvhPairs = frustumFilter.getFrustumIntersectionPairs();
+            const PairSet exhaustivePairs = getExhaustiveIntersectionPairs(sfmData, depthRange.first, depthRange.second);
+
+            BOOST_TEST_CONTEXT("seed: " << seed << ", zNear: " << depthRange.first << ", zFar: " << depthRange.second)
+            {
+                BOOST_CHECK(!exhaustivePairs.empty());
+                BOOST_CHECK_EQUAL(bvhPairs.size(), exhaustivePairs.size());
+                BOOST_CHECK(bvhPairs == exhaustivePairs);
+            }
+        }
+    }
+}
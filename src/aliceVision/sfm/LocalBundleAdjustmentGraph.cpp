@@ -10,6 +10,7 @@
 
 #include <lemon/bfs.h>
 
+#include <deque>
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
@@ -778,5 +779,58 @@ unsigned int LocalBundleAdjustmentGraph::countEdges() const
     return count;
 }
 
+std::vector<std::set<IndexT>> LocalBundleAdjustmentGraph::computePoseClusters(const sfmData::SfMData& sfmData,
+                                                                              std::size_t maxNbPosesPerCluster) const
+{
+    // edges added for shared intrinsics or rigs link views without any common observation
+    std::set<int> ignoredEdgesId;
+    for (const auto& edgesPerIntrinsic : _intrinsicEdgesId)
+        ignoredEdgesId.insert(edgesPerIntrinsic.second.begin(), edgesPerIntrinsic.second.end());
+    for (const auto& edgesPerRig : _rigEdgesId)
+        ignoredEdgesId.insert(edgesPerRig.second.begin(), edgesPerRig.second.end());
+
+    std::vector<std::set<IndexT>> clusters;
+    std::set<IndexT> clusteredPosesId;
+
+    for (const auto& seed : _nodePerViewId)
+    {
+        if (clusteredPosesId.count(sfmData.getView(seed.first).getPoseId()))
+            continue;
+
+        // grow a new cluster from the seed view, only through the views not clustered yet
+        clusters.emplace_back();
+        std::set<IndexT>& cluster = clusters.back();
+
+        std::deque<lemon::ListGraph::Node> queue = {seed.second};
+        std::set<IndexT> visitedViewsId = {seed.first};
+
+        while (!queue.empty() && cluster.size() < maxNbPosesPerCluster)
+        {
+            const lemon::ListGraph::Node node = queue.front();
+            queue.pop_front();
+
+            const IndexT poseId = sfmData.getView(_viewIdPerNode.at(node)).getPoseId();
+            if (clusteredPosesId.insert(poseId).second)
+                cluster.insert(poseId);
+
+            for (lemon::ListGraph::IncEdgeIt e(_graph, node); e != lemon::INVALID; ++e)
+            {
+                if (ignoredEdgesId.count(_graph.id(lemon::ListGraph::Edge(e))))
+                    continue;
+
+                const lemon::ListGraph::Node neighbor = _graph.oppositeNode(node, e);
+                const IndexT neighborViewId = _viewIdPerNode.at(neighbor);
+
+                if (clusteredPosesId.count(sfmData.getView(neighborViewId).getPoseId()) == 0 && visitedViewsId.insert(neighborViewId).second)
+                    queue.push_back(neighbor);
+            }
+        }
+    }
+
+    ALICEVISION_LOG_DEBUG("The graph has been split into " << clusters.size() << " clusters of at most " << maxNbPosesPerCluster << " poses.");
+
+    return clusters;
+}
+
 }  // namespace sfm
 }  // namespace aliceVision
@@ -200,6 +200,16 @@ class LocalBundleAdjustmentGraph
      */
     unsigned int countEdges() const;
 
+    /**
+     * @brief Split the poses of the graph into clusters of connected poses.
+     * @details Clusters are grown with a Breadth-first Search (BFS) on the matches edges,
+     *          intrinsic and rig edges are not used as they do not reflect any visibility.
+     * @param[in] sfmData contains all the information about the reconstruction
+     * @param[in] maxNbPosesPerCluster The maximum number of poses in a cluster
+     * @return the list of pose ids per cluster, each pose belongs to a single cluster
+     */
+    std::vector<std::set<IndexT>> computePoseClusters(const sfmData::SfMData& sfmData, std::size_t maxNbPosesPerCluster) const;
+
   private:
     /**
      * @brief Return the distance between a specific pose and the new posed views.
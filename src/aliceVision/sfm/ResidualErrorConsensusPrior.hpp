@@ -0,0 +1,68 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <ceres/ceres.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace aliceVision {
+namespace sfm {
+
+/**
+ * @brief Ceres cost function pulling a parameter block towards a target value.
+ *
+ *  Residuals: sqrt(weight) * (x - target)
+ *  It is the quadratic penalty of the consensus (ADMM) formulation used by the
+ *  partitioned bundle adjustment: each cluster keeps its own copy of the shared
+ *  parameters and is pulled towards the current consensus value.
+ *
+ *  Data parameter blocks are the following <N,N>
+ *  - N => dimension of the residuals,
+ *  - N => the parameter block (landmark, intrinsic, ...)
+ */
+class ConsensusPriorCostFunction : public ceres::CostFunction
+{
+  public:
+    ConsensusPriorCostFunction(const std::vector<double>& target, double weight)
+      : _target(target),
+        _sqrtWeight(std::sqrt(weight))
+    {
+        set_num_residuals(static_cast<int>(_target.size()));
+        mutable_parameter_block_sizes()->push_back(static_cast<int>(_target.size()));
+    }
+
+    bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
+    {
+        const std::size_t size = _target.size();
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            residuals[i] = _sqrtWeight * (parameters[0][i] - _target[i]);
+        }
+
+        if (jacobians != nullptr && jacobians[0] != nullptr)
+        {
+            std::fill(jacobians[0], jacobians[0] + size * size, 0.0);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                jacobians[0][i * size + i] = _sqrtWeight;
+            }
+        }
+
+        return true;
+    }
+
+  private:
+    std::vector<double> _target;
+    double _sqrtWeight;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -9,651 +9,122 @@
 
 #include <aliceVision/camera/camera.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/geometry/lie.hpp>
 
-#include <ceres/rotation.h>
+#include <ceres/ceres.h>
 
 #include <memory>
 
-// Define ceres Cost_functor for each AliceVision camera model
+// Define the ceres reprojection residual for each AliceVision camera model.
+//
+// Each camera model is described at compile time by a distortion model (number of parameters
+// and templated distortion function, written once) combined with a projection model.
+// ResidualErrorCostFunction is specialized for each description and computes the pose, rig,
+// landmark and projection jacobians analytically. Only the small distortion function is
+// differentiated automatically, on 2 + (number of distortion parameters) dimensions.
 
 namespace aliceVision {
 namespace sfm {
 
 /**
- * @brief Ceres functor to use a Pinhole (pinhole camera model K[R[t]) and a 3D point.
- *
- *  Data parameter blocks are the following <2,3,6,3>
- *  - 2 => dimension of the residuals,
- *  - 3 => the intrinsic data block [focal, principal point x, principal point y],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Distortion model without any parameter.
  */
-struct ResidualErrorFunctor_Pinhole
+struct DistortionModel_None
 {
-    explicit ResidualErrorFunctor_Pinhole(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3
-    };
-
-    template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
-    {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_u;
-        const T projected_y = principal_point_y + focalY * y_u;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
-
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
+    static constexpr int nbParams = 0;
 
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y] )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
     template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        // T absCam_R[3];
-        // T absCam_t[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u;
+        y_d = y_u;
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a PinholeRadialK1
- *
- *  Data parameter blocks are the following <2,4,6,3>
- *  - 2 => dimension of the residuals,
- *  - 4 => the intrinsic data block [focal, principal point x, principal point y, K1],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Radial distortion with one parameter [K1].
  */
-struct ResidualErrorFunctor_PinholeRadialK1
+struct DistortionModel_RadialK1
 {
-    explicit ResidualErrorFunctor_PinholeRadialK1(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_K1 = 4
-    };
+    static constexpr int nbParams = 1;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-        const T& k1 = cam_K[OFFSET_DISTO_K1];
+        const T& k1 = disto[0];
 
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
         const T r2 = x_u * x_u + y_u * y_u;
         const T r_coeff = (T(1) + k1 * r2);
-        const T x_d = x_u * r_coeff;
-        const T y_d = y_u * r_coeff;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
-
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], K1 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u * r_coeff;
+        y_d = y_u * r_coeff;
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a PinholeRadialK3
- *
- *  Data parameter blocks are the following <2,6,6,3>
- *  - 2 => dimension of the residuals,
- *  - 6 => the intrinsic data block [focal, principal point x, principal point y, K1, K2, K3],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Radial distortion with three parameters [K1, K2, K3].
  */
-struct ResidualErrorFunctor_PinholeRadialK3
+struct DistortionModel_RadialK3
 {
-    explicit ResidualErrorFunctor_PinholeRadialK3(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_K1 = 4,
-        OFFSET_DISTO_K2 = 5,
-        OFFSET_DISTO_K3 = 6,
-    };
+    static constexpr int nbParams = 3;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-        const T& k1 = cam_K[OFFSET_DISTO_K1];
-        const T& k2 = cam_K[OFFSET_DISTO_K2];
-        const T& k3 = cam_K[OFFSET_DISTO_K3];
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
+        const T& k1 = disto[0];
+        const T& k2 = disto[1];
+        const T& k3 = disto[2];
+
         const T r2 = x_u * x_u + y_u * y_u;
         const T r4 = r2 * r2;
         const T r6 = r4 * r2;
         const T r_coeff = (T(1) + k1 * r2 + k2 * r4 + k3 * r6);
-        const T x_d = x_u * r_coeff;
-        const T y_d = y_u * r_coeff;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        // Apply external parameters (RIG pose and RIG sub-pose)
-        T pos_proj[3];
-
-        // Apply RIG pose
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-            // Rotate the point according to the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);  // TODO DELI cam_Rt <-> subposeRt
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Apply RIG sub-pose
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-            // Rotate the point according to the camera rotation. In-place rotation not supported by Ceres
-            T pos_proj_tmp[3];
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj, pos_proj_tmp);
-
-            // Apply the camera translation
-            pos_proj[0] = pos_proj_tmp[0] + cam_t[0];
-            pos_proj[1] = pos_proj_tmp[1] + cam_t[1];
-            pos_proj[2] = pos_proj_tmp[2] + cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        // Apply intrinsic parameters
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u * r_coeff;
+        y_d = y_u * r_coeff;
     }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], k1, k2, k3 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor with constrained 3D points to use a PinholeBrownT2
- *
- *  Data parameter blocks are the following <2,8,6,3>
- *  - 2 => dimension of the residuals,
- *  - 8 => the intrinsic data block [focal, principal point x, principal point y, K1, K2, K3, T1, T2],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Brown distortion with three radial and two tangential parameters [K1, K2, K3, T1, T2].
  */
-struct ResidualErrorFunctor_PinholeBrownT2
+struct DistortionModel_BrownT2
 {
-    explicit ResidualErrorFunctor_PinholeBrownT2(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_K1 = 4,
-        OFFSET_DISTO_K2 = 5,
-        OFFSET_DISTO_K3 = 6,
-        OFFSET_DISTO_T1 = 7,
-        OFFSET_DISTO_T2 = 8,
-    };
+    static constexpr int nbParams = 5;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-        const T& k1 = cam_K[OFFSET_DISTO_K1];
-        const T& k2 = cam_K[OFFSET_DISTO_K2];
-        const T& k3 = cam_K[OFFSET_DISTO_K3];
-        const T& t1 = cam_K[OFFSET_DISTO_T1];
-        const T& t2 = cam_K[OFFSET_DISTO_T2];
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
+        const T& k1 = disto[0];
+        const T& k2 = disto[1];
+        const T& k3 = disto[2];
+        const T& t1 = disto[3];
+        const T& t2 = disto[4];
+
         const T r2 = x_u * x_u + y_u * y_u;
         const T r4 = r2 * r2;
         const T r6 = r4 * r2;
         const T r_coeff = (T(1) + k1 * r2 + k2 * r4 + k3 * r6);
         const T t_x = t2 * (r2 + T(2) * x_u * x_u) + T(2) * t1 * x_u * y_u;
         const T t_y = t1 * (r2 + T(2) * y_u * y_u) + T(2) * t2 * x_u * y_u;
-        const T x_d = x_u * r_coeff + t_x;
-        const T y_d = y_u * r_coeff + t_y;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
-
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u * r_coeff + t_x;
+        y_d = y_u * r_coeff + t_y;
     }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], k1, k2, k3, t1, t2 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor with constrained 3D points to use a PinholeFisheye
- *
- *  Data parameter blocks are the following <2,8,6,3>
- *  - 2 => dimension of the residuals,
- *  - 7 => the intrinsic data block [focal, principal point x, principal point y, K1, K2, K3, K4],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Fisheye distortion with four parameters [K1, K2, K3, K4].
  */
-struct ResidualErrorFunctor_PinholeFisheye
+struct DistortionModel_Fisheye
 {
-    explicit ResidualErrorFunctor_PinholeFisheye(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_K1 = 4,
-        OFFSET_DISTO_K2 = 5,
-        OFFSET_DISTO_K3 = 6,
-        OFFSET_DISTO_K4 = 7,
-    };
+    static constexpr int nbParams = 4;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-        const T& k1 = cam_K[OFFSET_DISTO_K1];
-        const T& k2 = cam_K[OFFSET_DISTO_K2];
-        const T& k3 = cam_K[OFFSET_DISTO_K3];
-        const T& k4 = cam_K[OFFSET_DISTO_K4];
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
+        const T& k1 = disto[0];
+        const T& k2 = disto[1];
+        const T& k3 = disto[2];
+        const T& k4 = disto[3];
+
         const T r2 = x_u * x_u + y_u * y_u;
         const T r = sqrt(r2);
         const T theta = atan(r);
@@ -663,305 +134,46 @@ struct ResidualErrorFunctor_PinholeFisheye
         const T inv_r = r > T(1e-8) ? T(1.0) / r : T(1.0);
         const T cdist = r > T(1e-8) ? theta_dist * inv_r : T(1);
 
-        const T x_d = x_u * cdist;
-        const T y_d = y_u * cdist;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
-
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], k1, k2, k3, k4 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u * cdist;
+        y_d = y_u * cdist;
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a ResidualErrorFunctor_PinholeFisheye1
- *
- *  Data parameter blocks are the following <2,4,6,3>
- *  - 2 => dimension of the residuals,
- *  - 4 => the intrinsic data block [focal, principal point x, principal point y, K1],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief Fisheye distortion with one parameter [K1].
  */
-struct ResidualErrorFunctor_PinholeFisheye1
+struct DistortionModel_Fisheye1
 {
-    explicit ResidualErrorFunctor_PinholeFisheye1(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_K1 = 4
-    };
+    static constexpr int nbParams = 1;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-        const T& k1 = cam_K[OFFSET_DISTO_K1];
+        const T& k1 = disto[0];
 
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
         const T r2 = x_u * x_u + y_u * y_u;
         const T r = sqrt(r2);
         const T r_coeff = (atan(2.0 * r * tan(0.5 * k1)) / k1) / r;
-        const T x_d = x_u * r_coeff;
-        const T y_d = y_u * r_coeff;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
-
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], K1 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
+        x_d = x_u * r_coeff;
+        y_d = y_u * r_coeff;
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a Pinhole3DEClassicLD
- *
- *  Data parameter blocks are the following <2,9,6,3>
- *  - 2 => dimension of the residuals,
- *  - 6 => the intrinsic data block [focal_x, focal_y, principal point x, principal point y, K1, K2, K3],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief 3DEqualizer classic LD distortion [delta, invepsilon, mux, muy, q].
  */
-struct ResidualErrorFunctor_Pinhole3DEClassicLD
+struct DistortionModel_3DEClassicLD
 {
-    explicit ResidualErrorFunctor_Pinhole3DEClassicLD(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_DELTA = 4,
-        OFFSET_DISTO_IEPS = 5,
-        OFFSET_DISTO_MUX = 6,
-        OFFSET_DISTO_MUY = 7,
-        OFFSET_DISTO_Q = 8,
-    };
+    static constexpr int nbParams = 5;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
     {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
-        const T& delta = cam_K[OFFSET_DISTO_DELTA];
-        const T& invepsilon = cam_K[OFFSET_DISTO_IEPS];
-        const T& mux = cam_K[OFFSET_DISTO_MUX];
-        const T& muy = cam_K[OFFSET_DISTO_MUY];
-        const T& q = cam_K[OFFSET_DISTO_Q];
+        const T& delta = disto[0];
+        const T& invepsilon = disto[1];
+        const T& mux = disto[2];
+        const T& muy = disto[3];
+        const T& q = disto[4];
 
         const T eps = 1.0 + cos(invepsilon);
 
@@ -976,341 +188,76 @@ struct ResidualErrorFunctor_Pinhole3DEClassicLD
         const T cyxy = 2.0 * q;
         const T cyyy = q;
 
-        T x = x_u;
-        T y = y_u;
-        T xx = x * x;
-        T yy = y * y;
-        T xxxx = xx * xx;
-        T yyyy = yy * yy;
-        T xxyy = xx * yy;
-
-        T x_d = x * (1.0 + cxx * xx + cxy * yy + cxxx * xxxx + cxxy * xxyy + cxyy * yyyy);
-        T y_d = y * (1.0 + cyx * xx + cyy * yy + cyxx * xxxx + cyxy * xxyy + cyyy * yyyy);
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
-
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        // Apply external parameters (RIG pose and RIG sub-pose)
-        T pos_proj[3];
-
-        // Apply RIG pose
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-            // Rotate the point according to the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);  // TODO DELI cam_Rt <-> subposeRt
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Apply RIG sub-pose
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-            // Rotate the point according to the camera rotation. In-place rotation not supported by Ceres
-            T pos_proj_tmp[3];
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj, pos_proj_tmp);
-
-            // Apply the camera translation
-            pos_proj[0] = pos_proj_tmp[0] + cam_t[0];
-            pos_proj[1] = pos_proj_tmp[1] + cam_t[1];
-            pos_proj[2] = pos_proj_tmp[2] + cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        // Apply intrinsic parameters
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], k1, k2, k3 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
+        const T xx = x_u * x_u;
+        const T yy = y_u * y_u;
+        const T xxxx = xx * xx;
+        const T yyyy = yy * yy;
+        const T xxyy = xx * yy;
 
-        return true;
+        x_d = x_u * (1.0 + cxx * xx + cxy * yy + cxxx * xxxx + cxxy * xxyy + cxyy * yyyy);
+        y_d = y_u * (1.0 + cyx * xx + cyy * yy + cyxx * xxxx + cyxy * xxyy + cyyy * yyyy);
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a ResidualErrorFunctor_Pinhole3DERadial4
- *
- *  Data parameter blocks are the following <2,10,6,3>
- *  - 2 => dimension of the residuals,
- *  - 6 => the intrinsic data block [focal_x, focal_y, principal point x, principal point y, K1, K2, K3],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief 3DEqualizer radial 4 distortion [c2, c4, u1, v1, u3, v3].
  */
-struct ResidualErrorFunctor_Pinhole3DERadial4
+struct DistortionModel_3DERadial4
 {
-    explicit ResidualErrorFunctor_Pinhole3DERadial4(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_C2 = 4,
-        OFFSET_DISTO_C4 = 5,
-        OFFSET_DISTO_U1 = 6,
-        OFFSET_DISTO_V1 = 7,
-        OFFSET_DISTO_U3 = 8,
-        OFFSET_DISTO_V3 = 9,
-    };
-
-    template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
-    {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
-        const T& c2 = cam_K[OFFSET_DISTO_C2];
-        const T& c4 = cam_K[OFFSET_DISTO_C4];
-        const T& u1 = cam_K[OFFSET_DISTO_U1];
-        const T& v1 = cam_K[OFFSET_DISTO_V1];
-        const T& u3 = cam_K[OFFSET_DISTO_U3];
-        const T& v3 = cam_K[OFFSET_DISTO_V3];
-
-        T x = x_u;
-        T y = y_u;
-        T xx = x * x;
-        T yy = y * y;
-        T xy = x * y;
-        T r2 = xx + yy;
-        T r4 = r2 * r2;
-
-        T p1 = 1.0 + c2 * r2 + c4 * r4;
-        T p2 = r2 + 2.0 * xx;
-        T p3 = r2 + 2.0 * yy;
-        T p4 = u1 + u3 * r2;
-        T p5 = v1 + v3 * r2;
-        T p6 = 2.0 * xy;
-
-        T x_d = x * p1 + p2 * p4 + p6 * p5;
-        T y_d = y * p1 + p3 * p5 + p6 * p4;
-
-        // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * x_d;
-        const T projected_y = principal_point_y + focalY * y_d;
-
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
-    }
+    static constexpr int nbParams = 6;
 
     template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        // Apply external parameters (RIG pose and RIG sub-pose)
-        T pos_proj[3];
-
-        // Apply RIG pose
-        {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
-            // Rotate the point according to the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);  // TODO DELI cam_Rt <-> subposeRt
-
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
-        }
-
-        // Apply RIG sub-pose
-        {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
-            // Rotate the point according to the camera rotation. In-place rotation not supported by Ceres
-            T pos_proj_tmp[3];
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj, pos_proj_tmp);
-
-            // Apply the camera translation
-            pos_proj[0] = pos_proj_tmp[0] + cam_t[0];
-            pos_proj[1] = pos_proj_tmp[1] + cam_t[1];
-            pos_proj[2] = pos_proj_tmp[2] + cam_t[2];
-        }
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        // Apply intrinsic parameters
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
-
-        return true;
-    }
-
-    /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y], k1, k2, k3 )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
-     */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
-    {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
-
-        //--
-        // Apply intrinsic parameters
-        //--
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
+    {
+        const T& c2 = disto[0];
+        const T& c4 = disto[1];
+        const T& u1 = disto[2];
+        const T& v1 = disto[3];
+        const T& u3 = disto[4];
+        const T& v3 = disto[5];
+
+        const T xx = x_u * x_u;
+        const T yy = y_u * y_u;
+        const T xy = x_u * y_u;
+        const T r2 = xx + yy;
+        const T r4 = r2 * r2;
 
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
+        const T p1 = 1.0 + c2 * r2 + c4 * r4;
+        const T p2 = r2 + 2.0 * xx;
+        const T p3 = r2 + 2.0 * yy;
+        const T p4 = u1 + u3 * r2;
+        const T p5 = v1 + v3 * r2;
+        const T p6 = 2.0 * xy;
 
-        return true;
+        x_d = x_u * p1 + p2 * p4 + p6 * p5;
+        y_d = y_u * p1 + p3 * p5 + p6 * p4;
     }
-
-    const sfmData::Observation _obs;  // The 2D observation
-    const Vec2 _center;
 };
 
 /**
- * @brief Ceres functor to use a ResidualErrorFunctor_Pinhole3DEAnamorphic4
- *
- *  Data parameter blocks are the following <2,18,6,3>
- *  - 2 => dimension of the residuals,
- *  - 18 => the intrinsic data block [focal, principal point, distortion parameters],
- *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
- *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz].
- *  - 3 => a 3D point data block.
- *
+ * @brief 3DEqualizer anamorphic 4 distortion
+ *        [cx02, cy02, cx22, cy22, cx04, cy04, cx24, cy24, cx44, cy44, phi, sqx, sqy, ps].
  */
-struct ResidualErrorFunctor_Pinhole3DEAnamorphic4
+struct DistortionModel_3DEAnamorphic4
 {
-    explicit ResidualErrorFunctor_Pinhole3DEAnamorphic4(int w, int h, const sfmData::Observation& obs)
-      : _center(double(w) * 0.5, double(h) * 0.5),
-        _obs(obs)
-    {}
-
-    // Enum to map intrinsics parameters between aliceVision & ceres camera data parameter block.
-    enum
-    {
-        OFFSET_FOCAL_LENGTH_X = 0,
-        OFFSET_FOCAL_LENGTH_Y = 1,
-        OFFSET_PRINCIPAL_POINT_X = 2,
-        OFFSET_PRINCIPAL_POINT_Y = 3,
-        OFFSET_DISTO_CX02 = 4,
-        OFFSET_DISTO_CY02 = 5,
-        OFFSET_DISTO_CX22 = 6,
-        OFFSET_DISTO_CY22 = 7,
-        OFFSET_DISTO_CX04 = 8,
-        OFFSET_DISTO_CY04 = 9,
-        OFFSET_DISTO_CX24 = 10,
-        OFFSET_DISTO_CY24 = 11,
-        OFFSET_DISTO_CX44 = 12,
-        OFFSET_DISTO_CY44 = 13,
-        OFFSET_DISTO_PHI = 14,
-        OFFSET_DISTO_SQX = 15,
-        OFFSET_DISTO_SQY = 16,
-        OFFSET_DISTO_PS = 17
-    };
+    static constexpr int nbParams = 14;
 
     template<typename T>
-    void applyIntrinsicParameters(const T* const cam_K, const T x_u, const T y_u, T* out_residuals) const
-    {
-        const T& focalX = cam_K[OFFSET_FOCAL_LENGTH_X];
-        const T& focalY = cam_K[OFFSET_FOCAL_LENGTH_Y];
-        const T& principal_point_x = cam_K[OFFSET_PRINCIPAL_POINT_X] + _center(0);
-        const T& principal_point_y = cam_K[OFFSET_PRINCIPAL_POINT_Y] + _center(1);
-
-        // Apply distortion (xd,yd) = disto(x_u,y_u)
-        const T& cx02 = cam_K[OFFSET_DISTO_CX02];
-        const T& cy02 = cam_K[OFFSET_DISTO_CY02];
-        const T& cx22 = cam_K[OFFSET_DISTO_CX22];
-        const T& cy22 = cam_K[OFFSET_DISTO_CY22];
-        const T& cx04 = cam_K[OFFSET_DISTO_CX04];
-        const T& cy04 = cam_K[OFFSET_DISTO_CY04];
-        const T& cx24 = cam_K[OFFSET_DISTO_CX24];
-        const T& cy24 = cam_K[OFFSET_DISTO_CY24];
-        const T& cx44 = cam_K[OFFSET_DISTO_CX44];
-        const T& cy44 = cam_K[OFFSET_DISTO_CY44];
-        const T& phi = cam_K[OFFSET_DISTO_PHI];
-        const T& sqx = cam_K[OFFSET_DISTO_SQX];
-        const T& sqy = cam_K[OFFSET_DISTO_SQY];
+    static void addDistortion(const T* const disto, const T& x_u, const T& y_u, T& x_d, T& y_d)
+    {
+        const T& cx02 = disto[0];
+        const T& cy02 = disto[1];
+        const T& cx22 = disto[2];
+        const T& cy22 = disto[3];
+        const T& cx04 = disto[4];
+        const T& cy04 = disto[5];
+        const T& cx24 = disto[6];
+        const T& cy24 = disto[7];
+        const T& cx44 = disto[8];
+        const T& cy44 = disto[9];
+        const T& phi = disto[10];
+        const T& sqx = disto[11];
+        const T& sqy = disto[12];
 
         const T cphi = cos(phi);
         const T sphi = sin(phi);
@@ -1327,11 +274,9 @@ struct ResidualErrorFunctor_Pinhole3DEAnamorphic4
         const T cy_xxxx = cy04 + cy24 + cy44;
         const T cy_yyyy = cy04 - cy24 + cy44;
 
-        const T x = x_u;
-        const T y = y_u;
-
-        const T xr = cphi * x + sphi * y;
-        const T yr = -sphi * x + cphi * y;
+        // First rotate axis
+        const T xr = cphi * x_u + sphi * y_u;
+        const T yr = -sphi * x_u + cphi * y_u;
 
         const T xx = xr * xr;
         const T yy = yr * yr;
@@ -1342,113 +287,250 @@ struct ResidualErrorFunctor_Pinhole3DEAnamorphic4
         const T xd = xr * (1.0 + xx * cx_xx + yy * cx_yy + xxxx * cx_xxxx + xxyy * cx_xxyy + yyyy * cx_yyyy);
         const T yd = yr * (1.0 + xx * cy_xx + yy * cy_yy + xxxx * cy_xxxx + xxyy * cy_xxyy + yyyy * cy_yyyy);
 
+        // Squeeze axis
         const T squizzed_x = xd * sqx;
         const T squizzed_y = yd * sqy;
 
-        const T np_x = cphi * squizzed_x - sphi * squizzed_y;
-        const T np_y = sphi * squizzed_x + cphi * squizzed_y;
+        // Unrotate axis
+        x_d = cphi * squizzed_x - sphi * squizzed_y;
+        y_d = sphi * squizzed_x + cphi * squizzed_y;
+    }
+};
+
+/**
+ * @brief Pinhole projection model followed by the given distortion model.
+ *
+ *  The intrinsic data block follows the camera::IntrinsicBase::getParams() layout:
+ *  [focal x, focal y, principal point offset x, principal point offset y, distortion parameters...]
+ */
+template<typename DistortionModel>
+struct PinholeModel
+{
+    static constexpr int nbParams = 4 + DistortionModel::nbParams;
+
+    /**
+     * @brief Project a point expressed in the camera frame.
+     * @param[in] params the intrinsic data block
+     * @param[in] center the image center, added to the principal point offset
+     * @param[in] X the point in the camera frame
+     * @param[out] pt the projected point in pixels
+     * @param[out] d_pt_d_X if not null, the jacobian of the projection wrt X
+     * @param[out] d_pt_d_params if not null, the row-major 2 x nbParams jacobian of the projection wrt params
+     */
+    static void project(const double* params,
+                        const Vec2& center,
+                        const Vec3& X,
+                        Vec2& pt,
+                        Eigen::Matrix<double, 2, 3>* d_pt_d_X,
+                        double* d_pt_d_params)
+    {
+        const double& focalX = params[0];
+        const double& focalY = params[1];
+        const double* disto = params + 4;
+
+        // Transform the point from homogeneous to euclidean (undistorted point)
+        const double invZ = 1.0 / X(2);
+        const double x_u = X(0) * invZ;
+        const double y_u = X(1) * invZ;
+
+        // Apply distortion (x_d, y_d) = disto(x_u, y_u)
+        double x_d;
+        double y_d;
+        Eigen::Matrix2d d_d_d_u = Eigen::Matrix2d::Identity();
+        Eigen::Matrix<double, 2, DistortionModel::nbParams> d_d_d_disto;
+
+        if constexpr (DistortionModel::nbParams == 0)
+        {
+            x_d = x_u;
+            y_d = y_u;
+        }
+        else if (d_pt_d_X == nullptr && d_pt_d_params == nullptr)
+        {
+            DistortionModel::addDistortion(disto, x_u, y_u, x_d, y_d);
+        }
+        else
+        {
+            // Only the distortion is differentiated automatically, wrt (x_u, y_u, disto)
+            using Jet = ceres::Jet<double, 2 + DistortionModel::nbParams>;
+
+            Jet jetDisto[DistortionModel::nbParams];
+            for (int i = 0; i < DistortionModel::nbParams; ++i)
+            {
+                jetDisto[i] = Jet(disto[i], 2 + i);
+            }
+
+            Jet jet_x_d;
+            Jet jet_y_d;
+            DistortionModel::addDistortion(jetDisto, Jet(x_u, 0), Jet(y_u, 1), jet_x_d, jet_y_d);
+
+            x_d = jet_x_d.a;
+            y_d = jet_y_d.a;
+
+            d_d_d_u.row(0) = jet_x_d.v.template head<2>();
+            d_d_d_u.row(1) = jet_y_d.v.template head<2>();
+            d_d_d_disto.row(0) = jet_x_d.v.template tail<DistortionModel::nbParams>();
+            d_d_d_disto.row(1) = jet_y_d.v.template tail<DistortionModel::nbParams>();
+        }
 
         // Apply focal length and principal point to get the final image coordinates
-        const T projected_x = principal_point_x + focalX * np_x;
-        const T projected_y = principal_point_y + focalY * np_y;
+        pt(0) = params[2] + center(0) + focalX * x_d;
+        pt(1) = params[3] + center(1) + focalY * y_d;
 
-        // Compute and return the error is the difference between the predicted
-        //  and observed position
-        const T scale(_obs.getScale() > 0.0 ? _obs.getScale() : 1.0);
-        out_residuals[0] = (projected_x - T(_obs.getX())) / scale;
-        out_residuals[1] = (projected_y - T(_obs.getY())) / scale;
+        if (d_pt_d_X != nullptr)
+        {
+            Eigen::Matrix<double, 2, 3> d_u_d_X;
+            d_u_d_X << invZ, 0.0, -x_u * invZ, 0.0, invZ, -y_u * invZ;
+
+            *d_pt_d_X = Eigen::Vector2d(focalX, focalY).asDiagonal() * d_d_d_u * d_u_d_X;
+        }
+
+        if (d_pt_d_params != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, nbParams, Eigen::RowMajor>> J(d_pt_d_params);
+
+            J.template leftCols<4>() << x_d, 0.0, 1.0, 0.0, 0.0, y_d, 0.0, 1.0;
+
+            if constexpr (DistortionModel::nbParams > 0)
+            {
+                J.row(0).template tail<DistortionModel::nbParams>() = focalX * d_d_d_disto.row(0);
+                J.row(1).template tail<DistortionModel::nbParams>() = focalY * d_d_d_disto.row(1);
+            }
+        }
     }
+};
 
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const subpose_Rt, const T* const pos_3dpoint, T* out_residuals) const
+/**
+ * @brief Ceres cost function of the reprojection error of a 3D point for a given camera model.
+ *
+ *  Data parameter blocks are the following <2, CameraModel::nbParams, 6, [6,] 3>
+ *  - 2 => dimension of the residuals,
+ *  - CameraModel::nbParams => the intrinsic data block,
+ *  - 6 => the camera extrinsic data block (camera orientation and position) [R;t],
+ *         - rotation(angle axis), and translation [rX,rY,rZ,tx,ty,tz],
+ *  - 6 => (rig only) the rig sub-pose data block [R;t] applied after the camera extrinsic,
+ *  - 3 => a 3D point data block.
+ */
+template<typename CameraModel>
+class ResidualErrorCostFunction : public ceres::CostFunction
+{
+  public:
+    ResidualErrorCostFunction(int w, int h, const sfmData::Observation& obs, bool withRig)
+      : _obs(obs),
+        _center(double(w) * 0.5, double(h) * 0.5),
+        _withRig(withRig)
     {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        T pos_proj[3];
+        set_num_residuals(2);
 
+        mutable_parameter_block_sizes()->push_back(CameraModel::nbParams);
+        mutable_parameter_block_sizes()->push_back(6);
+        if (_withRig)
         {
-            const T* cam_R = cam_Rt;
-            const T* cam_t = &cam_Rt[3];
+            mutable_parameter_block_sizes()->push_back(6);
+        }
+        mutable_parameter_block_sizes()->push_back(3);
+    }
 
-            // Rotate the point according the camera rotation
-            ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
+    bool Evaluate(double const* const* parameters, double* residuals, double** jacobians) const override
+    {
+        const double* cam_K = parameters[0];
+        const double* cam_Rt = parameters[1];
+        const double* subpose_Rt = _withRig ? parameters[2] : nullptr;
+        const Eigen::Map<const Vec3> pos_3dpoint(parameters[_withRig ? 3 : 2]);
+
+        // Apply external parameters (pose, then rig sub-pose)
+        const Eigen::Map<const Vec3> cam_R(cam_Rt);
+        const Eigen::Map<const Vec3> cam_t(cam_Rt + 3);
+        const Eigen::Matrix3d R = SO3::expm(cam_R);
+        const Vec3 X_pose = R * pos_3dpoint + cam_t;
 
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
+        Eigen::Matrix3d R_subpose = Eigen::Matrix3d::Identity();
+        Vec3 X = X_pose;
+        if (_withRig)
+        {
+            const Eigen::Map<const Vec3> subpose_R(subpose_Rt);
+            const Eigen::Map<const Vec3> subpose_t(subpose_Rt + 3);
+            R_subpose = SO3::expm(subpose_R);
+            X = R_subpose * X_pose + subpose_t;
         }
 
+        // Apply intrinsic parameters
+        const bool needJacobians = (jacobians != nullptr);
+        Vec2 projected;
+        Eigen::Matrix<double, 2, 3> d_pt_d_X;
+        CameraModel::project(cam_K, _center, X, projected, needJacobians ? &d_pt_d_X : nullptr, needJacobians ? jacobians[0] : nullptr);
+
+        // Compute and return the error is the difference between the predicted
+        //  and observed position
+        const double scale = (_obs.getScale() > 0.0) ? _obs.getScale() : 1.0;
+        residuals[0] = (projected(0) - _obs.getX()) / scale;
+        residuals[1] = (projected(1) - _obs.getY()) / scale;
+
+        if (!needJacobians)
         {
-            const T* cam_R = subpose_Rt;
-            const T* cam_t = &subpose_Rt[3];
+            return true;
+        }
 
-            // Rotate the point according to the camera rotation
-            T pos_proj_tmp[3] = {pos_proj[0], pos_proj[1], pos_proj[2]};
-            ceres::AngleAxisRotatePoint(cam_R, pos_proj_tmp, pos_proj);
+        const Eigen::Matrix<double, 2, 3> d_res_d_X = d_pt_d_X / scale;
 
-            // Apply the camera translation
-            pos_proj[0] += cam_t[0];
-            pos_proj[1] += cam_t[1];
-            pos_proj[2] += cam_t[2];
+        if (jacobians[0] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, CameraModel::nbParams, Eigen::RowMajor>> J(jacobians[0]);
+            J /= scale;
         }
 
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
+        if (jacobians[1] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[1]);
+            const Eigen::Matrix<double, 2, 3> d_res_d_X_pose = d_res_d_X * R_subpose;
+            J.leftCols<3>() = d_res_d_X_pose * getJacobianRotatePointWrtAngleAxis(cam_R, R, pos_3dpoint);
+            J.rightCols<3>() = d_res_d_X_pose;
+        }
 
-        //--
-        // Apply intrinsic parameters
-        //--
+        if (_withRig && jacobians[2] != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 6, Eigen::RowMajor>> J(jacobians[2]);
+            const Eigen::Map<const Vec3> subpose_R(subpose_Rt);
+            J.leftCols<3>() = d_res_d_X * getJacobianRotatePointWrtAngleAxis(subpose_R, R_subpose, X_pose);
+            J.rightCols<3>() = d_res_d_X;
+        }
 
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
+        double* jacobianPoint = jacobians[_withRig ? 3 : 2];
+        if (jacobianPoint != nullptr)
+        {
+            Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobianPoint);
+            J = d_res_d_X * R_subpose * R;
+        }
 
         return true;
     }
 
+  private:
     /**
-     * @param[in] cam_K: Camera intrinsics( focal, principal point [x,y] )
-     * @param[in] cam_Rt: Camera parameterized using one block of 6 parameters [R;t]:
-     *   - 3 for rotation(angle axis), 3 for translation
-     * @param[in] pos_3dpoint
-     * @param[out] out_residuals
+     * @brief Jacobian of R(aa) * pt wrt the angle axis aa, with R(aa) the rotation matrix of aa.
+     *        d(R * pt) / d(aa) = -R * [pt]x * Jr(aa), with Jr the right jacobian of SO(3).
      */
-    template<typename T>
-    bool operator()(const T* const cam_K, const T* const cam_Rt, const T* const pos_3dpoint, T* out_residuals) const
+    static Eigen::Matrix3d getJacobianRotatePointWrtAngleAxis(const Vec3& aa, const Eigen::Matrix3d& R, const Vec3& pt)
     {
-        //--
-        // Apply external parameters (Pose)
-        //--
-
-        const T* cam_R = cam_Rt;
-        const T* cam_t = &cam_Rt[3];
-
-        T pos_proj[3];
-        // Rotate the point according the camera rotation
-        ceres::AngleAxisRotatePoint(cam_R, pos_3dpoint, pos_proj);
-
-        // Apply the camera translation
-        pos_proj[0] += cam_t[0];
-        pos_proj[1] += cam_t[1];
-        pos_proj[2] += cam_t[2];
-
-        // Transform the point from homogeneous to euclidean (undistorted point)
-        const T x_u = pos_proj[0] / pos_proj[2];
-        const T y_u = pos_proj[1] / pos_proj[2];
+        const double angle = aa.norm();
+        const Eigen::Matrix3d omega = SO3::skew(aa);
 
-        //--
-        // Apply intrinsic parameters
-        //--
-
-        applyIntrinsicParameters(cam_K, x_u, y_u, out_residuals);
+        Eigen::Matrix3d Jr = Eigen::Matrix3d::Identity();
+        if (angle < 1e-8)
+        {
+            Jr -= 0.5 * omega;
+        }
+        else
+        {
+            const double angle2 = angle * angle;
+            Jr += -((1.0 - cos(angle)) / angle2) * omega + ((angle - sin(angle)) / (angle2 * angle)) * omega * omega;
+        }
 
-        return true;
+        return -R * SO3::skew(pt) * Jr;
     }
 
     const sfmData::Observation _obs;  // The 2D observation
     const Vec2 _center;
+    const bool _withRig;
 };
 
 }  // namespace sfm
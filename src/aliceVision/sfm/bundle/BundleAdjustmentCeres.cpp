@@ -9,6 +9,7 @@
 #include <aliceVision/sfm/ResidualErrorFunctor.hpp>
 #include <aliceVision/sfm/ResidualErrorConstraintFunctor.hpp>
 #include <aliceVision/sfm/ResidualErrorRotationPriorFunctor.hpp>
+#include <aliceVision/sfm/ResidualErrorConsensusPrior.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 #include <aliceVision/config.hpp>
@@ -187,15 +188,22 @@ class IntrinsicsManifold : public ceres::Manifold
  * @brief Create the appropriate cost functor according the provided input camera intrinsic model
  * @param[in] intrinsicPtr The intrinsic pointer
  * @param[in] observation The corresponding observation
+ * @param[in] withRig True if the observation is made by a camera of a rig (extra sub-pose parameter block)
  * @return cost functor
  */
-ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const sfmData::Observation& observation)
+ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const sfmData::Observation& observation, bool withRig)
 {
     int w = intrinsicPtr->w();
     int h = intrinsicPtr->h();
 
+    if (!camera::isPinhole(intrinsicPtr->getType()))
+    {
+        throw std::logic_error("Cannot create cost function, unrecognized intrinsic type in BA.");
+    }
+
     // Apply undistortion to observation
     sfmData::Observation obsUndistorted = observation;
+    EDISTORTION distortionType = EDISTORTION::NONE;
     const camera::IntrinsicScaleOffsetDisto* intrinsicDistortionPtr = dynamic_cast<const camera::IntrinsicScaleOffsetDisto*>(intrinsicPtr);
     if (intrinsicDistortionPtr)
     {
@@ -209,94 +217,37 @@ ceres::CostFunction* createCostFunctionFromIntrinsics(const IntrinsicBase* intri
                 throw std::runtime_error("Distortion should not be there when undistortion exists");
             }
         }
-    }
-
-    switch (intrinsicPtr->getType())
-    {
-        case EINTRINSIC::PINHOLE_CAMERA:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 3>(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_RADIAL1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 5, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_RADIAL3:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DERadial4, 2, 10, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DEClassicLD, 2, 9, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 3>(new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_BROWN:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeBrownT2, 2, 9, 6, 3>(
-              new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye, 2, 8, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye1, 2, 5, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
-        default:
-            throw std::logic_error("Cannot create cost function, unrecognized intrinsic type in BA.");
-    }
-}
 
-/**
- * @brief Create the appropriate cost functor according the provided input rig camera intrinsic model
- * @param[in] intrinsicPtr The intrinsic pointer
- * @param[in] observation The corresponding observation
- * @return cost functor
- */
-ceres::CostFunction* createRigCostFunctionFromIntrinsics(const IntrinsicBase* intrinsicPtr, const sfmData::Observation& observation)
-{
-    int w = intrinsicPtr->w();
-    int h = intrinsicPtr->h();
-
-    // Apply undistortion to observation
-    sfmData::Observation obsUndistorted = observation;
-    const camera::IntrinsicScaleOffsetDisto* intrinsicDistortionPtr = dynamic_cast<const camera::IntrinsicScaleOffsetDisto*>(intrinsicPtr);
-    if (intrinsicDistortionPtr)
-    {
-        auto undistortion = intrinsicDistortionPtr->getUndistortion();
-        if (undistortion)
+        if (intrinsicDistortionPtr->getDistortion())
         {
-            obsUndistorted.setCoordinates(undistortion->undistort(observation.getCoordinates()));
+            distortionType = intrinsicDistortionPtr->getDistortion()->getType();
         }
     }
 
-    switch (intrinsicPtr->getType())
+    // The camera model is selected from the distortion actually held by the intrinsic,
+    // so that the cost function always matches the size of the intrinsic parameter block.
+    switch (distortionType)
     {
-        case EINTRINSIC::PINHOLE_CAMERA:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_RADIAL1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK1, 2, 5, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK1(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_RADIAL3:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeRadialK3, 2, 7, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeRadialK3(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DERadial4, 2, 10, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DERadial4(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole3DEClassicLD, 2, 9, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole3DEClassicLD(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_Pinhole, 2, 4, 6, 6, 3>(
-              new ResidualErrorFunctor_Pinhole(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_BROWN:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeBrownT2, 2, 9, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeBrownT2(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye, 2, 8, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye(w, h, obsUndistorted));
-        case EINTRINSIC::PINHOLE_CAMERA_FISHEYE1:
-            return new ceres::AutoDiffCostFunction<ResidualErrorFunctor_PinholeFisheye1, 2, 5, 6, 6, 3>(
-              new ResidualErrorFunctor_PinholeFisheye1(w, h, obsUndistorted));
+        case EDISTORTION::NONE:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_None>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_RADIALK1:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_RadialK1>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_RADIALK3:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_RadialK3>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_BROWN:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_BrownT2>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_FISHEYE:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_Fisheye>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_FISHEYE1:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_Fisheye1>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_3DERADIAL4:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_3DERadial4>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_3DECLASSICLD:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_3DEClassicLD>>(w, h, obsUndistorted, withRig);
+        case EDISTORTION::DISTORTION_3DEANAMORPHIC4:
+            return new ResidualErrorCostFunction<PinholeModel<DistortionModel_3DEAnamorphic4>>(w, h, obsUndistorted, withRig);
         default:
-            throw std::logic_error("Cannot create rig cost function, unrecognized intrinsic type in BA.");
+            throw std::logic_error("Cannot create cost function, unrecognized distortion type in BA.");
     }
 }
 
@@ -387,6 +338,24 @@ void BundleAdjustmentCeres::CeresOptions::setSparseBA()
     }
 }
 
+void BundleAdjustmentCeres::CeresOptions::setIterativeBA()
+{
+    // the Schur complement is never built, it is solved with a preconditioned conjugate gradient
+    linearSolverType = ceres::ITERATIVE_SCHUR;
+    // the visibility-based preconditioner factorizes the camera clusters with a sparse library
+    if (ceres::IsSparseLinearAlgebraLibraryTypeAvailable(ceres::SUITE_SPARSE))
+    {
+        sparseLinearAlgebraLibraryType = ceres::SUITE_SPARSE;
+        preconditionerType = ceres::CLUSTER_JACOBI;
+        ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: ITERATIVE_SCHUR, CLUSTER_JACOBI");
+    }
+    else
+    {
+        preconditionerType = ceres::SCHUR_JACOBI;
+        ALICEVISION_LOG_DEBUG("BundleAdjustment[Ceres]: ITERATIVE_SCHUR, SCHUR_JACOBI");
+    }
+}
+
 bool BundleAdjustmentCeres::Statistics::exportToFile(const std::string& folder, const std::string& filename) const
 {
     std::ofstream os;
@@ -409,7 +378,8 @@ bool BundleAdjustmentCeres::Statistics::exportToFile(const std::string& folder,
               "ResidualBlocks;SuccessIteration;BadIteration;"
               "InitRMSE;FinalRMSE;"
               "d=-1;d=0;d=1;d=2;d=3;d=4;"
-              "d=5;d=6;d=7;d=8;d=9;d=10+;\n";
+              "d=5;d=6;d=7;d=8;d=9;d=10+;"
+              "Cameras;LinearSolver;Preconditioner;LinearSolves;LinearSolverTime(s);\n";
     }
 
     std::map<EParameter, std::map<EEstimatorParameterState, std::size_t>> states = parametersStates;
@@ -436,7 +406,8 @@ bool BundleAdjustmentCeres::Statistics::exportToFile(const std::string& folder,
             os << "0;";
     }
 
-    os << posesWithDistUpperThanTen << ";\n";
+    os << posesWithDistUpperThanTen << ";" << nbCameras << ";" << linearSolverType << ";" << preconditionerType << ";" << nbLinearSolves << ";"
+       << linearSolverTime << ";\n";
 
     os.close();
     return true;
@@ -492,6 +463,9 @@ void BundleAdjustmentCeres::Statistics::show() const
                          << "\t    - # refined:  " << states[EParameter::INTRINSIC][EEstimatorParameterState::REFINED] << "\n"
                          << "\t    - # constant: " << states[EParameter::INTRINSIC][EEstimatorParameterState::CONSTANT] << "\n"
                          << "\t    - # ignored:  " << states[EParameter::INTRINSIC][EEstimatorParameterState::IGNORED] << "\n"
+                         << "\t- # cameras: " << nbCameras << "\n"
+                         << "\t- linear solver: " << linearSolverType << " (" << preconditionerType << ")\n"
+                         << "\t- # linear solves: " << nbLinearSolves << " (" << linearSolverTime << " s)\n"
                          << "\t- # residual blocks: " << nbResidualBlocks << "\n"
                          << "\t- # successful iterations: " << nbSuccessfullIterations << "\n"
                          << "\t- # unsuccessful iterations: " << nbUnsuccessfullIterations << "\n"
@@ -504,6 +478,22 @@ void BundleAdjustmentCeres::setSolverOptions(ceres::Solver::Options& solverOptio
     solverOptions.preconditioner_type = _ceresOptions.preconditionerType;
     solverOptions.linear_solver_type = _ceresOptions.linearSolverType;
     solverOptions.sparse_linear_algebra_library_type = _ceresOptions.sparseLinearAlgebraLibraryType;
+    solverOptions.visibility_clustering_type = _ceresOptions.visibilityClusteringType;
+
+    // on very large scenes, building and factorizing the reduced camera system dominates time and memory:
+    // switch to the iterative Schur solver, Ceres clusters the cameras from the landmarks visibility
+    if (_ceresOptions.minNbCamerasForIterativeBA > 0 && _posesBlocks.size() >= _ceresOptions.minNbCamerasForIterativeBA &&
+        _ceresOptions.linearSolverType != ceres::ITERATIVE_SCHUR)
+    {
+        CeresOptions iterativeOptions = _ceresOptions;
+        iterativeOptions.setIterativeBA();
+
+        ALICEVISION_LOG_INFO("Bundle Adjustment: " << _posesBlocks.size() << " cameras, use the iterative Schur solver.");
+
+        solverOptions.preconditioner_type = iterativeOptions.preconditionerType;
+        solverOptions.linear_solver_type = iterativeOptions.linearSolverType;
+        solverOptions.sparse_linear_algebra_library_type = iterativeOptions.sparseLinearAlgebraLibraryType;
+    }
     solverOptions.minimizer_progress_to_stdout = _ceresOptions.verbose;
     solverOptions.logging_type = ceres::SILENT;
     solverOptions.num_threads = _ceresOptions.nbThreads;
@@ -833,7 +823,7 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
 
             if (view.isPartOfRig() && !view.isPoseIndependant())
             {
-                ceres::CostFunction* costFunction = createRigCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation, true);
 
                 double* rigBlockPtr = _rigBlocks.at(view.getRigId()).at(view.getSubPoseId()).data();
                 _linearSolverOrdering.AddElementToGroup(rigBlockPtr, 1);
@@ -847,7 +837,7 @@ void BundleAdjustmentCeres::addLandmarksToProblem(const sfmData::SfMData& sfmDat
             }
             else
             {
-                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation);
+                ceres::CostFunction* costFunction = createCostFunctionFromIntrinsics(sfmData.getIntrinsicPtr(view.getIntrinsicId()), observation, false);
 
                 problem.AddResidualBlock(costFunction,
                                          lossFunction,
@@ -933,6 +923,44 @@ void BundleAdjustmentCeres::addRotationPriorsToProblem(const sfmData::SfMData& s
     }
 }
 
+void BundleAdjustmentCeres::addConsensusPriorsToProblem(ceres::Problem& problem)
+{
+    if (_consensusPriorWeight <= 0.0)
+        return;
+
+    for (const auto& priorPair : _landmarksConsensusPrior)
+    {
+        const auto blockIt = _landmarksBlocks.find(priorPair.first);
+        if (blockIt == _landmarksBlocks.end() || problem.IsParameterBlockConstant(blockIt->second.data()))
+            continue;
+
+        const Vec3& target = priorPair.second;
+        ceres::CostFunction* costFunction = new ConsensusPriorCostFunction({target(0), target(1), target(2)}, _consensusPriorWeight);
+        problem.AddResidualBlock(costFunction, nullptr, blockIt->second.data());
+    }
+
+    for (const auto& priorPair : _intrinsicsConsensusPrior)
+    {
+        const auto blockIt = _intrinsicsBlocks.find(priorPair.first);
+        if (blockIt == _intrinsicsBlocks.end() || problem.IsParameterBlockConstant(blockIt->second.data()))
+            continue;
+
+        assert(priorPair.second.size() == blockIt->second.size());
+
+        ceres::CostFunction* costFunction = new ConsensusPriorCostFunction(priorPair.second, _consensusPriorWeight);
+        problem.AddResidualBlock(costFunction, nullptr, blockIt->second.data());
+    }
+}
+
+void BundleAdjustmentCeres::setConsensusPriors(const std::map<IndexT, Vec3>& landmarksPrior,
+                                               const std::map<IndexT, std::vector<double>>& intrinsicsPrior,
+                                               double weight)
+{
+    _landmarksConsensusPrior = landmarksPrior;
+    _intrinsicsConsensusPrior = intrinsicsPrior;
+    _consensusPriorWeight = weight;
+}
+
 void BundleAdjustmentCeres::createProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem)
 {
     // clear previously computed data
@@ -956,6 +984,9 @@ void BundleAdjustmentCeres::createProblem(const sfmData::SfMData& sfmData, ERefi
 
     // add rotation priors to the Ceres problem
     addRotationPriorsToProblem(sfmData, refineOptions, problem);
+
+    // add consensus priors to the Ceres problem
+    addConsensusPriorsToProblem(problem);
 }
 
 void BundleAdjustmentCeres::resetProblem()
@@ -1120,6 +1151,11 @@ bool BundleAdjustmentCeres::adjust(sfmData::SfMData& sfmData, ERefineOptions ref
     _statistics.nbResidualBlocks = summary.num_residuals;
     _statistics.RMSEinitial = std::sqrt(summary.initial_cost / summary.num_residuals);
     _statistics.RMSEfinal = std::sqrt(summary.final_cost / summary.num_residuals);
+    _statistics.nbCameras = _posesBlocks.size();
+    _statistics.linearSolverType = ceres::LinearSolverTypeToString(summary.linear_solver_type_used);
+    _statistics.preconditionerType = ceres::PreconditionerTypeToString(summary.preconditioner_type_used);
+    _statistics.nbLinearSolves = summary.num_linear_solves;
+    _statistics.linearSolverTime = summary.linear_solver_time_in_seconds;
 
     return true;
 }
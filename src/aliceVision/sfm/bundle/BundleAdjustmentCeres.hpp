@@ -45,6 +45,7 @@ class BundleAdjustmentCeres : public BundleAdjustment
 
         void setDenseBA();
         void setSparseBA();
+        void setIterativeBA();
 
         ceres::LinearSolverType linearSolverType;
         ceres::PreconditionerType preconditionerType;
@@ -52,6 +53,10 @@ class BundleAdjustmentCeres : public BundleAdjustment
         std::shared_ptr<ceres::LossFunction> lossFunction;
         unsigned int nbThreads;
         unsigned int maxNumIterations;
+        /// camera clustering used by the CLUSTER_JACOBI preconditioner, built from the camera/landmark visibility
+        ceres::VisibilityClusteringType visibilityClusteringType = ceres::SINGLE_LINKAGE;
+        /// minimum number of cameras in the problem to automatically switch to the iterative Schur solver (0: disabled)
+        std::size_t minNbCamerasForIterativeBA = 0;
         bool useParametersOrdering = true;
         bool summary = false;
         bool verbose = true;
@@ -101,6 +106,16 @@ class BundleAdjustmentCeres : public BundleAdjustment
         double RMSEfinal = 0.0;
         /// time spent to solve the BA (s)
         double time = 0.0;
+        /// number of cameras in the Ceres problem
+        std::size_t nbCameras = 0;
+        /// linear solver used by Ceres
+        std::string linearSolverType;
+        /// preconditioner used by Ceres
+        std::string preconditionerType;
+        /// number of linear solves performed by Ceres
+        std::size_t nbLinearSolves = 0;
+        /// time spent in the linear solver (s)
+        double linearSolverTime = 0.0;
         /// number of states per parameter
         std::map<EParameter, std::map<EEstimatorParameterState, std::size_t>> parametersStates;
         /// The distribution of the cameras for each graph distance <distance, numOfCam>
@@ -140,6 +155,16 @@ class BundleAdjustmentCeres : public BundleAdjustment
      */
     inline const Statistics& getStatistics() const { return _statistics; }
 
+    /**
+     * @brief Add quadratic priors pulling landmarks and intrinsics towards target values
+     * @details Used by the partitioned bundle adjustment to enforce the consensus on the parameters shared between clusters.
+     *          The priors are kept for all the following adjustments.
+     * @param[in] landmarksPrior The target position per landmark id
+     * @param[in] intrinsicsPrior The target parameters per intrinsic id
+     * @param[in] weight The weight of the quadratic penalty
+     */
+    void setConsensusPriors(const std::map<IndexT, Vec3>& landmarksPrior, const std::map<IndexT, std::vector<double>>& intrinsicsPrior, double weight);
+
   private:
     /**
      * @brief Clear structures for a new problem
@@ -192,6 +217,12 @@ class BundleAdjustmentCeres : public BundleAdjustment
      */
     void addRotationPriorsToProblem(const sfmData::SfMData& sfmData, ERefineOptions refineOptions, ceres::Problem& problem);
 
+    /**
+     * @brief Create a residual block for each consensus prior on a refined landmark or intrinsic
+     * @param[out] problem The Ceres bundle adjustement problem
+     */
+    void addConsensusPriorsToProblem(ceres::Problem& problem);
+
     /**
      * @brief Create the Ceres bundle adjustement problem with:
      *  - extrincics and intrinsics parameters blocks.
@@ -221,6 +252,13 @@ class BundleAdjustmentCeres : public BundleAdjustment
     /// last adjustment iteration statisics
     Statistics _statistics;
 
+    /// consensus priors on landmarks positions
+    std::map<IndexT, Vec3> _landmarksConsensusPrior;
+    /// consensus priors on intrinsics parameters
+    std::map<IndexT, std::vector<double>> _intrinsicsConsensusPrior;
+    /// weight of the consensus priors
+    double _consensusPriorWeight = 0.0;
+
     // data wrappers for refinement
 
     /// all parameters blocks pointers
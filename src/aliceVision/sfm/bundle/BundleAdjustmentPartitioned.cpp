@@ -0,0 +1,548 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
+#include <aliceVision/sfm/LocalBundleAdjustmentGraph.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+
+namespace aliceVision {
+namespace sfm {
+
+namespace {
+
+/**
+ * @brief Add the statistics of a cluster adjustment to the statistics of the partitioned adjustment
+ * @param[in] clusterStatistics The statistics of the cluster adjustment
+ * @param[in,out] statistics The statistics of the partitioned adjustment, the RMSE are accumulated as weighted sums of squares
+ */
+void addClusterStatistics(const BundleAdjustmentCeres::Statistics& clusterStatistics, BundleAdjustmentCeres::Statistics& statistics)
+{
+    const double nbResiduals = static_cast<double>(clusterStatistics.nbResidualBlocks);
+
+    statistics.nbSuccessfullIterations += clusterStatistics.nbSuccessfullIterations;
+    statistics.nbUnsuccessfullIterations += clusterStatistics.nbUnsuccessfullIterations;
+    statistics.nbResidualBlocks += clusterStatistics.nbResidualBlocks;
+    statistics.RMSEinitial += nbResiduals * clusterStatistics.RMSEinitial * clusterStatistics.RMSEinitial;
+    statistics.RMSEfinal += nbResiduals * clusterStatistics.RMSEfinal * clusterStatistics.RMSEfinal;
+    statistics.nbLinearSolves += clusterStatistics.nbLinearSolves;
+    statistics.linearSolverTime += clusterStatistics.linearSolverTime;
+    statistics.linearSolverType = clusterStatistics.linearSolverType;
+    statistics.preconditionerType = clusterStatistics.preconditionerType;
+
+    for (const auto& parameterPair : clusterStatistics.parametersStates)
+    {
+        for (const auto& statePair : parameterPair.second)
+            statistics.parametersStates[parameterPair.first][statePair.first] += statePair.second;
+    }
+}
+
+}  // namespace
+
+std::vector<std::set<IndexT>> BundleAdjustmentPartitioned::computeClusters(const sfmData::SfMData& sfmData) const
+{
+    // the landmarks are the tracks of the reconstruction
+    const track::TracksPerView tracksPerView = sfmData::getLandmarksPerViews(sfmData);
+
+    // the graph is empty: all the posed views are added with their matches edges
+    LocalBundleAdjustmentGraph graph(sfmData);
+    graph.updateGraphWithNewViews(sfmData, tracksPerView, std::set<IndexT>(), _options.minNbMatchesPerEdge);
+
+    std::vector<std::set<IndexT>> clusters = graph.computePoseClusters(sfmData, _options.maxNbPosesPerCluster);
+
+    std::map<IndexT, std::size_t> clusterPerPose;
+    for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+    {
+        for (const IndexT poseId : clusters.at(clusterId))
+            clusterPerPose[poseId] = clusterId;
+    }
+
+    // the posed views missing from the graph: their pose joins the cluster sharing most of their landmarks
+    std::map<IndexT, std::vector<IndexT>> missingViewsPerPose;
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        if (sfmData.isPoseAndIntrinsicDefined(viewPair.first) && clusterPerPose.count(viewPair.second->getPoseId()) == 0)
+            missingViewsPerPose[viewPair.second->getPoseId()].push_back(viewPair.first);
+    }
+
+    for (const auto& missingPair : missingViewsPerPose)
+    {
+        std::map<std::size_t, std::size_t> nbObservationsPerCluster;
+        for (const IndexT viewId : missingPair.second)
+        {
+            const auto tracksIt = tracksPerView.find(viewId);
+            if (tracksIt == tracksPerView.end())
+                continue;
+
+            for (const std::size_t landmarkId : tracksIt->second)
+            {
+                const auto landmarkIt = sfmData.getLandmarks().find(landmarkId);
+                if (landmarkIt == sfmData.getLandmarks().end())
+                    continue;
+
+                for (const auto& observationPair : landmarkIt->second.getObservations())
+                {
+                    const auto clusterIt = clusterPerPose.find(sfmData.getView(observationPair.first).getPoseId());
+                    if (clusterIt != clusterPerPose.end())
+                        ++nbObservationsPerCluster[clusterIt->second];
+                }
+            }
+        }
+
+        const auto bestIt = std::max_element(nbObservationsPerCluster.begin(), nbObservationsPerCluster.end(), [](const auto& a, const auto& b) {
+            return a.second < b.second;
+        });
+
+        // without any common landmark, the pose is adjusted in its own cluster
+        const std::size_t clusterId = (bestIt != nbObservationsPerCluster.end()) ? bestIt->first : clusters.size();
+        if (clusterId == clusters.size())
+            clusters.emplace_back();
+
+        clusters.at(clusterId).insert(missingPair.first);
+        clusterPerPose[missingPair.first] = clusterId;
+    }
+
+    if (!missingViewsPerPose.empty())
+        ALICEVISION_LOG_DEBUG("Partitioned Bundle Adjustment: " << missingViewsPerPose.size() << " poses missing from the view graph added to the clusters.");
+
+    return clusters;
+}
+
+std::vector<BundleAdjustmentPartitioned::Cluster> BundleAdjustmentPartitioned::createClusters(const sfmData::SfMData& sfmData,
+                                                                                              const std::vector<std::set<IndexT>>& clustersPosesId,
+                                                                                              const std::map<IndexT, std::size_t>& clusterPerPose)
+{
+    std::vector<Cluster> clusters(clustersPosesId.size());
+
+    // poses of the other clusters observing the landmarks of each cluster
+    std::vector<std::set<IndexT>> neighborPosesPerCluster(clusters.size());
+
+    for (const auto& landmarkPair : sfmData.getLandmarks())
+    {
+        std::set<std::size_t> clustersId;
+        for (const auto& observationPair : landmarkPair.second.getObservations())
+        {
+            if (!sfmData.isPoseAndIntrinsicDefined(observationPair.first))
+                continue;
+            clustersId.insert(clusterPerPose.at(sfmData.getView(observationPair.first).getPoseId()));
+        }
+
+        for (const std::size_t clusterId : clustersId)
+        {
+            clusters.at(clusterId).landmarksId.push_back(landmarkPair.first);
+
+            for (const auto& observationPair : landmarkPair.second.getObservations())
+            {
+                if (!sfmData.isPoseAndIntrinsicDefined(observationPair.first))
+                    continue;
+
+                const IndexT poseId = sfmData.getView(observationPair.first).getPoseId();
+                if (clusterPerPose.at(poseId) != clusterId)
+                    neighborPosesPerCluster.at(clusterId).insert(poseId);
+            }
+        }
+    }
+
+    for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+    {
+        Cluster& cluster = clusters.at(clusterId);
+        cluster.posesId.assign(clustersPosesId.at(clusterId).begin(), clustersPosesId.at(clusterId).end());
+        cluster.neighborPosesId.assign(neighborPosesPerCluster.at(clusterId).begin(), neighborPosesPerCluster.at(clusterId).end());
+    }
+
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        if (!sfmData.isPoseAndIntrinsicDefined(viewPair.first))
+            continue;
+
+        const IndexT poseId = viewPair.second->getPoseId();
+        const IndexT intrinsicId = viewPair.second->getIntrinsicId();
+
+        clusters.at(clusterPerPose.at(poseId)).intrinsicsId.insert(intrinsicId);
+        for (Cluster& cluster : clusters)
+        {
+            if (std::binary_search(cluster.neighborPosesId.begin(), cluster.neighborPosesId.end(), poseId))
+                cluster.intrinsicsId.insert(intrinsicId);
+        }
+    }
+
+    return clusters;
+}
+
+void BundleAdjustmentPartitioned::createClusterScene(const sfmData::SfMData& sfmData,
+                                                     const Cluster& cluster,
+                                                     const ClusterState& state,
+                                                     const std::map<IndexT, geometry::Pose3>& posesTransform,
+                                                     const std::map<IndexT, std::vector<IndexT>>& viewsPerPose,
+                                                     sfmData::SfMData& clusterSfmData)
+{
+    const auto addPose = [&](IndexT poseId, bool isNeighbor) {
+        sfmData::CameraPose pose = sfmData.getPoses().at(poseId);
+        pose.setTransform(posesTransform.at(poseId));
+        if (isNeighbor)
+            pose.setState(EEstimatorParameterState::CONSTANT);
+        else
+            pose.initializeState();
+        clusterSfmData.getPoses().emplace(poseId, pose);
+
+        for (const IndexT viewId : viewsPerPose.at(poseId))
+            clusterSfmData.getViews().emplace(viewId, sfmData.getViews().at(viewId));
+    };
+
+    for (const IndexT poseId : cluster.posesId)
+        addPose(poseId, false);
+    for (const IndexT poseId : cluster.neighborPosesId)
+        addPose(poseId, true);
+
+    // each cluster refines its own copy of the intrinsics
+    for (const IndexT intrinsicId : cluster.intrinsicsId)
+    {
+        std::shared_ptr<camera::IntrinsicBase> intrinsic(sfmData.getIntrinsics().at(intrinsicId)->clone());
+        intrinsic->updateFromParams(state.intrinsicsParams.at(intrinsicId));
+        intrinsic->initializeState();
+        clusterSfmData.getIntrinsics().emplace(intrinsicId, intrinsic);
+    }
+
+    for (std::size_t i = 0; i < cluster.landmarksId.size(); ++i)
+    {
+        const IndexT landmarkId = cluster.landmarksId.at(i);
+
+        sfmData::Landmark& landmark = clusterSfmData.getLandmarks()[landmarkId];
+        landmark = sfmData.getLandmarks().at(landmarkId);
+        landmark.X = state.landmarksX.at(i);
+        landmark.state = EEstimatorParameterState::REFINED;
+
+        // the observations of the views without pose cannot be part of the problem
+        sfmData::Observations& observations = landmark.getObservations();
+        for (auto it = observations.begin(); it != observations.end();)
+        {
+            if (clusterSfmData.getViews().count(it->first) == 0)
+                it = observations.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    // rig sub-poses are shared by all the clusters: keep them constant
+    clusterSfmData.getRigs() = sfmData.getRigs();
+    for (auto& rigPair : clusterSfmData.getRigs())
+    {
+        for (sfmData::RigSubPose& subPose : rigPair.second.getSubPoses())
+        {
+            if (subPose.status == sfmData::ERigSubPoseStatus::ESTIMATED)
+                subPose.status = sfmData::ERigSubPoseStatus::CONSTANT;
+        }
+    }
+
+    const auto hasViews = [&](IndexT viewFirst, IndexT viewSecond) {
+        return clusterSfmData.getViews().count(viewFirst) > 0 && clusterSfmData.getViews().count(viewSecond) > 0;
+    };
+
+    for (const sfmData::Constraint2D& constraint : sfmData.getConstraints2D())
+    {
+        if (hasViews(constraint.ViewFirst, constraint.ViewSecond))
+            clusterSfmData.getConstraints2D().push_back(constraint);
+    }
+
+    for (const sfmData::RotationPrior& prior : sfmData.getRotationPriors())
+    {
+        if (hasViews(prior.ViewFirst, prior.ViewSecond))
+            clusterSfmData.getRotationPriors().push_back(prior);
+    }
+}
+
+bool BundleAdjustmentPartitioned::adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions)
+{
+    _nbClusters = 1;
+    _nbIterations = 0;
+    _statistics = BundleAdjustmentCeres::Statistics();
+
+    // small scenes are adjusted in one piece
+    if (sfmData.getPoses().size() <= _options.maxNbPosesPerCluster)
+    {
+        BundleAdjustmentCeres bundleAdjustment(_ceresOptions, _minNbImagesToRefineOpticalCenter);
+        const bool success = bundleAdjustment.adjust(sfmData, refineOptions);
+        _statistics = bundleAdjustment.getStatistics();
+        return success;
+    }
+
+    system::Timer timer;
+
+    const std::vector<std::set<IndexT>> clustersPosesId = computeClusters(sfmData);
+    _nbClusters = clustersPosesId.size();
+
+    std::map<IndexT, std::size_t> clusterPerPose;
+    for (std::size_t clusterId = 0; clusterId < clustersPosesId.size(); ++clusterId)
+    {
+        for (const IndexT poseId : clustersPosesId.at(clusterId))
+            clusterPerPose[poseId] = clusterId;
+    }
+
+    const std::vector<Cluster> clusters = createClusters(sfmData, clustersPosesId, clusterPerPose);
+
+    std::map<IndexT, std::vector<IndexT>> viewsPerPose;
+    for (const auto& viewPair : sfmData.getViews())
+    {
+        if (sfmData.isPoseAndIntrinsicDefined(viewPair.first))
+            viewsPerPose[viewPair.second->getPoseId()].push_back(viewPair.first);
+    }
+
+    // current transform of the clustered poses, updated after each consensus iteration
+    std::map<IndexT, geometry::Pose3> posesTransform;
+    for (const auto& clusterPair : clusterPerPose)
+        posesTransform[clusterPair.first] = sfmData.getPoses().at(clusterPair.first).getTransform();
+
+    std::vector<ClusterState> states(clusters.size());
+    std::map<IndexT, std::size_t> nbClustersPerLandmark;
+    std::map<IndexT, std::size_t> nbClustersPerIntrinsic;
+
+    for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+    {
+        const Cluster& cluster = clusters.at(clusterId);
+        ClusterState& state = states.at(clusterId);
+
+        state.landmarksX.reserve(cluster.landmarksId.size());
+        for (const IndexT landmarkId : cluster.landmarksId)
+        {
+            state.landmarksX.push_back(sfmData.getLandmarks().at(landmarkId).X);
+            ++nbClustersPerLandmark[landmarkId];
+        }
+
+        for (const IndexT intrinsicId : cluster.intrinsicsId)
+        {
+            state.intrinsicsParams[intrinsicId] = sfmData.getIntrinsics().at(intrinsicId)->getParams();
+            ++nbClustersPerIntrinsic[intrinsicId];
+        }
+    }
+
+    // separators: parameters refined in several clusters, driven to their consensus value
+    std::map<IndexT, Vec3> landmarksConsensus;
+    std::map<IndexT, Eigen::VectorXd> intrinsicsConsensus;
+
+    for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+    {
+        ClusterState& state = states.at(clusterId);
+
+        for (const IndexT landmarkId : clusters.at(clusterId).landmarksId)
+        {
+            if (nbClustersPerLandmark.at(landmarkId) < 2)
+                continue;
+            landmarksConsensus[landmarkId] = sfmData.getLandmarks().at(landmarkId).X;
+            state.landmarksDual[landmarkId] = Vec3::Zero();
+        }
+
+        for (const auto& paramsPair : state.intrinsicsParams)
+        {
+            if (nbClustersPerIntrinsic.at(paramsPair.first) < 2)
+                continue;
+            intrinsicsConsensus[paramsPair.first] = Eigen::Map<const Eigen::VectorXd>(paramsPair.second.data(), paramsPair.second.size());
+            state.intrinsicsDual[paramsPair.first] = Eigen::VectorXd::Zero(paramsPair.second.size());
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Partitioned Bundle Adjustment: " << clusters.size() << " clusters, " << landmarksConsensus.size()
+                                                           << " shared landmarks, " << intrinsicsConsensus.size() << " shared intrinsics.");
+
+    // share the threads between the clusters optimized concurrently
+    const int nbParallelClusters = std::max(
+      1, std::min(static_cast<int>(clusters.size()),
+                  static_cast<int>(_options.nbParallelClusters > 0 ? _options.nbParallelClusters : omp_get_max_threads())));
+
+    BundleAdjustmentCeres::CeresOptions clusterCeresOptions = _ceresOptions;
+    clusterCeresOptions.nbThreads = std::max(1u, _ceresOptions.nbThreads / static_cast<unsigned int>(nbParallelClusters));
+    clusterCeresOptions.verbose = false;
+    clusterCeresOptions.summary = false;
+
+    while (_nbIterations < _options.maxNbIterations)
+    {
+        std::vector<char> clustersSuccess(clusters.size(), 0);
+        BundleAdjustmentCeres::Statistics iterationStatistics;
+
+        // the scene of a cluster only exists while it is adjusted
+#pragma omp parallel for schedule(dynamic) num_threads(nbParallelClusters)
+        for (int clusterId = 0; clusterId < static_cast<int>(clusters.size()); ++clusterId)
+        {
+            const Cluster& cluster = clusters.at(clusterId);
+            ClusterState& state = states.at(clusterId);
+
+            // each cluster is pulled towards the consensus minus its own dual variable
+            std::map<IndexT, Vec3> landmarksPrior;
+            for (const auto& dualPair : state.landmarksDual)
+                landmarksPrior[dualPair.first] = landmarksConsensus.at(dualPair.first) - dualPair.second;
+
+            std::map<IndexT, std::vector<double>> intrinsicsPrior;
+            for (const auto& dualPair : state.intrinsicsDual)
+            {
+                const Eigen::VectorXd target = intrinsicsConsensus.at(dualPair.first) - dualPair.second;
+                intrinsicsPrior[dualPair.first] = std::vector<double>(target.data(), target.data() + target.size());
+            }
+
+            sfmData::SfMData clusterSfmData;
+            createClusterScene(sfmData, cluster, state, posesTransform, viewsPerPose, clusterSfmData);
+
+            BundleAdjustmentCeres bundleAdjustment(clusterCeresOptions, _minNbImagesToRefineOpticalCenter);
+            bundleAdjustment.setConsensusPriors(landmarksPrior, intrinsicsPrior, _options.consensusWeight);
+            clustersSuccess.at(clusterId) = bundleAdjustment.adjust(clusterSfmData, refineOptions);
+
+            if (!clustersSuccess.at(clusterId))
+                continue;
+
+            // keep the refined values, the poses are applied once all the clusters are adjusted
+            for (std::size_t i = 0; i < cluster.landmarksId.size(); ++i)
+                state.landmarksX.at(i) = clusterSfmData.getLandmarks().at(cluster.landmarksId.at(i)).X;
+
+            state.posesTransform.resize(cluster.posesId.size());
+            for (std::size_t i = 0; i < cluster.posesId.size(); ++i)
+                state.posesTransform.at(i) = clusterSfmData.getPoses().at(cluster.posesId.at(i)).getTransform();
+
+            for (auto& paramsPair : state.intrinsicsParams)
+                paramsPair.second = clusterSfmData.getIntrinsics().at(paramsPair.first)->getParams();
+
+#pragma omp critical(partitionedBundleAdjustmentStatistics)
+            addClusterStatistics(bundleAdjustment.getStatistics(), iterationStatistics);
+        }
+
+        ++_nbIterations;
+
+        const auto failedIt = std::find(clustersSuccess.begin(), clustersSuccess.end(), 0);
+        if (failedIt != clustersSuccess.end())
+        {
+            ALICEVISION_LOG_WARNING("Partitioned Bundle Adjustment failed on cluster " << std::distance(clustersSuccess.begin(), failedIt) << ".");
+            return false;
+        }
+
+        // the poses refined by a cluster are constant in its neighbors
+        for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+        {
+            const Cluster& cluster = clusters.at(clusterId);
+            for (std::size_t i = 0; i < cluster.posesId.size(); ++i)
+                posesTransform.at(cluster.posesId.at(i)) = states.at(clusterId).posesTransform.at(i);
+        }
+
+        // consensus and dual updates
+        std::map<IndexT, Vec3> landmarksSum;
+        std::map<IndexT, Eigen::VectorXd> intrinsicsSum;
+
+        for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+        {
+            const Cluster& cluster = clusters.at(clusterId);
+            const ClusterState& state = states.at(clusterId);
+
+            for (std::size_t i = 0; i < cluster.landmarksId.size(); ++i)
+            {
+                const auto dualIt = state.landmarksDual.find(cluster.landmarksId.at(i));
+                if (dualIt == state.landmarksDual.end())
+                    continue;
+
+                const auto sumIt = landmarksSum.emplace(dualIt->first, Vec3::Zero()).first;
+                sumIt->second += state.landmarksX.at(i) + dualIt->second;
+            }
+
+            for (const auto& dualPair : state.intrinsicsDual)
+            {
+                const std::vector<double>& params = state.intrinsicsParams.at(dualPair.first);
+                const auto sumIt = intrinsicsSum.emplace(dualPair.first, Eigen::VectorXd::Zero(params.size())).first;
+                sumIt->second += Eigen::Map<const Eigen::VectorXd>(params.data(), params.size()) + dualPair.second;
+            }
+        }
+
+        for (auto& consensusPair : landmarksConsensus)
+            consensusPair.second = landmarksSum.at(consensusPair.first) / static_cast<double>(nbClustersPerLandmark.at(consensusPair.first));
+        for (auto& consensusPair : intrinsicsConsensus)
+            consensusPair.second = intrinsicsSum.at(consensusPair.first) / static_cast<double>(nbClustersPerIntrinsic.at(consensusPair.first));
+
+        double maxDistance = 0.0;
+
+        for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+        {
+            const Cluster& cluster = clusters.at(clusterId);
+            ClusterState& state = states.at(clusterId);
+
+            for (std::size_t i = 0; i < cluster.landmarksId.size(); ++i)
+            {
+                const auto dualIt = state.landmarksDual.find(cluster.landmarksId.at(i));
+                if (dualIt == state.landmarksDual.end())
+                    continue;
+
+                const Vec3& consensus = landmarksConsensus.at(dualIt->first);
+                const Vec3 difference = state.landmarksX.at(i) - consensus;
+                dualIt->second += difference;
+                maxDistance = std::max(maxDistance, difference.norm() / std::max(1.0, consensus.norm()));
+            }
+
+            for (auto& dualPair : state.intrinsicsDual)
+            {
+                const std::vector<double>& params = state.intrinsicsParams.at(dualPair.first);
+                const Eigen::VectorXd& consensus = intrinsicsConsensus.at(dualPair.first);
+                const Eigen::VectorXd difference = Eigen::Map<const Eigen::VectorXd>(params.data(), params.size()) - consensus;
+                dualPair.second += difference;
+                maxDistance = std::max(maxDistance, difference.norm() / std::max(1.0, consensus.norm()));
+            }
+        }
+
+        // the initial RMSE is the one of the first iteration, the final RMSE the one of the last iteration
+        const double initialSquaredError = (_nbIterations == 1) ? iterationStatistics.RMSEinitial : _statistics.RMSEinitial;
+        iterationStatistics.nbSuccessfullIterations += _statistics.nbSuccessfullIterations;
+        iterationStatistics.nbUnsuccessfullIterations += _statistics.nbUnsuccessfullIterations;
+        iterationStatistics.nbLinearSolves += _statistics.nbLinearSolves;
+        iterationStatistics.linearSolverTime += _statistics.linearSolverTime;
+        _statistics = iterationStatistics;
+        _statistics.RMSEinitial = initialSquaredError;
+
+        ALICEVISION_LOG_INFO("Partitioned Bundle Adjustment: iteration " << _nbIterations << ", max relative distance to consensus: " << maxDistance);
+
+        if (maxDistance < _options.consensusThreshold)
+            break;
+    }
+
+    // the weighted sums of squares of the last iteration and the first iteration
+    const double nbResiduals = static_cast<double>(std::max<std::size_t>(1, _statistics.nbResidualBlocks));
+    _statistics.RMSEfinal = std::sqrt(_statistics.RMSEfinal / nbResiduals);
+    _statistics.RMSEinitial = std::sqrt(_statistics.RMSEinitial / nbResiduals);
+    _statistics.nbCameras = clusterPerPose.size();
+    _statistics.time = timer.elapsed();
+
+    // update input sfmData with the solution
+    for (const auto& transformPair : posesTransform)
+        sfmData.getPoses().at(transformPair.first).setTransform(transformPair.second);
+
+    for (std::size_t clusterId = 0; clusterId < clusters.size(); ++clusterId)
+    {
+        const Cluster& cluster = clusters.at(clusterId);
+        const ClusterState& state = states.at(clusterId);
+
+        for (std::size_t i = 0; i < cluster.landmarksId.size(); ++i)
+        {
+            const IndexT landmarkId = cluster.landmarksId.at(i);
+            const auto consensusIt = landmarksConsensus.find(landmarkId);
+            sfmData.getLandmarks().at(landmarkId).X = (consensusIt != landmarksConsensus.end()) ? consensusIt->second : state.landmarksX.at(i);
+        }
+
+        for (const auto& paramsPair : state.intrinsicsParams)
+        {
+            const auto consensusIt = intrinsicsConsensus.find(paramsPair.first);
+            if (consensusIt == intrinsicsConsensus.end())
+            {
+                sfmData.getIntrinsics().at(paramsPair.first)->updateFromParams(paramsPair.second);
+                continue;
+            }
+
+            const Eigen::VectorXd& params = consensusIt->second;
+            sfmData.getIntrinsics().at(paramsPair.first)->updateFromParams(std::vector<double>(params.data(), params.data() + params.size()));
+        }
+    }
+
+    ALICEVISION_LOG_INFO("Partitioned Bundle Adjustment done in " << timer.elapsed() << " s (" << _nbIterations << " iterations).");
+
+    return true;
+}
+
+}  // namespace sfm
+}  // namespace aliceVision
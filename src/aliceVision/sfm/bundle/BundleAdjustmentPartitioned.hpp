@@ -0,0 +1,196 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/types.hpp>
+#include <aliceVision/geometry/Pose3.hpp>
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustment.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace aliceVision {
+
+namespace sfmData {
+class SfMData;
+}  // namespace sfmData
+
+namespace sfm {
+
+/**
+ * @brief Bundle adjustment of large scenes split into camera clusters.
+ * @details The poses are split into clusters using the view graph of the LocalBundleAdjustmentGraph.
+ *          Each cluster is optimized independently with its own Ceres problem, the poses observing
+ *          the same landmarks in the neighbor clusters are kept constant (overlap).
+ *          The landmarks and intrinsics shared by several clusters (separators) are driven to a
+ *          common value with a consensus ADMM scheme.
+ *          The scenes of the clusters are streamed: at most nbParallelClusters cluster scenes exist at the same time,
+ *          between the consensus iterations each cluster only keeps the values of its refined parameters.
+ */
+class BundleAdjustmentPartitioned : public BundleAdjustment
+{
+  public:
+    /**
+     * @brief Contains all the partitioning parameters.
+     */
+    struct PartitionedOptions
+    {
+        PartitionedOptions()
+          : maxNbPosesPerCluster(1000),
+            minNbMatchesPerEdge(50),
+            maxNbIterations(10),
+            consensusWeight(100.0),
+            consensusThreshold(1e-4),
+            nbParallelClusters(0)
+        {}
+
+        /// maximum number of poses per cluster, scenes with less poses are adjusted in one piece
+        std::size_t maxNbPosesPerCluster;
+        /// minimum number of shared landmarks to connect two views in the view graph
+        std::size_t minNbMatchesPerEdge;
+        /// maximum number of consensus iterations
+        unsigned int maxNbIterations;
+        /// weight of the consensus penalty
+        double consensusWeight;
+        /// stop when the relative distance of the shared parameters to their consensus is below this threshold
+        double consensusThreshold;
+        /// number of clusters optimized concurrently, i.e. of cluster scenes in memory (0: one per available core)
+        unsigned int nbParallelClusters;
+    };
+
+    /**
+     * @brief Partitioned bundle adjustment constructor
+     * @param[in] ceresOptions The Ceres options used for each cluster
+     * @param[in] options The partitioning options
+     * @param[in] minNbImagesToRefineOpticalCenter The minimum number of images of an intrinsic to refine its optical center
+     */
+    BundleAdjustmentPartitioned(const BundleAdjustmentCeres::CeresOptions& ceresOptions = BundleAdjustmentCeres::CeresOptions(),
+                                const PartitionedOptions& options = PartitionedOptions(),
+                                int minNbImagesToRefineOpticalCenter = 3)
+      : _ceresOptions(ceresOptions),
+        _options(options),
+        _minNbImagesToRefineOpticalCenter(minNbImagesToRefineOpticalCenter)
+    {}
+
+    /**
+     * @brief Perform a partitioned Bundle Adjustment on the SfM scene with refinement of the requested parameters
+     * @note In each cluster, the states of the parameters are reinitialized: only the locked parameters are kept constant.
+     * @param[in,out] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] refineOptions The chosen refine flag
+     * @return false if the bundle adjustment failed else true
+     * @see BundleAdjustment::Adjust
+     */
+    bool adjust(sfmData::SfMData& sfmData, ERefineOptions refineOptions = REFINE_ALL) override;
+
+    /**
+     * @brief Get the number of clusters used by the last adjustment
+     * @return number of clusters
+     */
+    inline std::size_t getNbClusters() const { return _nbClusters; }
+
+    /**
+     * @brief Get the number of consensus iterations performed by the last adjustment
+     * @return number of iterations
+     */
+    inline std::size_t getNbIterations() const { return _nbIterations; }
+
+    /**
+     * @brief Get the statistics of the last adjustment
+     * @details The Ceres statistics of the clusters are summed over the clusters and the consensus iterations,
+     *          the RMSE are weighted by the number of residuals of each cluster.
+     * @return statistics
+     */
+    inline const BundleAdjustmentCeres::Statistics& getStatistics() const { return _statistics; }
+
+  private:
+    /**
+     * @brief Parameters of a cluster, computed once per adjustment
+     */
+    struct Cluster
+    {
+        /// poses refined by the cluster
+        std::vector<IndexT> posesId;
+        /// poses of the other clusters observing the landmarks of the cluster, kept constant
+        std::vector<IndexT> neighborPosesId;
+        /// landmarks observed by the poses of the cluster
+        std::vector<IndexT> landmarksId;
+        /// intrinsics of the poses and neighbor poses of the cluster
+        std::set<IndexT> intrinsicsId;
+    };
+
+    /**
+     * @brief Values of the refined parameters of a cluster, kept between the consensus iterations
+     */
+    struct ClusterState
+    {
+        /// refined position of each landmark, in the order of Cluster::landmarksId
+        std::vector<Vec3> landmarksX;
+        /// refined transform of each pose, in the order of Cluster::posesId
+        std::vector<geometry::Pose3> posesTransform;
+        /// refined parameters of each intrinsic
+        std::map<IndexT, std::vector<double>> intrinsicsParams;
+        /// dual variables of the shared landmarks
+        std::map<IndexT, Vec3> landmarksDual;
+        /// dual variables of the shared intrinsics
+        std::map<IndexT, Eigen::VectorXd> intrinsicsDual;
+    };
+
+    /**
+     * @brief Split the reconstructed poses into clusters of connected poses
+     * @note The poses missing from the view graph are added to the cluster sharing most of their landmarks.
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @return the list of pose ids per cluster
+     */
+    std::vector<std::set<IndexT>> computeClusters(const sfmData::SfMData& sfmData) const;
+
+    /**
+     * @brief Compute the parameters of each cluster: its poses, the landmarks observed by its poses
+     *        and the poses of the other clusters observing these landmarks
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] clustersPosesId The list of pose ids per cluster
+     * @param[in] clusterPerPose The cluster index of each pose
+     * @return the parameters of each cluster
+     */
+    static std::vector<Cluster> createClusters(const sfmData::SfMData& sfmData,
+                                               const std::vector<std::set<IndexT>>& clustersPosesId,
+                                               const std::map<IndexT, std::size_t>& clusterPerPose);
+
+    /**
+     * @brief Create the scene of a cluster from the current values of its parameters
+     * @param[in] sfmData The input SfMData contains all the information about the reconstruction
+     * @param[in] cluster The parameters of the cluster
+     * @param[in] state The current values of the parameters refined by the cluster
+     * @param[in] posesTransform The current transform of each pose
+     * @param[in] viewsPerPose The posed views of each pose
+     * @param[out] clusterSfmData The scene of the cluster
+     */
+    static void createClusterScene(const sfmData::SfMData& sfmData,
+                                   const Cluster& cluster,
+                                   const ClusterState& state,
+                                   const std::map<IndexT, geometry::Pose3>& posesTransform,
+                                   const std::map<IndexT, std::vector<IndexT>>& viewsPerPose,
+                                   sfmData::SfMData& clusterSfmData);
+
+    /// user Ceres options used for each cluster
+    BundleAdjustmentCeres::CeresOptions _ceresOptions;
+    /// user partitioning options
+    PartitionedOptions _options;
+    /// minimum number of images of an intrinsic to refine its optical center
+    int _minNbImagesToRefineOpticalCenter;
+    /// number of clusters used by the last adjustment
+    std::size_t _nbClusters = 0;
+    /// number of consensus iterations performed by the last adjustment
+    std::size_t _nbIterations = 0;
+    /// statistics of the last adjustment
+    BundleAdjustmentCeres::Statistics _statistics;
+};
+
+}  // namespace sfm
+}  // namespace aliceVision
@@ -241,6 +241,118 @@ BOOST_AUTO_TEST_CASE(LOCAL_BUNDLE_ADJUSTMENT_EffectiveMinimization_Pinhole_Camer
     BOOST_CHECK_LT(dResidual_after, dResidual_before);
 }
 
+// Test summary:
+// - Create a SfMData scene from a synthetic dataset
+// - Refine two copies of it, with the direct solver and with the iterative Schur solver
+//   selected by the camera count threshold
+// - Check that both solver paths converge to the same solution
+
+BOOST_AUTO_TEST_CASE(BUNDLE_ADJUSTMENT_IterativeSolver_MatchesDirectSolver)
+{
+    const int nviews = 8;
+    const int npoints = 30;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    SfMData sfmDataDirect = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+    SfMData sfmDataIterative = sfmDataDirect;
+
+    const double dResidual_before = RMSE(sfmDataDirect);
+
+    BundleAdjustmentCeres::CeresOptions directOptions(false);
+    directOptions.setDenseBA();
+    directOptions.maxNumIterations = 200;
+
+    BundleAdjustmentCeres::CeresOptions iterativeOptions = directOptions;
+    iterativeOptions.minNbCamerasForIterativeBA = 1;  // always switch to the iterative Schur solver
+
+    BundleAdjustmentCeres directBA(directOptions);
+    BOOST_CHECK(directBA.adjust(sfmDataDirect));
+    BundleAdjustmentCeres iterativeBA(iterativeOptions);
+    BOOST_CHECK(iterativeBA.adjust(sfmDataIterative));
+
+    BOOST_CHECK_EQUAL(directBA.getStatistics().linearSolverType, std::string(ceres::LinearSolverTypeToString(ceres::DENSE_SCHUR)));
+    BOOST_CHECK_EQUAL(iterativeBA.getStatistics().linearSolverType, std::string(ceres::LinearSolverTypeToString(ceres::ITERATIVE_SCHUR)));
+
+    const double dResidualDirect = RMSE(sfmDataDirect);
+    const double dResidualIterative = RMSE(sfmDataIterative);
+    BOOST_CHECK_LT(dResidualDirect, dResidual_before);
+    // the gauge is free, compare the reached minimum rather than the parameters
+    BOOST_CHECK_SMALL(dResidualDirect - dResidualIterative, 1e-3);
+    BOOST_CHECK_SMALL(directBA.getStatistics().RMSEfinal - iterativeBA.getStatistics().RMSEfinal, 1e-3);
+}
+
+// Test summary:
+// - Create a SfMData scene from a synthetic dataset
+// - Split it into clusters of at most 3 poses
+// - Check that the partitioned Bundle Adjustment reaches a consensus and reduces the residual
+
+BOOST_AUTO_TEST_CASE(PARTITIONED_BUNDLE_ADJUSTMENT_EffectiveMinimization_Pinhole)
+{
+    const int nviews = 8;
+    const int npoints = 20;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    const double dResidual_before = RMSE(sfmData);
+
+    BundleAdjustmentCeres::CeresOptions ceresOptions;
+    ceresOptions.setDenseBA();
+
+    BundleAdjustmentPartitioned::PartitionedOptions options;
+    options.maxNbPosesPerCluster = 3;
+    options.minNbMatchesPerEdge = 1;
+    options.maxNbIterations = 20;
+
+    BundleAdjustmentPartitioned BA(ceresOptions, options);
+    BOOST_CHECK(BA.adjust(sfmData));
+
+    BOOST_CHECK_EQUAL(BA.getNbClusters(), 3);
+    BOOST_CHECK_GE(BA.getNbIterations(), 1);
+
+    const double dResidual_after = RMSE(sfmData);
+    BOOST_CHECK_LT(dResidual_after, dResidual_before);
+}
+
+// Test summary:
+// - Create a SfMData scene from a synthetic dataset
+// - Refine two copies of it, in one piece and split into clusters of at most 3 poses
+// - Check that the partitioned Bundle Adjustment reaches the residual of the full Bundle Adjustment
+
+BOOST_AUTO_TEST_CASE(PARTITIONED_BUNDLE_ADJUSTMENT_MatchesFullBundleAdjustment)
+{
+    const int nviews = 8;
+    const int npoints = 30;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    SfMData sfmDataFull = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+    SfMData sfmDataPartitioned = sfmDataFull;
+
+    BundleAdjustmentCeres::CeresOptions ceresOptions(false);
+    ceresOptions.setDenseBA();
+
+    BundleAdjustmentCeres fullBA(ceresOptions);
+    BOOST_CHECK(fullBA.adjust(sfmDataFull));
+
+    BundleAdjustmentPartitioned::PartitionedOptions options;
+    options.maxNbPosesPerCluster = 3;
+    options.minNbMatchesPerEdge = 1;
+    options.maxNbIterations = 50;
+    options.consensusThreshold = 1e-6;
+
+    BundleAdjustmentPartitioned partitionedBA(ceresOptions, options);
+    BOOST_CHECK(partitionedBA.adjust(sfmDataPartitioned));
+    BOOST_CHECK_GT(partitionedBA.getNbClusters(), 1);
+
+    const double dResidualFull = RMSE(sfmDataFull);
+    const double dResidualPartitioned = RMSE(sfmDataPartitioned);
+    BOOST_CHECK_LT(dResidualPartitioned, dResidualFull * 1.05 + 1e-3);
+}
+
 /// Compute the Root Mean Square Error of the residuals
 double RMSE(const SfMData& sfm_data)
 {
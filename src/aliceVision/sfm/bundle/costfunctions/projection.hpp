@@ -23,7 +23,7 @@ class CostProjection : public ceres::CostFunction
 
         mutable_parameter_block_sizes()->push_back(16);
         mutable_parameter_block_sizes()->push_back(16);
-        mutable_parameter_block_sizes()->push_back(intrinsics->getParams().size());
+        mutable_parameter_block_sizes()->push_back(intrinsics->getParamsSize());
         mutable_parameter_block_sizes()->push_back(3);
     }
 
@@ -38,21 +38,15 @@ class CostProjection : public ceres::CostFunction
         const Eigen::Map<const SE3::Matrix> cTr(parameter_rig);
         const Eigen::Map<const Vec3> pt(parameter_landmark);
 
-        /*Update intrinsics object with estimated parameters*/
-        size_t params_size = _intrinsics->getParams().size();
-        std::vector<double> params;
-        for (size_t param_id = 0; param_id < params_size; param_id++)
-        {
-            params.push_back(parameter_intrinsics[param_id]);
-        }
-        _intrinsics->updateFromParams(params);
-
         const SE3::Matrix T = cTr * rTo;
-        const geometry::Pose3 T_pose3(T);
-
         const Vec4 pth = pt.homogeneous();
 
-        const Vec2 pt_est = _intrinsics->project(T_pose3, pth, true);
+        // Project with the parameter block directly: no intrinsic update, no allocation
+        Vec2 pt_est;
+        Eigen::Matrix<double, 2, 3> d_pt_est_d_X;
+        double* jacobian_intrinsics = (jacobians != nullptr) ? jacobians[2] : nullptr;
+        _intrinsics->projectWithParams(parameter_intrinsics, T, pth, pt_est, &d_pt_est_d_X, jacobian_intrinsics);
+
         const double scale = (_measured.getScale() > 1e-12) ? _measured.getScale() : 1.0;
 
         residuals[0] = (pt_est(0) - _measured.getX()) / scale;
@@ -63,36 +57,48 @@ class CostProjection : public ceres::CostFunction
             return true;
         }
 
-        Eigen::Matrix2d d_res_d_pt_est = Eigen::Matrix2d::Identity() / scale;
+        const Eigen::Matrix<double, 2, 3> d_res_d_X = d_pt_est_d_X / scale;
 
-        if (jacobians[0] != nullptr)
+        if (jacobians[0] != nullptr || jacobians[1] != nullptr)
         {
-            Eigen::Map<Eigen::Matrix<double, 2, 16, Eigen::RowMajor>> J(jacobians[0]);
-
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtPose(T, pth) * getJacobian_AB_wrt_B<4, 4, 4>(cTr, rTo) *
-                getJacobian_AB_wrt_A<4, 4, 4>(Eigen::Matrix4d::Identity(), rTo);
-        }
-
-        if (jacobians[1] != nullptr)
-        {
-            Eigen::Map<Eigen::Matrix<double, 2, 16, Eigen::RowMajor>> J(jacobians[1]);
-
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtPose(T, pth) * getJacobian_AB_wrt_A<4, 4, 4>(cTr, rTo) *
-                getJacobian_AB_wrt_A<4, 4, 4>(Eigen::Matrix4d::Identity(), cTr);
+            // Derivative of the residual wrt T, using X = T * pth
+            Eigen::Matrix<double, 2, 16> d_res_d_T;
+            for (int j = 0; j < 4; ++j)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    d_res_d_T.col(4 * j + i) = d_res_d_X.col(i) * pth(j);
+                }
+                d_res_d_T.col(4 * j + 3).setZero();
+            }
+
+            if (jacobians[0] != nullptr)
+            {
+                Eigen::Map<Eigen::Matrix<double, 2, 16, Eigen::RowMajor>> J(jacobians[0]);
+
+                J = d_res_d_T * getJacobian_AB_wrt_B<4, 4, 4>(cTr, rTo) * getJacobian_AB_wrt_A<4, 4, 4>(Eigen::Matrix4d::Identity(), rTo);
+            }
+
+            if (jacobians[1] != nullptr)
+            {
+                Eigen::Map<Eigen::Matrix<double, 2, 16, Eigen::RowMajor>> J(jacobians[1]);
+
+                J = d_res_d_T * getJacobian_AB_wrt_A<4, 4, 4>(cTr, rTo) * getJacobian_AB_wrt_A<4, 4, 4>(Eigen::Matrix4d::Identity(), cTr);
+            }
         }
 
         if (jacobians[2] != nullptr)
         {
-            Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> J(jacobians[2], 2, params_size);
+            Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> J(jacobians[2], 2, _intrinsics->getParamsSize());
 
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtParams(T, pth);
+            J /= scale;
         }
 
         if (jacobians[3] != nullptr)
         {
             Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[3]);
 
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtPoint(T, pth) * Eigen::Matrix<double, 4, 3>::Identity();
+            J = d_res_d_X * T.block<3, 3>(0, 0);
         }
 
         return true;
@@ -21,7 +21,7 @@ class CostProjectionSimple : public ceres::CostFunction
         set_num_residuals(2);
 
         mutable_parameter_block_sizes()->push_back(16);
-        mutable_parameter_block_sizes()->push_back(intrinsics->getParams().size());
+        mutable_parameter_block_sizes()->push_back(intrinsics->getParamsSize());
         mutable_parameter_block_sizes()->push_back(3);
     }
 
@@ -36,9 +36,12 @@ class CostProjectionSimple : public ceres::CostFunction
 
         const Vec4 pth = pt.homogeneous();
 
-        const Vec4 cpt = T * pth;
+        // Project with the parameter block directly: no intrinsic update, no allocation
+        Vec2 pt_est;
+        Eigen::Matrix<double, 2, 3> d_pt_est_d_X;
+        double* jacobian_intrinsics = (jacobians != nullptr) ? jacobians[1] : nullptr;
+        _intrinsics->projectWithParams(parameter_intrinsics, T, pth, pt_est, &d_pt_est_d_X, jacobian_intrinsics);
 
-        Vec2 pt_est = _intrinsics->project(T, pth, true);
         const double scale = (_measured.getScale() > 1e-12) ? _measured.getScale() : 1.0;
 
         residuals[0] = (pt_est(0) - _measured.getX()) / scale;
@@ -49,30 +52,36 @@ class CostProjectionSimple : public ceres::CostFunction
             return true;
         }
 
-        const geometry::Pose3 T_pose3(T);
-        size_t params_size = _intrinsics->getParams().size();
-
-        double d_res_d_pt_est = 1.0 / scale;
+        const Eigen::Matrix<double, 2, 3> d_res_d_X = d_pt_est_d_X / scale;
 
         if (jacobians[0] != nullptr)
         {
             Eigen::Map<Eigen::Matrix<double, 2, 16, Eigen::RowMajor>> J(jacobians[0]);
 
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtPoseLeft(T, pth);
+            // Left update of the pose: derivative wrt T applied on the camera point cpt = T * pth
+            const Vec4 cpt = T * pth;
+            for (int j = 0; j < 4; ++j)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    J.col(4 * j + i) = d_res_d_X.col(i) * ((j < 3) ? cpt(j) : 1.0);
+                }
+                J.col(4 * j + 3).setZero();
+            }
         }
 
         if (jacobians[1] != nullptr)
         {
-            Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> J(jacobians[1], 2, params_size);
+            Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>> J(jacobians[1], 2, _intrinsics->getParamsSize());
 
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtParams(T, pth);
+            J /= scale;
         }
 
         if (jacobians[2] != nullptr)
         {
             Eigen::Map<Eigen::Matrix<double, 2, 3, Eigen::RowMajor>> J(jacobians[2]);
 
-            J = d_res_d_pt_est * _intrinsics->getDerivativeProjectWrtPoint3(T, pth);
+            J = d_res_d_X * T.block<3, 3>(0, 0);
         }
 
         return true;
@@ -0,0 +1,155 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/sfm/ResidualErrorFunctor.hpp>
+#include <aliceVision/camera/camera.hpp>
+
+#include <vector>
+
+#define BOOST_TEST_MODULE residualErrorFunctor
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+using namespace aliceVision::sfm;
+
+namespace {
+
+/**
+ * @brief Evaluate the cost function with the given parameter blocks.
+ */
+Vec2 evaluate(const ceres::CostFunction& cost, const std::vector<std::vector<double>>& blocks, std::vector<std::vector<double>>* jacobians = nullptr)
+{
+    std::vector<const double*> parameters;
+    for (const auto& block : blocks)
+    {
+        parameters.push_back(block.data());
+    }
+
+    std::vector<double*> jacobiansPtr;
+    if (jacobians)
+    {
+        jacobians->clear();
+        for (const auto& block : blocks)
+        {
+            jacobians->emplace_back(2 * block.size());
+            jacobiansPtr.push_back(jacobians->back().data());
+        }
+    }
+
+    Vec2 residuals;
+    cost.Evaluate(parameters.data(), residuals.data(), jacobians ? jacobiansPtr.data() : nullptr);
+    return residuals;
+}
+
+template<typename DistortionModel>
+void checkCostFunction(const IntrinsicBase& intrinsic, bool withRig)
+{
+    const std::vector<double> angleAxis = {0.1, -0.2, 0.15};
+    const std::vector<double> subposeAngleAxis = {-0.05, 0.1, 0.02};
+    const Vec3 translation(0.2, -0.1, 0.3);
+    const Vec3 subposeTranslation(-0.1, 0.05, 0.0);
+
+    std::vector<std::vector<double>> blocks;
+    blocks.push_back(intrinsic.getParams());
+    blocks.push_back({angleAxis[0], angleAxis[1], angleAxis[2], translation(0), translation(1), translation(2)});
+    if (withRig)
+    {
+        blocks.push_back({subposeAngleAxis[0], subposeAngleAxis[1], subposeAngleAxis[2], subposeTranslation(0), subposeTranslation(1), subposeTranslation(2)});
+    }
+    blocks.push_back({0.3, -0.2, 4.0});
+
+    Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+    T.block<3, 3>(0, 0) = SO3::expm(Vec3(angleAxis[0], angleAxis[1], angleAxis[2]));
+    T.block<3, 1>(0, 3) = translation;
+    if (withRig)
+    {
+        Eigen::Matrix4d subposeT = Eigen::Matrix4d::Identity();
+        subposeT.block<3, 3>(0, 0) = SO3::expm(Vec3(subposeAngleAxis[0], subposeAngleAxis[1], subposeAngleAxis[2]));
+        subposeT.block<3, 1>(0, 3) = subposeTranslation;
+        T = subposeT * T;
+    }
+    const geometry::Pose3 pose(T);
+
+    const Vec3 point(blocks.back()[0], blocks.back()[1], blocks.back()[2]);
+    const Vec2 projected = intrinsic.project(pose, point.homogeneous(), true);
+    const sfmData::Observation observation(projected + Vec2(1.5, -0.5), 0, 2.0);
+
+    const ResidualErrorCostFunction<PinholeModel<DistortionModel>> cost(intrinsic.w(), intrinsic.h(), observation, withRig);
+    BOOST_CHECK_EQUAL(cost.parameter_block_sizes().front(), intrinsic.getParamsSize());
+
+    // residual must match the camera model projection
+    std::vector<std::vector<double>> jacobians;
+    const Vec2 residuals = evaluate(cost, blocks, &jacobians);
+    EXPECT_MATRIX_NEAR(residuals, Vec2(-0.75, 0.25), 1e-6);
+
+    // analytic jacobians must match central finite differences
+    for (std::size_t idBlock = 0; idBlock < blocks.size(); ++idBlock)
+    {
+        for (std::size_t idParam = 0; idParam < blocks[idBlock].size(); ++idParam)
+        {
+            const double eps = 1e-6 * std::max(1.0, std::abs(blocks[idBlock][idParam]));
+
+            std::vector<std::vector<double>> blocksPlus = blocks;
+            std::vector<std::vector<double>> blocksMinus = blocks;
+            blocksPlus[idBlock][idParam] += eps;
+            blocksMinus[idBlock][idParam] -= eps;
+
+            const Vec2 numeric = (evaluate(cost, blocksPlus) - evaluate(cost, blocksMinus)) / (2.0 * eps);
+            const Vec2 analytic(jacobians[idBlock][idParam], jacobians[idBlock][blocks[idBlock].size() + idParam]);
+
+            EXPECT_MATRIX_NEAR(numeric, analytic, 1e-5 * std::max(1.0, analytic.norm()));
+        }
+    }
+}
+
+template<typename DistortionModel>
+void checkCostFunction(EINTRINSIC type)
+{
+    // distortion only, the bundle adjustment does not refine an undistortion
+    std::shared_ptr<Pinhole> intrinsic = std::make_shared<Pinhole>(1000, 800, 900.0, 910.0, 12.0, -7.0, createDistortion(getDistortionType(type)));
+
+    if (intrinsic->getDistortion())
+    {
+        std::vector<double> distortionParams = intrinsic->getDistortionParams();
+        for (std::size_t i = 0; i < distortionParams.size(); ++i)
+        {
+            distortionParams[i] += 0.01 * double(i + 1);
+        }
+        intrinsic->setDistortionParams(distortionParams);
+    }
+
+    BOOST_TEST_CONTEXT("Intrinsic type: " << EINTRINSIC_enumToString(type))
+    {
+        checkCostFunction<DistortionModel>(*intrinsic, false);
+        checkCostFunction<DistortionModel>(*intrinsic, true);
+    }
+}
+
+}  // namespace
+
+//-----------------
+// Test summary:
+//-----------------
+// - For every pinhole camera model, build the reprojection cost function
+// - Assert the residual matches the camera model projection, with and without rig
+// - Assert the analytic jacobians match the numerical derivatives
+//-----------------
+BOOST_AUTO_TEST_CASE(residualErrorCostFunction_matchesCameraModels)
+{
+    checkCostFunction<DistortionModel_None>(EINTRINSIC::PINHOLE_CAMERA);
+    checkCostFunction<DistortionModel_RadialK1>(EINTRINSIC::PINHOLE_CAMERA_RADIAL1);
+    checkCostFunction<DistortionModel_RadialK3>(EINTRINSIC::PINHOLE_CAMERA_RADIAL3);
+    checkCostFunction<DistortionModel_BrownT2>(EINTRINSIC::PINHOLE_CAMERA_BROWN);
+    checkCostFunction<DistortionModel_Fisheye>(EINTRINSIC::PINHOLE_CAMERA_FISHEYE);
+    checkCostFunction<DistortionModel_Fisheye1>(EINTRINSIC::PINHOLE_CAMERA_FISHEYE1);
+    checkCostFunction<DistortionModel_3DERadial4>(EINTRINSIC::PINHOLE_CAMERA_3DERADIAL4);
+    checkCostFunction<DistortionModel_3DEClassicLD>(EINTRINSIC::PINHOLE_CAMERA_3DECLASSICLD);
+    checkCostFunction<DistortionModel_3DEAnamorphic4>(EINTRINSIC::PINHOLE_CAMERA_3DEANAMORPHIC4);
+}
@@ -31,6 +31,11 @@
 
 #include <aliceVision/utils/Histogram.hpp>
 
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
 namespace aliceVision {
 namespace sfm {
 
@@ -204,6 +209,7 @@ bool GlobalSfMTranslationAveragingSolver::translationAveraging(ETranslationAvera
             break;
 
             case TRANSLATION_AVERAGING_L2_DISTANCE_CHORDAL:
+            case TRANSLATION_AVERAGING_BATA:
             {
                 std::vector<int> vecEdges;
                 vecEdges.reserve(vecInitialRijTijEstimatesCpy.size() * 2);
@@ -231,21 +237,38 @@ bool GlobalSfMTranslationAveragingSolver::translationAveraging(ETranslationAvera
                     vecWeights.push_back(1.0);
                 }
 
-                const double functionTolerance = 1e-7, parameterTolerance = 1e-8;
-                const int maxIterations = 500;
+                std::vector<double> X(iNview * 3, 0.0);
+                bool solved = false;
 
-                const double lossWidth = 0.0;  // No loss in order to compare with TRANSLATION_AVERAGING_L1
+                if (eTranslationAveragingMethod == TRANSLATION_AVERAGING_BATA)
+                {
+                    // robust loss on the residual of the unit directions (chordal distance)
+                    const double lossWidth = 0.1;
+                    const double tolerance = 1e-8;
+                    const int maxIterations = 100;
 
-                std::vector<double> X(iNview * 3, 0.0);
-                if (!translationAveraging::solve_translations_problem_l2_chordal(&vecEdges[0],
-                                                                                 &vecPoses[0],
-                                                                                 &vecWeights[0],
-                                                                                 vecInitialRijTijEstimatesCpy.size(),
-                                                                                 lossWidth,
-                                                                                 &X[0],
-                                                                                 functionTolerance,
-                                                                                 parameterTolerance,
-                                                                                 maxIterations))
+                    solved = translationAveraging::solve_translations_problem_bata(
+                      &vecEdges[0], &vecPoses[0], &vecWeights[0], vecInitialRijTijEstimatesCpy.size(), lossWidth, &X[0], tolerance, maxIterations);
+                }
+                else
+                {
+                    const double functionTolerance = 1e-7, parameterTolerance = 1e-8;
+                    const int maxIterations = 500;
+
+                    const double lossWidth = 0.0;  // No loss in order to compare with TRANSLATION_AVERAGING_L1
+
+                    solved = translationAveraging::solve_translations_problem_l2_chordal(&vecEdges[0],
+                                                                                         &vecPoses[0],
+                                                                                         &vecWeights[0],
+                                                                                         vecInitialRijTijEstimatesCpy.size(),
+                                                                                         lossWidth,
+                                                                                         &X[0],
+                                                                                         functionTolerance,
+                                                                                         parameterTolerance,
+                                                                                         maxIterations);
+                }
+
+                if (!solved)
                 {
                     ALICEVISION_LOG_WARNING("Compute global translations: failed");
                     return false;
@@ -288,6 +311,55 @@ void GlobalSfMTranslationAveragingSolver::computeTranslations(const SfMData& sfm
       sfmData, mapGlobalR, normalizedFeaturesPerView, pairwiseMatches, randomNumberGenerator, m_vec_initialRijTijEstimates, tripletWiseMatches);
 }
 
+namespace {
+
+/// pairwise matches of the views grouped by pair of distinct pose ids (ordered)
+using MatchesPerPosePair = std::map<Pair, std::vector<const matching::PairwiseMatches::value_type*>>;
+
+/**
+ * @brief Group the pairwise matches by pair of poses supported by the rotation graph
+ * @param[in] sfmData The input SfMData with the views
+ * @param[in] pairwiseMatches The pairwise matches of the views
+ * @param[in] poseIds The pose ids of the rotation graph
+ * @return the pairwise matches per pair of poses
+ */
+MatchesPerPosePair getMatchesPerPosePair(const SfMData& sfmData, const matching::PairwiseMatches& pairwiseMatches, const std::set<IndexT>& poseIds)
+{
+    MatchesPerPosePair matchesPerPosePair;
+    for (const auto& matchIterator : pairwiseMatches)
+    {
+        const IndexT poseI = sfmData.getViews().at(matchIterator.first.first)->getPoseId();
+        const IndexT poseJ = sfmData.getViews().at(matchIterator.first.second)->getPoseId();
+        if (poseI != poseJ && poseIds.count(poseI) && poseIds.count(poseJ))
+        {
+            matchesPerPosePair[std::minmax(poseI, poseJ)].push_back(&matchIterator);
+        }
+    }
+    return matchesPerPosePair;
+}
+
+/**
+ * @brief List the pairwise matches shared by the poses of a triplet
+ * @param[in] triplet The triplet of pose ids
+ * @param[in] matchesPerPosePair The pairwise matches per pair of poses
+ * @return the pairwise matches of the triplet
+ */
+matching::PairwiseMatches getTripletMatches(const graph::Triplet& triplet, const MatchesPerPosePair& matchesPerPosePair)
+{
+    matching::PairwiseMatches tripletMatches;
+    for (const Pair& posePair : {std::minmax(triplet.i, triplet.j), std::minmax(triplet.i, triplet.k), std::minmax(triplet.j, triplet.k)})
+    {
+        const auto it = matchesPerPosePair.find(posePair);
+        if (it == matchesPerPosePair.end())
+            continue;
+        for (const matching::PairwiseMatches::value_type* matches : it->second)
+            tripletMatches.insert(*matches);
+    }
+    return tripletMatches;
+}
+
+}  // namespace
+
 //-- Perform a trifocal estimation of the graph contained in vec_triplets with an
 // edge coverage algorithm. Its complexity is sub-linear in term of edges count.
 void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverage(const SfMData& sfmData,
@@ -327,42 +399,33 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
     const std::vector<graph::Triplet> vecTriplets = graph::tripletListing(rotationPoseIdGraph);
     ALICEVISION_LOG_DEBUG("#Triplets: " << vecTriplets.size());
 
+    // Index the matches per pair of poses once, instead of scanning all the pairwise matches for each triplet
+    const MatchesPerPosePair matchesPerPosePair = getMatchesPerPosePair(sfmData, pairwiseMatches, setPoseIds);
+
+    // Each triplet estimation uses its own random number generator seeded from the triplet index,
+    // so the result does not depend on the scheduling of the threads
+    const std::mt19937::result_type tripletSeed = randomNumberGenerator();
+
     {
         // Compute triplets of translations
         // Avoid to cover each edge of the graph by using an edge coverage algorithm
         // An estimated triplets of translation mark three edges as estimated.
 
         //-- precompute the number of track per triplet:
-        HashMap<IndexT, IndexT> mapTracksPerTriplets;
+        std::vector<std::size_t> vecTracksPerTriplets(vecTriplets.size(), 0);
 
 #pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < (int)vecTriplets.size(); ++i)
         {
             // List matches that belong to the triplet of poses
-            const graph::Triplet& triplet = vecTriplets[i];
-            matching::PairwiseMatches mapTripletMatches;
-            const std::set<IndexT> setTripletPoseIds = {triplet.i, triplet.j, triplet.k};
-            // List shared correspondences (pairs) between the triplet poses
-            for (const auto& matchIterator : pairwiseMatches)
-            {
-                const Pair pair = matchIterator.first;
-                const View* v1 = sfmData.getViews().at(pair.first).get();
-                const View* v2 = sfmData.getViews().at(pair.second).get();
-                if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-                  (v1->getPoseId() != v2->getPoseId()) && setTripletPoseIds.count(v1->getPoseId()) && setTripletPoseIds.count(v2->getPoseId()))
-                {
-                    mapTripletMatches.insert(matchIterator);
-                }
-            }
+            const matching::PairwiseMatches mapTripletMatches = getTripletMatches(vecTriplets[i], matchesPerPosePair);
+
             // Compute tracks:
-            {
-                aliceVision::track::TracksBuilder tracksBuilder;
-                tracksBuilder.build(mapTripletMatches);
-                tracksBuilder.filter(true, 3);
+            aliceVision::track::TracksBuilder tracksBuilder;
+            tracksBuilder.build(mapTripletMatches);
+            tracksBuilder.filter(true, 3);
 
-#pragma omp critical
-                mapTracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
-            }
+            vecTracksPerTriplets[i] = tracksBuilder.nbTracks();  // count the # of matches in the UF tree
         }
 
         typedef Pair myEdge;
@@ -388,6 +451,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
 
         // set number of threads, 1 if openMP is not enabled
         std::vector<translationAveraging::RelativeInfoVec> initialEstimates(omp_get_max_threads());
+        std::vector<matching::PairwiseMatches> newPairMatchesPerThread(omp_get_max_threads());
         const bool bVerbose = false;
 
 #pragma omp parallel for schedule(dynamic)
@@ -404,7 +468,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                 std::vector<size_t> vecCommonTracksPerTriplets;
                 for (const size_t tripletIndex : vecPossibleTripletIndexes)
                 {
-                    vecCommonTracksPerTriplets.push_back(mapTracksPerTriplets[tripletIndex]);
+                    vecCommonTracksPerTriplets.push_back(vecTracksPerTriplets[tripletIndex]);
                 }
 
                 using namespace stl::indexed_sort;
@@ -439,12 +503,13 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                     aliceVision::track::TracksMap poseTripletTracks;
 
                     const std::string sOutDirectory = "./";
+                    std::mt19937 tripletRandomNumberGenerator(tripletSeed + static_cast<std::mt19937::result_type>(tripletIndex));
                     const bool bTripletEstimation = estimateTTriplet(sfmData,
                                                                      mapGlobalR,
                                                                      normalizedFeaturesPerView,
-                                                                     pairwiseMatches,
+                                                                     getTripletMatches(triplet, matchesPerPosePair),
                                                                      triplet,
-                                                                     randomNumberGenerator,
+                                                                     tripletRandomNumberGenerator,
                                                                      vecTis,
                                                                      dPrecision,
                                                                      vecInliers,
@@ -482,9 +547,9 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                             initialEstimates[threadId].emplace_back(std::make_pair(triplet.j, triplet.k), std::make_pair(Rjk, tjk));
                             initialEstimates[threadId].emplace_back(std::make_pair(triplet.i, triplet.k), std::make_pair(Rik, tik));
 
-//--- ATOMIC
-#pragma omp critical
                             {
+                                matching::PairwiseMatches& newThreadPairMatches = newPairMatchesPerThread[threadId];
+
                                 // Add inliers as valid pairwise matches
                                 for (std::vector<size_t>::const_iterator iterInliers = vecInliers.begin(); iterInliers != vecInliers.end();
                                      ++iterInliers)
@@ -514,7 +579,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                                             const size_t idViewJ = iterJ->first;
                                             const size_t idFeatJ = iterJ->second.featureId;
 
-                                            newpairMatches[std::make_pair(idViewI, idViewJ)][track.descType].emplace_back(idFeatI, idFeatJ);
+                                            newThreadPairMatches[std::make_pair(idViewI, idViewJ)][track.descType].emplace_back(idFeatI, idFeatJ);
                                         }
                                     }
                                 }
@@ -535,6 +600,17 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
                 vecInitialEstimates.emplace_back(val);
             }
         }
+        for (const matching::PairwiseMatches& threadPairMatches : newPairMatchesPerThread)
+        {
+            for (const auto& pairMatches : threadPairMatches)
+            {
+                for (const auto& descMatches : pairMatches.second)
+                {
+                    matching::IndMatches& matches = newpairMatches[pairMatches.first][descMatches.first];
+                    matches.insert(matches.end(), descMatches.second.begin(), descMatches.second.end());
+                }
+            }
+        }
     }
 
     const double timeLPTriplet = timerLPTriplet.elapsed();
@@ -557,7 +633,7 @@ void GlobalSfMTranslationAveragingSolver::computePutativeTranslationEdgesCoverag
 bool GlobalSfMTranslationAveragingSolver::estimateTTriplet(const SfMData& sfmData,
                                                            const HashMap<IndexT, Mat3>& mapGlobalR,
                                                            const feature::FeaturesPerView& normalizedFeaturesPerView,
-                                                           const matching::PairwiseMatches& pairwiseMatches,
+                                                           const matching::PairwiseMatches& tripletMatches,
                                                            const graph::Triplet& posesId,
                                                            std::mt19937& randomNumberGenerator,
                                                            std::vector<Vec3>& vecTis,
@@ -566,24 +642,8 @@ bool GlobalSfMTranslationAveragingSolver::estimateTTriplet(const SfMData& sfmDat
                                                            aliceVision::track::TracksMap& tracks,
                                                            const std::string& outDirectory) const
 {
-    // List matches that belong to the triplet of poses
-    matching::PairwiseMatches mapTripletMatches;
-    const std::set<IndexT> setPoseIds = {posesId.i, posesId.j, posesId.k};
-    // List shared correspondences (pairs) between poses
-    for (const auto& matchIterator : pairwiseMatches)
-    {
-        const Pair& pair = matchIterator.first;
-        const View* v1 = sfmData.getViews().at(pair.first).get();
-        const View* v2 = sfmData.getViews().at(pair.second).get();
-        if (  // Consider the pair iff it is supported by the triplet graph & 2 different pose id
-          (v1->getPoseId() != v2->getPoseId()) && setPoseIds.count(v1->getPoseId()) && setPoseIds.count(v2->getPoseId()))
-        {
-            mapTripletMatches.insert(matchIterator);
-        }
-    }
-
     aliceVision::track::TracksBuilder tracksBuilder;
-    tracksBuilder.build(mapTripletMatches);
+    tracksBuilder.build(tripletMatches);
     tracksBuilder.filter(true, 3);
     tracksBuilder.exportToSTL(tracks);
 
@@ -666,7 +726,7 @@ bool GlobalSfMTranslationAveragingSolver::estimateTTriplet(const SfMData& sfmDat
     tinyScene.poses[posesId.k] = Pose3(vecGlobalRTriplet[2], -vecGlobalRTriplet[2].transpose() * vecTis[2]);
 
     // insert views used by the relative pose pairs
-    for (const auto& pairIterator : mapTripletMatches)
+    for (const auto& pairIterator : tripletMatches)
     {
         // initialize camera indexes
         const IndexT I = pairIterator.first.first;
@@ -21,7 +21,8 @@ enum ETranslationAveragingMethod
 {
     TRANSLATION_AVERAGING_L1 = 1,
     TRANSLATION_AVERAGING_L2_DISTANCE_CHORDAL = 2,
-    TRANSLATION_AVERAGING_SOFTL1 = 3
+    TRANSLATION_AVERAGING_SOFTL1 = 3,
+    TRANSLATION_AVERAGING_BATA = 4
 };
 
 inline std::string ETranslationAveragingMethod_enumToString(ETranslationAveragingMethod eTranslationAveragingMethod)
@@ -34,6 +35,8 @@ inline std::string ETranslationAveragingMethod_enumToString(ETranslationAveragin
             return "L2_minimization";
         case ETranslationAveragingMethod::TRANSLATION_AVERAGING_SOFTL1:
             return "L1_soft_minimization";
+        case ETranslationAveragingMethod::TRANSLATION_AVERAGING_BATA:
+            return "BATA_minimization";
     }
     throw std::out_of_range("Invalid translation averaging method type");
 }
@@ -46,6 +49,8 @@ inline ETranslationAveragingMethod ETranslationAveragingMethod_stringToEnum(cons
         return ETranslationAveragingMethod::TRANSLATION_AVERAGING_L2_DISTANCE_CHORDAL;
     if (TranslationAveragingMethodName == "L1_soft_minimization")
         return ETranslationAveragingMethod::TRANSLATION_AVERAGING_SOFTL1;
+    if (TranslationAveragingMethodName == "BATA_minimization")
+        return ETranslationAveragingMethod::TRANSLATION_AVERAGING_BATA;
 
     throw std::out_of_range("Invalid translation averaging method name : '" + TranslationAveragingMethodName + "'");
 }
@@ -104,11 +109,12 @@ class GlobalSfMTranslationAveragingSolver
 
     /**
      * @brief Robust estimation and refinement of a translation and 3D points of an image triplets.
+     * @note tripletMatches only contains the pairwise matches between the views of the triplet poses.
      */
     bool estimateTTriplet(const sfmData::SfMData& sfmData,
                           const HashMap<IndexT, Mat3>& mapGlobalR,
                           const feature::FeaturesPerView& normalizedFeaturesPerView,
-                          const matching::PairwiseMatches& pairwiseMatches,
+                          const matching::PairwiseMatches& tripletMatches,
                           const graph::Triplet& posesId,
                           std::mt19937& randomNumberGenerator,
                           std::vector<Vec3>& vecTis,
@@ -14,6 +14,7 @@
 #include <cmath>
 #include <cstdio>
 #include <iostream>
+#include <sstream>
 
 #define BOOST_TEST_MODULE GLOBAL_SFM
 
@@ -229,3 +230,58 @@ BOOST_AUTO_TEST_CASE(GLOBAL_SFM_RotationAveragingL2_TranslationAveragingSoftL1)
     BOOST_CHECK(sfmEngine.getSfMData().getPoses().size() == nviews);
     BOOST_CHECK(sfmEngine.getSfMData().getLandmarks().size() == npoints);
 }
+
+BOOST_AUTO_TEST_CASE(GLOBAL_SFM_RotationAveragingL2_TranslationAveragingBATA)
+{
+    makeRandomOperationsReproducible();
+
+    const int nviews = 6;
+    const int npoints = 64;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    const SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    // Remove poses and structure
+    SfMData sfmData2 = sfmData;
+    sfmData2.getPoses().clear();
+    sfmData2.getLandmarks().clear();
+
+    ReconstructionEngine_globalSfM sfmEngine(sfmData2, "./", "./Reconstruction_Report.html");
+
+    // Add a tiny noise in 2D observations to make data more realistic
+    std::normal_distribution<double> distribution(0.0, 0.5);
+
+    // Configure the featuresPerView & the matches_provider from the synthetic dataset
+    feature::FeaturesPerView featuresPerView;
+    generateSyntheticFeatures(featuresPerView, feature::EImageDescriberType::UNKNOWN, sfmData, distribution);
+
+    matching::PairwiseMatches pairwiseMatches;
+    generateSyntheticMatches(pairwiseMatches, sfmData, feature::EImageDescriberType::UNKNOWN);
+
+    // Configure data provider (Features and Matches)
+    sfmEngine.setFeaturesProvider(&featuresPerView);
+    sfmEngine.setMatchesProvider(&pairwiseMatches);
+
+    // Configure reconstruction parameters
+    sfmEngine.setLockAllIntrinsics(true);
+
+    // Configure motion averaging method
+    // select the translation averaging method from its name, as the command line does
+    ETranslationAveragingMethod translationAveragingMethod = TRANSLATION_AVERAGING_SOFTL1;
+    std::istringstream("BATA_minimization") >> translationAveragingMethod;
+    BOOST_CHECK_EQUAL(translationAveragingMethod, TRANSLATION_AVERAGING_BATA);
+    BOOST_CHECK_NO_THROW(ETranslationAveragingMethod_enumToString(translationAveragingMethod));
+
+    sfmEngine.setRotationAveragingMethod(ROTATION_AVERAGING_L2);
+    sfmEngine.setTranslationAveragingMethod(translationAveragingMethod);
+
+    BOOST_CHECK(sfmEngine.process());
+
+    const double residual = RMSE(sfmEngine.getSfMData());
+    ALICEVISION_LOG_DEBUG("RMSE residual: " << residual);
+    BOOST_CHECK(residual < 0.5);
+    BOOST_CHECK(sfmEngine.getSfMData().getPoses().size() == nviews);
+    BOOST_CHECK(sfmEngine.getSfMData().getLandmarks().size() == npoints);
+}
@@ -58,7 +58,8 @@ bool SfMLocalizer::localize(const Pair& imageSize,
         // robust estimation of the Projection matrix and its precision
         robustEstimation::Mat34Model model;
         const std::pair<double, double> ACRansacOut =
-          robustEstimation::ACRANSAC(kernel, randomNumberGenerator, resectionData.vec_inliers, resectionData.max_iteration, &model, precision);
+          robustEstimation::ACRANSAC(
+            kernel, randomNumberGenerator, resectionData.vec_inliers, resectionData.max_iteration, &model, precision, resectionData.nbThreads);
         P = model.getMatrix();
         // update the upper bound precision of the model found by AC-RANSAC
         resectionData.error_max = ACRansacOut.first;
@@ -97,7 +98,7 @@ bool SfMLocalizer::localize(const Pair& imageSize,
                 // robust estimation of the Projection matrix and its precision
                 robustEstimation::Mat34Model model;
                 const std::pair<double, double> ACRansacOut = robustEstimation::ACRANSAC(
-                  kernel, randomNumberGenerator, resectionData.vec_inliers, resectionData.max_iteration, &model, precision);
+                  kernel, randomNumberGenerator, resectionData.vec_inliers, resectionData.max_iteration, &model, precision, resectionData.nbThreads);
 
                 P = model.getMatrix();
 
@@ -139,10 +140,20 @@ bool SfMLocalizer::localize(const Pair& imageSize,
                 // @todo refactor, maybe move scorer directly inside the kernel
                 const double threshold =
                   resectionData.error_max * resectionData.error_max * (kernel.thresholdNormalizer() * kernel.thresholdNormalizer());
-                robustEstimation::ScoreEvaluator<KernelT> scorer(threshold);
+                robustEstimation::Mat34Model model;
 
-                const robustEstimation::Mat34Model model =
-                  robustEstimation::LO_RANSAC(kernel, scorer, randomNumberGenerator, &resectionData.vec_inliers);
+                if (resectionData.useSPRT)
+                {
+                    const robustEstimation::SPRTScoreEvaluator<KernelT> scorer(threshold);
+                    model = robustEstimation::LO_RANSAC(
+                      kernel, scorer, randomNumberGenerator, &resectionData.vec_inliers, nullptr, false, 100, 1e-2, resectionData.nbThreads);
+                }
+                else
+                {
+                    const robustEstimation::ScoreEvaluator<KernelT> scorer(threshold);
+                    model = robustEstimation::LO_RANSAC(
+                      kernel, scorer, randomNumberGenerator, &resectionData.vec_inliers, nullptr, false, 100, 1e-2, resectionData.nbThreads);
+                }
                 P = model.getMatrix();
 
                 break;
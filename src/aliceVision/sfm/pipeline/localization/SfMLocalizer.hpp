@@ -42,6 +42,10 @@ struct ImageLocalizerMatchData
     /// Upper bound pixel(s) tolerance for residual errors
     double error_max = std::numeric_limits<double>::infinity();
     size_t max_iteration = 4096;
+    /// Number of threads evaluating the robust estimation hypotheses (1: sequential, 0: all the available cores)
+    std::size_t nbThreads = 1;
+    /// Stop the scoring of the bad hypotheses early with a SPRT (LORANSAC only)
+    bool useSPRT = false;
 };
 
 class SfMLocalizer
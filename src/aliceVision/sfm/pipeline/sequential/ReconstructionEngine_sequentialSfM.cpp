@@ -10,6 +10,7 @@
 #include <aliceVision/sfm/utils/statistics.hpp>
 #include <aliceVision/sfmDataIO/sfmDataIO.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentCeres.hpp>
+#include <aliceVision/sfm/bundle/BundleAdjustmentPartitioned.hpp>
 #include <aliceVision/sfm/bundle/BundleAdjustmentSymbolicCeres.hpp>
 #include <aliceVision/sfm/sfmFilters.hpp>
 #include <aliceVision/sfm/sfmStatistics.hpp>
@@ -23,6 +24,7 @@
 #include <aliceVision/multiview/triangulation/NViewsTriangulationLORansac.hpp>
 #include <aliceVision/robustEstimation/LORansac.hpp>
 #include <aliceVision/robustEstimation/ScoreEvaluator.hpp>
+#include <aliceVision/stl/parallelFor.hpp>
 #include <aliceVision/stl/stl.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
 #include <aliceVision/system/Timer.hpp>
@@ -235,9 +237,11 @@ void ReconstructionEngine_sequentialSfM::initializePyramidScoring()
     {
         _pyramidWeights.resize(_params.pyramidDepth);
         std::size_t maxWeight = 0;
+        _nbPyramidCells = 0;
         for (std::size_t level = 0; level < _params.pyramidDepth; ++level)
         {
             std::size_t nbCells = Square(std::pow(_params.pyramidBase, level + 1));
+            _nbPyramidCells += nbCells;
             // We use a different weighting strategy than [Schonberger 2016].
             // They use w = 2^l with l={1...L} (even if there is a typo in the text where they say to use w=2^{2*l}.
             // We prefer to give more importance to the first levels of the pyramid, so:
@@ -452,12 +456,56 @@ void ReconstructionEngine_sequentialSfM::remapLandmarkIdsToTrackIds()
         }
     }
 
+    // all the remapped landmarks are new in the next best view index
+    for (const auto& landmarkPair : _sfmData.getLandmarks())
+        _changedTrackIds.insert(landmarkPair.first);
+
     ALICEVISION_LOG_INFO("Landmark ids to track ids remapping: " << std::endl
                                                                  << "\t- # tracks: " << _map_tracks.size() << std::endl
                                                                  << "\t- # input landmarks: " << landmarks.size() << std::endl
                                                                  << "\t- # output landmarks: " << _sfmData.getLandmarks().size());
 }
 
+namespace {
+
+/**
+ * @brief Time spent in each step of a resection group of the incremental reconstruction (in seconds)
+ */
+struct ResectionGroupTimes
+{
+    double nextBestViews = 0.0;
+    double resection = 0.0;
+    double triangulation = 0.0;
+    double bundleAdjustment = 0.0;
+
+    ResectionGroupTimes& operator+=(const ResectionGroupTimes& other)
+    {
+        nextBestViews += other.nextBestViews;
+        resection += other.resection;
+        triangulation += other.triangulation;
+        bundleAdjustment += other.bundleAdjustment;
+        return *this;
+    }
+};
+
+/**
+ * @brief Log the timing breakdown of a resection group and accumulate it
+ * @param[in] groupTimes The times of the resection group
+ * @param[in,out] totalTimes The times of the whole reconstruction
+ */
+void logResectionGroupTimes(const ResectionGroupTimes& groupTimes, ResectionGroupTimes& totalTimes)
+{
+    totalTimes += groupTimes;
+
+    ALICEVISION_LOG_INFO("Resection group timing breakdown:" << std::endl
+                                                             << "\t- next best views: " << groupTimes.nextBestViews << " s" << std::endl
+                                                             << "\t- resection: " << groupTimes.resection << " s" << std::endl
+                                                             << "\t- triangulation: " << groupTimes.triangulation << " s" << std::endl
+                                                             << "\t- bundle adjustment: " << groupTimes.bundleAdjustment << " s");
+}
+
+}  // namespace
+
 double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
 {
     // to be visited views
@@ -504,6 +552,7 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
     aliceVision::system::Timer timer;
     std::size_t nbValidPoses = 0;
     std::size_t globalIteration = 0;
+    ResectionGroupTimes totalTimes;
 
     do
     {
@@ -528,9 +577,16 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
         // get set of reconstructed views
         std::set<IndexT> prevReconstructedViews = _sfmData.getValidViews();
 
+        // views resected and triangulated but not yet refined by a bundle adjustment (batched mode)
+        std::set<IndexT> pendingBundleViews;
+
         // compute robust resection of remaining images
+        system::Timer stepTimer;
         while (findNextBestViews(bestViewCandidates, viewsToVisit))
         {
+            ResectionGroupTimes groupTimes;
+            groupTimes.nextBestViews = stepTimer.elapsed();
+
             ALICEVISION_LOG_INFO("Update Reconstruction:" << std::endl
                                                           << "\t- resection id: " << _resectionId << std::endl
                                                           << "\t- # images in the resection group: " << bestViewCandidates.size() << std::endl
@@ -543,9 +599,14 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
             }
 
             // Return the difference between reconstructed views and prevReconstructedViews
+            stepTimer.reset();
             std::set<IndexT> newReconstructedViews = resection(_resectionId, bestViewCandidates, prevReconstructedViews);
+            groupTimes.resection = stepTimer.elapsed();
+
             if (newReconstructedViews.empty())
             {
+                logResectionGroupTimes(groupTimes, totalTimes);
+                stepTimer.reset();
                 continue;
             }
 
@@ -563,22 +624,63 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
                 minimalResectionedViewsForBundle = 1;
             }
 
-            // No bundle if we did not accumulate enough resectionned views
-            if (newReconstructedViews.size() < minimalResectionedViewsForBundle && viewsToVisit.size() > 0)
+            if (_params.useBatchedResection)
             {
-                continue;
+                // Triangulate the new tracks right away: the next resection group uses them
+                stepTimer.reset();
+                triangulate(prevReconstructedViews, newReconstructedViews);
+                groupTimes.triangulation = stepTimer.elapsed();
+
+                prevReconstructedViews = _sfmData.getValidViews();
+                pendingBundleViews.insert(newReconstructedViews.begin(), newReconstructedViews.end());
+
+                // Adaptive bundle adjustment frequency: wait for the reconstruction to grow by a given ratio
+                const std::size_t minimalViewsForBundle = std::max(static_cast<std::size_t>(minimalResectionedViewsForBundle),
+                                                                   static_cast<std::size_t>(_params.bundleAdjustmentGrowthRatio * prevReconstructedViews.size()));
+
+                if (pendingBundleViews.size() >= minimalViewsForBundle || viewsToVisit.empty())
+                {
+                    stepTimer.reset();
+                    bundleAdjustment(pendingBundleViews);
+                    groupTimes.bundleAdjustment = stepTimer.elapsed();
+
+                    prevReconstructedViews = _sfmData.getValidViews();
+
+                    // Compute the connected views to inform we have new information !
+                    registerChanges(linkedViewIds, pendingBundleViews);
+                    std::set_union(
+                      potentials.begin(), potentials.end(), linkedViewIds.begin(), linkedViewIds.end(), std::inserter(potentials, potentials.end()));
+                    pendingBundleViews.clear();
+                }
             }
+            else
+            {
+                // No bundle if we did not accumulate enough resectionned views
+                if (newReconstructedViews.size() < minimalResectionedViewsForBundle && viewsToVisit.size() > 0)
+                {
+                    logResectionGroupTimes(groupTimes, totalTimes);
+                    stepTimer.reset();
+                    continue;
+                }
 
-            triangulate(prevReconstructedViews, newReconstructedViews);
-            bundleAdjustment(newReconstructedViews);
+                stepTimer.reset();
+                triangulate(prevReconstructedViews, newReconstructedViews);
+                groupTimes.triangulation = stepTimer.elapsed();
 
-            // Only update prevReconstructedViews after the resectioned views have been refined
-            prevReconstructedViews = _sfmData.getValidViews();
+                stepTimer.reset();
+                bundleAdjustment(newReconstructedViews);
+                groupTimes.bundleAdjustment = stepTimer.elapsed();
 
-            // Compute the connected views to inform we have new information !
-            registerChanges(linkedViewIds, newReconstructedViews);
-            std::set_union(
-              potentials.begin(), potentials.end(), linkedViewIds.begin(), linkedViewIds.end(), std::inserter(potentials, potentials.end()));
+                // Only update prevReconstructedViews after the resectioned views have been refined
+                prevReconstructedViews = _sfmData.getValidViews();
+
+                // Compute the connected views to inform we have new information !
+                registerChanges(linkedViewIds, newReconstructedViews);
+                std::set_union(
+                  potentials.begin(), potentials.end(), linkedViewIds.begin(), linkedViewIds.end(), std::inserter(potentials, potentials.end()));
+            }
+
+            logResectionGroupTimes(groupTimes, totalTimes);
 
             // scene logging for visual debug
             if (_params.logIntermediateSteps && (_resectionId % 3) == 0)
@@ -594,6 +696,21 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
             }
 
             ++_resectionId;
+            stepTimer.reset();
+        }
+
+        // Refine the views resected since the last bundle adjustment (batched mode)
+        if (!pendingBundleViews.empty())
+        {
+            ResectionGroupTimes groupTimes;
+            stepTimer.reset();
+            bundleAdjustment(pendingBundleViews);
+            groupTimes.bundleAdjustment = stepTimer.elapsed();
+            logResectionGroupTimes(groupTimes, totalTimes);
+
+            registerChanges(linkedViewIds, pendingBundleViews);
+            std::set_union(
+              potentials.begin(), potentials.end(), linkedViewIds.begin(), linkedViewIds.end(), std::inserter(potentials, potentials.end()));
         }
 
         if (_params.rig.useRigConstraint && !_sfmData.getRigs().empty())
@@ -627,7 +744,16 @@ double ReconstructionEngine_sequentialSfM::incrementalReconstruction()
                                                                       << "\t- # number of resection groups: " << _resectionId << std::endl
                                                                       << "\t- # number of poses: " << nbValidPoses << std::endl
                                                                       << "\t- # number of landmarks: " << _sfmData.getLandmarks().size()
-                                                                      << std::endl);
+                                                                      << std::endl
+                                                                      << "\t- next best views time: " << totalTimes.nextBestViews << " s" << std::endl
+                                                                      << "\t- resection time: " << totalTimes.resection << " s" << std::endl
+                                                                      << "\t- triangulation time: " << totalTimes.triangulation << " s" << std::endl
+                                                                      << "\t- bundle adjustment time: " << totalTimes.bundleAdjustment << " s");
+
+    _jsonLogTree.put("sfm.timing.nextBestViews", totalTimes.nextBestViews);
+    _jsonLogTree.put("sfm.timing.resection", totalTimes.resection);
+    _jsonLogTree.put("sfm.timing.triangulation", totalTimes.triangulation);
+    _jsonLogTree.put("sfm.timing.bundleAdjustment", totalTimes.bundleAdjustment);
 
     return timer.elapsed();
 }
@@ -638,8 +764,19 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
 {
     auto chrono_start = std::chrono::steady_clock::now();
 
-    // add images to the 3D reconstruction
-#pragma omp parallel for
+    // the resections use the reconstructed tracks of the next best view index
+    updateReconstructedTracksIndex();
+
+    // draw the seeds of the robust estimations sequentially, the resections do not share the random number generator
+    std::vector<std::mt19937::result_type> seeds(bestViewIds.size());
+    for (std::mt19937::result_type& seed : seeds)
+        seed = _randomNumberGenerator();
+
+    std::vector<ResectionData> resectionsData(bestViewIds.size());
+    std::vector<char> hasResected(bestViewIds.size(), 0);
+
+    // compute the resections, the scene is only read
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < bestViewIds.size(); ++i)
     {
         const IndexT viewId = bestViewIds.at(i);
@@ -676,23 +813,28 @@ std::set<IndexT> ReconstructionEngine_sequentialSfM::resection(IndexT resectionI
             }
         }
 
-        ResectionData newResectionData;
-        newResectionData.error_max = _params.localizerEstimatorError;
-        newResectionData.max_iteration = _params.localizerEstimatorMaxIterations;
-        const bool hasResected = computeResection(viewId, newResectionData);
+        ResectionData& resectionData = resectionsData[i];
+        resectionData.error_max = _params.localizerEstimatorError;
+        resectionData.max_iteration = _params.localizerEstimatorMaxIterations;
 
-#pragma omp critical
+        std::mt19937 randomNumberGenerator(seeds[i]);
+        hasResected[i] = computeResection(viewId, randomNumberGenerator, resectionData);
+    }
+
+    // add images to the 3D reconstruction, in the order of the resection group
+    for (int i = 0; i < bestViewIds.size(); ++i)
+    {
+        const IndexT viewId = bestViewIds.at(i);
+
+        if (hasResected[i])
         {
-            if (hasResected)
-            {
-                updateScene(viewId, newResectionData);
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
-                _sfmData.getViews().at(viewId)->setResectionId(resectionId);
-            }
-            else
-            {
-                ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
-            }
+            updateScene(viewId, resectionsData[i]);
+            ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) succeed.");
+            _sfmData.getViews().at(viewId)->setResectionId(resectionId);
+        }
+        else
+        {
+            ALICEVISION_LOG_DEBUG("Resection of image " << i << " ( view id: " << viewId << " ) was not possible.");
         }
     }
 
@@ -720,6 +862,9 @@ void ReconstructionEngine_sequentialSfM::triangulate(const std::set<IndexT>& pre
 {
     auto chrono_start = std::chrono::steady_clock::now();
 
+    // the triangulation only adds or removes the landmarks of the tracks seen by the new views
+    registerChangedTracks(newReconstructedViews);
+
     // allow to use to the old triangulatation algorithm (using 2 views only)
     if (_params.minNbObservationsForTriangulation == 0)
         triangulate2Views(_sfmData, prevReconstructedViews, newReconstructedViews);
@@ -738,6 +883,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
     auto chronoStart = std::chrono::steady_clock::now();
 
     BundleAdjustmentCeres::CeresOptions options;
+    options.minNbCamerasForIterativeBA = _params.minNbCamerasForIterativeBA;
     BundleAdjustment::ERefineOptions refineOptions =
       BundleAdjustment::REFINE_ROTATION | BundleAdjustment::REFINE_TRANSLATION | BundleAdjustment::REFINE_STRUCTURE;
 
@@ -794,6 +940,15 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
 
     BundleAdjustmentCeres BA(options, _params.minNbCamerasToRefinePrincipalPoint);
 
+    // the global adjustment of large scenes is split into clusters of poses
+    const bool usePartitionedBA = !enableLocalStrategy && _params.bundleAdjustmentPartitionSize > 0 &&
+                                  _sfmData.getPoses().size() > _params.bundleAdjustmentPartitionSize;
+
+    BundleAdjustmentPartitioned::PartitionedOptions partitionedOptions;
+    partitionedOptions.maxNbPosesPerCluster = _params.bundleAdjustmentPartitionSize;
+    partitionedOptions.minNbMatchesPerEdge = _params.kMinNbOfMatches;
+    BundleAdjustmentPartitioned partitionedBA(options, partitionedOptions, _params.minNbCamerasToRefinePrincipalPoint);
+
     // give the local strategy graph is local strategy is enable
     if (!enableLocalStrategy)
     {
@@ -808,7 +963,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
 
         // bundle adjustment iteration
         {
-            const bool success = BA.adjust(_sfmData, refineOptions);
+            const bool success = usePartitionedBA ? partitionedBA.adjust(_sfmData, refineOptions) : BA.adjust(_sfmData, refineOptions);
 
             if (!success)
                 return false;  // not usable solution
@@ -818,7 +973,7 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
                 _localStrategyGraph->saveIntrinsicsToHistory(_sfmData);
 
             // export and print information about the refinement
-            const BundleAdjustmentCeres::Statistics& statistics = BA.getStatistics();
+            const BundleAdjustmentCeres::Statistics& statistics = usePartitionedBA ? partitionedBA.getStatistics() : BA.getStatistics();
             statistics.exportToFile(_outputFolder, "bundle_adjustment.csv");
             statistics.show();
         }
@@ -826,7 +981,8 @@ bool ReconstructionEngine_sequentialSfM::bundleAdjustment(std::set<IndexT>& newR
         nbOutliers = removeOutliers();
 
         std::set<IndexT> removedViewsIdIteration;
-        eraseUnstablePosesAndObservations(this->_sfmData, _params.minPointsPerPose, _params.minTrackLength, &removedViewsIdIteration);
+        eraseUnstablePosesAndObservations(
+          this->_sfmData, _params.minPointsPerPose, _params.minTrackLength, &removedViewsIdIteration, &_changedTrackIds);
 
         for (IndexT v : removedViewsIdIteration)
             newReconstructedViews.erase(v);
@@ -995,21 +1151,13 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
     if (remainingViewIds.empty() || _sfmData.getLandmarks().empty())
         return false;
 
-    // Collect tracksIds
-    std::set<size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
+    // Only the views observing the tracks added or removed since the last call are updated
+    updateReconstructedTracksIndex();
 
     const std::set<IndexT> reconstructedIntrinsics = _sfmData.getReconstructedIntrinsics();
 
-#pragma omp parallel for
-    for (int i = 0; i < remainingViewIds.size(); ++i)
+    for (const IndexT viewId : remainingViewIds)
     {
-        std::set<IndexT>::const_iterator iter = remainingViewIds.cbegin();
-        std::advance(iter, i);
-        const IndexT viewId = *iter;
         const IndexT intrinsicId = _sfmData.getViews().at(viewId)->getIntrinsicId();
         const bool isIntrinsicsReconstructed = reconstructedIntrinsics.count(intrinsicId);
 
@@ -1042,22 +1190,21 @@ bool ReconstructionEngine_sequentialSfM::findConnectedViews(std::vector<ViewConn
             }
         }
 
-        // Count the common possible putative point
-        //  with the already 3D reconstructed trackId
-        std::vector<std::size_t> vec_trackIdForResection;
-        vec_trackIdForResection.reserve(set_tracksIds.size());
-        std::set_intersection(set_tracksIds.begin(),
-                              set_tracksIds.end(),
-                              reconstructed_trackId.begin(),
-                              reconstructed_trackId.end(),
-                              std::back_inserter(vec_trackIdForResection));
-        // Compute an image score based on the number of matches to the 3D scene
-        // and the repartition of these features in the image.
-        std::size_t score = computeCandidateImageScore(viewId, vec_trackIdForResection);
-#pragma omp critical
+        // Number of reconstructed tracks visible in the view and image score based on the number
+        // of matches to the 3D scene and the repartition of these features in the image.
+        const auto reconstructedTracksIt = _reconstructedTracksPerView.find(viewId);
+        if (reconstructedTracksIt == _reconstructedTracksPerView.end())
         {
-            out_connectedViews.emplace_back(viewId, vec_trackIdForResection.size(), score, isIntrinsicsReconstructed);
+            out_connectedViews.emplace_back(viewId, 0, 0, isIntrinsicsReconstructed);
+            continue;
         }
+
+#ifdef ALICEVISION_NEXTBESTVIEW_WITHOUT_SCORE
+        const std::size_t score = reconstructedTracksIt->second.nbTracks;
+#else
+        const std::size_t score = reconstructedTracksIt->second.score;
+#endif
+        out_connectedViews.emplace_back(viewId, reconstructedTracksIt->second.nbTracks, score, isIntrinsicsReconstructed);
     }
 
     // Sort by the image score
@@ -1149,10 +1296,20 @@ bool ReconstructionEngine_sequentialSfM::findNextBestViews(std::vector<IndexT>&
         out_selectedViewIds.resize(1);
     }
 
+    // In batched mode, the views of a resection group are resected concurrently
+    if (_params.useBatchedResection)
+    {
+        const std::size_t nbConflictingViews = removeConflictingViews(out_selectedViewIds);
+        if (nbConflictingViews > 0)
+            ALICEVISION_LOG_DEBUG("findNextBestViews: " << nbConflictingViews << " conflicting view(s) postponed to the next resection group.");
+    }
+
     // No more than maxImagesPerGroup cameras should be added at once without performing the bundle adjustment (if set to
     // 0, then there is no limit on the number of views that can be added at once)
-    if (_params.maxImagesPerGroup > 0 && out_selectedViewIds.size() > _params.maxImagesPerGroup)
-        out_selectedViewIds.resize(_params.maxImagesPerGroup);
+    // In batched mode, the new tracks are triangulated after each group so larger groups are allowed.
+    const std::size_t maxImagesPerGroup = _params.useBatchedResection ? _params.maxImagesPerBatch : _params.maxImagesPerGroup;
+    if (maxImagesPerGroup > 0 && out_selectedViewIds.size() > maxImagesPerGroup)
+        out_selectedViewIds.resize(maxImagesPerGroup);
 
     ALICEVISION_LOG_DEBUG("Find next best views took: "
                           << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - chrono_start).count()
@@ -1171,6 +1328,35 @@ bool ReconstructionEngine_sequentialSfM::findNextBestViews(std::vector<IndexT>&
     return (!out_selectedViewIds.empty());
 }
 
+std::size_t ReconstructionEngine_sequentialSfM::removeConflictingViews(std::vector<IndexT>& viewIds) const
+{
+    const std::set<IndexT> reconstructedIntrinsics = _sfmData.getReconstructedIntrinsics();
+    std::set<IndexT> newIntrinsics;
+    std::set<IndexT> sharedPoses;
+
+    const std::size_t nbViews = viewIds.size();
+
+    viewIds.erase(std::remove_if(viewIds.begin(),
+                                 viewIds.end(),
+                                 [&](IndexT viewId) {
+                                     const View& view = _sfmData.getView(viewId);
+
+                                     // the first resection of an intrinsic refines it
+                                     const IndexT intrinsicId = view.getIntrinsicId();
+                                     if (reconstructedIntrinsics.count(intrinsicId) == 0 && !newIntrinsics.insert(intrinsicId).second)
+                                         return true;
+
+                                     // the views of an initialized rig set the same rig pose
+                                     if (!view.isPoseIndependant() && !sharedPoses.insert(view.getPoseId()).second)
+                                         return true;
+
+                                     return false;
+                                 }),
+                  viewIds.end());
+
+    return nbViews - viewIds.size();
+}
+
 bool ReconstructionEngine_sequentialSfM::makeInitialPair3D(const Pair& currentPair)
 {
     // compute robust Essential matrix for ImageId [I,J]
@@ -1255,6 +1441,7 @@ bool ReconstructionEngine_sequentialSfM::makeInitialPair3D(const Pair& currentPa
         // triangulate
         const std::set<IndexT> prevImageIndex = {static_cast<IndexT>(I)};
         const std::set<IndexT> newImageIndex = {static_cast<IndexT>(J)};
+        registerChangedTracks(newImageIndex);
         triangulate2Views(_sfmData, prevImageIndex, newImageIndex);
 
         // refine only structure & rotations & translations (keep intrinsic constant)
@@ -1527,6 +1714,75 @@ std::size_t ReconstructionEngine_sequentialSfM::computeCandidateImageScore(Index
 #endif
 }
 
+void ReconstructionEngine_sequentialSfM::updateReconstructedTracksIndex() const
+{
+    std::size_t nbAddedTracks = 0;
+    std::size_t nbRemovedTracks = 0;
+
+    for (const IndexT trackId : _changedTrackIds)
+    {
+        // the landmarks without track (not remapped) cannot be used by the resection
+        const bool isReconstructed = _sfmData.getLandmarks().count(trackId) > 0 && _map_tracks.count(trackId) > 0;
+
+        if (isReconstructed && _reconstructedTrackIds.insert(trackId).second)
+        {
+            updateReconstructedTrackInIndex(trackId, true);
+            ++nbAddedTracks;
+        }
+        else if (!isReconstructed && _reconstructedTrackIds.erase(trackId) > 0)
+        {
+            updateReconstructedTrackInIndex(trackId, false);
+            ++nbRemovedTracks;
+        }
+    }
+
+    ALICEVISION_LOG_DEBUG("Next best view index update: " << _changedTrackIds.size() << " changed track(s), " << nbAddedTracks << " added track(s), "
+                                                          << nbRemovedTracks << " removed track(s).");
+
+    _changedTrackIds.clear();
+}
+
+void ReconstructionEngine_sequentialSfM::registerChangedTracks(const std::set<IndexT>& viewIds)
+{
+    for (const IndexT viewId : viewIds)
+    {
+        const auto tracksIt = _map_tracksPerView.find(viewId);
+        if (tracksIt != _map_tracksPerView.end())
+            _changedTrackIds.insert(tracksIt->second.begin(), tracksIt->second.end());
+    }
+}
+
+void ReconstructionEngine_sequentialSfM::updateReconstructedTrackInIndex(IndexT trackId, bool isAdded) const
+{
+    const track::Track& track = _map_tracks.at(trackId);
+
+    for (const auto& featView : track.featPerView)
+    {
+        const IndexT viewId = featView.first;
+        const auto& featsPyramid = _map_featsPyramidPerView.at(viewId);
+        ReconstructedTracksInView& reconstructedTracks = _reconstructedTracksPerView[viewId];
+
+        if (reconstructedTracks.nbTracksPerCell.empty())
+            reconstructedTracks.nbTracksPerCell.resize(_nbPyramidCells, 0);
+
+        if (isAdded)
+            ++reconstructedTracks.nbTracks;
+        else
+            --reconstructedTracks.nbTracks;
+
+        // a cell contributes to the score when it contains at least one reconstructed track
+        for (std::size_t level = 0; level < _params.pyramidDepth; ++level)
+        {
+            unsigned int& nbTracksInCell = reconstructedTracks.nbTracksPerCell[featsPyramid.at(trackId * _params.pyramidDepth + level)];
+
+            if (isAdded && nbTracksInCell++ == 0)
+                reconstructedTracks.score += _pyramidWeights[level];
+            else if (!isAdded && --nbTracksInCell == 0)
+                reconstructedTracks.score -= _pyramidWeights[level];
+        }
+    }
+}
+
 /**
  * @brief Add one image to the 3D reconstruction. To the resectioning of
  * the camera.
@@ -1538,25 +1794,18 @@ std::size_t ReconstructionEngine_sequentialSfM::computeCandidateImageScore(Index
  * C. Do the resectioning: compute the camera pose.
  * D. Refine the pose of the found camera
  */
-bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, ResectionData& resectionData)
+bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, std::mt19937& randomNumberGenerator, ResectionData& resectionData)
 {
     // A. Compute 2D/3D matches
     // A1. list tracks ids used by the view
     const aliceVision::track::TrackIdSet& set_tracksIds = _map_tracksPerView.at(viewId);
 
-    // A2. intersects the track list with the reconstructed
-    std::set<std::size_t> reconstructed_trackId;
-    std::transform(_sfmData.getLandmarks().begin(),
-                   _sfmData.getLandmarks().end(),
-                   std::inserter(reconstructed_trackId, reconstructed_trackId.begin()),
-                   stl::RetrieveKey());
-
-    // Get the ids of the already reconstructed tracks
-    std::set_intersection(set_tracksIds.begin(),
-                          set_tracksIds.end(),
-                          reconstructed_trackId.begin(),
-                          reconstructed_trackId.end(),
-                          std::inserter(resectionData.tracksId, resectionData.tracksId.begin()));
+    // A2. intersects the track list with the reconstructed tracks of the next best view index (synchronized by the resection)
+    for (const std::size_t trackId : set_tracksIds)
+    {
+        if (_reconstructedTrackIds.count(trackId))
+            resectionData.tracksId.insert(resectionData.tracksId.end(), trackId);
+    }
 
     if (resectionData.tracksId.empty())
     {
@@ -1599,7 +1848,7 @@ bool ReconstructionEngine_sequentialSfM::computeResection(const IndexT viewId, R
 
     const bool bResection = sfm::SfMLocalizer::localize(Pair(view_I->getImage().getWidth(), view_I->getImage().getHeight()),
                                                         intrinsics.get(),
-                                                        _randomNumberGenerator,
+                                                        randomNumberGenerator,
                                                         resectionData,
                                                         resectionData.pose,
                                                         _params.localizerEstimator);
@@ -1721,38 +1970,25 @@ void ReconstructionEngine_sequentialSfM::getTracksToTriangulate(const std::set<I
     std::set<IndexT> allTracksInNewViews;
     track::getTracksInImagesFast(newReconstructedViews, _map_tracksPerView, allTracksInNewViews);
 
-    std::set<IndexT>::iterator it;
-#pragma omp parallel private(it)
-    {
-        for (it = allTracksInNewViews.begin(); it != allTracksInNewViews.end(); ++it)
-        {
-#pragma omp single nowait
-            {
-                const std::size_t trackId = *it;
-
-                const track::Track& track = _map_tracks.at(trackId);
-
-                std::set<IndexT> allViewsSharingTheTrack;
-                std::transform(track.featPerView.begin(),
-                               track.featPerView.end(),
-                               std::inserter(allViewsSharingTheTrack, allViewsSharingTheTrack.begin()),
-                               stl::RetrieveKey());
-
-                std::set<IndexT> allReconstructedViewsSharingTheTrack;
-                std::set_intersection(allViewsSharingTheTrack.begin(),
-                                      allViewsSharingTheTrack.end(),
-                                      allReconstructedViews.begin(),
-                                      allReconstructedViews.end(),
-                                      std::inserter(allReconstructedViewsSharingTheTrack, allReconstructedViewsSharingTheTrack.begin()));
-
-                if (allReconstructedViewsSharingTheTrack.size() >= _params.minNbObservationsForTriangulation)
-                {
-#pragma omp critical
-                    mapTracksToTriangulate[trackId] = allReconstructedViewsSharingTheTrack;
-                }
-            }
-        }
-    }
+    // each thread collects its tracks in its own buffer
+    using TrackObservations = std::pair<IndexT, std::set<IndexT>>;
+    std::vector<TrackObservations> tracksToTriangulate =
+      parallelForEachCollect<TrackObservations>(allTracksInNewViews, [&](const IndexT trackId, std::vector<TrackObservations>& buffer) {
+          const track::Track& track = _map_tracks.at(trackId);
+
+          std::set<IndexT> allReconstructedViewsSharingTheTrack;
+          for (const auto& featView : track.featPerView)
+          {
+              if (allReconstructedViews.count(featView.first))
+                  allReconstructedViewsSharingTheTrack.insert(allReconstructedViewsSharingTheTrack.end(), featView.first);
+          }
+
+          if (allReconstructedViewsSharingTheTrack.size() >= _params.minNbObservationsForTriangulation)
+              buffer.emplace_back(trackId, std::move(allReconstructedViewsSharingTheTrack));
+      });
+
+    for (TrackObservations& trackObservations : tracksToTriangulate)
+        mapTracksToTriangulate.emplace(trackObservations.first, std::move(trackObservations.second));
 }
 
 namespace {
@@ -1808,7 +2044,19 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
     std::vector<IndexT> setTracksId;  // <trackId>
     std::transform(mapTracksToTriangulate.begin(), mapTracksToTriangulate.end(), std::inserter(setTracksId, setTracksId.begin()), stl::RetrieveKey());
 
-#pragma omp parallel for
+    // the tracks are triangulated in parallel, each with its own random number generator
+    // and output slot, the scene is updated sequentially afterwards
+    enum class ETriangulationStatus : char
+    {
+        SKIPPED,
+        VALID,
+        INVALID
+    };
+    std::vector<ETriangulationStatus> trackStatus(setTracksId.size(), ETriangulationStatus::SKIPPED);
+    std::vector<Landmark> trackLandmarks(setTracksId.size());
+    const std::mt19937::result_type seed = _randomNumberGenerator();
+
+#pragma omp parallel for schedule(dynamic, 256)
     for (int i = 0; i < setTracksId.size(); i++)  // each track (already reconstructed or not)
     {
         const IndexT trackId = setTracksId.at(i);
@@ -1894,7 +2142,8 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
             Vec4 X_homogeneous = Vec4::Zero();
             std::vector<std::size_t> inliersIndex;
 
-            multiview::TriangulateNViewLORANSAC(features, Ps, _randomNumberGenerator, X_homogeneous, &inliersIndex, 8.0);
+            std::mt19937 randomNumberGenerator(seed + trackId);
+            multiview::TriangulateNViewLORANSAC(features, Ps, randomNumberGenerator, X_homogeneous, &inliersIndex, 8.0);
 
             homogeneousToEuclidean(X_homogeneous, X_euclidean);
 
@@ -1914,7 +2163,7 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
         // -- Add the tringulated point to the scene
         if (isValidTrack)
         {
-            Landmark landmark;
+            Landmark& landmark = trackLandmarks[i];
             landmark.X = X_euclidean;
             landmark.descType = track.descType;
             for (const IndexT& viewId : inliers)  // add inliers as observations
@@ -1924,20 +2173,22 @@ void ReconstructionEngine_sequentialSfM::triangulateMultiViewsLORANSAC(SfMData&
                 const double scale = (_params.featureConstraint == EFeatureConstraint::BASIC) ? 0.0 : p.scale();
                 landmark.getObservations()[viewId] = Observation(x, track.featPerView.at(viewId).featureId, scale);
             }
-#pragma omp critical
-            {
-                scene.getLandmarks()[trackId] = landmark;
-            }
+            trackStatus[i] = ETriangulationStatus::VALID;
         }
         else
         {
-#pragma omp critical
-            {
-                if (scene.getLandmarks().find(trackId) != scene.getLandmarks().end())
-                    scene.getLandmarks().erase(trackId);
-            }
+            trackStatus[i] = ETriangulationStatus::INVALID;
         }
     }  // for all shared tracks
+
+    Landmarks& landmarks = scene.getLandmarks();
+    for (std::size_t i = 0; i < setTracksId.size(); ++i)
+    {
+        if (trackStatus[i] == ETriangulationStatus::VALID)
+            landmarks[setTracksId[i]] = std::move(trackLandmarks[i]);
+        else if (trackStatus[i] == ETriangulationStatus::INVALID)
+            landmarks.erase(setTracksId[i]);
+    }
 }
 
 void ReconstructionEngine_sequentialSfM::triangulate2Views(SfMData& scene,
@@ -2121,8 +2372,8 @@ void ReconstructionEngine_sequentialSfM::triangulate2Views(SfMData& scene,
 std::size_t ReconstructionEngine_sequentialSfM::removeOutliers()
 {
     const std::size_t nbOutliersResidualErr =
-      removeOutliersWithPixelResidualError(_sfmData, _params.featureConstraint, _params.maxReprojectionError, 2);
-    const std::size_t nbOutliersAngleErr = removeOutliersWithAngleError(_sfmData, _params.minAngleForLandmark);
+      removeOutliersWithPixelResidualError(_sfmData, _params.featureConstraint, _params.maxReprojectionError, 2, &_changedTrackIds);
+    const std::size_t nbOutliersAngleErr = removeOutliersWithAngleError(_sfmData, _params.minAngleForLandmark, &_changedTrackIds);
 
     ALICEVISION_LOG_INFO("Remove outliers: " << std::endl
                                              << "\t- # outliers residual error: " << nbOutliersResidualErr << std::endl
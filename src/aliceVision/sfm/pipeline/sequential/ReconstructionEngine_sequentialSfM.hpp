@@ -90,11 +90,29 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         /// we don't add too much data in one step without bundle adjustment.
         std::size_t maxImagesPerGroup = 30;
 
+        // Batched resection
+
+        /// Resect larger groups of views for large datasets: the new tracks are triangulated
+        /// after each group and the bundle adjustment is only performed when the reconstruction
+        /// has grown enough since the last one (see bundleAdjustmentGrowthRatio).
+        bool useBatchedResection = false;
+        /// Maximum number of views in a resection group in batched mode (0: no limit)
+        std::size_t maxImagesPerBatch = 200;
+        /// In batched mode, the bundle adjustment is performed when the number of views resected
+        /// since the last one exceeds this ratio of the reconstructed views.
+        double bundleAdjustmentGrowthRatio = 0.1;
+
         /// Threshold for the maximum number of outliers allowed at the end of a BA iteration.
         /// If the limit is not met, another BA iteration is performed.
         /// Using a negative value for this threshold will disable BA iterations.
         int bundleAdjustmentMaxOutliers = 50;
 
+        /// Minimum number of cameras in the bundle adjustment to switch to the iterative Schur solver (0: disabled)
+        std::size_t minNbCamerasForIterativeBA = 0;
+        /// Maximum number of poses per cluster of the partitioned bundle adjustment,
+        /// used for the global bundle adjustments of larger scenes (0: disabled)
+        std::size_t bundleAdjustmentPartitionSize = 0;
+
         // Local Bundle Adjustment data
 
         /// The minimum number of shared matches to create an edge between two views (nodes)
@@ -218,6 +236,32 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
      */
     bool findNextBestViews(std::vector<IndexT>& out_selectedViewIds, const std::set<IndexT>& remainingViewIds) const;
 
+    /**
+     * @brief Compute a score of the view for a subset of features. This is
+     *        used for the next best view choice.
+     *
+     * The score is based on a pyramid which allows to compute a weighting
+     * strategy to promote a good repartition in the image (instead of relying
+     * only on the number of features).
+     * Inspired by [Schonberger 2016]:
+     * "Structure-from-Motion Revisited", Johannes L. Schonberger, Jan-Michael Frahm
+     *
+     * http://people.inf.ethz.ch/jschoenb/papers/schoenberger2016sfm.pdf
+     * We don't use the same weighting strategy. The weighting choice
+     * is not justified in the paper.
+     *
+     * @param[in] viewId: the ID of the view
+     * @param[in] trackIds: set of track IDs contained in viewId
+     * @return the computed score
+     */
+    std::size_t computeCandidateImageScore(IndexT viewId, const std::vector<std::size_t>& trackIds) const;
+
+    /**
+     * @brief Get the putative tracks per view
+     * @return the track IDs of each view
+     */
+    const track::TracksPerView& getTracksPerView() const { return _map_tracksPerView; }
+
   private:
     struct ResectionData : ImageLocalizerMatchData
     {
@@ -229,6 +273,18 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
         geometry::Pose3 pose;
     };
 
+    /**
+     * @brief Remove the views which cannot be resected concurrently with a previous view of the list:
+     * - the views sharing an intrinsic used for the first time (refined by the resection),
+     * - the views sharing a pose (views of an initialized rig).
+     * The removed views are left for the next resection group.
+     * Only used in batched mode (@see Params::useBatchedResection).
+     *
+     * @param[in,out] viewIds: the list of view IDs sorted by priority.
+     * @return the number of removed views.
+     */
+    std::size_t removeConflictingViews(std::vector<IndexT>& viewIds) const;
+
     /**
      * @brief Compute the initial 3D seed (First camera t=0; R=Id, second estimated by 5 point algorithm)
      * @param[in] initialPair
@@ -245,32 +301,34 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     bool getBestInitialImagePairs(std::vector<Pair>& out_bestImagePairs, IndexT filterViewId = UndefinedIndexT);
 
     /**
-     * @brief Compute a score of the view for a subset of features. This is
-     *        used for the next best view choice.
-     *
-     * The score is based on a pyramid which allows to compute a weighting
-     * strategy to promote a good repartition in the image (instead of relying
-     * only on the number of features).
-     * Inspired by [Schonberger 2016]:
-     * "Structure-from-Motion Revisited", Johannes L. Schonberger, Jan-Michael Frahm
-     *
-     * http://people.inf.ethz.ch/jschoenb/papers/schoenberger2016sfm.pdf
-     * We don't use the same weighting strategy. The weighting choice
-     * is not justified in the paper.
-     *
-     * @param[in] viewId: the ID of the view
-     * @param[in] trackIds: set of track IDs contained in viewId
-     * @return the computed score
+     * @brief Synchronize the next best view index with the landmarks of the scene.
+     * Only the tracks registered as changed since the last call are checked (@see registerChangedTracks),
+     * and only the views observing the tracks added or removed are updated, with the same score as computeCandidateImageScore.
+     * @note The landmarks added or removed outside of the reconstruction steps of the engine are not seen by the index.
      */
-    std::size_t computeCandidateImageScore(IndexT viewId, const std::vector<std::size_t>& trackIds) const;
+    void updateReconstructedTracksIndex() const;
+
+    /**
+     * @brief Register the tracks of the given views as possibly added or removed from the landmarks
+     * @param[in] viewIds: the view IDs
+     */
+    void registerChangedTracks(const std::set<IndexT>& viewIds);
+
+    /**
+     * @brief Add or remove a reconstructed track in the next best view index
+     * @param[in] trackId: the track ID
+     * @param[in] isAdded: true if the track has been reconstructed, false if it has been removed
+     */
+    void updateReconstructedTrackInIndex(IndexT trackId, bool isAdded) const;
 
     /**
      * @brief Apply the resection on a single view.
      * @param[in] viewIndex: image index to add to the reconstruction.
+     * @param[in,out] randomNumberGenerator: the random number generator of the robust estimation.
      * @param[out] resectionData: contains the result (P) and all the data used during the resection.
      * @return false if resection failed
      */
-    bool computeResection(const IndexT viewIndex, ResectionData& resectionData);
+    bool computeResection(const IndexT viewIndex, std::mt19937& randomNumberGenerator, ResectionData& resectionData);
 
     /**
      * @brief Update the global scene with the new found camera pose, intrinsic (if not defined) and
@@ -368,6 +426,30 @@ class ReconstructionEngine_sequentialSfM : public ReconstructionEngine
     /// internal cache of precomputed values for the weighting of the pyramid levels
     std::vector<int> _pyramidWeights;
     int _pyramidThreshold;
+    /// total number of cells of the pyramid (all levels)
+    std::size_t _nbPyramidCells = 0;
+
+    // Next best view index
+
+    /**
+     * @brief Reconstructed tracks visible in a view
+     */
+    struct ReconstructedTracksInView
+    {
+        /// number of reconstructed tracks
+        std::size_t nbTracks = 0;
+        /// pyramid score of the reconstructed tracks
+        std::size_t score = 0;
+        /// number of reconstructed tracks in each cell of the pyramid
+        std::vector<unsigned int> nbTracksPerCell;
+    };
+
+    /// Cache of the reconstructed tracks per view, updated incrementally from the landmarks changes
+    mutable HashMap<IndexT, ReconstructedTracksInView> _reconstructedTracksPerView;
+    /// Ids of the reconstructed tracks in the index
+    mutable std::set<IndexT> _reconstructedTrackIds;
+    /// Ids of the tracks possibly added or removed from the landmarks since the last update of the index
+    mutable std::set<IndexT> _changedTrackIds;
 
     // Temporary data
 
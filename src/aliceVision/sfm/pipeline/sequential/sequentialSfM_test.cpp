@@ -180,3 +180,122 @@ BOOST_AUTO_TEST_CASE(SEQUENTIAL_SFM_Known_Rig)
     BOOST_CHECK_EQUAL(sfmEngine.getSfMData().getPoses().size(), nbPoses);
     BOOST_CHECK_EQUAL(sfmEngine.getSfMData().getLandmarks().size(), nbPoints);
 }
+
+// Test the batched resection mode: large resection groups, triangulation after each group
+// and bundle adjustment when the reconstruction has grown enough
+BOOST_AUTO_TEST_CASE(SEQUENTIAL_SFM_Batched_Resection)
+{
+    const int nviews = 16;
+    const int npoints = 256;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    const SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    // Remove poses and structure
+    SfMData sfmData2 = sfmData;
+    sfmData2.getPoses().clear();
+    sfmData2.getLandmarks().clear();
+
+    ReconstructionEngine_sequentialSfM::Params sfmParams;
+    sfmParams.userInitialImagePair = Pair(0, 1);
+    sfmParams.lockAllIntrinsics = true;
+    sfmParams.nbFirstUnstableCameras = 4;
+    sfmParams.useBatchedResection = true;
+    sfmParams.bundleAdjustmentGrowthRatio = 0.5;
+
+    ReconstructionEngine_sequentialSfM sfmEngine(sfmData2, sfmParams, "./", "./Reconstruction_Report.html");
+
+    // Add a tiny noise in 2D observations to make data more realistic
+    std::normal_distribution<double> distribution(0.0, 0.5);
+
+    // Configure the featuresPerView & the matches_provider from the synthetic dataset
+    feature::FeaturesPerView featuresPerView;
+    generateSyntheticFeatures(featuresPerView, feature::EImageDescriberType::UNKNOWN, sfmData, distribution);
+
+    matching::PairwiseMatches pairwiseMatches;
+    generateSyntheticMatches(pairwiseMatches, sfmData, feature::EImageDescriberType::UNKNOWN);
+
+    // Configure data provider (Features and Matches)
+    sfmEngine.setFeatures(&featuresPerView);
+    sfmEngine.setMatches(&pairwiseMatches);
+
+    BOOST_CHECK(sfmEngine.process());
+
+    const double residual = RMSE(sfmEngine.getSfMData());
+    ALICEVISION_LOG_DEBUG("RMSE residual: " << residual);
+    BOOST_CHECK_LT(residual, 0.5);
+    BOOST_CHECK_EQUAL(sfmEngine.getSfMData().getPoses().size(), nviews);
+    BOOST_CHECK_EQUAL(sfmEngine.getSfMData().getLandmarks().size(), npoints);
+}
+
+// Test summary:
+// - Perform Sequential SfM with batched resections, so that the next best view index is updated
+//   from the landmarks added and removed at each step
+// - Assert that the score of each view given by the index is the score computed from all the landmarks
+BOOST_AUTO_TEST_CASE(SEQUENTIAL_SFM_Next_Best_View_Index)
+{
+    const int nviews = 12;
+    const int npoints = 256;
+    const NViewDatasetConfigurator config;
+    const NViewDataSet d = NRealisticCamerasRing(nviews, npoints, config);
+
+    // Translate the input dataset to a SfMData scene
+    const SfMData sfmData = getInputScene(d, config, EINTRINSIC::PINHOLE_CAMERA);
+
+    // Remove poses and structure
+    SfMData sfmData2 = sfmData;
+    sfmData2.getPoses().clear();
+    sfmData2.getLandmarks().clear();
+
+    ReconstructionEngine_sequentialSfM::Params sfmParams;
+    sfmParams.userInitialImagePair = Pair(0, 1);
+    sfmParams.lockAllIntrinsics = true;
+    sfmParams.useBatchedResection = true;
+
+    ReconstructionEngine_sequentialSfM sfmEngine(sfmData2, sfmParams, "./", "./Reconstruction_Report.html");
+
+    // Add a large noise in 2D observations to have outliers removed along the reconstruction
+    std::normal_distribution<double> distribution(0.0, 2.0);
+
+    // Configure the featuresPerView & the matches_provider from the synthetic dataset
+    feature::FeaturesPerView featuresPerView;
+    generateSyntheticFeatures(featuresPerView, feature::EImageDescriberType::UNKNOWN, sfmData, distribution);
+
+    matching::PairwiseMatches pairwiseMatches;
+    generateSyntheticMatches(pairwiseMatches, sfmData, feature::EImageDescriberType::UNKNOWN);
+
+    // Configure data provider (Features and Matches)
+    sfmEngine.setFeatures(&featuresPerView);
+    sfmEngine.setMatches(&pairwiseMatches);
+
+    BOOST_CHECK(sfmEngine.process());
+
+    const Landmarks& landmarks = sfmEngine.getSfMData().getLandmarks();
+    BOOST_REQUIRE(!landmarks.empty());
+
+    std::set<IndexT> viewIds;
+    for (const auto& viewPair : sfmEngine.getSfMData().getViews())
+        viewIds.insert(viewPair.first);
+
+    std::vector<ViewConnectionScore> connectedViews;
+    BOOST_REQUIRE(sfmEngine.findConnectedViews(connectedViews, viewIds));
+    BOOST_CHECK_EQUAL(connectedViews.size(), viewIds.size());
+
+    for (const ViewConnectionScore& connectedView : connectedViews)
+    {
+        const IndexT viewId = std::get<0>(connectedView);
+
+        // reconstructed tracks of the view computed from all the landmarks
+        std::vector<std::size_t> reconstructedTrackIds;
+        for (const std::size_t trackId : sfmEngine.getTracksPerView().at(viewId))
+        {
+            if (landmarks.count(trackId))
+                reconstructedTrackIds.push_back(trackId);
+        }
+
+        BOOST_CHECK_EQUAL(std::get<1>(connectedView), reconstructedTrackIds.size());
+        BOOST_CHECK_EQUAL(std::get<2>(connectedView), sfmEngine.computeCandidateImageScore(viewId, reconstructedTrackIds));
+    }
+}
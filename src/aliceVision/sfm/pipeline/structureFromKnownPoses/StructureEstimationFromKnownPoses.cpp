@@ -15,6 +15,7 @@
 #include <aliceVision/track/TracksBuilder.hpp>
 #include <aliceVision/sfm/sfmTriangulation.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/stl/parallelFor.hpp>
 #include <aliceVision/config.hpp>
 
 namespace aliceVision {
@@ -76,89 +77,89 @@ void StructureEstimationFromKnownPoses::match(const SfMData& sfmData,
 {
     auto progressDisplay = system::createConsoleProgressDisplay(pairs.size(), std::cout, "Compute pairwise fundamental guided matching:\n");
 
-#pragma omp parallel
-    for (PairSet::const_iterator it = pairs.begin(); it != pairs.end(); ++it)
-    {
-#pragma omp single nowait
-        {
-            // --
-            // Perform GUIDED MATCHING
-            // --
-            // Use the computed model to check valid correspondences
-            // - by considering geometric error and descriptor distance ratio.
-
-            const View* viewL = sfmData.getViews().at(it->first).get();
-            const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
-            const View* viewR = sfmData.getViews().at(it->second).get();
-            const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
-            const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
-
-            if (sfmData.getIntrinsics().count(viewL->getIntrinsicId()) != 0 || sfmData.getIntrinsics().count(viewR->getIntrinsicId()) != 0)
-            {
-                std::shared_ptr<IntrinsicBase> camL = iterIntrinsicL->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(camL);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
-
-                std::shared_ptr<IntrinsicBase> camR = iterIntrinsicR->second;
-                std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(camR);
-                if (!pinHoleCamL)
-                {
-                    ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
-                }
-
-                const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
-                const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
-
-                const Mat3 F_lr = F_from_P(P_L, P_R);
-                std::vector<feature::EImageDescriberType> commonDescTypes = regionsPerView.getCommonDescTypes(*it);
-
-                matching::MatchesPerDescType allImagePairMatches;
-                for (feature::EImageDescriberType descType : commonDescTypes)
-                {
-                    std::vector<matching::IndMatch> matches;
+    using PairMatches = std::pair<Pair, matching::MatchesPerDescType>;
+
+    std::vector<PairMatches> putativeMatches =
+      parallelForEachCollect<PairMatches>(pairs, [&](const Pair& pair, std::vector<PairMatches>& threadPutativeMatches) {
+          // --
+          // Perform GUIDED MATCHING
+          // --
+          // Use the computed model to check valid correspondences
+          // - by considering geometric error and descriptor distance ratio.
+
+          const View* viewL = sfmData.getViews().at(pair.first).get();
+          const Pose3 poseL = sfmData.getPose(*viewL).getTransform();
+          const Intrinsics::const_iterator iterIntrinsicL = sfmData.getIntrinsics().find(viewL->getIntrinsicId());
+          const View* viewR = sfmData.getViews().at(pair.second).get();
+          const Pose3 poseR = sfmData.getPose(*viewR).getTransform();
+          const Intrinsics::const_iterator iterIntrinsicR = sfmData.getIntrinsics().find(viewR->getIntrinsicId());
+
+          if (sfmData.getIntrinsics().count(viewL->getIntrinsicId()) != 0 || sfmData.getIntrinsics().count(viewR->getIntrinsicId()) != 0)
+          {
+              std::shared_ptr<IntrinsicBase> camL = iterIntrinsicL->second;
+              std::shared_ptr<camera::Pinhole> pinHoleCamL = std::dynamic_pointer_cast<camera::Pinhole>(camL);
+              if (!pinHoleCamL)
+              {
+                  ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
+              }
+
+              std::shared_ptr<IntrinsicBase> camR = iterIntrinsicR->second;
+              std::shared_ptr<camera::Pinhole> pinHoleCamR = std::dynamic_pointer_cast<camera::Pinhole>(camR);
+              if (!pinHoleCamL)
+              {
+                  ALICEVISION_LOG_ERROR("Camera is not pinhole in match");
+              }
+
+              const Mat34 P_L = pinHoleCamL->getProjectiveEquivalent(poseL);
+              const Mat34 P_R = pinHoleCamR->getProjectiveEquivalent(poseR);
+
+              const Mat3 F_lr = F_from_P(P_L, P_R);
+              std::vector<feature::EImageDescriberType> commonDescTypes = regionsPerView.getCommonDescTypes(pair);
+
+              matching::MatchesPerDescType allImagePairMatches;
+              for (feature::EImageDescriberType descType : commonDescTypes)
+              {
+                  std::vector<matching::IndMatch> matches;
 #ifdef ALICEVISION_EXHAUSTIVE_MATCHING
-                    matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      // descType,
-                      Square(thresholdF),
-                      Square(0.8),
-                      matches);
+                  matching::guidedMatching<Mat3, multiview::relativePose::FundamentalEpipolarDistanceError>(
+                    F_lr,
+                    iterIntrinsicL->second.get(),
+                    regionsPerView.getRegions(pair.first, descType),
+                    iterIntrinsicR->second.get(),
+                    regionsPerView.getRegions(pair.second, descType),
+                    // descType,
+                    Square(thresholdF),
+                    Square(0.8),
+                    matches);
 #else
-                    const Vec3 epipole2 = epipole_from_P(P_R, poseL);
-
-                    // const feature::Regions& regions = regionsPerView.getRegions(it->first);
-                    matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(
-                      F_lr,
-                      epipole2,
-                      iterIntrinsicL->second.get(),
-                      regionsPerView.getRegions(it->first, descType),
-                      iterIntrinsicR->second.get(),
-                      regionsPerView.getRegions(it->second, descType),
-                      iterIntrinsicR->second->w(),
-                      iterIntrinsicR->second->h(),
-                      // descType,
-                      Square(geometricErrorMax),
-                      Square(0.8),
-                      matches);
+                  const Vec3 epipole2 = epipole_from_P(P_R, poseL);
+
+                  // const feature::Regions& regions = regionsPerView.getRegions(pair.first);
+                  matching::guidedMatchingFundamentalFast<multiview::relativePose::FundamentalEpipolarDistanceError>(
+                    F_lr,
+                    epipole2,
+                    iterIntrinsicL->second.get(),
+                    regionsPerView.getRegions(pair.first, descType),
+                    iterIntrinsicR->second.get(),
+                    regionsPerView.getRegions(pair.second, descType),
+                    iterIntrinsicR->second->w(),
+                    iterIntrinsicR->second->h(),
+                    // descType,
+                    Square(geometricErrorMax),
+                    Square(0.8),
+                    matches);
 #endif
-                    allImagePairMatches[descType] = matches;
-                }
-
-#pragma omp critical
-                {
-                    ++progressDisplay;
-                    _putativeMatches[*it] = allImagePairMatches;
-                }
-            }
-        }
+                  allImagePairMatches[descType] = matches;
+              }
+
+              ++progressDisplay;
+              threadPutativeMatches.emplace_back(pair, std::move(allImagePairMatches));
+          }
+      });
+
+    for (PairMatches& pairMatches : putativeMatches)
+    {
+        _putativeMatches[pairMatches.first] = std::move(pairMatches.second);
     }
 }
 
@@ -174,81 +175,88 @@ void StructureEstimationFromKnownPoses::filter(const SfMData& sfmData, const Pai
 
     auto progressDisplay =
       system::createConsoleProgressDisplay(triplets.size(), std::cout, "Per triplet tracks validation (discard spurious correspondences):\n");
-#pragma omp parallel
-    for (Triplets::const_iterator it = triplets.begin(); it != triplets.end(); ++it)
+
+    struct TripletMatch
     {
-#pragma omp single nowait
-        {
-            ++progressDisplay;
-
-            const graph::Triplet& triplet = *it;
-            const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
-
-            track::TracksMap map_tracksCommon;
-            track::TracksBuilder tracksBuilder;
-            {
-                matching::PairwiseMatches map_matchesIJK;
-                if (_putativeMatches.count(std::make_pair(I, J)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, J)));
-
-                if (_putativeMatches.count(std::make_pair(I, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, K)));
-
-                if (_putativeMatches.count(std::make_pair(J, K)))
-                    map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(J, K)));
-
-                if (map_matchesIJK.size() >= 2)
-                {
-                    tracksBuilder.build(map_matchesIJK);
-                    tracksBuilder.filter(true, 3, false);
-                    tracksBuilder.exportToSTL(map_tracksCommon);
-                }
-
-                // Triangulate the tracks
-                for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
-                {
-                    {
-                        const track::Track& subTrack = iterTracks->second;
-                        multiview::Triangulation trianObj;
-                        for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
-                        {
-                            const size_t imaIndex = iter->first;
-                            const size_t featIndex = iter->second.featureId;
-                            const View* view = sfmData.getViews().at(imaIndex).get();
-
-                            std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-                            std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-                            if (!camPinHole)
-                            {
-                                ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
-                                continue;
-                            }
-
-                            const Pose3 pose = sfmData.getPose(*view).getTransform();
-                            const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
-                            trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->get_ud_pixel(pt));
-                        }
-                        const Vec3 Xs = trianObj.compute();
-                        if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
-                        // TODO: Add an angular check ?
-                        {
-#pragma omp critical
-                            {
-                                track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
-                                iterI = iterJ = iterK = subTrack.featPerView.begin();
-                                std::advance(iterJ, 1);
-                                std::advance(iterK, 2);
-
-                                _tripletMatches[std::make_pair(I, J)][subTrack.descType].emplace_back(iterI->second.featureId, iterJ->second.featureId);
-                                _tripletMatches[std::make_pair(J, K)][subTrack.descType].emplace_back(iterJ->second.featureId, iterK->second.featureId);
-                                _tripletMatches[std::make_pair(I, K)][subTrack.descType].emplace_back(iterI->second.featureId, iterK->second.featureId);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+        Pair pair;
+        feature::EImageDescriberType descType;
+        matching::IndMatch match;
+    };
+
+    const std::vector<TripletMatch> tripletMatches =
+      parallelForEachCollect<TripletMatch>(triplets, [&](const graph::Triplet& triplet, std::vector<TripletMatch>& threadTripletMatches) {
+          ++progressDisplay;
+
+          const IndexT I = triplet.i, J = triplet.j, K = triplet.k;
+
+          track::TracksMap map_tracksCommon;
+          track::TracksBuilder tracksBuilder;
+          {
+              matching::PairwiseMatches map_matchesIJK;
+              if (_putativeMatches.count(std::make_pair(I, J)))
+                  map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, J)));
+
+              if (_putativeMatches.count(std::make_pair(I, K)))
+                  map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(I, K)));
+
+              if (_putativeMatches.count(std::make_pair(J, K)))
+                  map_matchesIJK.insert(*_putativeMatches.find(std::make_pair(J, K)));
+
+              if (map_matchesIJK.size() >= 2)
+              {
+                  tracksBuilder.build(map_matchesIJK);
+                  tracksBuilder.filter(true, 3, false);
+                  tracksBuilder.exportToSTL(map_tracksCommon);
+              }
+
+              // Triangulate the tracks
+              for (track::TracksMap::const_iterator iterTracks = map_tracksCommon.begin(); iterTracks != map_tracksCommon.end(); ++iterTracks)
+              {
+                  const track::Track& subTrack = iterTracks->second;
+                  multiview::Triangulation trianObj;
+                  for (auto iter = subTrack.featPerView.begin(); iter != subTrack.featPerView.end(); ++iter)
+                  {
+                      const size_t imaIndex = iter->first;
+                      const size_t featIndex = iter->second.featureId;
+                      const View* view = sfmData.getViews().at(imaIndex).get();
+
+                      std::shared_ptr<camera::IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
+                      std::shared_ptr<camera::Pinhole> camPinHole = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+                      if (!camPinHole)
+                      {
+                          ALICEVISION_LOG_ERROR("Camera is not pinhole in filter");
+                          continue;
+                      }
+
+                      const Pose3 pose = sfmData.getPose(*view).getTransform();
+                      const Vec2 pt = regionsPerView.getRegions(imaIndex, subTrack.descType).GetRegionPosition(featIndex);
+                      trianObj.add(camPinHole->getProjectiveEquivalent(pose), cam->get_ud_pixel(pt));
+                  }
+                  const Vec3 Xs = trianObj.compute();
+                  if (trianObj.minDepth() > 0 && trianObj.error() / (double)trianObj.size() < 4.0)
+                  // TODO: Add an angular check ?
+                  {
+                      track::Track::FeatureIdPerView::const_iterator iterI, iterJ, iterK;
+                      iterI = iterJ = iterK = subTrack.featPerView.begin();
+                      std::advance(iterJ, 1);
+                      std::advance(iterK, 2);
+
+                      threadTripletMatches.push_back(
+                        {std::make_pair(I, J), subTrack.descType, matching::IndMatch(iterI->second.featureId, iterJ->second.featureId)});
+                      threadTripletMatches.push_back(
+                        {std::make_pair(J, K), subTrack.descType, matching::IndMatch(iterJ->second.featureId, iterK->second.featureId)});
+                      threadTripletMatches.push_back(
+                        {std::make_pair(I, K), subTrack.descType, matching::IndMatch(iterI->second.featureId, iterK->second.featureId)});
+                  }
+              }
+          }
+      });
+
+    for (const TripletMatch& tripletMatch : tripletMatches)
+    {
+        _tripletMatches[tripletMatch.pair][tripletMatch.descType].push_back(tripletMatch.match);
     }
+
     // Clear putatives matches since they are no longer required
     matching::PairwiseMatches().swap(_putativeMatches);
 }
@@ -15,6 +15,72 @@
 namespace aliceVision {
 namespace sfm {
 
+namespace {
+
+/**
+ * @brief Compute the norm of the reprojection residuals of the observations, grouped per view.
+ * @note The observations of a view are projected with a single call to the batched projection of its intrinsic.
+ * @param[in] sfmData the input sfmData
+ * @param[in] specificViews the views to use, all the views if empty
+ * @param[out] out_residualsPerView the residuals of the observations of each view
+ */
+void computeViewsResiduals(const sfmData::SfMData& sfmData,
+                           const std::set<IndexT>& specificViews,
+                           std::map<IndexT, std::vector<double>>& out_residualsPerView)
+{
+    // Group the observations per view
+    std::map<IndexT, std::vector<std::pair<const Vec3*, const sfmData::Observation*>>> observationsPerView;
+
+    for (const auto& landmark : sfmData.getLandmarks())
+    {
+        const aliceVision::sfmData::Observations& observations = landmark.second.getObservations();
+        for (const auto& obs : observations)
+        {
+            if (!specificViews.empty() && specificViews.count(obs.first) == 0)
+                continue;
+
+            observationsPerView[obs.first].emplace_back(&landmark.second.X, &obs.second);
+        }
+    }
+
+    // Get the cameras outside of the parallel loop, the pose lookup may throw
+    std::vector<IndexT> viewIds;
+    std::vector<Eigen::Matrix4d> poses;
+    std::vector<std::shared_ptr<aliceVision::camera::IntrinsicBase>> intrinsics;
+    for (const auto& viewObservations : observationsPerView)
+    {
+        const sfmData::View& view = sfmData.getView(viewObservations.first);
+        viewIds.push_back(viewObservations.first);
+        poses.push_back(sfmData.getPose(view).getTransform().getHomogeneous());
+        intrinsics.push_back(sfmData.getIntrinsics().find(view.getIntrinsicId())->second);
+        out_residualsPerView[viewObservations.first].resize(viewObservations.second.size());
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < viewIds.size(); ++i)
+    {
+        const IndexT viewId = viewIds[i];
+        const auto& observations = observationsPerView.at(viewId);
+        std::vector<double>& residuals = out_residualsPerView.at(viewId);
+
+        const Eigen::Index nbObservations = observations.size();
+        Mat4X pts3D(4, nbObservations);
+        Mat2X pts2D(2, nbObservations);
+        for (Eigen::Index j = 0; j < nbObservations; ++j)
+        {
+            pts3D.col(j) = observations[j].first->homogeneous();
+            pts2D.col(j) = observations[j].second->getCoordinates();
+        }
+
+        Mat2X projections;
+        intrinsics[i]->projectPoints(poses[i], pts3D, projections);
+
+        Eigen::Map<Eigen::Matrix<double, 1, Eigen::Dynamic>>(residuals.data(), nbObservations) = (pts2D - projections).colwise().norm();
+    }
+}
+
+}  // namespace
+
 void computeResidualsHistogram(const sfmData::SfMData& sfmData,
                                BoxStats<double>& outStats,
                                utils::Histogram<double>* outHistogram,
@@ -32,27 +98,15 @@ void computeResidualsHistogram(const sfmData::SfMData& sfmData,
         return;
 
     // Collect residuals for each observation
+    std::map<IndexT, std::vector<double>> residualsPerView;
+    computeViewsResiduals(sfmData, specificViews, residualsPerView);
+
     std::vector<double> vecResiduals;
     vecResiduals.reserve(sfmData.getLandmarks().size());
 
-    for (const auto& track : sfmData.getLandmarks())
+    for (const auto& viewResiduals : residualsPerView)
     {
-        const aliceVision::sfmData::Observations& observations = track.second.getObservations();
-        for (const auto& obs : observations)
-        {
-            if (!specificViews.empty())
-            {
-                if (specificViews.count(obs.first) == 0)
-                    continue;
-            }
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, track.second.X.homogeneous(), obs.second.getCoordinates());
-            vecResiduals.push_back(residual.norm());
-            // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram track: " << track.first << ", residual: " <<
-            // residual.norm());
-        }
+        vecResiduals.insert(vecResiduals.end(), viewResiduals.second.begin(), viewResiduals.second.end());
     }
 
     // ALICEVISION_LOG_INFO("[AliceVision] sfmtstatistics::computeResidualsHistogram vecResiduals.size(): " << vec_residuals.size());
@@ -331,19 +385,7 @@ void computeResidualsPerView(const sfmData::SfMData& sfmData,
 
     // Collect residuals (number of residuals per 3D points) of all landmarks visible in each view
     std::map<IndexT, std::vector<double>> residualsPerView;
-
-    for (const auto& landmark : sfmData.getLandmarks())
-    {
-        const aliceVision::sfmData::Observations& observations = landmark.second.getObservations();
-        for (const auto& obs : observations)
-        {
-            const sfmData::View& view = sfmData.getView(obs.first);
-            const aliceVision::geometry::Pose3 pose = sfmData.getPose(view).getTransform();
-            const std::shared_ptr<aliceVision::camera::IntrinsicBase> intrinsic = sfmData.getIntrinsics().find(view.getIntrinsicId())->second;
-            const Vec2 residual = intrinsic->residual(pose, landmark.second.X.homogeneous(), obs.second.getCoordinates());
-            residualsPerView[obs.first].push_back(residual.norm());
-        }
-    }
+    computeViewsResiduals(sfmData, {}, residualsPerView);
 
     std::vector<IndexT> viewKeys;
     for (const auto& v : sfmData.getViews())
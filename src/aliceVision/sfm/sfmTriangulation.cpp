@@ -9,10 +9,11 @@
 #include <aliceVision/multiview/triangulation/Triangulation.hpp>
 #include <aliceVision/robustEstimation/randSampling.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/stl/parallelFor.hpp>
 #include <aliceVision/config.hpp>
 
-#include <deque>
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace sfm {
@@ -30,67 +31,56 @@ StructureComputationBlind::StructureComputationBlind(bool verbose)
 
 void StructureComputationBlind::triangulate(sfmData::SfMData& sfmData, std::mt19937& randomNumberGenerator) const
 {
-    std::deque<IndexT> rejectedId;
     system::ProgressDisplay progressDisplay;
     if (_bConsoleVerbose)
         progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "Blind triangulation progress:\n");
 
-#pragma omp parallel
-    for (sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin(); iterTracks != sfmData.getLandmarks().end(); ++iterTracks)
-    {
-#pragma omp single nowait
-        {
-            if (_bConsoleVerbose)
-            {
-                ++(progressDisplay);
-            }
-            // Triangulate each landmark
-            multiview::Triangulation trianObj;
-            const sfmData::Observations& observations = iterTracks->second.getObservations();
-            for (const auto& itObs : observations)
-            {
-                const sfmData::View* view = sfmData.getViews().at(itObs.first).get();
-                if (sfmData.isPoseAndIntrinsicDefined(view))
-                {
-                    std::shared_ptr<IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
-                    std::shared_ptr<camera::Pinhole> pinHoleCam = std::dynamic_pointer_cast<camera::Pinhole>(cam);
-                    if (!pinHoleCam)
-                    {
-                        ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulate");
-                        continue;
-                    }
-
-                    const Pose3 pose = sfmData.getPose(*view).getTransform();
-                    trianObj.add(pinHoleCam->getProjectiveEquivalent(pose), cam->get_ud_pixel(itObs.second.getCoordinates()));
-                }
-            }
-            if (trianObj.size() < 2)
-            {
-#pragma omp critical
-                {
-                    rejectedId.push_front(iterTracks->first);
-                }
-            }
-            else
-            {
-                // Compute the 3D point
-                const Vec3 X = trianObj.compute();
-                if (trianObj.minDepth() > 0)  // Keep the point only if it have a positive depth
-                {
-                    iterTracks->second.X = X;
-                }
-                else
-                {
-#pragma omp critical
-                    {
-                        rejectedId.push_front(iterTracks->first);
-                    }
-                }
-            }
-        }
-    }
+    const std::vector<IndexT> rejectedId =
+      parallelForEachCollect<IndexT>(sfmData.getLandmarks(), [&](sfmData::Landmarks::value_type& landmarkPair, std::vector<IndexT>& threadRejectedId) {
+          if (_bConsoleVerbose)
+          {
+              ++(progressDisplay);
+          }
+          // Triangulate each landmark
+          multiview::Triangulation trianObj;
+          const sfmData::Observations& observations = landmarkPair.second.getObservations();
+          for (const auto& itObs : observations)
+          {
+              const sfmData::View* view = sfmData.getViews().at(itObs.first).get();
+              if (sfmData.isPoseAndIntrinsicDefined(view))
+              {
+                  std::shared_ptr<IntrinsicBase> cam = sfmData.getIntrinsics().at(view->getIntrinsicId());
+                  std::shared_ptr<camera::Pinhole> pinHoleCam = std::dynamic_pointer_cast<camera::Pinhole>(cam);
+                  if (!pinHoleCam)
+                  {
+                      ALICEVISION_LOG_ERROR("Camera is not pinhole in triangulate");
+                      continue;
+                  }
+
+                  const Pose3 pose = sfmData.getPose(*view).getTransform();
+                  trianObj.add(pinHoleCam->getProjectiveEquivalent(pose), cam->get_ud_pixel(itObs.second.getCoordinates()));
+              }
+          }
+          if (trianObj.size() < 2)
+          {
+              threadRejectedId.push_back(landmarkPair.first);
+              return;
+          }
+
+          // Compute the 3D point
+          const Vec3 X = trianObj.compute();
+          if (trianObj.minDepth() > 0)  // Keep the point only if it have a positive depth
+          {
+              landmarkPair.second.X = X;
+          }
+          else
+          {
+              threadRejectedId.push_back(landmarkPair.first);
+          }
+      });
+
     // Erase the unsuccessful triangulated tracks
-    for (auto& it : rejectedId)
+    for (const IndexT it : rejectedId)
     {
         sfmData.getLandmarks().erase(it);
     }
@@ -110,38 +100,35 @@ void StructureComputationRobust::triangulate(sfmData::SfMData& sfmData, std::mt1
 /// Invalid landmark are removed.
 void StructureComputationRobust::robustTriangulation(sfmData::SfMData& sfmData, std::mt19937& randomNumberGenerator) const
 {
-    std::deque<IndexT> rejectedId;
-
     system::ProgressDisplay progressDisplay;
     if (_bConsoleVerbose)
         progressDisplay = system::createConsoleProgressDisplay(sfmData.getLandmarks().size(), std::cout, "Robust triangulation progress:\n");
 
-#pragma omp parallel
-    for (sfmData::Landmarks::iterator iterTracks = sfmData.getLandmarks().begin(); iterTracks != sfmData.getLandmarks().end(); ++iterTracks)
-    {
-#pragma omp single nowait
-        {
-            if (_bConsoleVerbose)
-            {
-                ++(progressDisplay);
-            }
-            Vec3 X;
-            if (robustTriangulation(sfmData, iterTracks->second.getObservations(), randomNumberGenerator, X))
-            {
-                iterTracks->second.X = X;
-            }
-            else
-            {
-                iterTracks->second.X = Vec3::Zero();
-#pragma omp critical
-                {
-                    rejectedId.push_front(iterTracks->first);
-                }
-            }
-        }
-    }
+    // one random number generator per landmark, seeded from the input one and the landmark id:
+    // the results do not depend on the number of threads or on the scheduling
+    const std::mt19937::result_type seed = randomNumberGenerator();
+
+    const std::vector<IndexT> rejectedId =
+      parallelForEachCollect<IndexT>(sfmData.getLandmarks(), [&](sfmData::Landmarks::value_type& landmarkPair, std::vector<IndexT>& threadRejectedId) {
+          if (_bConsoleVerbose)
+          {
+              ++(progressDisplay);
+          }
+          std::mt19937 landmarkRandomNumberGenerator(seed + static_cast<std::mt19937::result_type>(landmarkPair.first));
+          Vec3 X;
+          if (robustTriangulation(sfmData, landmarkPair.second.getObservations(), landmarkRandomNumberGenerator, X))
+          {
+              landmarkPair.second.X = X;
+          }
+          else
+          {
+              landmarkPair.second.X = Vec3::Zero();
+              threadRejectedId.push_back(landmarkPair.first);
+          }
+      });
+
     // Erase the unsuccessful triangulated tracks
-    for (auto& it : rejectedId)
+    for (const IndexT it : rejectedId)
     {
         sfmData.getLandmarks().erase(it);
     }
@@ -0,0 +1,129 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// ---------------------------
+// Usage example :
+// ---------------------------
+
+// HashMap<IndexT, Landmark> landmarks;
+// // Process each landmark in parallel
+// parallelForEach(landmarks, [&](auto& landmarkPair) { update(landmarkPair.second); });
+// // Collect the ids of the rejected landmarks, each thread appends to its own buffer
+// const std::vector<IndexT> rejected = parallelForEachCollect<IndexT>(landmarks, [&](const auto& landmarkPair, std::vector<IndexT>& buffer) {
+//     if (!isValid(landmarkPair.second))
+//         buffer.push_back(landmarkPair.first);
+// });
+
+namespace aliceVision {
+
+namespace detail {
+
+/**
+ * @brief Get the chunk size used to split a parallel loop
+ * @param[in] size The number of elements of the loop
+ * @param[in] chunkSize The requested chunk size (0: automatic, about 8 chunks per thread)
+ * @return the chunk size, at least 1
+ */
+inline int getParallelForChunkSize(int size, int chunkSize)
+{
+    if (chunkSize > 0)
+        return chunkSize;
+    return std::max(1, size / (8 * omp_get_max_threads()));
+}
+
+}  // namespace detail
+
+/**
+ * @brief Call a function on each element of a container in parallel.
+ * @details The elements are split into chunks dynamically scheduled between the OpenMP threads.
+ *          Containers without random access iterators (std::map based HashMap, std::set, ...)
+ *          have their iterators gathered first, which is much cheaper than one task per element.
+ * @param[in,out] container The container (HashMap, stl::flat_map, std::vector, ...)
+ * @param[in] function The function called with each element
+ * @param[in] chunkSize The number of consecutive elements processed by a thread at once
+ *                      (0: derived from the container size, about 8 chunks per thread)
+ */
+template<typename Container, typename Function>
+void parallelForEach(Container& container, Function&& function, int chunkSize = 0)
+{
+    using Iterator = decltype(std::begin(container));
+    using IteratorCategory = typename std::iterator_traits<Iterator>::iterator_category;
+
+    if constexpr (std::is_base_of_v<std::random_access_iterator_tag, IteratorCategory>)
+    {
+        const Iterator first = std::begin(container);
+        const int size = static_cast<int>(std::distance(first, std::end(container)));
+        const int scheduleChunkSize = detail::getParallelForChunkSize(size, chunkSize);
+
+#pragma omp parallel for schedule(dynamic, scheduleChunkSize)
+        for (int i = 0; i < size; ++i)
+        {
+            function(first[i]);
+        }
+    }
+    else
+    {
+        std::vector<Iterator> iterators;
+        iterators.reserve(std::size(container));
+        for (Iterator it = std::begin(container); it != std::end(container); ++it)
+        {
+            iterators.push_back(it);
+        }
+
+        const int size = static_cast<int>(iterators.size());
+        const int scheduleChunkSize = detail::getParallelForChunkSize(size, chunkSize);
+
+#pragma omp parallel for schedule(dynamic, scheduleChunkSize)
+        for (int i = 0; i < size; ++i)
+        {
+            function(*iterators[i]);
+        }
+    }
+}
+
+/**
+ * @brief Call a function on each element of a container in parallel and collect its results.
+ * @details Each thread appends its results to its own buffer, without any synchronization.
+ *          The buffers are concatenated at the end, the order of the results is not deterministic.
+ * @param[in,out] container The container (HashMap, stl::flat_map, std::vector, ...)
+ * @param[in] function The function called with each element and the buffer of the current thread
+ * @param[in] chunkSize The number of consecutive elements processed by a thread at once
+ *                      (0: derived from the container size, about 8 chunks per thread)
+ * @return the results of all the threads
+ */
+template<typename Result, typename Container, typename Function>
+std::vector<Result> parallelForEachCollect(Container& container, Function&& function, int chunkSize = 0)
+{
+    std::vector<std::vector<Result>> buffers(omp_get_max_threads());
+
+    parallelForEach(
+      container, [&](auto& element) { function(element, buffers[omp_get_thread_num()]); }, chunkSize);
+
+    std::size_t size = 0;
+    for (const std::vector<Result>& buffer : buffers)
+    {
+        size += buffer.size();
+    }
+
+    std::vector<Result> results;
+    results.reserve(size);
+    for (std::vector<Result>& buffer : buffers)
+    {
+        std::move(buffer.begin(), buffer.end(), std::back_inserter(results));
+    }
+    return results;
+}
+
+}  // namespace aliceVision
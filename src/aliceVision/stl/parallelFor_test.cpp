@@ -0,0 +1,83 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "parallelFor.hpp"
+#include "FlatMap.hpp"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <vector>
+
+#define BOOST_TEST_MODULE stlParallelFor
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+
+BOOST_AUTO_TEST_CASE(PARALLEL_FOR_EACH_Map)
+{
+    std::map<int, int> values;
+    for (int i = 0; i < 10000; ++i)
+        values[i] = 0;
+
+    parallelForEach(values, [](auto& valuePair) { valuePair.second = 2 * valuePair.first; });
+
+    for (const auto& valuePair : values)
+        BOOST_CHECK_EQUAL(valuePair.second, 2 * valuePair.first);
+}
+
+BOOST_AUTO_TEST_CASE(PARALLEL_FOR_EACH_FlatMap)
+{
+    stl::flat_map<int, int> values;
+    for (int i = 0; i < 10000; ++i)
+        values[i] = 0;
+
+    parallelForEach(values, [](auto& valuePair) { valuePair.second = valuePair.first + 1; }, 16);
+
+    for (const auto& valuePair : values)
+        BOOST_CHECK_EQUAL(valuePair.second, valuePair.first + 1);
+}
+
+BOOST_AUTO_TEST_CASE(PARALLEL_FOR_EACH_Collect)
+{
+    std::map<int, int> values;
+    for (int i = 0; i < 10000; ++i)
+        values[i] = i % 3;
+
+    const std::map<int, int>& constValues = values;
+    std::vector<int> collected = parallelForEachCollect<int>(constValues, [](const auto& valuePair, std::vector<int>& buffer) {
+        if (valuePair.second == 0)
+            buffer.push_back(valuePair.first);
+    });
+
+    // the order of the results depends on the threads scheduling
+    std::sort(collected.begin(), collected.end());
+
+    BOOST_REQUIRE_EQUAL(collected.size(), 3334);
+    for (std::size_t i = 0; i < collected.size(); ++i)
+        BOOST_CHECK_EQUAL(collected[i], 3 * i);
+
+    // empty container
+    const std::vector<int> empty;
+    BOOST_CHECK(parallelForEachCollect<int>(empty, [](int value, std::vector<int>& buffer) { buffer.push_back(value); }).empty());
+}
+
+BOOST_AUTO_TEST_CASE(PARALLEL_FOR_EACH_ChunkSize)
+{
+    // an explicit chunk size is kept
+    BOOST_CHECK_EQUAL(detail::getParallelForChunkSize(10000, 16), 16);
+
+    // small loops are split element by element, so that expensive elements are spread over the threads
+    BOOST_CHECK_EQUAL(detail::getParallelForChunkSize(0, 0), 1);
+    BOOST_CHECK_EQUAL(detail::getParallelForChunkSize(omp_get_max_threads(), 0), 1);
+
+    // large loops get several chunks per thread
+    const int size = 1000000;
+    const int chunkSize = detail::getParallelForChunkSize(size, 0);
+    BOOST_CHECK_GE(chunkSize, 1);
+    BOOST_CHECK_GE(size / chunkSize, omp_get_max_threads());
+}
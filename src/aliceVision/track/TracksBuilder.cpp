@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "TracksBuilder.hpp"
+#include <aliceVision/stl/parallelFor.hpp>
 
 #include <lemon/list_graph.h>
 #include <lemon/unionfind.h>
@@ -122,29 +123,34 @@ void TracksBuilder::filter(bool clearForks, std::size_t minTrackLength, bool mul
     if (!clearForks && minTrackLength == 0)
         return;
 
-    std::set<int> set_classToErase;
-
-#pragma omp parallel if (multithreaded)
+    std::vector<int> classes;
     for (lemon::UnionFindEnum<IndexMap>::ClassIt cit(*_d->tracksUF); cit != INVALID; ++cit)
-    {
-#pragma omp single nowait
+        classes.push_back(cit.operator int());
+
+    const auto checkClass = [&](int classId, std::vector<int>& classesToErase) {
+        std::size_t cpt = 0;
+        std::set<std::size_t> myset;
+        for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, classId); iit != INVALID; ++iit)
         {
-            std::size_t cpt = 0;
-            std::set<std::size_t> myset;
-            for (lemon::UnionFindEnum<IndexMap>::ItemIt iit(*_d->tracksUF, cit); iit != INVALID; ++iit)
-            {
-                myset.insert(_d->map_nodeToIndex[iit].first);
-                ++cpt;
-            }
-            if ((clearForks && myset.size() != cpt) || myset.size() < minTrackLength)
-            {
-#pragma omp critical
-                set_classToErase.insert(cit.operator int());
-            }
+            myset.insert(_d->map_nodeToIndex.at(iit).first);
+            ++cpt;
         }
+        if ((clearForks && myset.size() != cpt) || myset.size() < minTrackLength)
+            classesToErase.push_back(classId);
+    };
+
+    std::vector<int> classesToErase;
+    if (multithreaded)
+    {
+        classesToErase = parallelForEachCollect<int>(classes, checkClass);
+    }
+    else
+    {
+        for (const int classId : classes)
+            checkClass(classId, classesToErase);
     }
 
-    std::for_each(set_classToErase.begin(), set_classToErase.end(), [&](int toErase) { _d->tracksUF->eraseClass(toErase); });
+    std::for_each(classesToErase.begin(), classesToErase.end(), [&](int toErase) { _d->tracksUF->eraseClass(toErase); });
 }
 
 bool TracksBuilder::exportToStream(std::ostream& os)
@@ -38,7 +38,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::sfmDataIO;
@@ -168,6 +168,7 @@ int aliceVision_main(int argc, char **argv)
   std::string imageFolder;
   std::string sensorDatabasePath;
   std::string lensCorrectionProfileInfo;
+  std::string lensCorrectionProfileIndex;
   std::string outputFilePath;
 
   // user optional parameters
@@ -208,6 +209,10 @@ int aliceVision_main(int argc, char **argv)
          "DNG Color Profiles (DCP) database path.")
         ("lensCorrectionProfileInfo", po::value<std::string>(&lensCorrectionProfileInfo)->default_value(""),
          "Lens Correction Profile filepath or database directory path.")
+        ("lensCorrectionProfileIndex", po::value<std::string>(&lensCorrectionProfileIndex)->default_value(lensCorrectionProfileIndex),
+         "Binary index file of the Lens Correction Profile headers, created or updated if needed and reused by the next runs.\n"
+         "If empty, an index file of the database folder is kept in the cache folder of the user.\n"
+         "If 'none', the headers are parsed on demand, for the camera makers of the images only.")
         ("lensCorrectionProfileSearchIgnoreCameraModel", po::value<bool>(&lensCorrectionProfileSearchIgnoreCameraModel)->default_value(lensCorrectionProfileSearchIgnoreCameraModel),
          "Automatic LCP Search considers only the camera maker and the lens name.")
         ("defaultFocalLength", po::value<double>(&defaultFocalLength)->default_value(defaultFocalLength),
@@ -417,8 +422,13 @@ int aliceVision_main(int argc, char **argv)
   }
   int viewsWithDCPMetadata = 0;
 
+  if (lensCorrectionProfileIndex.empty())
+    lensCorrectionProfileIndex = getDefaultLCPIndexFilepath(lensCorrectionProfileInfo);
+  else if (lensCorrectionProfileIndex == "none")
+    lensCorrectionProfileIndex.clear();
+
   ALICEVISION_LOG_DEBUG("List files in the LCP database: " << lensCorrectionProfileInfo);
-  LCPdatabase lcpStore(lensCorrectionProfileInfo, lensCorrectionProfileSearchIgnoreCameraModel);
+  LCPdatabase lcpStore(lensCorrectionProfileInfo, lensCorrectionProfileSearchIgnoreCameraModel, lensCorrectionProfileIndex);
   if (!lensCorrectionProfileInfo.empty())
   {
     ALICEVISION_LOG_INFO(lcpStore.size() << " profile(s) stored in the LCP database.");
@@ -609,7 +619,6 @@ int aliceVision_main(int argc, char **argv)
 
       if (!make.empty() && !lensModel.empty())
       {
-        #pragma omp critical(lcp)
         lcpData = lcpStore.findLCP(make, model, lensModel, lensID, 1);
       }
     }
@@ -83,6 +83,10 @@ int aliceVision_main(int argc, char** argv)
   double resectionErrorMax = 4.0;  
   /// the maximum reprojection error allowed for image matching with geometric validation
   double matchingErrorMax = 4.0;   
+  /// the number of threads evaluating the hypotheses of the robust estimations
+  std::size_t nbRansacThreads = 1;
+  /// whether to stop the scoring of the bad hypotheses early with a SPRT (LORANSAC only)
+  bool useSPRT = false;
   /// whether to use the voctreeLocalizer or cctagLocalizer
   bool useVoctreeLocalizer = true;
   
@@ -154,6 +158,12 @@ int aliceVision_main(int argc, char** argv)
         ("reprojectionError", po::value<double>(&resectionErrorMax)->default_value(resectionErrorMax),
          "Maximum reprojection error (in pixels) allowed for resectioning. If set "
          "to 0 it lets the ACRansac select an optimal value.")
+        ("nbRansacThreads", po::value<std::size_t>(&nbRansacThreads)->default_value(nbRansacThreads),
+         "Number of threads evaluating the hypotheses of the robust estimations (1: sequential, 0: all the available cores). "
+         "The results are reproducible for a given random seed.")
+        ("useSPRT", po::value<bool>(&useSPRT)->default_value(useSPRT),
+         "Stop the scoring of the bad hypotheses early with a SPRT (Wald's sequential probability ratio test). "
+         "Only used with the LORANSAC estimators.")
         ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
          "This seed value will generate a sequence using a linear random generator. Set -1 to use a random seed.");
   
@@ -339,6 +349,8 @@ int aliceVision_main(int argc, char** argv)
   param->_errorMax = resectionErrorMax;
   param->_resectionEstimator = resectionEstimator;
   param->_matchingEstimator = matchingEstimator;
+  param->_nbRansacThreads = nbRansacThreads;
+  param->_useSPRT = useSPRT;
   
   
   if(!localizer->isInit())
@@ -24,7 +24,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
 
 using namespace aliceVision;
 
@@ -52,6 +52,9 @@ int aliceVision_main(int argc, char* argv[])
     int pixSizeBall = 0;
     int pixSizeBallWithLowSimilarity = 0;
     int nNearestCams = 10;
+    int mapCacheSize = 0;
+    bool singlePass = true;
+    bool exportChunkedMaps = false;
     bool computeNormalMaps = false;
 
     // clang-format off
@@ -86,6 +89,15 @@ int aliceVision_main(int argc, char* argv[])
          "Filter ball size (in px) when the similarity is weak or ambiguous.")
         ("nNearestCams", po::value<int>(&nNearestCams)->default_value(nNearestCams),
          "Number of nearest cameras.")
+        ("mapCacheSize", po::value<int>(&mapCacheSize)->default_value(mapCacheSize),
+         "Maximum number of depth/similarity maps kept in memory and shared between the cameras filtered in parallel "
+         "(0: automatic, depends on the number of threads, of nearest cameras and on the available memory).")
+        ("singlePass", po::value<bool>(&singlePass)->default_value(singlePass),
+         "Compute the number of consistent cameras and filter the depth maps in a single pass per camera, "
+         "without reading back the intermediate nmodMap files.")
+        ("exportChunkedMaps", po::value<bool>(&exportChunkedMaps)->default_value(exportChunkedMaps),
+         "Also write the filtered maps in chunked map files (.avmap), read without image decoding "
+         "and with partial reads of regions of interest by the next steps.")
         ("computeNormalMaps", po::value<bool>(&computeNormalMaps)->default_value(computeNormalMaps),
          "Compute normal maps per depth map.");
     // clang-format on
@@ -112,6 +124,7 @@ int aliceVision_main(int argc, char* argv[])
 
     mp.setMinViewAngle(minViewAngle);
     mp.setMaxViewAngle(maxViewAngle);
+    mp.userParams.put("global.exportChunkedMaps", exportChunkedMaps);
 
     std::vector<int> cams;
     cams.reserve(mp.ncams);
@@ -141,8 +154,22 @@ int aliceVision_main(int argc, char* argv[])
 
     {
         fuseCut::Fuser fs(mp);
-        fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams);
-        fs.filterDepthMaps(cams, minNumOfConsistentCams, minNumOfConsistentCamsWithLowSimilarity);
+        fs.setMapCacheSize(std::max(mapCacheSize, 0));
+        if (singlePass)
+        {
+            fs.filterGroupsAndDepthMaps(cams,
+                                        pixToleranceFactor,
+                                        pixSizeBall,
+                                        pixSizeBallWithLowSimilarity,
+                                        nNearestCams,
+                                        minNumOfConsistentCams,
+                                        minNumOfConsistentCamsWithLowSimilarity);
+        }
+        else
+        {
+            fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams);
+            fs.filterDepthMaps(cams, minNumOfConsistentCams, minNumOfConsistentCamsWithLowSimilarity);
+        }
     }
 
     if(computeNormalMaps)
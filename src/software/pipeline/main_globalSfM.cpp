@@ -19,11 +19,12 @@
 
 #include <filesystem>
 #include <cstdlib>
+#include <stdexcept>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -74,7 +75,8 @@ int aliceVision_main(int argc, char **argv)
         ("translationAveraging", po::value<sfm::ETranslationAveragingMethod>(&translationAveragingMethod)->default_value(translationAveragingMethod),
          "* 1: L1 minimization\n"
          "* 2: L2 minimization of sum of squared Chordal distances\n"
-         "* 3: L1 soft minimization")
+         "* 3: L1 soft minimization\n"
+         "* 4: BATA robust minimization (baseline desensitized, sparse solver for large scenes)")
         ("lockAllIntrinsics", po::value<bool>(&lockAllIntrinsics)->default_value(lockAllIntrinsics),
          "Force lock of all camera intrinsic parameters, so they will not be refined during Bundle Adjustment.")
         ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
@@ -101,8 +103,12 @@ int aliceVision_main(int argc, char **argv)
     return EXIT_FAILURE;
   }
 
-  if (translationAveragingMethod < sfm::TRANSLATION_AVERAGING_L1 ||
-      translationAveragingMethod > sfm::TRANSLATION_AVERAGING_SOFTL1 )
+  // every method with a name is valid
+  try
+  {
+    sfm::ETranslationAveragingMethod_enumToString(translationAveragingMethod);
+  }
+  catch (const std::out_of_range&)
   {
     ALICEVISION_LOG_ERROR("Translation averaging method is invalid");
     return EXIT_FAILURE;
@@ -28,7 +28,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 4
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 6
 
 using namespace aliceVision;
 
@@ -165,9 +165,23 @@ int aliceVision_main(int argc, char **argv)
         ("maxImagesPerGroup", po::value<std::size_t>(&sfmParams.maxImagesPerGroup)->default_value(sfmParams.maxImagesPerGroup),
          "Maximum number of cameras that can be added before the bundle adjustment is performed. "
          "This prevents adding too much data at once without performing the bundle adjustment.")
+        ("useBatchedResection", po::value<bool>(&sfmParams.useBatchedResection)->default_value(sfmParams.useBatchedResection),
+         "Resect larger groups of cameras for large datasets: the new points are triangulated after each group and the bundle "
+         "adjustment is only performed when the reconstruction has grown enough since the last one.")
+        ("maxImagesPerBatch", po::value<std::size_t>(&sfmParams.maxImagesPerBatch)->default_value(sfmParams.maxImagesPerBatch),
+         "Maximum number of cameras resected at once in batched mode (0: no limit).")
+        ("bundleAdjustmentGrowthRatio", po::value<double>(&sfmParams.bundleAdjustmentGrowthRatio)->default_value(sfmParams.bundleAdjustmentGrowthRatio),
+         "In batched mode, the bundle adjustment is performed when the number of cameras added since the last one "
+         "exceeds this ratio of the reconstructed cameras.")
         ("bundleAdjustmentMaxOutliers", po::value<int>(&sfmParams.bundleAdjustmentMaxOutliers)->default_value(sfmParams.bundleAdjustmentMaxOutliers),
          "Threshold for the maximum number of outliers allowed at the end of a bundle adjustment iteration."
          "Using a negative value for this threshold will disable BA iterations.")
+        ("minNbCamerasForIterativeBA", po::value<std::size_t>(&sfmParams.minNbCamerasForIterativeBA)->default_value(sfmParams.minNbCamerasForIterativeBA),
+         "Minimum number of cameras in the bundle adjustment to use the iterative Schur solver instead of the direct one. "
+         "It reduces the time and memory on very large scenes (0: disabled).")
+        ("bundleAdjustmentPartitionSize", po::value<std::size_t>(&sfmParams.bundleAdjustmentPartitionSize)->default_value(sfmParams.bundleAdjustmentPartitionSize),
+         "Maximum number of cameras per cluster of the partitioned bundle adjustment. When the scene has more cameras, the global "
+         "bundle adjustment optimizes clusters of connected cameras and makes them agree on their shared points (0: disabled).")
         ("localizerEstimator", po::value<robustEstimation::ERobustEstimator>(&sfmParams.localizerEstimator)->default_value(sfmParams.localizerEstimator),
          "Estimator type used to localize cameras (acransac (default), ransac, lsmeds, loransac, maxconsensus).")
         ("localizerEstimatorError", po::value<double>(&sfmParams.localizerEstimatorError)->default_value(0.0),
@@ -22,6 +22,7 @@
 #include <filesystem>
 #include <vector>
 #include <set>
+#include <map>
 #include <iterator>
 #include <iomanip>
 #include <fstream>
@@ -29,7 +30,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::camera;
@@ -42,7 +43,7 @@ namespace po = boost::program_options;
 namespace fs = std::filesystem;
 
 template <class ImageT, class MaskFuncT>
-void process(const std::string &dstColorImage, const IntrinsicBase* cam, const oiio::ParamValueList & metadata, const std::string & srcImage, bool evCorrection, float exposureCompensation, MaskFuncT && maskFunc)
+void process(const std::string &dstColorImage, const IntrinsicBase* cam, UndistortionMapCache* undistortionMapCache, const oiio::ParamValueList & metadata, const std::string & srcImage, bool evCorrection, float exposureCompensation, MaskFuncT && maskFunc)
 {
     ImageT image, image_ud;
     readImage(srcImage, image, image::EImageColorSpace::LINEAR);
@@ -67,7 +68,25 @@ void process(const std::string &dstColorImage, const IntrinsicBase* cam, const o
         // undistort the image and save it
         using Pix = typename ImageT::Tpixel;
         Pix pixZero(Pix::Zero());
-        UndistortImage(image, cam, image_ud, pixZero);
+        // the views sharing the intrinsic share the undistortion map
+        UndistortionMapCache::MapSharedPtr undistortionMap;
+        if(undistortionMapCache)
+        {
+            // called from a parallel region: a failure falls back to the undistortion without map
+            try
+            {
+                undistortionMap = undistortionMapCache->get(*cam, image.width(), image.height());
+            }
+            catch(const std::exception& e)
+            {
+                ALICEVISION_LOG_WARNING("Cannot get the undistortion map of the image '" << srcImage << "': " << e.what());
+            }
+        }
+
+        if(undistortionMap)
+            UndistortImage(image, *undistortionMap, image_ud, pixZero);
+        else
+            UndistortImage(image, cam, image_ud, pixZero);
         writeImage(dstColorImage, image_ud, image::ImageWriteOptions(), metadata);
     }
     else
@@ -86,7 +105,8 @@ bool prepareDenseScene(const SfMData& sfmData,
                        image::EImageFileType outputFileType,
                        bool saveMetadata,
                        bool saveMatricesFiles,
-                       bool evCorrection)
+                       bool evCorrection,
+                       const std::string& undistortionMapsFolder)
 {
     // defined view Ids
     std::set<IndexT> viewIds;
@@ -123,6 +143,14 @@ bool prepareDenseScene(const SfMData& sfmData,
     const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
     ALICEVISION_LOG_INFO("Median Camera Exposure: " << medianCameraExposure << ", Median EV: " << std::log2(1.0/medianCameraExposure));
 
+    // undistortion maps shared by the views of the same intrinsic
+    UndistortionMapCache undistortionMapCache(undistortionMapsFolder);
+
+    // a map is only worth computing for the intrinsics of several views
+    std::map<IndexT, int> nbViewsPerIntrinsic;
+    for(const IndexT viewId : viewIds)
+        ++nbViewsPerIntrinsic[sfmData.getViews().at(viewId)->getIntrinsicId()];
+
     #pragma omp parallel for num_threads(3)
     for(int i = 0; i < viewIds.size(); ++i)
     {
@@ -233,6 +261,7 @@ bool prepareDenseScene(const SfMData& sfmData,
             }
             const std::string dstColorImage = (fs::path(outFolder) / (baseFilename + "." + image::EImageFileType_enumToString(outputFileType))).string();
             const IntrinsicBase* cam = iterIntrinsic->second.get();
+            UndistortionMapCache* viewUndistortionMapCache = (nbViewsPerIntrinsic.at(view->getIntrinsicId()) > 1) ? &undistortionMapCache : nullptr;
 
             // add exposure values to images metadata
             const double cameraExposure = view->getImage().getCameraExposureSetting().getExposure();
@@ -249,7 +278,7 @@ bool prepareDenseScene(const SfMData& sfmData,
             image::Image<unsigned char> mask;
             if(tryLoadMask(&mask, masksFolders, viewId, srcImage, maskExtension))
             {
-                process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, [&mask] (Image<RGBAfColor> & image)
+                process<Image<RGBAfColor>>(dstColorImage, cam, viewUndistortionMapCache, metadata, srcImage, evCorrection, exposureCompensation, [&mask] (Image<RGBAfColor> & image)
                 {
                     if(image.width() * image.height() != mask.width() * mask.height())
                     {
@@ -267,7 +296,7 @@ bool prepareDenseScene(const SfMData& sfmData,
             else
             {
                 const auto noMaskingFunc = [] (Image<RGBAfColor> & image) {};
-                process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
+                process<Image<RGBAfColor>>(dstColorImage, cam, viewUndistortionMapCache, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
             }
         }
 
@@ -293,6 +322,7 @@ int aliceVision_main(int argc, char *argv[])
     bool saveMetadata = true;
     bool saveMatricesTxtFiles = false;
     bool evCorrection = false;
+    std::string undistortionMapsFolder;
 
     // clang-format off
     po::options_description requiredParams("Required parameters");
@@ -323,7 +353,10 @@ int aliceVision_main(int argc, char *argv[])
         ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
          "Range size.")
         ("evCorrection", po::value<bool>(&evCorrection)->default_value(evCorrection),
-         "Correct exposure value.");
+         "Correct exposure value.")
+        ("undistortionMapsFolder", po::value<std::string>(&undistortionMapsFolder)->default_value(undistortionMapsFolder),
+         "Folder to store the undistortion maps of the intrinsics shared by several views (EXR) and reuse them across runs.\n"
+         "If empty, the maps are only kept in memory.");
     // clang-format on
 
     CmdLine cmdline("AliceVision prepareDenseScene");
@@ -376,9 +409,12 @@ int aliceVision_main(int argc, char *argv[])
         rangeStart = 0;
     }
 
+    if(!undistortionMapsFolder.empty() && !fs::exists(undistortionMapsFolder))
+        fs::create_directories(undistortionMapsFolder);
+
     // export
     if(prepareDenseScene(sfmData, imagesFolders, masksFolders, maskExtension, rangeStart, rangeEnd,
-                         outFolder, outputFileType, saveMetadata, saveMatricesTxtFiles, evCorrection))
+                         outFolder, outputFileType, saveMetadata, saveMatricesTxtFiles, evCorrection, undistortionMapsFolder))
         return EXIT_SUCCESS;
 
     return EXIT_FAILURE;
@@ -428,15 +428,11 @@ int aliceVision_main(int argc, char** argv)
 
         if (enforcePureRotation)
         {
-            //Transform to vector
-            Mat refVecs(3, n);
-            Mat nextVecs(3, n);
-            for (int idx = 0; idx < n; idx++)
-            {
-                //Lift to unit sphere
-                refVecs.col(idx) = refIntrinsics->toUnitSphere(refIntrinsics->removeDistortion(refIntrinsics->ima2cam(refX.col(idx))));
-                nextVecs.col(idx) = nextIntrinsics->toUnitSphere(nextIntrinsics->removeDistortion(nextIntrinsics->ima2cam(nextX.col(idx))));
-            }
+            //Lift to unit sphere
+            Mat3X refVecs;
+            Mat3X nextVecs;
+            refIntrinsics->backprojectPoints(refX, refVecs);
+            nextIntrinsics->backprojectPoints(nextX, nextVecs);
 
             //Try to fit an essential matrix (we assume we are approx. calibrated)
             Mat3 R;
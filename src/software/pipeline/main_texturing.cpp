@@ -29,7 +29,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -139,7 +139,10 @@ int aliceVision_main(int argc, char* argv[])
          " * PullPush: Combine results from Pull and Push results.'")
         ("subdivisionTargetRatio", po::value<float>(&texParams.subdivisionTargetRatio)->default_value(texParams.subdivisionTargetRatio),
          "Percentage of the density of the reconstruction as the target for the subdivision "
-         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).");
+         "(0: disable subdivision, 0.5: half density of the reconstruction, 1: full density of the reconstruction).")
+        ("maxNbPrefetchedCameras", po::value<unsigned int>(&texParams.maxNbPrefetchedCameras)->default_value(texParams.maxNbPrefetchedCameras),
+         "Maximum number of camera images and laplacian pyramids prepared in background while the current camera is processed "
+         "(bounded by the available memory, 0: disable).");
     // clang-format on
 
     CmdLine cmdline("AliceVision texturing");
@@ -45,7 +45,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 3
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 3
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 5
 
 using namespace aliceVision;
 namespace po = boost::program_options;
@@ -547,7 +547,8 @@ void undistortChromaticAberrations(const aliceVision::image::Image<aliceVision::
 }
 
 void processImage(image::Image<image::RGBAfColor>& image, ProcessingParams& pParams,
-                  std::map<std::string, std::string>& imageMetadata, std::shared_ptr<camera::IntrinsicBase> cam)
+                  std::map<std::string, std::string>& imageMetadata, std::shared_ptr<camera::IntrinsicBase> cam,
+                  camera::UndistortionMapCache* undistortionMapCache)
 {
     const unsigned int nchannels = 4;
 
@@ -590,11 +591,30 @@ void processImage(image::Image<image::RGBAfColor>& image, ProcessingParams& pPar
         {
             const image::RGBAfColor FBLACK_A(.0f, .0f, .0f, 1.0f);
             image::Image<image::RGBAfColor> image_ud;
-            const image::Sampler2d<image::SamplerLinear> sampler;
 
-            image_ud.resize(image.width(), image.height(), true, FBLACK_A);
+            // the images sharing the intrinsic share the undistortion map
+            camera::UndistortionMapCache::MapSharedPtr undistortionMap;
+            if (undistortionMapCache)
+            {
+                // a failure of the cache falls back to the undistortion without map
+                try
+                {
+                    undistortionMap = undistortionMapCache->get(*cam, image.width(), image.height());
+                }
+                catch (const std::exception& e)
+                {
+                    ALICEVISION_LOG_WARNING("Cannot get the undistortion map: " << e.what());
+                }
+            }
 
-            camera::UndistortImage(image, cam.get(), image_ud, FBLACK_A);
+            if (undistortionMap)
+            {
+                camera::UndistortImage(image, *undistortionMap, image_ud, FBLACK_A);
+            }
+            else
+            {
+                camera::UndistortImage(image, cam.get(), image_ud, FBLACK_A);
+            }
 
             image = image_ud;
         }
@@ -998,8 +1018,10 @@ int aliceVision_main(int argc, char * argv[])
     int highlightMode = 0;
     double correlatedColorTemperature = -1;
     std::string lensCorrectionProfileInfo;
+    std::string lensCorrectionProfileIndex;
     bool lensCorrectionProfileSearchIgnoreCameraModel = true;
     std::string sensorDatabasePath;
+    std::string undistortionMapsFolder;
 
     ProcessingParams pParams;
 
@@ -1156,7 +1178,16 @@ int aliceVision_main(int argc, char * argv[])
             
         ("lensCorrectionProfileInfo", po::value<std::string>(&lensCorrectionProfileInfo)->default_value(""),
          "Lens Correction Profile filepath or database directory path.")
+
+        ("lensCorrectionProfileIndex", po::value<std::string>(&lensCorrectionProfileIndex)->default_value(lensCorrectionProfileIndex),
+         "Binary index file of the Lens Correction Profile headers, created or updated if needed and reused by the next runs.\n"
+         "If empty, an index file of the database folder is kept in the cache folder of the user.\n"
+         "If 'none', the headers are parsed on demand, for the camera makers of the images only.")
             
+        ("undistortionMapsFolder", po::value<std::string>(&undistortionMapsFolder)->default_value(undistortionMapsFolder),
+         "Folder to store the undistortion maps of the intrinsics shared by several views (EXR) and reuse them across runs.\n"
+         "If empty, the maps are only kept in memory.")
+
         ("lensCorrectionProfileSearchIgnoreCameraModel", po::value<bool>(&lensCorrectionProfileSearchIgnoreCameraModel)->default_value(lensCorrectionProfileSearchIgnoreCameraModel),
          "Automatic LCP Search considers only the camera maker and the lens name.")
 
@@ -1222,6 +1253,12 @@ int aliceVision_main(int argc, char * argv[])
         return EXIT_FAILURE;
     }
 
+    if (!undistortionMapsFolder.empty() && !fs::exists(undistortionMapsFolder))
+        fs::create_directories(undistortionMapsFolder);
+
+    // undistortion maps shared by the images of the same intrinsic
+    camera::UndistortionMapCache undistortionMapCache(undistortionMapsFolder);
+
     // Check if sfmInputDataFilename exist and is recognized as sfm data file
     const std::string inputExt = boost::to_lower_copy(fs::path(inputExpression).extension().string());
     static const std::array<std::string, 2> sfmSupportedExtensions = {".sfm", ".abc"};
@@ -1277,6 +1314,11 @@ int aliceVision_main(int argc, char * argv[])
             }
         }
 
+        // a map is only worth computing for the intrinsics of several views
+        std::map<IndexT, int> nbViewsPerIntrinsic;
+        for (const auto& viewPath : ViewPaths)
+            ++nbViewsPerIntrinsic[sfmData.getView(viewPath.first).getIntrinsicId()];
+
         const int size = ViewPaths.size();
         int i = 0;
 
@@ -1414,7 +1456,7 @@ int aliceVision_main(int argc, char * argv[])
             }
 
             // Image processing
-            processImage(image, pParams, viewMetadata, cam);
+            processImage(image, pParams, viewMetadata, cam, (nbViewsPerIntrinsic[view.getIntrinsicId()] > 1) ? &undistortionMapCache : nullptr);
 
             if (pParams.applyDcpMetadata)
             {
@@ -1536,7 +1578,12 @@ int aliceVision_main(int argc, char * argv[])
         }
 
         image::DCPDatabase dcpDatabase;
-        LCPdatabase lcpStore(lensCorrectionProfileInfo, lensCorrectionProfileSearchIgnoreCameraModel);
+        if (lensCorrectionProfileIndex.empty())
+            lensCorrectionProfileIndex = getDefaultLCPIndexFilepath(lensCorrectionProfileInfo);
+        else if (lensCorrectionProfileIndex == "none")
+            lensCorrectionProfileIndex.clear();
+
+        LCPdatabase lcpStore(lensCorrectionProfileInfo, lensCorrectionProfileSearchIgnoreCameraModel, lensCorrectionProfileIndex);
 
         // check sensor database
         std::vector<sensorDB::Datasheet> sensorDatabase;
@@ -1649,7 +1696,6 @@ int aliceVision_main(int argc, char * argv[])
 
                     if (!make.empty() && !lensModel.empty())
                     {
-                        #pragma omp critical(lcp)
                         lcpData = lcpStore.findLCP(make, model, lensModel, lensID, 1);
                     }
                 }
@@ -1815,7 +1861,8 @@ int aliceVision_main(int argc, char * argv[])
             image::readImage(inputFilePath, image, readOptions);
 
             // Image processing
-            processImage(image, pParams, md, intrinsicBase);
+            // the intrinsic is built from the metadata of each image, it is not shared
+            processImage(image, pParams, md, intrinsicBase, nullptr);
 
             image::ImageWriteOptions writeOptions;
 
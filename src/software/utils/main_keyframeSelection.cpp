@@ -19,7 +19,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 5
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -56,6 +56,9 @@ int aliceVision_main(int argc, char** argv)
         image::EStorageDataType::Float;
     bool renameKeyframes = false;           // name selected keyframes as consecutive frames instead of using their index as a name
     std::size_t minBlockSize = 10;          // minimum number of frames in a block for multi-threading
+    bool pipelinedScoring = false;          // decode each media once and score its frames with a pool of threads
+    bool streamingSelection = false;        // select and write the keyframes while the medias are decoded (smart selection)
+    std::size_t maxSubsequenceSize = 1000;  // maximum number of frames in a subsequence (streaming selection)
     std::vector<std::string> maskPaths;    // masks path list
 
     // Debug options
@@ -140,6 +143,18 @@ int aliceVision_main(int argc, char** argv)
          "Size, in pixels, of the cells within an input frame that are used to compute the optical flow scores.")
         ("minBlockSize", po::value<std::size_t>(&minBlockSize)->default_value(minBlockSize),
          "Minimum number of frames processed by a single thread when multi-threading is used.")
+        ("pipelinedScoring", po::value<bool>(&pipelinedScoring)->default_value(pipelinedScoring),
+         "Decode each media once, sequentially, in its own thread and compute the scores of the decoded frames with "
+         "a pool of threads, instead of splitting the frames into blocks that each read all the medias. The frames "
+         "are converted once into grayscale proxies, downscaled to the largest rescaled width, from which the "
+         "sharpness and motion frames are derived.")
+        ("streamingSelection", po::value<bool>(&streamingSelection)->default_value(streamingSelection),
+         "Select the keyframes in a single pass, while the medias are decoded: each keyframe is written as soon as "
+         "its subsequence is complete, and the scores of the whole sequence are not kept in memory. The minimum "
+         "number of output keyframes cannot be enforced, and the scores cannot be exported in this mode.")
+        ("maxSubsequenceSize", po::value<std::size_t>(&maxSubsequenceSize)->default_value(maxSubsequenceSize),
+         "Maximum number of frames in a subsequence with the streaming selection: a keyframe is selected once a "
+         "subsequence reaches this size, even if the motion accumulation threshold is not reached. 0 = no limit.")
         ("maskPaths", po::value<std::vector<std::string>>(&maskPaths)->default_value(models)->multitoken(),
          "Paths to directories containing masks. Masks (e.g. segmentation masks) will be used to ignore some parts "
          "of the frames when computing the scores.");
@@ -249,6 +264,7 @@ int aliceVision_main(int argc, char** argv)
     selector.setMinOutFrames(minNbOutFrames);
     selector.setMaxOutFrames(maxNbOutFrames);
     selector.setMinBlockSize(minBlockSize);
+    selector.setPipelinedScoring(pipelinedScoring);
 
     if (flowVisualisationOnly) {
         bool exported = selector.exportFlowVisualisation(rescaledWidthFlow);
@@ -269,6 +285,20 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_SUCCESS;
     }
 
+    if (useSmartSelection && streamingSelection)
+    {
+        if (exportScores || exportFlowVisualisation)
+            ALICEVISION_LOG_WARNING("The scores and the optical flow visualisation cannot be exported with the streaming selection.");
+
+        // The keyframes are written during the selection
+        if (!selector.processStreaming(pxDisplacement, rescaledWidthSharp, rescaledWidthFlow, sharpnessWindowSize, flowCellSize,
+                                       maxSubsequenceSize, brands, models, mmFocals, renameKeyframes, outputExtension, exrDataType,
+                                       skipSharpnessComputation))
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    }
+
     // Process media paths with regular or smart method
     if (useSmartSelection)
         selector.processSmart(pxDisplacement, rescaledWidthSharp, rescaledWidthFlow, sharpnessWindowSize, flowCellSize,
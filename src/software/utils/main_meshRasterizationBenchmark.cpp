@@ -0,0 +1,283 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/main.hpp>
+#include <aliceVision/config.hpp>
+#include <boost/program_options.hpp>
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/triangleRasterization.hpp>
+
+#include <geogram/basic/geometry_nd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace po = boost::program_options;
+
+/// tolerance threshold of 1/2 pixel used by the texturing
+const double pixelInTriangleMaxSquaredDistance = 0.5 + std::numeric_limits<double>::epsilon();
+
+/**
+ * @brief Per-pixel test on the triangle bounding box, as done by the texturing before the row spans rasterization
+ * @param[in] triangle the triangle as an array of 3 point2Ds
+ * @param[in] beginX the first column
+ * @param[in] beginY the first row
+ * @param[in] endX the column after the last one
+ * @param[in] endY the row after the last one
+ * @param[in,out] barycentricSum the sum of the barycentric coordinates of the selected pixels
+ * @return the number of selected pixels
+ */
+std::size_t rasterizeTrianglePerPixel(const Point2d* triangle, int beginX, int beginY, int endX, int endY, double& barycentricSum)
+{
+    const GEO::vec2 V0(triangle[0].x, triangle[0].y);
+    const GEO::vec2 V1(triangle[1].x, triangle[1].y);
+    const GEO::vec2 V2(triangle[2].x, triangle[2].y);
+
+    std::size_t nbPixels = 0;
+    for (int y = beginY; y < endY; ++y)
+    {
+        for (int x = beginX; x < endX; ++x)
+        {
+            const GEO::vec2 p(x + 0.5, y + 0.5);
+            GEO::vec2 closestPoint;
+            double l1, l2, l3;
+            if (GEO::Geom::point_triangle_squared_distance<GEO::vec2>(p, V0, V1, V2, closestPoint, l1, l2, l3) < pixelInTriangleMaxSquaredDistance)
+            {
+                barycentricSum += l3 + l2;
+                ++nbPixels;
+            }
+        }
+    }
+    return nbPixels;
+}
+
+/**
+ * @brief Get the triangles of a mesh in texture pixels, as the texturing rasterizes them
+ * @param[in] mesh the mesh with UVs
+ * @param[in] textureSide the texture side in pixels
+ * @param[out] triangles the UV triangles in texture pixels, remapped to the [0,1] range of their UDIM
+ */
+void getMeshUvTriangles(const Mesh& mesh, unsigned int textureSide, std::vector<std::array<Point2d, 3>>& triangles)
+{
+    triangles.resize(mesh.tris.size());
+    for (int triangleId = 0; triangleId < mesh.tris.size(); ++triangleId)
+    {
+        const Voxel& triangleUvIds = mesh.trisUvIds[triangleId];
+        Point2d udimBL;
+        udimBL.x = std::floor(std::min({mesh.uvCoords[triangleUvIds.x].x, mesh.uvCoords[triangleUvIds.y].x, mesh.uvCoords[triangleUvIds.z].x}));
+        udimBL.y = std::floor(std::min({mesh.uvCoords[triangleUvIds.x].y, mesh.uvCoords[triangleUvIds.y].y, mesh.uvCoords[triangleUvIds.z].y}));
+
+        for (int k = 0; k < 3; ++k)
+            triangles[triangleId][k] = (mesh.uvCoords[triangleUvIds.m[k]] - udimBL) * textureSide;
+    }
+}
+
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::string inputMeshFilepath;
+    unsigned int textureSide = 8192;
+    int nbTriangles = 100000;
+    double triangleSize = 16.0;
+    int nbRepeats = 10;
+
+    // clang-format off
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("inputMesh", po::value<std::string>(&inputMeshFilepath)->default_value(inputMeshFilepath),
+         "Textured mesh (with UVs) whose UV triangles are rasterized. If empty, random triangles are rasterized.")
+        ("textureSide", po::value<unsigned int>(&textureSide)->default_value(textureSide),
+         "Output texture size, used to scale the UV triangles of the input mesh.")
+        ("nbTriangles", po::value<int>(&nbTriangles)->default_value(nbTriangles),
+         "Number of random triangles to rasterize (without input mesh).")
+        ("triangleSize", po::value<double>(&triangleSize)->default_value(triangleSize),
+         "Maximum extent of the random triangles, in pixels.")
+        ("nbRepeats", po::value<int>(&nbRepeats)->default_value(nbRepeats),
+         "Number of times all the triangles are rasterized.");
+    // clang-format on
+
+    CmdLine cmdline("This program measures the texturing triangle rasterization against the previous per-pixel tests.\n"
+                    "AliceVision meshRasterizationBenchmark");
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::array<Point2d, 3>> triangles;
+
+    if (!inputMeshFilepath.empty())
+    {
+        // UV triangles of a textured mesh
+        Mesh inputMesh;
+        inputMesh.load(inputMeshFilepath);
+
+        if (inputMesh.tris.empty() || inputMesh.trisUvIds.size() != inputMesh.tris.size() || inputMesh.uvCoords.empty())
+        {
+            ALICEVISION_LOG_ERROR("The input mesh has no UVs: " << inputMeshFilepath);
+            return EXIT_FAILURE;
+        }
+
+        getMeshUvTriangles(inputMesh, textureSide, triangles);
+        nbTriangles = triangles.size();
+
+        ALICEVISION_LOG_INFO("Rasterize the " << nbTriangles << " UV triangles of '" << inputMeshFilepath << "' in a " << textureSide
+                                              << " px texture, " << nbRepeats << " times.");
+    }
+    else
+    {
+        // random triangles, one thin triangle out of four
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> position(triangleSize, 1024.0 - triangleSize);
+        std::uniform_real_distribution<double> offset(-triangleSize, triangleSize);
+        std::uniform_real_distribution<double> thinOffset(-0.05, 0.05);
+
+        triangles.resize(nbTriangles);
+        for (int i = 0; i < nbTriangles; ++i)
+        {
+            const Point2d a(position(generator), position(generator));
+            const Point2d b(a.x + offset(generator), a.y + offset(generator));
+            const Point2d c = (i % 4 == 3) ? (a + b) * 0.5 + Point2d(thinOffset(generator), thinOffset(generator))
+                                           : Point2d(a.x + offset(generator), a.y + offset(generator));
+            triangles[i] = {a, b, c};
+        }
+
+        ALICEVISION_LOG_INFO("Rasterize " << nbTriangles << " random triangles of maximum extent " << triangleSize << " px, " << nbRepeats
+                                          << " times.");
+    }
+
+    // texturing rasterization
+    {
+        std::size_t nbPixelsPerPixel = 0;
+        std::size_t nbPixelsSpans = 0;
+        double barycentricSumPerPixel = 0.0;
+        double barycentricSumSpans = 0.0;
+
+        system::Timer timer;
+        for (int repeat = 0; repeat < nbRepeats; ++repeat)
+        {
+            for (const auto& triangle : triangles)
+            {
+                const Point2d* t = triangle.data();
+                nbPixelsPerPixel += rasterizeTrianglePerPixel(t,
+                                                              static_cast<int>(std::floor(std::min({t[0].x, t[1].x, t[2].x}))),
+                                                              static_cast<int>(std::floor(std::min({t[0].y, t[1].y, t[2].y}))),
+                                                              static_cast<int>(std::ceil(std::max({t[0].x, t[1].x, t[2].x}))),
+                                                              static_cast<int>(std::ceil(std::max({t[0].y, t[1].y, t[2].y}))),
+                                                              barycentricSumPerPixel);
+            }
+        }
+        const double perPixelTime = timer.elapsed();
+
+        timer.reset();
+        for (int repeat = 0; repeat < nbRepeats; ++repeat)
+        {
+            for (const auto& triangle : triangles)
+            {
+                const Point2d* t = triangle.data();
+                rasterizeTriangle(t,
+                                  static_cast<int>(std::floor(std::min({t[0].x, t[1].x, t[2].x}))),
+                                  static_cast<int>(std::floor(std::min({t[0].y, t[1].y, t[2].y}))),
+                                  static_cast<int>(std::ceil(std::max({t[0].x, t[1].x, t[2].x}))),
+                                  static_cast<int>(std::ceil(std::max({t[0].y, t[1].y, t[2].y}))),
+                                  pixelInTriangleMaxSquaredDistance,
+                                  [&](int, int, const Point2d& barycCoords) {
+                                      barycentricSumSpans += barycCoords.x + barycCoords.y;
+                                      ++nbPixelsSpans;
+                                  });
+            }
+        }
+        const double spansTime = timer.elapsed();
+
+        const double nbEvaluations = double(nbTriangles) * double(nbRepeats);
+        ALICEVISION_LOG_INFO("Texturing rasterization:" << std::endl
+                                                        << "\t- per pixel: " << 1e9 * perPixelTime / nbEvaluations << " ns/triangle, "
+                                                        << nbPixelsPerPixel << " pixels" << std::endl
+                                                        << "\t- row spans: " << 1e9 * spansTime / nbEvaluations << " ns/triangle, "
+                                                        << nbPixelsSpans << " pixels" << std::endl
+                                                        << "\t- speedup: " << perPixelTime / spansTime << std::endl
+                                                        << "\t- barycentric sums: " << barycentricSumPerPixel << " / " << barycentricSumSpans);
+    }
+
+    // conservative rasterization
+    {
+        Mesh mesh;
+        std::size_t nbPixelsPerPixel = 0;
+        std::size_t nbPixelsSpans = 0;
+
+        std::vector<Mesh::triangle_proj> tps(nbTriangles);
+        for (int i = 0; i < nbTriangles; ++i)
+        {
+            Mesh::triangle_proj& tp = tps[i];
+            tp.lu = Pixel(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+            tp.rd = Pixel(0, 0);
+            for (int j = 0; j < 3; ++j)
+            {
+                tp.tp2ds[j] = triangles[i][j];
+                tp.lu.x = std::min(tp.lu.x, static_cast<int>(tp.tp2ds[j].x));
+                tp.lu.y = std::min(tp.lu.y, static_cast<int>(tp.tp2ds[j].y));
+                tp.rd.x = std::max(tp.rd.x, static_cast<int>(tp.tp2ds[j].x));
+                tp.rd.y = std::max(tp.rd.y, static_cast<int>(tp.tp2ds[j].y));
+            }
+        }
+
+        system::Timer timer;
+        for (int repeat = 0; repeat < nbRepeats; ++repeat)
+        {
+            for (Mesh::triangle_proj& tp : tps)
+            {
+                Pixel pix;
+                for (pix.x = tp.lu.x; pix.x <= tp.rd.x; ++pix.x)
+                {
+                    for (pix.y = tp.lu.y; pix.y <= tp.rd.y; ++pix.y)
+                    {
+                        Mesh::rectangle re = Mesh::rectangle(pix, 1);
+                        if (mesh.doesTriangleIntersectsRectangle(tp, re))
+                            ++nbPixelsPerPixel;
+                    }
+                }
+            }
+        }
+        const double perPixelTime = timer.elapsed();
+
+        timer.reset();
+        for (int repeat = 0; repeat < nbRepeats; ++repeat)
+        {
+            for (const Mesh::triangle_proj& tp : tps)
+            {
+                rasterizeTriangleConservative(tp.tp2ds, tp.lu.x, tp.lu.y, tp.rd.x + 1, tp.rd.y + 1, [&](int, int) { ++nbPixelsSpans; });
+            }
+        }
+        const double spansTime = timer.elapsed();
+
+        const double nbEvaluations = double(nbTriangles) * double(nbRepeats);
+        ALICEVISION_LOG_INFO("Conservative rasterization:" << std::endl
+                                                           << "\t- per pixel: " << 1e9 * perPixelTime / nbEvaluations << " ns/triangle, "
+                                                           << nbPixelsPerPixel << " pixels" << std::endl
+                                                           << "\t- row spans: " << 1e9 * spansTime / nbEvaluations << " ns/triangle, "
+                                                           << nbPixelsSpans << " pixels" << std::endl
+                                                           << "\t- speedup: " << perPixelTime / spansTime);
+    }
+
+    return EXIT_SUCCESS;
+}
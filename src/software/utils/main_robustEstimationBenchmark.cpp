@@ -0,0 +1,183 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/main.hpp>
+#include <aliceVision/config.hpp>
+#include <boost/program_options.hpp>
+
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfmDataIO/sfmDataIO.hpp>
+#include <aliceVision/sfm/pipeline/regionsIO.hpp>
+#include <aliceVision/sfm/pipeline/pairwiseMatchesIO.hpp>
+#include <aliceVision/feature/FeaturesPerView.hpp>
+#include <aliceVision/feature/imageDescriberCommon.hpp>
+#include <aliceVision/matching/IndMatch.hpp>
+#include <aliceVision/matchingImageCollection/GeometricFilterMatrix_F_AC.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+
+namespace po = boost::program_options;
+
+/**
+ * @brief Filter the matches of an image pair with the fundamental matrix LORANSAC
+ * @param[in] sfmData The input SfMData with the views and intrinsics
+ * @param[in] featuresPerView The features of the views
+ * @param[in] pair The image pair
+ * @param[in] putativeMatches The matches of the image pair
+ * @param[in] precision The maximum reprojection error in pixels
+ * @param[in] maxIteration The maximum number of iterations
+ * @param[in] useSPRT Enable the SPRT early termination of the bad hypotheses
+ * @param[in] seed The seed of the random number generator
+ * @param[out] elapsed The accumulated estimation time in seconds
+ * @return the number of inliers
+ */
+std::size_t filterPair(const sfmData::SfMData& sfmData,
+                       const feature::FeaturesPerView& featuresPerView,
+                       const Pair& pair,
+                       const matching::MatchesPerDescType& putativeMatches,
+                       double precision,
+                       std::size_t maxIteration,
+                       bool useSPRT,
+                       int seed,
+                       double& elapsed)
+{
+    matchingImageCollection::GeometricFilterMatrix_F_AC filter(precision, maxIteration, robustEstimation::ERobustEstimator::LORANSAC);
+    filter.m_useSPRT = useSPRT;
+
+    std::mt19937 randomNumberGenerator(seed);
+    matching::MatchesPerDescType inliers;
+
+    system::Timer timer;
+    filter.geometricEstimation(&sfmData, featuresPerView, pair, putativeMatches, randomNumberGenerator, inliers);
+    elapsed += timer.elapsed();
+
+    return inliers.getNbAllMatches();
+}
+
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::string sfmDataFilepath;
+    std::vector<std::string> featuresFolders;
+    std::vector<std::string> matchesFolders;
+    std::string describerTypesName = feature::EImageDescriberType_enumToString(feature::EImageDescriberType::SIFT);
+    double precision = 4.0;
+    std::size_t maxIteration = 2048;
+    int maxNbPairs = 0;
+    int randomSeed = 0;
+
+    // clang-format off
+    po::options_description requiredParams("Required parameters");
+    requiredParams.add_options()
+        ("input,i", po::value<std::string>(&sfmDataFilepath)->required(),
+         "SfMData file.")
+        ("featuresFolders,f", po::value<std::vector<std::string>>(&featuresFolders)->multitoken()->required(),
+         "Path to folder(s) containing the extracted features.")
+        ("matchesFolders,m", po::value<std::vector<std::string>>(&matchesFolders)->multitoken()->required(),
+         "Path to folder(s) in which the putative matches are stored.");
+
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("describerTypes,d", po::value<std::string>(&describerTypesName)->default_value(describerTypesName),
+         feature::EImageDescriberType_informations().c_str())
+        ("precision", po::value<double>(&precision)->default_value(precision),
+         "Maximum reprojection error (in pixels) of the inliers.")
+        ("maxIteration", po::value<std::size_t>(&maxIteration)->default_value(maxIteration),
+         "Maximum number of iterations of the robust estimation.")
+        ("maxNbPairs", po::value<int>(&maxNbPairs)->default_value(maxNbPairs),
+         "Maximum number of image pairs to process (0: all the pairs).")
+        ("randomSeed", po::value<int>(&randomSeed)->default_value(randomSeed),
+         "Seed of the random number generator, the same for both scorings of a pair.");
+    // clang-format on
+
+    CmdLine cmdline("This program compares the fundamental matrix LORANSAC filtering of the matches "
+                    "with and without the SPRT early termination of the bad hypotheses.\n"
+                    "AliceVision robustEstimationBenchmark");
+    cmdline.add(requiredParams);
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // load input SfMData scene
+    sfmData::SfMData sfmData;
+    if (!sfmDataIO::load(sfmData, sfmDataFilepath, sfmDataIO::ESfMData(sfmDataIO::VIEWS | sfmDataIO::INTRINSICS)))
+    {
+        ALICEVISION_LOG_ERROR("The input SfMData file '" << sfmDataFilepath << "' cannot be read.");
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<feature::EImageDescriberType> describerTypes = feature::EImageDescriberType_stringToEnums(describerTypesName);
+
+    feature::FeaturesPerView featuresPerView;
+    if (!sfm::loadFeaturesPerView(featuresPerView, sfmData, featuresFolders, describerTypes))
+    {
+        ALICEVISION_LOG_ERROR("Invalid features");
+        return EXIT_FAILURE;
+    }
+
+    matching::PairwiseMatches pairwiseMatches;
+    if (!sfm::loadPairwiseMatches(pairwiseMatches, sfmData, matchesFolders, describerTypes))
+    {
+        ALICEVISION_LOG_ERROR("Unable to load matches files from: " << matchesFolders);
+        return EXIT_FAILURE;
+    }
+
+    std::size_t nbPairs = 0;
+    std::size_t nbSameInliers = 0;
+    std::size_t nbInliersFull = 0;
+    std::size_t nbInliersSPRT = 0;
+    double elapsedFull = 0.0;
+    double elapsedSPRT = 0.0;
+
+    for (const auto& matchesPair : pairwiseMatches)
+    {
+        if (maxNbPairs > 0 && nbPairs >= static_cast<std::size_t>(maxNbPairs))
+            break;
+
+        const Pair& pair = matchesPair.first;
+        if (!featuresPerView.viewExist(pair.first) || !featuresPerView.viewExist(pair.second))
+            continue;
+
+        const std::size_t inliersFull =
+          filterPair(sfmData, featuresPerView, pair, matchesPair.second, precision, maxIteration, false, randomSeed, elapsedFull);
+        const std::size_t inliersSPRT =
+          filterPair(sfmData, featuresPerView, pair, matchesPair.second, precision, maxIteration, true, randomSeed, elapsedSPRT);
+
+        ALICEVISION_LOG_DEBUG("Pair (" << pair.first << ", " << pair.second << "): " << matchesPair.second.getNbAllMatches() << " matches, "
+                                       << inliersFull << " inliers (full scoring), " << inliersSPRT << " inliers (SPRT)");
+
+        ++nbPairs;
+        nbInliersFull += inliersFull;
+        nbInliersSPRT += inliersSPRT;
+        if (inliersFull == inliersSPRT)
+            ++nbSameInliers;
+    }
+
+    ALICEVISION_LOG_INFO("Robust estimation benchmark:" << std::endl
+                         << "\t- # pairs: " << nbPairs << std::endl
+                         << "\t- # pairs with the same number of inliers: " << nbSameInliers << std::endl
+                         << "\t- # inliers (full scoring): " << nbInliersFull << std::endl
+                         << "\t- # inliers (SPRT): " << nbInliersSPRT << std::endl
+                         << "\t- time (full scoring): " << elapsedFull << " s" << std::endl
+                         << "\t- time (SPRT): " << elapsedSPRT << " s" << std::endl
+                         << "\t- speedup: " << (elapsedSPRT > 0.0 ? elapsedFull / elapsedSPRT : 0.0));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2024 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/cmdline/cmdline.hpp>
+#include <aliceVision/system/main.hpp>
+#include <aliceVision/config.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+#include <boost/program_options.hpp>
+
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/sfm/bundle/costfunctions/projection.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+// These constants define the current software version.
+// They must be updated when the command line is changed.
+#define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+
+using namespace aliceVision;
+using namespace aliceVision::sfm;
+
+namespace po = boost::program_options;
+
+/**
+ * @brief Storage for the parameter blocks used by one residual of the benchmark
+ */
+struct BenchmarkBlock
+{
+    SE3::Matrix pose;
+    SE3::Matrix rig;
+    Vec3 landmark;
+    sfmData::Observation observation;
+};
+
+/**
+ * @brief Evaluate all the cost functions and return the elapsed time in seconds
+ * @param[in] costs the cost functions to evaluate
+ * @param[in] blocks the parameter blocks associated to each cost function
+ * @param[in] intrinsicParams the intrinsic parameter block shared by all cost functions
+ * @param[in] withJacobians if true, evaluate the jacobians as well
+ * @param[in] nbThreads the number of threads to use
+ * @param[in] nbRepeats the number of times all cost functions are evaluated
+ * @return the elapsed time in seconds
+ */
+double evaluateCosts(const std::vector<std::unique_ptr<CostProjection>>& costs,
+                     std::vector<BenchmarkBlock>& blocks,
+                     std::vector<double>& intrinsicParams,
+                     bool withJacobians,
+                     int nbThreads,
+                     int nbRepeats)
+{
+    const int paramsSize = static_cast<int>(intrinsicParams.size());
+
+    system::Timer timer;
+
+    for (int repeat = 0; repeat < nbRepeats; ++repeat)
+    {
+#pragma omp parallel num_threads(nbThreads)
+        {
+            // per-thread buffers, Ceres does the same for its evaluators
+            double residuals[2];
+            double jacobianPose[2 * 16];
+            double jacobianRig[2 * 16];
+            std::vector<double> jacobianIntrinsics(2 * paramsSize);
+            double jacobianLandmark[2 * 3];
+            double* jacobians[4] = {jacobianPose, jacobianRig, jacobianIntrinsics.data(), jacobianLandmark};
+
+#pragma omp for
+            for (int i = 0; i < static_cast<int>(costs.size()); ++i)
+            {
+                const double* parameters[4] = {blocks[i].pose.data(), blocks[i].rig.data(), intrinsicParams.data(), blocks[i].landmark.data()};
+                costs[i]->Evaluate(parameters, residuals, withJacobians ? jacobians : nullptr);
+            }
+        }
+    }
+
+    return timer.elapsed();
+}
+
+int aliceVision_main(int argc, char** argv)
+{
+    // command-line parameters
+    std::string intrinsicType = camera::EINTRINSIC_enumToString(camera::EINTRINSIC::PINHOLE_CAMERA_RADIAL3);
+    int nbResiduals = 200000;
+    int nbRepeats = 10;
+    int maxThreads = 0;
+
+    // clang-format off
+    po::options_description optionalParams("Optional parameters");
+    optionalParams.add_options()
+        ("intrinsicType", po::value<std::string>(&intrinsicType)->default_value(intrinsicType),
+         "Camera model used for the residuals (pinhole, radial1, radial3, brown, fisheye4, fisheye1, 3deanamorphic4, 3deradial4, 3declassicld, equidistant, equidistant_r3).")
+        ("nbResiduals", po::value<int>(&nbResiduals)->default_value(nbResiduals),
+         "Number of projection residuals to evaluate.")
+        ("nbRepeats", po::value<int>(&nbRepeats)->default_value(nbRepeats),
+         "Number of times all the residuals are evaluated.")
+        ("maxThreads", po::value<int>(&maxThreads)->default_value(maxThreads),
+         "Maximum number of threads used for the scaling measurement (0: use all available cores).");
+    // clang-format on
+
+    CmdLine cmdline("This program measures the evaluation cost of the bundle adjustment projection residuals.\n"
+                    "AliceVision sfmBundleBenchmark");
+    cmdline.add(optionalParams);
+    if (!cmdline.execute(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (maxThreads <= 0)
+    {
+        maxThreads = omp_get_max_threads();
+    }
+
+    srand(0);
+
+    std::shared_ptr<camera::IntrinsicBase> intrinsic = camera::createIntrinsic(camera::EINTRINSIC_stringToEnum(intrinsicType), 1920, 1080, 980.0, 980.0, 10.0, 20.0);
+    if (!intrinsic)
+    {
+        ALICEVISION_LOG_ERROR("Invalid intrinsic type: " << intrinsicType);
+        return EXIT_FAILURE;
+    }
+    std::vector<double> intrinsicParams = intrinsic->getParams();
+
+    // random observations of points in front of the cameras
+    std::vector<BenchmarkBlock> blocks(nbResiduals);
+    std::vector<std::unique_ptr<CostProjection>> costs;
+    costs.reserve(nbResiduals);
+
+    for (int i = 0; i < nbResiduals; ++i)
+    {
+        BenchmarkBlock& block = blocks[i];
+        const geometry::Pose3 pose(SO3::expm(Vec3::Random() * 0.3), Vec3::Random());
+        block.pose = pose.getHomogeneous();
+        block.rig = SE3::Matrix::Identity();
+
+        const Vec3 ptCamera(Vec3::Random()(0), Vec3::Random()(1), 4.0 + Vec3::Random()(2));
+        block.landmark = pose.inverse()(ptCamera);
+        block.observation = sfmData::Observation(intrinsic->project(pose, block.landmark.homogeneous(), true) + Vec2::Random(), i, 1.0);
+
+        costs.emplace_back(new CostProjection(block.observation, intrinsic, false));
+    }
+
+    ALICEVISION_LOG_INFO("Evaluate " << nbResiduals << " residuals of type " << intrinsicType << ", " << nbRepeats << " times.");
+
+    double singleThreadTime = 0.0;
+    for (int nbThreads = 1; nbThreads <= maxThreads; nbThreads *= 2)
+    {
+        const double residualsTime = evaluateCosts(costs, blocks, intrinsicParams, false, nbThreads, nbRepeats);
+        const double jacobiansTime = evaluateCosts(costs, blocks, intrinsicParams, true, nbThreads, nbRepeats);
+
+        if (nbThreads == 1)
+        {
+            singleThreadTime = jacobiansTime;
+        }
+
+        const double nbEvaluations = double(nbResiduals) * double(nbRepeats);
+
+        ALICEVISION_LOG_INFO("Threads: " << nbThreads << std::endl
+                                         << "\t- residuals only: " << 1e9 * residualsTime / nbEvaluations << " ns/residual" << std::endl
+                                         << "\t- with jacobians: " << 1e9 * jacobiansTime / nbEvaluations << " ns/residual" << std::endl
+                                         << "\t- speedup: " << singleThreadTime / jacobiansTime);
+    }
+
+    return EXIT_SUCCESS;
+}